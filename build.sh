@@ -26,8 +26,8 @@ echo ""
 
 # Mostrar archivos nuevos
 echo "=== Archivos implementados ==="
-echo "Componente BLE HID Keyboard:"
-find components/ble_hid_keyboard -type f | sed 's/^/  /'
+echo "Componente BLE HID (raton + teclado):"
+find components/ble_hid_combined -type f | sed 's/^/  /'
 echo ""
 echo "Pantalla Magic Trick:"
 find components/gui -name "*magic_trick*" | sed 's/^/  /'
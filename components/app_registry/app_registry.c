@@ -0,0 +1,197 @@
+#include "app_registry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char* TAG = "APP_REG";
+
+#define INDEX_FILE   "/spiffs/apps.idx"
+#define INDEX_MAGIC  0x31525041u    // "APR1"
+
+static app_custom_table_t* s_custom;   // PSRAM, ~5 KB
+static SemaphoreHandle_t s_lock;
+static portMUX_TYPE s_init_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t s_generation;
+
+static void icon_path(const char* app_id, char* out, size_t cap)
+{
+    snprintf(out, cap, "/spiffs/app_%08lx.rle", (unsigned long)app_id_hash(app_id));
+}
+
+static void load_index(void)
+{
+    FILE* f = fopen(INDEX_FILE, "rb");
+    if (!f) return;
+    uint32_t magic = 0;
+    uint16_t n = 0;
+    if (fread(&magic, sizeof(magic), 1, f) == 1 && magic == INDEX_MAGIC &&
+        fread(&n, sizeof(n), 1, f) == 1 && n <= APP_CUSTOM_MAX &&
+        fread(s_custom->e, sizeof(s_custom->e[0]), n, f) == n) {
+        s_custom->n = n;
+    } else {
+        ESP_LOGW(TAG, "Ignoring damaged %s", INDEX_FILE);
+    }
+    fclose(f);
+}
+
+static bool save_index(void)
+{
+    FILE* f = fopen(INDEX_FILE, "wb");
+    if (!f) return false;
+    const uint32_t magic = INDEX_MAGIC;
+    bool ok = fwrite(&magic, sizeof(magic), 1, f) == 1 &&
+              fwrite(&s_custom->n, sizeof(s_custom->n), 1, f) == 1 &&
+              fwrite(s_custom->e, sizeof(s_custom->e[0]), s_custom->n, f) == s_custom->n;
+    return fclose(f) == 0 && ok;
+}
+
+esp_err_t app_registry_init(void)
+{
+    taskENTER_CRITICAL(&s_init_mux);
+    bool first = s_lock == NULL;
+    if (first) s_lock = xSemaphoreCreateMutex();
+    taskEXIT_CRITICAL(&s_init_mux);
+    if (!s_lock) return ESP_ERR_NO_MEM;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    if (!s_custom) {
+        s_custom = heap_caps_calloc(1, sizeof(*s_custom), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_custom) s_custom = calloc(1, sizeof(*s_custom));
+        if (s_custom) {
+            load_index();
+            ESP_LOGI(TAG, "%u custom apps", (unsigned)s_custom->n);
+        } else {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+bool app_registry_lookup(const char* app_id, app_info_t* out)
+{
+    memset(out, 0, sizeof(*out));
+
+    if (s_lock && app_id && *app_id) {
+        bool found = false;
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        int i = s_custom ? app_custom_find(s_custom, app_id) : -1;
+        if (i >= 0) {
+            const app_custom_t* e = &s_custom->e[i];
+            snprintf(out->name, sizeof(out->name), "%s", e->name[0] ? e->name : e->id);
+            out->icon = e->icon_len ? APP_ICON_CUSTOM : APP_ICON_GENERIC;
+            out->w = e->w;
+            out->h = e->h;
+            found = true;
+        }
+        xSemaphoreGive(s_lock);
+        if (found) return true;
+    }
+
+    const app_builtin_t* b = app_builtin_find(app_id);
+    if (b) {
+        snprintf(out->name, sizeof(out->name), "%s", b->name);
+        out->icon = b->icon;
+        return true;
+    }
+    snprintf(out->name, sizeof(out->name), "%s", (app_id && *app_id) ? app_id : "Notifications");
+    out->icon = APP_ICON_GENERIC;
+    return false;
+}
+
+esp_err_t app_registry_put(const char* app_id, const char* name,
+                           const uint8_t* icon, size_t icon_len, uint16_t w, uint16_t h)
+{
+    if (!app_id || !*app_id) return ESP_ERR_INVALID_ARG;
+    if (icon && (icon_len == 0 || icon_len > APP_ICON_RLE_MAX || w == 0 || h == 0 ||
+                 w > APP_ICON_MAX_DIM || h > APP_ICON_MAX_DIM)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = app_registry_init();
+    if (err != ESP_OK) return err;
+
+    app_custom_t e = {0};
+    snprintf(e.id, sizeof(e.id), "%s", app_id);
+    if (name) snprintf(e.name, sizeof(e.name), "%s", name);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (icon) {
+        char path[32];
+        icon_path(app_id, path, sizeof(path));
+        FILE* f = fopen(path, "wb");
+        bool ok = f && fwrite(icon, 1, icon_len, f) == icon_len;
+        if (f && fclose(f) != 0) ok = false;
+        if (ok) {
+            e.w = w;
+            e.h = h;
+            e.icon_len = (uint32_t)icon_len;
+        } else {
+            err = ESP_FAIL;
+        }
+    } else {
+        // Name only: keep an icon pushed earlier
+        int i = app_custom_find(s_custom, app_id);
+        if (i >= 0) {
+            e.w = s_custom->e[i].w;
+            e.h = s_custom->e[i].h;
+            e.icon_len = s_custom->e[i].icon_len;
+        }
+    }
+    if (err == ESP_OK && !app_custom_put(s_custom, &e)) err = ESP_ERR_NO_MEM;
+    if (err == ESP_OK && !save_index()) err = ESP_FAIL;
+    s_generation++;
+    xSemaphoreGive(s_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Register %s failed: %s", app_id, esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "Registered %s (%ux%u icon, %u B)", app_id, w, h, (unsigned)icon_len);
+    }
+    return err;
+}
+
+esp_err_t app_registry_load_icon(const char* app_id, uint8_t* img, size_t cap,
+                                 uint16_t* w, uint16_t* h)
+{
+    if (!s_lock || !app_id) return ESP_ERR_INVALID_STATE;
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int i = s_custom ? app_custom_find(s_custom, app_id) : -1;
+    if (i >= 0 && s_custom->e[i].icon_len) {
+        const app_custom_t* e = &s_custom->e[i];
+        uint8_t* rle = NULL;
+        FILE* f = NULL;
+        char path[32];
+        icon_path(app_id, path, sizeof(path));
+        if ((size_t)e->w * e->h * 3 > cap) {
+            err = ESP_ERR_INVALID_SIZE;
+        } else if ((rle = heap_caps_malloc(e->icon_len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)) == NULL) {
+            err = ESP_ERR_NO_MEM;
+        } else if ((f = fopen(path, "rb")) == NULL || fread(rle, 1, e->icon_len, f) != e->icon_len) {
+            err = ESP_FAIL;
+        } else if (!app_icon_decode(rle, e->icon_len, e->w, e->h, img)) {
+            err = ESP_ERR_INVALID_CRC;
+        } else {
+            *w = e->w;
+            *h = e->h;
+            err = ESP_OK;
+        }
+        if (f) fclose(f);
+        free(rle);
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+uint32_t app_registry_generation(void)
+{
+    return s_generation;
+}
@@ -0,0 +1,90 @@
+// Icon run-length codec (see app_rle.h)
+
+#include "app_rle.h"
+
+#include <string.h>
+
+static inline bool same(const uint8_t* a, const uint8_t* b, unsigned unit)
+{
+    return unit == 1 ? a[0] == b[0] : memcmp(a, b, unit) == 0;
+}
+
+static inline bool run3(const uint8_t* in, size_t i, size_t count, unsigned unit)
+{
+    return i + 2 < count && same(in + i * unit, in + (i + 1) * unit, unit) &&
+           same(in + i * unit, in + (i + 2) * unit, unit);
+}
+
+size_t app_rle_encode(const void* src, size_t count, unsigned unit, uint8_t* dst, size_t cap)
+{
+    const uint8_t* in = (const uint8_t*)src;
+    size_t i = 0, o = 0;
+
+    while (i < count) {
+        // Run of at least two equal units
+        size_t run = 1;
+        while (i + run < count && run < 129 && same(in + (i + run) * unit, in + i * unit, unit)) run++;
+        if (run >= 2) {
+            if (o + 1 + unit > cap) return 0;
+            dst[o++] = (uint8_t)(0x80 | (run - 2));
+            memcpy(dst + o, in + i * unit, unit);
+            o += unit;
+            i += run;
+            continue;
+        }
+
+        // Literals up to the next run of three: a pair inside a literal is
+        // cheaper than closing it, which bounds the growth of noisy input
+        size_t lit = 1;
+        while (i + lit < count && lit < 128 && !run3(in, i + lit, count, unit)) lit++;
+        if (o + 1 + lit * unit > cap) return 0;
+        dst[o++] = (uint8_t)(lit - 1);
+        memcpy(dst + o, in + i * unit, lit * unit);
+        o += lit * unit;
+        i += lit;
+    }
+    return o;
+}
+
+size_t app_rle_decode(const uint8_t* src, size_t len, void* dst, size_t count, unsigned unit)
+{
+    uint8_t* out = (uint8_t*)dst;
+    size_t i = 0, o = 0;
+
+    while (o < count) {
+        if (i >= len) return 0;
+        uint8_t ctrl = src[i++];
+        if (ctrl & 0x80) {
+            size_t run = (size_t)(ctrl & 0x7F) + 2;
+            if (run > count - o || i + unit > len) return 0;
+            for (size_t k = 0; k < run; ++k) memcpy(out + (o + k) * unit, src + i, unit);
+            i += unit;
+            o += run;
+        } else {
+            size_t lit = (size_t)ctrl + 1;
+            if (lit > count - o || i + lit * unit > len) return 0;
+            memcpy(out + o * unit, src + i, lit * unit);
+            i += lit * unit;
+            o += lit;
+        }
+    }
+    return i;
+}
+
+size_t app_icon_encode(const uint8_t* img, uint16_t w, uint16_t h, uint8_t* dst, size_t cap)
+{
+    size_t px = (size_t)w * h;
+    size_t a = app_rle_encode(img, px, 2, dst, cap);
+    if (!a) return 0;
+    size_t b = app_rle_encode(img + px * 2, px, 1, dst + a, cap - a);
+    return b ? a + b : 0;
+}
+
+bool app_icon_decode(const uint8_t* src, size_t len, uint16_t w, uint16_t h, uint8_t* img)
+{
+    size_t px = (size_t)w * h;
+    size_t a = app_rle_decode(src, len, img, px, 2);
+    if (!a) return false;
+    size_t b = app_rle_decode(src + a, len - a, img + px * 2, px, 1);
+    return b && a + b == len;
+}
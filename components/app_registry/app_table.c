@@ -0,0 +1,99 @@
+// App id lookup tables (see app_table.h)
+
+#include "app_table.h"
+
+#include <string.h>
+
+// Sorted by app_id_cmp on the id
+static const app_builtin_t k_builtin[] = {
+    { "call",                               "Call",         APP_ICON_CALL },
+    { "com.android.messaging",              "SMS",          APP_ICON_SMS },
+    { "com.facebook.katana",                "Facebook",     APP_ICON_MESSENGER },
+    { "com.google.android.apps.messagi",    "SMS",          APP_ICON_SMS },
+    { "com.google.android.apps.messaging",  "SMS",          APP_ICON_SMS },
+    { "com.google.android.dialer",          "Call",         APP_ICON_CALL },
+    { "com.google.android.gm",              "Gmail",        APP_ICON_GMAIL },
+    { "com.google.android.youtube",         "YouTube",      APP_ICON_YOUTUBE },
+    { "com.instagram.android",              "Instagram",    APP_ICON_INSTAGRAM },
+    { "com.microsoft.office.outlook",       "Outlook",      APP_ICON_OUTLOOK },
+    { "com.microsoft.teams",                "Teams",        APP_ICON_TEAMS },
+    { "com.twitter.android",                "X (Twitter)",  APP_ICON_X },
+    { "com.whatsapp",                       "WhatsApp",     APP_ICON_WHATSAPP },
+    { "com.zhiliaoapp.musically",           "TikTok",       APP_ICON_TIKTOK },
+    { "org.telegram.messenger",             "Telegram",     APP_ICON_TELEGRAM },
+    { "sms",                                "SMS",          APP_ICON_SMS },
+};
+
+static inline int lower(int c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+int app_id_cmp(const char* a, const char* b)
+{
+    for (;; ++a, ++b) {
+        int d = lower((unsigned char)*a) - lower((unsigned char)*b);
+        if (d || !*a) return d;
+    }
+}
+
+const app_builtin_t* app_builtin_table(size_t* n)
+{
+    *n = sizeof(k_builtin) / sizeof(k_builtin[0]);
+    return k_builtin;
+}
+
+const app_builtin_t* app_builtin_find(const char* id)
+{
+    if (!id) return NULL;
+    size_t lo = 0, hi = sizeof(k_builtin) / sizeof(k_builtin[0]);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int c = app_id_cmp(id, k_builtin[mid].id);
+        if (c == 0) return &k_builtin[mid];
+        if (c < 0) hi = mid; else lo = mid + 1;
+    }
+    return NULL;
+}
+
+// Lower bound: first entry not below id
+static size_t custom_lower(const app_custom_table_t* t, const char* id)
+{
+    size_t lo = 0, hi = t->n;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (app_id_cmp(t->e[mid].id, id) < 0) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+int app_custom_find(const app_custom_table_t* t, const char* id)
+{
+    if (!id) return -1;
+    size_t i = custom_lower(t, id);
+    return (i < t->n && app_id_cmp(t->e[i].id, id) == 0) ? (int)i : -1;
+}
+
+bool app_custom_put(app_custom_table_t* t, const app_custom_t* e)
+{
+    size_t i = custom_lower(t, e->id);
+    if (i < t->n && app_id_cmp(t->e[i].id, e->id) == 0) {
+        t->e[i] = *e;
+        return true;
+    }
+    if (t->n >= APP_CUSTOM_MAX) return false;
+    memmove(&t->e[i + 1], &t->e[i], (t->n - i) * sizeof(t->e[0]));
+    t->e[i] = *e;
+    t->n++;
+    return true;
+}
+
+uint32_t app_id_hash(const char* id)
+{
+    uint32_t h = 2166136261u;
+    for (; id && *id; ++id) {
+        h ^= (uint8_t)lower((unsigned char)*id);
+        h *= 16777619u;
+    }
+    return h;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "app_table.h"
+#include "app_rle.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// App metadata for notification cards: the built-in table plus apps the
+// phone registers at runtime (name and an RLE icon, see app_rle.h). Custom
+// entries and their icons persist on SPIFFS. Every call is thread safe and
+// copies its result out, so nothing returned is shared.
+
+typedef struct {
+    char name[APP_NAME_MAX];
+    uint8_t icon;             // app_icon_t
+    uint16_t w, h;            // APP_ICON_CUSTOM only
+} app_info_t;
+
+// Load the custom table. SPIFFS must be mounted; safe to call again.
+esp_err_t app_registry_init(void);
+
+// Custom entry first (the phone may override a built-in), then the
+// built-in table; unknown apps get their id as name and the generic icon.
+// Returns false for the generic fallback.
+bool app_registry_lookup(const char* app_id, app_info_t* out);
+
+// Register or update an app. icon may be NULL (name only); otherwise it is
+// an app_icon_encode() stream of a w x h RGB565A8 image.
+esp_err_t app_registry_put(const char* app_id, const char* name,
+                           const uint8_t* icon, size_t icon_len, uint16_t w, uint16_t h);
+
+// Decode the custom icon of app_id into img (w*h*3 bytes, RGB565A8)
+esp_err_t app_registry_load_icon(const char* app_id, uint8_t* img, size_t cap,
+                                 uint16_t* w, uint16_t* h);
+
+// Bumped by every put: cached decoded icons older than this are stale
+uint32_t app_registry_generation(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Run-length codec for app icons (PackBits style over 1- or 2-byte units).
+//
+//   ctrl < 0x80 : ctrl + 1 literal units follow
+//   ctrl >= 0x80: one unit follows, repeated (ctrl & 0x7F) + 2 times
+//
+// An icon is RGB565A8 like the LVGL images in gui/icons: the RGB565 plane
+// coded with 2-byte units followed by the alpha plane with 1-byte units.
+// Flat app icons shrink to a fraction of the raw 3 bytes per pixel.
+// Plain C, tested on the host.
+
+#define APP_ICON_MAX_DIM   96
+#define APP_ICON_RLE_MAX   8192   // largest encoded icon accepted
+
+// Worst case encoded size of count units
+static inline size_t app_rle_bound(size_t count, unsigned unit)
+{
+    return count * unit + (count + 127) / 128 + 1;
+}
+
+// Returns the encoded size, 0 if dst is too small
+size_t app_rle_encode(const void* src, size_t count, unsigned unit, uint8_t* dst, size_t cap);
+
+// Decode exactly count units. Returns the bytes of src consumed, 0 on
+// malformed or short input.
+size_t app_rle_decode(const uint8_t* src, size_t len, void* dst, size_t count, unsigned unit);
+
+// RGB565A8 image (w*h*2 color bytes, then w*h alpha bytes) <-> icon stream
+size_t app_icon_encode(const uint8_t* img, uint16_t w, uint16_t h, uint8_t* dst, size_t cap);
+bool app_icon_decode(const uint8_t* src, size_t len, uint16_t w, uint16_t h, uint8_t* img);
+
+#ifdef __cplusplus
+}
+#endif
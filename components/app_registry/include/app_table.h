@@ -0,0 +1,74 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// App id -> display name / icon tables, both searched by binary search on
+// the id (ASCII case-insensitive):
+//  - the built-in table, a const array kept sorted in app_table.c (the
+//    unit test fails if an entry is added out of order)
+//  - the custom table, filled at runtime with apps the phone has pushed an
+//    icon for; kept sorted on insert
+// Plain C, no locking (app_registry.c serialises access), tested on the host.
+
+#define APP_ID_MAX      32      // = NOTIF_STORE_APP_MAX: ids arrive truncated like stored ones
+#define APP_NAME_MAX    24
+#define APP_CUSTOM_MAX  64
+
+// Built-in icons; the GUI maps them to its LVGL images
+typedef enum {
+    APP_ICON_GENERIC = 0,
+    APP_ICON_SMS,
+    APP_ICON_CALL,
+    APP_ICON_GMAIL,
+    APP_ICON_YOUTUBE,
+    APP_ICON_WHATSAPP,
+    APP_ICON_MESSENGER,
+    APP_ICON_TELEGRAM,
+    APP_ICON_OUTLOOK,
+    APP_ICON_TEAMS,
+    APP_ICON_INSTAGRAM,
+    APP_ICON_TIKTOK,
+    APP_ICON_X,
+    APP_ICON_BUILTIN_COUNT,
+    APP_ICON_CUSTOM = 0xFF,   // pushed by the phone, stored on SPIFFS
+} app_icon_t;
+
+typedef struct {
+    const char* id;
+    const char* name;
+    uint8_t icon;
+} app_builtin_t;
+
+typedef struct {
+    char id[APP_ID_MAX];
+    char name[APP_NAME_MAX];
+    uint16_t w, h;
+    uint32_t icon_len;        // encoded size on SPIFFS, 0 = name only
+} app_custom_t;
+
+typedef struct {
+    uint16_t n;
+    app_custom_t e[APP_CUSTOM_MAX];
+} app_custom_table_t;
+
+int app_id_cmp(const char* a, const char* b);
+
+const app_builtin_t* app_builtin_find(const char* id);
+const app_builtin_t* app_builtin_table(size_t* n);
+
+// Index of id in the table, -1 if absent
+int app_custom_find(const app_custom_table_t* t, const char* id);
+// Insert keeping the order, or replace an entry with the same id.
+// False when the table is full.
+bool app_custom_put(app_custom_table_t* t, const app_custom_t* e);
+
+// FNV-1a of the lower-cased id (names the icon file)
+uint32_t app_id_hash(const char* id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+#include "unity.h"
+
+#include "app_rle.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIM APP_ICON_MAX_DIM
+#define PX (DIM * DIM)
+
+static uint8_t s_img[PX * 3];
+static uint8_t s_out[PX * 3];
+static uint8_t s_rle[PX * 3 + PX];
+
+// Flat app-icon look: a coloured disc with a white glyph band on a
+// transparent background
+static void draw_icon(uint8_t* img) {
+  uint16_t* color = (uint16_t*)img;
+  uint8_t* alpha = img + PX * 2;
+  for (int y = 0; y < DIM; ++y) {
+    for (int x = 0; x < DIM; ++x) {
+      int dx = x - DIM / 2, dy = y - DIM / 2;
+      bool in = dx * dx + dy * dy < (DIM / 2 - 2) * (DIM / 2 - 2);
+      bool band = in && y > DIM / 3 && y < DIM / 2;
+      color[y * DIM + x] = !in ? 0 : band ? 0xFFFF : 0x25E8;
+      alpha[y * DIM + x] = in ? 0xFF : 0;
+    }
+  }
+}
+
+static void roundtrip(const uint8_t* src, size_t count, unsigned unit) {
+  size_t n = app_rle_encode(src, count, unit, s_rle, sizeof(s_rle));
+  TEST_ASSERT_NOT_EQUAL(0, n);
+  TEST_ASSERT_LESS_OR_EQUAL(app_rle_bound(count, unit), n);
+  memset(s_out, 0xEE, sizeof(s_out));
+  TEST_ASSERT_EQUAL(n, app_rle_decode(s_rle, n, s_out, count, unit));
+  TEST_ASSERT_EQUAL_MEMORY(src, s_out, count * unit);
+}
+
+TEST_CASE("rle roundtrip: flat, noise, alternating, short", "[app_rle]") {
+  memset(s_img, 0x42, sizeof(s_img));
+  roundtrip(s_img, PX, 2);
+  roundtrip(s_img, PX * 3, 1);
+
+  srand(7);
+  for (size_t i = 0; i < sizeof(s_img); ++i) s_img[i] = (uint8_t)rand();
+  roundtrip(s_img, PX, 2);
+  roundtrip(s_img, PX * 3, 1);
+
+  for (size_t i = 0; i < sizeof(s_img); ++i) s_img[i] = (uint8_t)((i / 2) & 1 ? 0xAA : 0x55);
+  roundtrip(s_img, PX, 2);   // pairs: literal/run boundaries
+
+  for (size_t i = 0; i < sizeof(s_img); ++i) s_img[i] = (uint8_t)(i % 3 ? i / 3 : 0xFF);
+  roundtrip(s_img, PX * 3, 1);   // literal, pair, literal, pair...: must stay within the bound
+
+  for (size_t count = 1; count < 300; ++count) {
+    for (size_t i = 0; i < count; ++i) s_img[i] = (uint8_t)(i % 5 < 2 ? 0 : i);
+    roundtrip(s_img, count, 1);
+  }
+}
+
+TEST_CASE("rle rejects short and malformed input", "[app_rle]") {
+  draw_icon(s_img);
+  size_t n = app_icon_encode(s_img, DIM, DIM, s_rle, sizeof(s_rle));
+  TEST_ASSERT_NOT_EQUAL(0, n);
+  TEST_ASSERT_TRUE(app_icon_decode(s_rle, n, DIM, DIM, s_out));
+  TEST_ASSERT_EQUAL_MEMORY(s_img, s_out, sizeof(s_img));
+
+  TEST_ASSERT_FALSE(app_icon_decode(s_rle, n - 1, DIM, DIM, s_out));    // truncated
+  TEST_ASSERT_FALSE(app_icon_decode(s_rle, n, DIM, DIM - 1, s_out));    // trailing bytes
+  TEST_ASSERT_FALSE(app_icon_decode(s_rle, n, DIM, DIM + 1, s_out));    // too short
+
+  const uint8_t overrun[] = { 0xFF, 0x00 };   // run of 129 into 4 units
+  TEST_ASSERT_EQUAL(0, app_rle_decode(overrun, sizeof(overrun), s_out, 4, 1));
+  const uint8_t lit[] = { 0x05, 1, 2 };       // 6 literals promised, 2 given
+  TEST_ASSERT_EQUAL(0, app_rle_decode(lit, sizeof(lit), s_out, 6, 1));
+
+  TEST_ASSERT_EQUAL(0, app_rle_encode(s_img, PX, 2, s_rle, 16));        // dst too small
+}
+
+TEST_CASE("icon compression ratio", "[app_rle][bench]") {
+  draw_icon(s_img);
+  int64_t t0 = esp_timer_get_time();
+  size_t n = app_icon_encode(s_img, DIM, DIM, s_rle, sizeof(s_rle));
+  int64_t t_enc = esp_timer_get_time() - t0;
+  t0 = esp_timer_get_time();
+  TEST_ASSERT_TRUE(app_icon_decode(s_rle, n, DIM, DIM, s_out));
+  int64_t t_dec = esp_timer_get_time() - t0;
+
+  TEST_ASSERT_LESS_OR_EQUAL(APP_ICON_RLE_MAX, n);
+  printf("app_rle: %dx%d RGB565A8 %u B -> %u B (%u%%), encode %u us, decode %u us\n",
+         DIM, DIM, (unsigned)sizeof(s_img), (unsigned)n, (unsigned)(n * 100 / sizeof(s_img)),
+         (unsigned)t_enc, (unsigned)t_dec);
+}
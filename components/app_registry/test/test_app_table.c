@@ -0,0 +1,67 @@
+#include "unity.h"
+
+#include "app_table.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static app_custom_table_t s_table;
+
+static app_custom_t entry(const char* id, const char* name) {
+  app_custom_t e = {0};
+  strncpy(e.id, id, sizeof(e.id) - 1);
+  strncpy(e.name, name, sizeof(e.name) - 1);
+  return e;
+}
+
+TEST_CASE("built-in table is sorted and searchable", "[app_table]") {
+  size_t n;
+  const app_builtin_t* t = app_builtin_table(&n);
+  TEST_ASSERT_TRUE(n > 0);
+  for (size_t i = 1; i < n; ++i) {
+    if (app_id_cmp(t[i - 1].id, t[i].id) >= 0) printf("out of order: %s >= %s\n", t[i - 1].id, t[i].id);
+    TEST_ASSERT_TRUE(app_id_cmp(t[i - 1].id, t[i].id) < 0);
+  }
+  for (size_t i = 0; i < n; ++i) TEST_ASSERT_EQUAL_PTR(&t[i], app_builtin_find(t[i].id));
+
+  const app_builtin_t* w = app_builtin_find("COM.WhatsApp");
+  TEST_ASSERT_NOT_NULL(w);
+  TEST_ASSERT_EQUAL_STRING("WhatsApp", w->name);
+  TEST_ASSERT_EQUAL(APP_ICON_WHATSAPP, w->icon);
+  TEST_ASSERT_NULL(app_builtin_find("com.whatsapp.w4b"));
+  TEST_ASSERT_NULL(app_builtin_find(""));
+  TEST_ASSERT_NULL(app_builtin_find(NULL));
+}
+
+TEST_CASE("custom table insert, replace, full", "[app_table]") {
+  memset(&s_table, 0, sizeof(s_table));
+  app_custom_t e = entry("org.signal", "Signal");
+  TEST_ASSERT_TRUE(app_custom_put(&s_table, &e));
+  e = entry("com.discord", "Discord");
+  TEST_ASSERT_TRUE(app_custom_put(&s_table, &e));
+  e = entry("ORG.SIGNAL", "Signal 2");
+  TEST_ASSERT_TRUE(app_custom_put(&s_table, &e));
+  TEST_ASSERT_EQUAL(2, s_table.n);
+  TEST_ASSERT_EQUAL_STRING("com.discord", s_table.e[0].id);
+  TEST_ASSERT_EQUAL_STRING("Signal 2", s_table.e[app_custom_find(&s_table, "org.signal")].name);
+  TEST_ASSERT_EQUAL(-1, app_custom_find(&s_table, "org.sig"));
+
+  char id[APP_ID_MAX];
+  while (s_table.n < APP_CUSTOM_MAX) {
+    snprintf(id, sizeof(id), "app.%u", (unsigned)(APP_CUSTOM_MAX - s_table.n) * 7919u % 1000u);
+    e = entry(id, "x");
+    TEST_ASSERT_TRUE(app_custom_put(&s_table, &e));
+  }
+  for (size_t i = 1; i < s_table.n; ++i) {
+    TEST_ASSERT_TRUE(app_id_cmp(s_table.e[i - 1].id, s_table.e[i].id) < 0);
+  }
+  e = entry("zz.new", "x");
+  TEST_ASSERT_FALSE(app_custom_put(&s_table, &e));
+  e = entry("com.discord", "Discord");   // replacing still works when full
+  TEST_ASSERT_TRUE(app_custom_put(&s_table, &e));
+}
+
+TEST_CASE("id hash ignores case", "[app_table]") {
+  TEST_ASSERT_EQUAL_UINT32(app_id_hash("com.whatsapp"), app_id_hash("Com.WhatsApp"));
+  TEST_ASSERT_NOT_EQUAL(app_id_hash("com.whatsapp"), app_id_hash("com.whatsap"));
+}
@@ -1,15 +1,55 @@
 #pragma once
+#include <stdint.h>
 #include "esp_err.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// One audio task plays every alert. The calls below only queue a command
+// and return; a full queue drops the alert (counted in the stats). The
+// task writes fixed blocks to I2S, so it is paced by the DMA draining, and
+// keeps the codec open between alerts, closing it after
+// AUDIO_ALERT_IDLE_CLOSE_MS without one.
+
+#ifndef AUDIO_ALERT_QUEUE_LEN
+#define AUDIO_ALERT_QUEUE_LEN       4
+#endif
+#ifndef AUDIO_ALERT_BLOCK_BYTES
+#define AUDIO_ALERT_BLOCK_BYTES     2048    // one I2S write, DMA-capable RAM
+#endif
+#ifndef AUDIO_ALERT_IDLE_CLOSE_MS
+#define AUDIO_ALERT_IDLE_CLOSE_MS   3000
+#endif
+// Silence after each alert. When it has been written the DMA ring holds
+// nothing else, so the alert has been heard and the output can be muted.
+// 0 = the ring of the driver's default channel config, which is what the
+// BSP creates its TX channel with, plus the descriptor being played out.
+// Set it if the BSP's channel stops using the default.
+#ifndef AUDIO_ALERT_DRAIN_FRAMES
+#define AUDIO_ALERT_DRAIN_FRAMES    0
+#endif
+
+// Starts the audio task (codec init happens there). Called by the
+// functions below when needed; call it early to keep it off their path.
 esp_err_t audio_alert_init(void);
 void audio_alert_notify(void);
 // Schedule a one-shot startup tone after boot, with a short delay
 // to allow the codec/PA to settle and avoid first-play clicks.
 void audio_alert_play_startup(void);
 
+typedef struct {
+    uint32_t played;
+    uint32_t dropped;           // queue full, or no codec
+    uint32_t codec_opens;
+    uint32_t start_last_us;     // request -> first alert block taken by I2S
+    uint32_t start_max_us;
+    uint32_t start_sum_us;
+    uint32_t enqueue_max_us;    // longest time a caller spent queuing
+} audio_alert_stats_t;
+
+void audio_alert_get_stats(audio_alert_stats_t* out);
+void audio_alert_dump_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
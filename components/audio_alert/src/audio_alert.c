@@ -3,21 +3,68 @@
 #include <string.h>
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 #include "esp_codec_dev.h"
+#include "driver/i2s_common.h"
 #include "settings.h"
+#include "power_manager.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/task.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 
 static const char* TAG = "AUDIO_ALERT";
 
+#define TONE_SR             22050
+#define TONE_MAX_SAMPLES    8192
+#define STARTUP_DELAY_MS    400     // codec/PA settle after boot
+// Silence before an alert, against the click of the output coming up
+#define PAD_COLD_FRAMES     1024    // codec just opened (~46 ms at 22.05 kHz)
+#define PAD_WARM_FRAMES     256
+
+typedef enum {
+    AUDIO_CMD_NOTIFY = 0,
+    AUDIO_CMD_STARTUP,
+} audio_cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    int64_t t_us;               // when it was requested
+} audio_cmd_t;
+
+// What the next block is read from: a WAV file or PCM in memory
+typedef struct {
+    FILE* f;
+    size_t left;                // bytes
+    const int16_t* pcm;
+} audio_src_t;
+
 static esp_codec_dev_handle_t s_spk = NULL;
 static bool s_ready = false;
 static bool s_open = false;
+static esp_codec_dev_sample_info_t s_open_fs;  // format the codec is open with
 
-esp_err_t audio_alert_init(void)
+// Audio task only, allocated once
+static QueueHandle_t s_queue;
+static int16_t* s_block;        // block being handed to I2S
+static int16_t* s_zero;         // silence block
+static int16_t* s_tone;         // synthesized fallback chime
+static size_t s_tone_n;
+
+static audio_alert_stats_t s_stats;
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void* psram_calloc(size_t n, size_t size)
+{
+    void* p = heap_caps_calloc(n, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : calloc(n, size);
+}
+
+static esp_err_t codec_init(void)
 {
     if (s_ready) return ESP_OK;
     s_spk = bsp_audio_codec_speaker_init();
@@ -33,92 +80,71 @@ esp_err_t audio_alert_init(void)
     return ESP_OK;
 }
 
-static void play_pcm_16_mono_22k(const int16_t* pcm, size_t samples)
+// Synthesize a bell-like "Dong": low base + partials, short pitch glide,
+// multi-stage decay. Once, into PSRAM.
+static void synth_tone(void)
 {
-    if (!s_ready && audio_alert_init() != ESP_OK) return;
-    esp_codec_dev_sample_info_t fs = {
-        .sample_rate = 22050,
-        .channel = 1,
-        .bits_per_sample = 16,
-    };
-    int vol = (int)settings_get_notify_volume();
-    if (vol < 0) vol = 0;
-    if (vol > 100) vol = 100;
-    esp_codec_dev_set_out_vol(s_spk, vol);
-    if (!s_open) {
-        if (esp_codec_dev_open(s_spk, &fs) != ESP_OK) return;
-        s_open = true;
+    const float base_f = 440.0f;     // base pitch, slightly lower for deeper "Dong"
+    const float dur_s  = 0.32f;      // overall duration
+    size_t N = (size_t)(TONE_SR * dur_s);
+    if (N > TONE_MAX_SAMPLES) {
+        N = TONE_MAX_SAMPLES;
     }
-    // Give codec/PA a short settle time before streaming to avoid pops
-    vTaskDelay(pdMS_TO_TICKS(20));
-    // Ensure unmuted for playback
-    (void)esp_codec_dev_set_out_mute(s_spk, false);
+    s_tone = psram_calloc(N, sizeof(int16_t));
+    if (!s_tone) return;
 
-    // Write a short block of silence first to avoid initial click/pop
-    enum { ZERO_PAD_SAMP = 1024 }; // ~46ms at 22.05kHz
-    int16_t zero_pad[ZERO_PAD_SAMP] = {0};
-    (void)esp_codec_dev_write(s_spk, (void*)zero_pad, sizeof(zero_pad));
-
-    // Stream in small chunks to ensure DMA feed
-    const size_t chunk_samp = 256;
-    size_t written = 0;
-    while (written < samples) {
-        size_t n = samples - written;
-        if (n > chunk_samp) n = chunk_samp;
-        (void)esp_codec_dev_write(s_spk, (void*)(pcm + written), n * sizeof(int16_t));
-        written += n;
-    }
+    // Short fade-in to avoid click and give a percussive strike
+    const float attack_s = 0.004f; // ~4ms
+    const size_t attack_n = (size_t)(attack_s * TONE_SR);
 
-    // Add a short tail of silence to ensure clean ramp-down
-    (void)esp_codec_dev_write(s_spk, (void*)zero_pad, sizeof(zero_pad));
+    // Partial amplitudes and decays (sum kept < ~2.0 peak with early envelope)
+    const float a0 = 1.00f, d0 = 5.0f;   // base, slower decay
+    const float a1 = 0.45f, d1 = 8.0f;   // 1.5x, medium decay
+    const float a2 = 0.25f, d2 = 12.0f;  // 2.0x, faster decay
+    const float a3 = 0.20f, d3 = 10.0f;  // 2.0x detuned for gentle beating
 
-    // Wait for audio to drain before closing (approximate duration)
-    uint32_t total_samples = samples + (2 * ZERO_PAD_SAMP);
-    uint32_t ms = (uint32_t)((total_samples * 1000UL) / (fs.sample_rate));
-    vTaskDelay(pdMS_TO_TICKS(ms + 10));
-    // Optionally mute between alerts to avoid residual noise; keep stream open
-    (void)esp_codec_dev_set_out_mute(s_spk, true);
-}
+    for (size_t n = 0; n < N; ++n) {
+        float t = (float)n / (float)TONE_SR;
 
-static bool play_pcm_stream_i16(const int16_t* pcm, size_t samples, int sample_rate, int channels)
-{
-    if (!s_ready && audio_alert_init() != ESP_OK) return false;
-    if (channels != 1 && channels != 2) channels = 1;
-    esp_codec_dev_sample_info_t fs = {
-        .sample_rate = sample_rate,
-        .channel = channels,
-        .bits_per_sample = 16,
-    };
-    int vol = (int)settings_get_notify_volume();
-    if (vol < 0) vol = 0;
-    if (vol > 100) vol = 100;
-    esp_codec_dev_set_out_vol(s_spk, vol);
+        // Slight downward glide: start ~6% sharp, relax to base quickly
+        float glide = 1.0f + 0.06f * expf(-40.0f * t);
+        float f0 = base_f * glide;
+        float f1 = (base_f * 1.50f) * glide;
+        float f2 = (base_f * 2.00f) * glide;
+        float f3 = (base_f * 1.96f) * glide; // slight detune vs 2.0x
 
-    if (s_open) {
-        (void)esp_codec_dev_close(s_spk);
-        s_open = false;
-    }
-    if (esp_codec_dev_open(s_spk, &fs) != ESP_OK) return false;
-    s_open = true;
-    // simple settle and unmute
-    vTaskDelay(pdMS_TO_TICKS(10));
-    (void)esp_codec_dev_set_out_mute(s_spk, false);
+        // Exponential decays per partial
+        float e0 = expf(-d0 * t);
+        float e1 = expf(-d1 * t);
+        float e2 = expf(-d2 * t);
+        float e3 = expf(-d3 * t);
 
-    const size_t chunk_samp = 256 * channels; // interleaved frames
-    size_t written = 0;
-    while (written < samples) {
-        size_t n = samples - written;
-        if (n > chunk_samp) n = chunk_samp;
-        if (esp_codec_dev_write(s_spk, (void*)(pcm + written), n * sizeof(int16_t)) != ESP_OK) break;
-        written += n;
+        // Sum of partials (bell-ish spectrum, simple model)
+        float s = 0.0f;
+        s += a0 * e0 * sinf(2.0f * 3.14159265f * f0 * t);
+        s += a1 * e1 * sinf(2.0f * 3.14159265f * f1 * t);
+        s += a2 * e2 * sinf(2.0f * 3.14159265f * f2 * t);
+        s += a3 * e3 * sinf(2.0f * 3.14159265f * f3 * t);
+
+        // Attack ramp
+        float fade_in = 1.0f;
+        if (n < attack_n) {
+            fade_in = (float)n / (float)(attack_n);
+        }
+        s *= fade_in;
+
+        // Normalize to safe headroom
+        int v = (int)(s * 20000.0f);
+        if (v > 32767) v = 32767; else if (v < -32768) v = -32768;
+        s_tone[n] = (int16_t)v;
     }
-    (void)esp_codec_dev_set_out_mute(s_spk, true);
-    return true;
+    s_tone_n = N;
 }
 
-static bool play_wav_from_spiffs(const char *path)
+// Minimal WAV parser for PCM 16-bit LE mono/stereo. Leaves the file at the
+// start of the samples.
+static bool wav_open(const char *path, audio_src_t* src, esp_codec_dev_sample_info_t* fs)
 {
-    // Minimal WAV parser for PCM 16-bit LE mono/stereo
     struct stat st;
     if (stat(path, &st) != 0 || st.st_size <= 44) return false;
     FILE *f = fopen(path, "rb");
@@ -151,123 +177,246 @@ static bool play_wav_from_spiffs(const char *path)
     }
     if (fseek(f, data_offset, SEEK_SET) != 0) { fclose(f); return false; }
 
-    // Open codec with WAV format
-    esp_codec_dev_sample_info_t fs = {
+    memset(src, 0, sizeof(*src));
+    src->f = f;
+    src->left = data_size;
+    *fs = (esp_codec_dev_sample_info_t){
         .sample_rate = (int)sample_rate,
         .channel = (int)num_channels,
         .bits_per_sample = 16,
     };
+    return true;
+}
+
+// Next block into s_block; 0 at the end
+static size_t src_fill(audio_src_t* src)
+{
+    size_t n = src->left < AUDIO_ALERT_BLOCK_BYTES ? src->left : AUDIO_ALERT_BLOCK_BYTES;
+    if (n == 0) return 0;
+    if (src->f) {
+        // Boost only the SPIFFS read; the codec write blocks on I2S DMA
+        power_manager_boost_begin(PM_BOOST_AUDIO);
+        n = fread(s_block, 1, n, src->f);
+        power_manager_boost_end(PM_BOOST_AUDIO);
+    } else {
+        memcpy(s_block, src->pcm, n);
+        src->pcm += n / sizeof(int16_t);
+    }
+    src->left = n ? src->left - n : 0;
+    return n;
+}
+
+// Each write returns once I2S has room for it: this is what paces playback
+static void write_silence(uint32_t frames, int channels)
+{
+    size_t bytes = (size_t)frames * channels * sizeof(int16_t);
+    while (bytes > 0) {
+        size_t n = bytes < AUDIO_ALERT_BLOCK_BYTES ? bytes : AUDIO_ALERT_BLOCK_BYTES;
+        if (esp_codec_dev_write(s_spk, s_zero, n) != ESP_CODEC_DEV_OK) return;
+        bytes -= n;
+    }
+}
+
+// Frames the TX DMA ring can still be holding after the last write
+static uint32_t drain_frames(void)
+{
+#if AUDIO_ALERT_DRAIN_FRAMES > 0
+    return AUDIO_ALERT_DRAIN_FRAMES;
+#else
+    const i2s_chan_config_t chan = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    return (chan.dma_desc_num + 1) * chan.dma_frame_num;
+#endif
+}
+
+static bool stream_begin(const esp_codec_dev_sample_info_t* fs)
+{
     int vol = (int)settings_get_notify_volume();
     if (vol < 0) vol = 0;
     if (vol > 100) vol = 100;
     esp_codec_dev_set_out_vol(s_spk, vol);
-    if (s_open) {
-        (void)esp_codec_dev_close(s_spk);
-        s_open = false;
+
+    uint32_t pad = PAD_WARM_FRAMES;
+    bool same = s_open && s_open_fs.sample_rate == fs->sample_rate
+                && s_open_fs.channel == fs->channel;
+    if (!same) {
+        // Only a different format reopens the codec
+        if (s_open) {
+            (void)esp_codec_dev_close(s_spk);
+            s_open = false;
+        }
+        esp_codec_dev_sample_info_t open_fs = *fs;
+        if (esp_codec_dev_open(s_spk, &open_fs) != ESP_CODEC_DEV_OK) return false;
+        s_open = true;
+        s_open_fs = *fs;
+        pad = PAD_COLD_FRAMES;
+        portENTER_CRITICAL(&s_stats_mux);
+        s_stats.codec_opens++;
+        portEXIT_CRITICAL(&s_stats_mux);
     }
-    if (esp_codec_dev_open(s_spk, &fs) != ESP_OK) { fclose(f); return false; }
-    s_open = true;
-    vTaskDelay(pdMS_TO_TICKS(10));
     (void)esp_codec_dev_set_out_mute(s_spk, false);
+    // The codec/PA settles while the silence plays out
+    write_silence(pad, fs->channel);
+    return true;
+}
 
-    enum { BUF_SAMP = 1024*2 };
-    int16_t *buf = (int16_t*)malloc(BUF_SAMP * sizeof(int16_t));
-    if (!buf) { fclose(f); return false; }
-    size_t remaining = data_size;
-    while (remaining > 0) {
-        size_t to_read_bytes = BUF_SAMP * sizeof(int16_t);
-        if (to_read_bytes > remaining) to_read_bytes = remaining;
-        size_t rn = fread(buf, 1, to_read_bytes, f);
-        if (rn == 0) break;
-        remaining -= rn;
-        (void)esp_codec_dev_write(s_spk, buf, rn);
+static void play(audio_src_t* src, const esp_codec_dev_sample_info_t* fs, int64_t t_req_us)
+{
+    if (!stream_begin(fs)) {
+        portENTER_CRITICAL(&s_stats_mux);
+        s_stats.dropped++;
+        portEXIT_CRITICAL(&s_stats_mux);
+        return;
     }
-    free(buf);
-    fclose(f);
+
+    bool first = true;
+    size_t n;
+    while ((n = src_fill(src)) > 0) {
+        if (esp_codec_dev_write(s_spk, s_block, n) != ESP_CODEC_DEV_OK) break;
+        if (first) {
+            uint32_t us = (uint32_t)(esp_timer_get_time() - t_req_us);
+            portENTER_CRITICAL(&s_stats_mux);
+            s_stats.start_last_us = us;
+            if (us > s_stats.start_max_us) s_stats.start_max_us = us;
+            s_stats.start_sum_us += us;
+            s_stats.played++;
+            portEXIT_CRITICAL(&s_stats_mux);
+            first = false;
+        }
+    }
+
+    // Once the tail is in the DMA ring the alert itself has played out
+    write_silence(drain_frames(), fs->channel);
+    // Mute between alerts to avoid residual noise; keep stream open
     (void)esp_codec_dev_set_out_mute(s_spk, true);
-    return true;
 }
 
-void audio_alert_notify(void)
+static void play_notify(int64_t t_req_us)
 {
-    if (!settings_get_sound()) return;
+    audio_src_t src;
+    esp_codec_dev_sample_info_t fs;
     // 1) Try to play preloaded file from SPIFFS (prefer notify.wav for now)
-    if (play_wav_from_spiffs("/spiffs/notification.wav")) {
+    if (wav_open("/spiffs/notification.wav", &src, &fs)) {
+        play(&src, &fs, t_req_us);
+        fclose(src.f);
         return;
     }
     ESP_LOGI(TAG, "notification.wav not found, using synthesized tone");
-    // Synthesize a bell-like "Dong": low base + partials, short pitch glide, multi-stage decay
-    enum { SR = 22050 };
-    const float base_f = 440.0f;     // base pitch, slightly lower for deeper "Dong"
-    const float dur_s  = 0.32f;      // overall duration
-    size_t N = (size_t)(SR * dur_s);
-    static int16_t buf[8192];
-    size_t max_samples = sizeof(buf) / sizeof(buf[0]);
-    if (N > max_samples) {
-        N = max_samples;
-    }
+    if (!s_tone) synth_tone();
+    if (!s_tone) return;
 
-    // Short fade-in to avoid click and give a percussive strike
-    const float attack_s = 0.004f; // ~4ms
-    const size_t attack_n = (size_t)(attack_s * SR);
+    memset(&src, 0, sizeof(src));
+    src.pcm = s_tone;
+    src.left = s_tone_n * sizeof(int16_t);
+    fs = (esp_codec_dev_sample_info_t){
+        .sample_rate = TONE_SR,
+        .channel = 1,
+        .bits_per_sample = 16,
+    };
+    play(&src, &fs, t_req_us);
+}
 
-    // Partial amplitudes and decays (sum kept < ~2.0 peak with early envelope)
-    const float a0 = 1.00f, d0 = 5.0f;   // base, slower decay
-    const float a1 = 0.45f, d1 = 8.0f;   // 1.5x, medium decay
-    const float a2 = 0.25f, d2 = 12.0f;  // 2.0x, faster decay
-    const float a3 = 0.20f, d3 = 10.0f;  // 2.0x detuned for gentle beating
+static void audio_task(void* arg)
+{
+    (void)arg;
+    if (codec_init() != ESP_OK) {
+        ESP_LOGE(TAG, "No codec, alerts are dropped");
+    }
 
-    for (size_t n = 0; n < N; ++n) {
-        float t = (float)n / (float)SR;
+    for (;;) {
+        audio_cmd_t cmd;
+        TickType_t wait = s_open ? pdMS_TO_TICKS(AUDIO_ALERT_IDLE_CLOSE_MS) : portMAX_DELAY;
+        if (xQueueReceive(s_queue, &cmd, wait) != pdTRUE) {
+            // Idle: release the codec path until the next alert
+            (void)esp_codec_dev_close(s_spk);
+            s_open = false;
+            continue;
+        }
+        if (!s_ready) {
+            portENTER_CRITICAL(&s_stats_mux);
+            s_stats.dropped++;
+            portEXIT_CRITICAL(&s_stats_mux);
+            continue;
+        }
+        if (cmd.type == AUDIO_CMD_STARTUP) {
+            // Allow system/codec to fully settle; latency counts from then
+            int64_t due = cmd.t_us + STARTUP_DELAY_MS * 1000LL;
+            int64_t left_ms = (due - esp_timer_get_time()) / 1000;
+            if (left_ms > 0) vTaskDelay(pdMS_TO_TICKS(left_ms));
+            cmd.t_us = due;
+        }
+        play_notify(cmd.t_us);
+    }
+}
 
-        // Slight downward glide: start ~6% sharp, relax to base quickly
-        float glide = 1.0f + 0.06f * expf(-40.0f * t);
-        float f0 = base_f * glide;
-        float f1 = (base_f * 1.50f) * glide;
-        float f2 = (base_f * 2.00f) * glide;
-        float f3 = (base_f * 1.96f) * glide; // slight detune vs 2.0x
+esp_err_t audio_alert_init(void)
+{
+    if (s_queue) return ESP_OK;
 
-        // Exponential decays per partial
-        float e0 = expf(-d0 * t);
-        float e1 = expf(-d1 * t);
-        float e2 = expf(-d2 * t);
-        float e3 = expf(-d3 * t);
+    s_block = heap_caps_malloc(AUDIO_ALERT_BLOCK_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    s_zero = heap_caps_calloc(1, AUDIO_ALERT_BLOCK_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    QueueHandle_t q = xQueueCreate(AUDIO_ALERT_QUEUE_LEN, sizeof(audio_cmd_t));
+    if (!s_block || !s_zero || !q) {
+        free(s_block);
+        free(s_zero);
+        if (q) vQueueDelete(q);
+        s_block = s_zero = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    s_queue = q;
+    if (xTaskCreate(audio_task, "audio", 4096, NULL, 3, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "audio task not created");
+        vQueueDelete(s_queue);
+        s_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
 
-        // Sum of partials (bell-ish spectrum, simple model)
-        float s = 0.0f;
-        s += a0 * e0 * sinf(2.0f * 3.14159265f * f0 * t);
-        s += a1 * e1 * sinf(2.0f * 3.14159265f * f1 * t);
-        s += a2 * e2 * sinf(2.0f * 3.14159265f * f2 * t);
-        s += a3 * e3 * sinf(2.0f * 3.14159265f * f3 * t);
+static void enqueue(audio_cmd_type_t type)
+{
+    int64_t t0 = esp_timer_get_time();
+    if (!s_queue && audio_alert_init() != ESP_OK) return;
 
-        // Attack ramp
-        float fade_in = 1.0f;
-        if (n < attack_n) {
-            fade_in = (float)n / (float)(attack_n);
-        }
-        s *= fade_in;
+    audio_cmd_t cmd = { .type = (uint8_t)type, .t_us = t0 };
+    bool ok = xQueueSend(s_queue, &cmd, 0) == pdTRUE;
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
 
-        // Normalize to safe headroom
-        int v = (int)(s * 20000.0f);
-        if (v > 32767) v = 32767; else if (v < -32768) v = -32768;
-        buf[n] = (int16_t)v;
-    }
-    play_pcm_16_mono_22k(buf, N);
+    portENTER_CRITICAL(&s_stats_mux);
+    if (!ok) s_stats.dropped++;
+    if (us > s_stats.enqueue_max_us) s_stats.enqueue_max_us = us;
+    portEXIT_CRITICAL(&s_stats_mux);
 }
 
-// Delayed startup tone to avoid first-play click during boot
-static void audio_startup_tone_task(void *pv)
+void audio_alert_notify(void)
 {
-    (void)pv;
-    // Allow system/codec to fully settle
-    vTaskDelay(pdMS_TO_TICKS(400));
-    audio_alert_notify();
-    vTaskDelete(NULL);
+    if (!settings_get_sound()) return;
+    enqueue(AUDIO_CMD_NOTIFY);
 }
 
 void audio_alert_play_startup(void)
 {
     if (!settings_get_sound()) return;
-    // Create a detached task to play startup tone after a brief delay
-    xTaskCreate(audio_startup_tone_task, "tone_startup", 8192, NULL, 3, NULL);
+    enqueue(AUDIO_CMD_STARTUP);
+}
+
+void audio_alert_get_stats(audio_alert_stats_t* out)
+{
+    if (!out) return;
+    portENTER_CRITICAL(&s_stats_mux);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
+void audio_alert_dump_stats(void)
+{
+    audio_alert_stats_t st;
+    audio_alert_get_stats(&st);
+    ESP_LOGI(TAG, "Alerts: %u played, %u dropped, codec opened %u times",
+             (unsigned)st.played, (unsigned)st.dropped, (unsigned)st.codec_opens);
+    if (st.played) {
+        ESP_LOGI(TAG, "Start latency: last %u us, avg %u us, max %u us",
+                 (unsigned)st.start_last_us, (unsigned)(st.start_sum_us / st.played),
+                 (unsigned)st.start_max_us);
+    }
+    ESP_LOGI(TAG, "Caller enqueue max %u us", (unsigned)st.enqueue_max_us);
 }
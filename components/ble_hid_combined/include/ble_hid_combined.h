@@ -3,6 +3,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "hid_motion.h"
+#include "hid_desc.h"
+#include "hid_macro.h"
+#include "hid_keymap.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,7 +14,12 @@ extern "C" {
 
 /**
  * @brief Inicializa el dispositivo HID combinado (Mouse + Keyboard)
- * @param device_name Nombre del dispositivo BLE
+ *
+ * Añade el servicio HID al host NimBLE compartido (ble_host.h) sin
+ * arrancarlo: los demás servicios se añaden después y luego se llama a
+ * ble_host_start().
+ *
+ * @param device_name Nombre del dispositivo BLE (si el host ya tiene uno, se queda)
  * @param use_pin Si true, requiere PIN 1234 para emparejar
  * @return ESP_OK en caso de éxito
  */
@@ -21,26 +30,157 @@ esp_err_t ble_hid_combined_init(const char *device_name, bool use_pin);
  */
 bool ble_hid_combined_is_connected(void);
 
+/*
+ * Las funciones de envío no bloquean: encolan el report y vuelven. Una
+ * tarea propia lo manda al ritmo de la conexión BLE. Si la cola está
+ * llena el evento se descarta y se cuenta en dropped.
+ */
+
 /**
  * @brief Envía movimiento del mouse
  */
 void ble_hid_mouse_move(int8_t dx, int8_t dy, int8_t wheel);
 
+/**
+ * @brief Suma movimiento del táctil (px de pantalla) al acumulador del
+ *        ratón. Pasa por la curva de aceleración y sale como mucho un report
+ *        por evento de conexión, sin perder restos ni deltas grandes.
+ */
+void ble_hid_mouse_motion(int32_t dx, int32_t dy);
+
+/**
+ * @brief Fin del trazo (dedo levantado): olvida la fracción pendiente
+ */
+void ble_hid_mouse_motion_end(void);
+
+/**
+ * @brief Cambia la curva de aceleración (NULL = por defecto)
+ */
+void ble_hid_mouse_set_curve(const hid_motion_curve_t *curve);
+
+/**
+ * @brief Copia las estadísticas del acumulador (latencia, px descartados)
+ */
+void ble_hid_mouse_get_motion_stats(hid_motion_stats_t *out);
+
+/**
+ * @brief Puntero absoluto (Report ID 3): x, y en 0..HID_ABS_MAX sobre toda
+ *        la pantalla del host (ver hid_abs_scale). Mientras no cambie down
+ *        solo se envía la última posición, una por evento de conexión;
+ *        pulsar y soltar siempre salen.
+ */
+void ble_hid_abs_pointer(uint16_t x, uint16_t y, bool down);
+
+/**
+ * @brief Gesto del reloj: se traduce con la tabla de macros (rueda con
+ *        inercia, tecla multimedia o atajo). Los arrastres mandan MOVE con
+ *        los px de cada muestra y END al soltar; los gestos puntuales, END.
+ */
+void ble_hid_gesture(hid_gesture_t gesture, hid_gesture_phase_t phase, int32_t value);
+
+/**
+ * @brief Cambia la tabla de macros (NULL = por defecto). No se copia: debe
+ *        seguir viva mientras esté en uso.
+ */
+void ble_hid_macro_set_table(const hid_macro_t *table, size_t n);
+
 /**
  * @brief Envía botones del mouse
  */
 void ble_hid_mouse_buttons(bool left, bool right, bool middle);
 
+/* Layout con el que el host interpreta el teclado, hasta que se cambie */
+#ifndef HID_KBD_DEFAULT_LAYOUT
+#define HID_KBD_DEFAULT_LAYOUT HID_KBD_LAYOUT_US
+#endif
+
 /**
- * @brief Envía texto via teclado
+ * @brief Envía texto UTF-8 via teclado (se copia, el llamante puede
+ *        liberarlo). Se escribe con el layout actual; lo que el layout no
+ *        tiene sale sin acento o se salta.
  */
 void ble_hid_keyboard_send_text(const char *text);
 
+/**
+ * @brief Layout del teclado del host (vale para los textos que aún no se
+ *        han empezado a escribir)
+ */
+void ble_hid_keyboard_set_layout(hid_kbd_layout_t layout);
+hid_kbd_layout_t ble_hid_keyboard_get_layout(void);
+
 /**
  * @brief Envía una tecla especial
  */
 void ble_hid_keyboard_send_key(uint8_t keycode);
 
+typedef struct {
+    uint32_t reports;           // reports enviados
+    uint32_t dropped;           // cola llena o sin conexión
+    uint32_t conf_timeouts;     // sin confirmación de la pila a tiempo
+    uint32_t enqueue_max_us;    // lo máximo que ha tardado el llamante en encolar
+    uint32_t abs_coalesced;     // posiciones absolutas sustituidas por otra más nueva
+    uint32_t macros;            // gestos traducidos a teclas o Consumer
+    uint32_t last_text_chars;   // último texto escrito
+    uint32_t last_text_ms;
+} ble_hid_tx_stats_t;
+
+/**
+ * @brief Copia las estadísticas de envío
+ */
+void ble_hid_tx_get_stats(ble_hid_tx_stats_t *out);
+
+/**
+ * @brief Muestra las estadísticas de envío en el log
+ */
+void ble_hid_tx_dump_stats(void);
+
+/*
+ * Trazas de latencia del modo ratón, del táctil al report enviado. Cada
+ * etapa guarda un histograma del que salen p50/p95/p99.
+ */
+typedef enum {
+    HID_TRACE_TOUCH_READ = 0,   // read_cb del indev (lectura del táctil)
+    HID_TRACE_READ_PERIOD,      // entre dos lecturas con el dedo puesto
+    HID_TRACE_TO_CALLBACK,      // fin de la lectura -> callback de la pantalla
+    HID_TRACE_QUEUED,           // callback -> la tarea de envío saca el report
+    HID_TRACE_SEND,             // esp_hidd_dev_input_set
+    HID_TRACE_TOTAL,            // inicio de la lectura -> report enviado
+    HID_TRACE_STAGES,
+} hid_trace_stage_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} hid_trace_summary_t;
+
+/**
+ * @brief Marca una lectura del táctil (desde el read_cb del indev)
+ */
+void ble_hid_trace_touch_read(int64_t start_us, int64_t end_us, bool pressed);
+
+/**
+ * @brief Percentiles de una etapa
+ */
+void ble_hid_trace_get(hid_trace_stage_t stage, hid_trace_summary_t *out);
+
+/**
+ * @brief Vacía los histogramas
+ */
+void ble_hid_trace_reset(void);
+
+/**
+ * @brief Nombre corto de una etapa (para el log y la pantalla)
+ */
+const char *ble_hid_trace_stage_name(hid_trace_stage_t stage);
+
+/**
+ * @brief Muestra los percentiles de todas las etapas en el log
+ */
+void ble_hid_trace_dump(void);
+
 // Códigos de teclas HID
 #define HID_KEY_ENTER       0x28
 #define HID_KEY_BACKSPACE   0x2A
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Report map del HID combinado, montado a partir de una colección por
+ * tipo de report, y el formato de esos reports.
+ *
+ *  - ratón relativo  (Report ID 1): [Botones, X, Y, Rueda], -127..127
+ *  - teclado         (Report ID 2): [Modificador, Reservado, Tecla1..Tecla6]
+ *  - puntero absoluto(Report ID 3): [Botones, X lo, X hi, Y lo, Y hi],
+ *    0..HID_ABS_MAX en cada eje sobre toda la pantalla del host
+ *  - multimedia      (Report ID 4): [Uso lo, Uso hi], un uso Consumer o 0
+ *
+ * El puntero absoluto es lo natural para un táctil: cada report lleva la
+ * posición, así que no se acumula error entre reports y basta con mandar
+ * la última. C puro, probado en el host.
+ */
+
+#define HID_REPORT_ID_MOUSE     0x01
+#define HID_REPORT_ID_KEYBOARD  0x02
+#define HID_REPORT_ID_ABS       0x03
+#define HID_REPORT_ID_CONSUMER  0x04
+
+#define HID_MOUSE_REPORT_LEN    4
+#define HID_ABS_REPORT_LEN      5
+#define HID_CONSUMER_REPORT_LEN 2
+#define HID_ABS_MAX             32767
+
+#define HID_DESC_MOUSE          (1u << 0)
+#define HID_DESC_KEYBOARD       (1u << 1)
+#define HID_DESC_ABS            (1u << 2)
+#define HID_DESC_CONSUMER       (1u << 3)
+#define HID_DESC_ALL            (HID_DESC_MOUSE | HID_DESC_KEYBOARD | HID_DESC_ABS | \
+                                 HID_DESC_CONSUMER)
+
+#define HID_DESC_MAX_LEN        224
+
+/**
+ * @brief Monta el report map con las colecciones pedidas (HID_DESC_*)
+ * @return Bytes escritos, 0 si no caben en cap
+ */
+size_t hid_desc_build(uint32_t collections, uint8_t *out, size_t cap);
+
+/**
+ * @brief Escala una coordenada del área táctil (origin..origin+size-1) a
+ *        0..HID_ABS_MAX, redondeando y recortando lo que quede fuera
+ */
+uint16_t hid_abs_scale(int32_t v, int32_t origin, int32_t size);
+
+/**
+ * @brief Report del puntero absoluto
+ */
+void hid_abs_report(uint8_t out[HID_ABS_REPORT_LEN], uint8_t buttons, uint16_t x, uint16_t y);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hid_keymap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Secuencia de reports de teclado para escribir un texto UTF-8.
+ *
+ * Cada carácter se traduce a (modificador, tecla) con el layout del host
+ * (hid_keymap.h); los que llevan tecla muerta son dos pulsaciones. Entre
+ * dos teclas distintas no hace falta soltar: el report siguiente ya lleva
+ * la tecla nueva en lugar de la anterior y el host lo ve como soltar una y
+ * pulsar otra. Solo se inserta un report vacío cuando se repite la misma
+ * tecla ("ll", si no el host vería una sola pulsación) o cambia el
+ * modificador, y uno al final. "hello" son 7 reports en vez de 10.
+ *
+ * La secuencia se genera de uno en uno en una sola pasada por el texto,
+ * sin reservar memoria. C puro, sin FreeRTOS, probado en el host.
+ */
+
+#define HID_KBD_REPORT_LEN  8       // [Modificador, Reservado, Tecla1..Tecla6]
+
+typedef struct {
+    const char *next;           // resto del texto
+    hid_kbd_layout_t layout;
+    hid_kbd_stroke_t held;      // tecla pulsada en el último report
+    hid_kbd_stroke_t pending[2];    // pulsaciones del carácter en curso
+    uint8_t npending;
+    size_t typed;               // caracteres escritos hasta ahora
+} hid_kbd_seq_t;
+
+/**
+ * @brief Prepara la secuencia de reports de text (no se copia)
+ */
+void hid_kbd_seq_init(hid_kbd_seq_t *seq, const char *text, hid_kbd_layout_t layout);
+
+/**
+ * @brief Siguiente report de la secuencia. Los caracteres sin tecla ni
+ *        sustituto en el layout se saltan.
+ * @param report Salida, HID_KBD_REPORT_LEN bytes
+ * @return false cuando ya no quedan reports
+ */
+bool hid_kbd_seq_next(hid_kbd_seq_t *seq, uint8_t report[HID_KBD_REPORT_LEN]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Layouts de teclado: qué tecla (y modificador) escribe cada carácter en
+ * el host según el layout que tenga configurado. Las tablas las monta el
+ * compilador a partir de la descripción de cada tecla (hid_keymap.c), van
+ * indexadas por punto de código hasta U+00FF y no se recorren: buscar un
+ * carácter es un acceso directo.
+ *
+ * Las vocales acentuadas del layout ES se escriben con tecla muerta (el
+ * acento y después la letra). Lo que el layout no tiene se sustituye por
+ * su letra sin acento o el signo ASCII equivalente (comillas tipográficas,
+ * guiones), y si no hay nada parecido se salta.
+ *
+ * C puro, probado en el host.
+ */
+
+#define HID_KBD_MOD_LSHIFT  0x02
+#define HID_KBD_MOD_RALT    0x40    // AltGr
+
+typedef enum {
+    HID_KBD_LAYOUT_US = 0,
+    HID_KBD_LAYOUT_ES,              // España (ISO)
+    HID_KBD_LAYOUT_COUNT,
+} hid_kbd_layout_t;
+
+typedef struct {
+    uint8_t mod;
+    uint8_t key;        // 0 = ninguna
+} hid_kbd_stroke_t;
+
+/* Pulsaciones de un carácter: la tecla muerta (si hace falta) y la tecla */
+typedef struct {
+    hid_kbd_stroke_t dead;
+    hid_kbd_stroke_t key;
+} hid_kbd_chord_t;
+
+/**
+ * @brief Pulsaciones que escriben cp en el layout, sin sustituciones
+ * @return false si el layout no tiene ese carácter
+ */
+bool hid_keymap_lookup(hid_kbd_layout_t layout, uint32_t cp, hid_kbd_chord_t *out);
+
+/**
+ * @brief Como hid_keymap_lookup, pero si el carácter no está prueba con su
+ *        sustituto ASCII ("é" -> "e", "“" -> '"')
+ */
+bool hid_keymap_encode(hid_kbd_layout_t layout, uint32_t cp, hid_kbd_chord_t *out);
+
+/**
+ * @brief Nombre corto del layout ("US", "ES")
+ */
+const char *hid_keymap_name(hid_kbd_layout_t layout);
+
+/**
+ * @brief Decodifica el siguiente carácter UTF-8 y avanza *p. Una secuencia
+ *        mal formada da U+FFFD y avanza un byte.
+ * @return Punto de código, 0 al final del texto
+ */
+uint32_t hid_utf8_next(const char **p);
+
+#ifdef __cplusplus
+}
+#endif
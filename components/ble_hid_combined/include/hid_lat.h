@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Histograma de latencias para sacar percentiles sin guardar muestras.
+ *
+ * Cubetas log-lineales: exactas por debajo de 16 us y 8 por cada potencia
+ * de dos por encima (error < 12.5 %), hasta ~1 s; lo que pase va a la
+ * última. Un percentil devuelve el límite superior de su cubeta, nunca más
+ * que el máximo visto. C puro, sin bloqueos, probado en el host.
+ */
+
+#define HID_LAT_SUB         8
+#define HID_LAT_EXACT       16
+#define HID_LAT_BUCKETS     (HID_LAT_EXACT + (20 - 4) * HID_LAT_SUB)
+
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t bucket[HID_LAT_BUCKETS];
+} hid_lat_hist_t;
+
+void hid_lat_add(hid_lat_hist_t *h, uint32_t us);
+
+/**
+ * @brief Percentil pct (0..100) en us, 0 si no hay muestras
+ */
+uint32_t hid_lat_percentile(const hid_lat_hist_t *h, unsigned pct);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Macros HID: una tabla dice qué secuencia de reports produce cada gesto
+ * del reloj. Las acciones son rueda con inercia (ver hid_scroll.h), teclas
+ * multimedia (colección Consumer, Report ID 4) y atajos de teclado. Aquí
+ * solo se expanden a reports; el envío lo hace la tarea HID.
+ *
+ * C puro, probado en el host.
+ */
+
+typedef enum {
+    HID_GESTURE_SCROLL_DRAG = 0,        // dos dedos, o la franja del borde derecho
+                                        // con un táctil de un punto; value: px en vertical
+    HID_GESTURE_EDGE_SWIPE_LEFT,        // desde el borde derecho hacia dentro
+    HID_GESTURE_EDGE_SWIPE_RIGHT,       // desde el borde izquierdo hacia dentro
+    HID_GESTURE_WRIST_FLICK_LEFT,       // IMU
+    HID_GESTURE_WRIST_FLICK_RIGHT,
+    HID_GESTURE_COUNT,
+} hid_gesture_t;
+
+typedef enum {
+    HID_PHASE_MOVE = 0,                 // arrastres: cada muestra
+    HID_PHASE_END,                      // fin del arrastre, o gesto puntual
+} hid_gesture_phase_t;
+
+typedef enum {
+    HID_ACTION_NONE = 0,
+    HID_ACTION_SCROLL,                  // code: px por paso de rueda
+    HID_ACTION_CONSUMER,                // code: uso de la página Consumer
+    HID_ACTION_KEY,                     // mod + code: atajo de teclado
+} hid_action_t;
+
+typedef struct {
+    uint8_t gesture;                    // hid_gesture_t
+    uint8_t action;                     // hid_action_t
+    uint8_t mod;                        // HID_ACTION_KEY
+    uint16_t code;
+} hid_macro_t;
+
+/* Usos Consumer (HID Usage Tables, página 0x0C) */
+#define HID_CONSUMER_NEXT_TRACK     0x00B5
+#define HID_CONSUMER_PREV_TRACK     0x00B6
+#define HID_CONSUMER_PLAY_PAUSE     0x00CD
+#define HID_CONSUMER_VOLUME_UP      0x00E9
+#define HID_CONSUMER_VOLUME_DOWN    0x00EA
+
+#define HID_MOD_LALT                0x04
+#define HID_KEY_RIGHT_ARROW         0x4F
+#define HID_KEY_LEFT_ARROW          0x50
+
+#define HID_MACRO_MAX_REPORTS       2
+
+typedef struct {
+    uint8_t report_id;
+    uint8_t len;
+    uint8_t data[8];
+} hid_macro_report_t;
+
+/**
+ * @brief Tabla por defecto (rueda, pista siguiente/anterior, atrás/adelante)
+ */
+const hid_macro_t *hid_macro_default_table(size_t *n);
+
+/**
+ * @brief Primera entrada de la tabla para el gesto, NULL si no hay
+ */
+const hid_macro_t *hid_macro_find(const hid_macro_t *table, size_t n, hid_gesture_t gesture);
+
+/**
+ * @brief Reports de una acción puntual (tecla o Consumer): pulsar y soltar.
+ *        La rueda no se expande aquí, va por hid_scroll.
+ * @return Reports escritos en out (como mucho HID_MACRO_MAX_REPORTS)
+ */
+size_t hid_macro_expand(const hid_macro_t *m, hid_macro_report_t out[HID_MACRO_MAX_REPORTS]);
+
+#ifdef __cplusplus
+}
+#endif
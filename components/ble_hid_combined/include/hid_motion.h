@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Acumulador de movimiento del ratón.
+ *
+ * Los deltas del táctil se suman en coma fija (HID_MOTION_FRAC_BITS bits de
+ * fracción) después de aplicar la curva de aceleración, así no se pierden
+ * los restos de las divisiones. Quien envía saca un report cuando puede
+ * (uno por evento de conexión): lleva todo lo acumulado hasta ±127 y el
+ * resto se queda para el siguiente, de modo que un movimiento grande se
+ * reparte en varios reports sin perder nada.
+ *
+ * C puro, sin bloqueos (el llamante serializa), probado en el host.
+ */
+
+#define HID_MOTION_FRAC_BITS    8
+#define HID_MOTION_ONE          (1 << HID_MOTION_FRAC_BITS)
+#define HID_MOTION_MAX_PENDING  4096    // px por eje; lo que pase de aquí se descarta
+
+/* Ganancia según la velocidad del dedo: base_gain por debajo de
+ * accel_start, max_gain desde accel_full y lineal entre medias. */
+typedef struct {
+    uint16_t base_gain;         // Q8: 128 = 0.5 px de ratón por px de pantalla
+    uint16_t max_gain;          // Q8
+    uint16_t accel_start;       // px/s
+    uint16_t accel_full;        // px/s
+} hid_motion_curve_t;
+
+typedef struct {
+    uint32_t samples;           // deltas recibidos
+    uint32_t reports;           // reports sacados
+    uint32_t splits;            // reports extra por pasar de ±127
+    uint32_t dropped_px;        // px descartados por saturación
+    uint32_t latency_max_us;    // del primer delta pendiente a su report
+    uint64_t latency_sum_us;
+} hid_motion_stats_t;
+
+typedef struct {
+    hid_motion_curve_t curve;
+    int32_t acc_x, acc_y;       // Q8 pendiente
+    int64_t first_us;           // primer delta aún sin enviar, 0 = nada
+    int64_t last_us;            // muestra anterior, 0 = trazo nuevo
+    hid_motion_stats_t stats;
+} hid_motion_t;
+
+/**
+ * @brief Curva por defecto: 0.5x lento (como antes), hasta 1.5x rápido
+ */
+hid_motion_curve_t hid_motion_default_curve(void);
+
+/**
+ * @brief Inicializa el acumulador (curve NULL = curva por defecto)
+ */
+void hid_motion_init(hid_motion_t *m, const hid_motion_curve_t *curve);
+
+/**
+ * @brief Ganancia Q8 de la curva para una velocidad en px/s
+ */
+uint32_t hid_motion_gain(const hid_motion_curve_t *curve, uint32_t speed);
+
+/**
+ * @brief Suma un delta del táctil (px de pantalla) tomado en now_us
+ */
+void hid_motion_add(hid_motion_t *m, int32_t dx, int32_t dy, int64_t now_us);
+
+/**
+ * @brief Hay al menos un px entero por enviar
+ */
+bool hid_motion_pending(const hid_motion_t *m);
+
+/**
+ * @brief Saca el siguiente report (como mucho ±127 por eje)
+ * @return false si no hay nada que enviar
+ */
+bool hid_motion_take(hid_motion_t *m, int8_t *dx, int8_t *dy, int64_t now_us);
+
+/**
+ * @brief Fin del trazo: olvida la fracción pendiente y la velocidad.
+ *        Los px enteros pendientes se siguen enviando.
+ */
+void hid_motion_end(hid_motion_t *m);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Rueda del ratón con inercia.
+ *
+ * Mientras el dedo arrastra, los px se pasan a pasos de rueda (px_per_detent
+ * px por paso, restos en coma fija) y se estima la velocidad. Al soltar, la
+ * rueda sigue a esa velocidad y frena de forma exponencial (constante
+ * tau_ms) hasta pararse; un toque nuevo la para en seco. Quien envía llama
+ * a hid_scroll_step() cada HID_SCROLL_TICK_MS mientras esté activa.
+ *
+ * C puro, sin bloqueos (el llamante serializa), probado en el host.
+ */
+
+#define HID_SCROLL_FRAC_BITS    8
+#define HID_SCROLL_TICK_MS      16
+#define HID_SCROLL_FLING_MIN    (2 << HID_SCROLL_FRAC_BITS)   // pasos/s para tener inercia
+#define HID_SCROLL_STALE_MS     100    // sin mover tanto tiempo antes de soltar: sin inercia
+
+typedef struct {
+    uint16_t px_per_detent;
+    uint16_t tau_ms;
+    int32_t acc;                // Q8 px pendientes
+    int32_t vel;                // Q8 px/s (estimada al arrastrar, inercia al soltar)
+    int64_t last_us;            // última muestra o paso
+    bool dragging;
+    bool fling;
+} hid_scroll_t;
+
+void hid_scroll_init(hid_scroll_t *s, uint16_t px_per_detent, uint16_t tau_ms);
+
+/**
+ * @brief Arrastre de dpx px (positivo = rueda hacia arriba)
+ */
+void hid_scroll_drag(hid_scroll_t *s, int32_t dpx, int64_t now_us);
+
+/**
+ * @brief Fin del arrastre: arranca la inercia si el dedo se movía rápido
+ */
+void hid_scroll_release(hid_scroll_t *s, int64_t now_us);
+
+/**
+ * @brief Para la inercia y olvida lo pendiente
+ */
+void hid_scroll_stop(hid_scroll_t *s);
+
+/**
+ * @brief Queda algo por enviar o la inercia sigue
+ */
+bool hid_scroll_active(const hid_scroll_t *s);
+
+/**
+ * @brief Avanza la inercia hasta now_us y saca los pasos enteros (±127)
+ * @return false si no hay pasos que enviar ahora
+ */
+bool hid_scroll_step(hid_scroll_t *s, int64_t now_us, int8_t *wheel);
+
+#ifdef __cplusplus
+}
+#endif
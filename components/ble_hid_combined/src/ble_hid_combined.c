@@ -1,17 +1,25 @@
 #include "ble_hid_combined.h"
 #include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 
-#include "esp_bt.h"
-#include "esp_bt_main.h"
-#include "esp_bt_device.h"
-#include "esp_gap_ble_api.h"
+#include "ble_host.h"
+#include "host/ble_hs.h"
 #include "esp_hidd.h"
 #include "esp_hid_common.h"
+#include "hid_kbd.h"
+#include "hid_motion.h"
+#include "hid_lat.h"
+#include "hid_desc.h"
+#include "hid_scroll.h"
+#include "hid_macro.h"
 
 static const char *TAG = "BLE_HID_MOUSE";
 
@@ -23,49 +31,110 @@ static bool s_use_pin = false;
 static char s_device_name[32] = {0};
 static esp_hidd_dev_t *s_hid_dev = NULL;
 static uint16_t s_hid_conn_id = 0;  // ID de conexión HID
-static esp_bd_addr_t s_peer_bd_addr = {0};  // Dirección del dispositivo conectado
-
-/* HID Report Descriptor MOUSE con Report ID (máxima compatibilidad) */
-static const uint8_t s_combined_report_map[] = {
-    // Mouse - CON Report ID 0x01 para compatibilidad universal
-    0x05, 0x01,       // Usage Page (Generic Desktop)
-    0x09, 0x02,       // Usage (Mouse)
-    0xA1, 0x01,       // Collection (Application)
-    0x85, 0x01,       //   Report ID (1) - IMPORTANTE para compatibilidad
-    0x09, 0x01,       //   Usage (Pointer)
-    0xA1, 0x00,       //   Collection (Physical)
-    0x05, 0x09,       //     Usage Page (Buttons)
-    0x19, 0x01,       //     Usage Minimum (1)
-    0x29, 0x03,       //     Usage Maximum (3)
-    0x15, 0x00,       //     Logical Minimum (0)
-    0x25, 0x01,       //     Logical Maximum (1)
-    0x95, 0x03,       //     Report Count (3)
-    0x75, 0x01,       //     Report Size (1)
-    0x81, 0x02,       //     Input (Data,Var,Abs)
-    0x95, 0x01,       //     Report Count (1)
-    0x75, 0x05,       //     Report Size (5)
-    0x81, 0x01,       //     Input (Const)
-    0x05, 0x01,       //     Usage Page (Generic Desktop)
-    0x09, 0x30,       //     Usage (X)
-    0x09, 0x31,       //     Usage (Y)
-    0x09, 0x38,       //     Usage (Wheel)
-    0x15, 0x81,       //     Logical Minimum (-127)
-    0x25, 0x7F,       //     Logical Maximum (127)
-    0x75, 0x08,       //     Report Size (8)
-    0x95, 0x03,       //     Report Count (3)
-    0x81, 0x06,       //     Input (Data,Var,Rel)
-    0xC0,             //   End Collection
-    0xC0              // End Collection
+
+/*
+ * Cola de envío HID. Las funciones públicas solo encolan (sin esperar) y
+ * la tarea hid_tx manda los reports de uno en uno: tras cada uno espera
+ * el BLE_GAP_EVENT_NOTIFY_TX de ese report, con HID_TX_CONF_TIMEOUT_MS de
+ * margen por si no llega. El evento solo dice que la pila ha entregado la
+ * notificación al controlador, no que haya salido por el aire: cuándo sale
+ * lo decide el siguiente evento de conexión. Así no hay nunca más de un
+ * report a medio entregar y la tarea de LVGL nunca se bloquea escribiendo
+ * texto.
+ */
+#define HID_TX_QUEUE_LEN        32
+#define HID_TX_CONF_TIMEOUT_MS  50
+
+typedef enum {
+    HID_TX_REPORT = 0,          // report ya formado
+    HID_TX_TEXT,                // texto a teclear, copia en heap (la libera la tarea)
+    HID_TX_MOTION,              // sacar un report del acumulador de movimiento
+    HID_TX_ABS,                 // enviar la última posición absoluta
+    HID_TX_GESTURE,             // gesto del reloj, se traduce con la tabla de macros
+} hid_tx_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t report_id;
+    uint8_t len;
+    uint8_t seq;                // HID_TX_ABS: solo vale si sigue siendo s_abs_seq
+    uint8_t data[HID_KBD_REPORT_LEN];   // HID_TX_GESTURE: gesto y fase
+    int32_t value;              // HID_TX_GESTURE
+    char *text;
+} hid_tx_item_t;
+
+/* Layout del teclado del host: lo lee la tarea hid_tx al empezar cada texto */
+static volatile hid_kbd_layout_t s_kbd_layout = HID_KBD_DEFAULT_LAYOUT;
+
+static QueueHandle_t s_tx_queue = NULL;
+static TaskHandle_t s_tx_task = NULL;
+static ble_hid_tx_stats_t s_tx_stats = {0};
+
+/* Movimiento pendiente del ratón. Solo hay un HID_TX_MOTION en la cola a
+ * la vez: cada uno saca un report y, si queda más, se vuelve a encolar
+ * detrás de lo que haya, así sale un report por evento de conexión. */
+static hid_motion_t s_motion;
+static bool s_motion_queued = false;
+static portMUX_TYPE s_motion_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* Posición absoluta pendiente: solo cuenta la última, así que se
+ * sobrescribe y un único HID_TX_ABS en la cola la envía. Pulsar o soltar
+ * va como report normal (no se puede perder) y cambia s_abs_seq, con lo
+ * que un HID_TX_ABS anterior ya no envía nada. */
+static struct {
+    bool valid;
+    bool queued;
+    uint8_t seq;
+    uint8_t buttons;
+    uint16_t x, y;
+} s_abs;
+
+/* Trazas de latencia del modo ratón: la lectura del táctil (la marca el
+ * read_cb del indev), la llegada al callback de la pantalla, la salida de
+ * la cola y el envío. El report lleva la traza de la muestra que lo puso
+ * en marcha; los trozos de un delta partido no se trazan. */
+typedef struct {
+    bool valid;
+    int64_t read_start_us;
+    int64_t read_end_us;
+    int64_t callback_us;
+} hid_trace_sample_t;
+
+/* Macros de gestos. La tabla la lee la tarea hid_tx; la rueda con inercia
+ * solo la toca ella, así que no necesita bloqueo. */
+#define HID_SCROLL_TAU_MS       325
+
+static const hid_macro_t *s_macro_table = NULL;
+static size_t s_macro_n = 0;
+static portMUX_TYPE s_macro_mux = portMUX_INITIALIZER_UNLOCKED;
+static hid_scroll_t s_scroll;
+
+static hid_lat_hist_t *s_trace_hist = NULL;    // HID_TRACE_STAGES, en PSRAM
+static hid_trace_sample_t s_trace_pending;     // protegido por s_motion_mux
+static int64_t s_last_read_start_us = 0;
+static int64_t s_last_read_end_us = 0;
+static bool s_last_read_pressed = false;
+static portMUX_TYPE s_trace_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const s_trace_names[HID_TRACE_STAGES] = {
+    "touch read", "read period", "to callback", "queued", "send", "total",
 };
 
+static void hid_tx_task(void *arg);
+
+/* HID Report Descriptor: ratón relativo, teclado, puntero absoluto y
+ * teclas multimedia, cada uno con su Report ID (ver hid_desc.h). Se monta
+ * en init. */
+static uint8_t s_combined_report_map[HID_DESC_MAX_LEN];
+
 static esp_hid_raw_report_map_t s_report_maps[] = {
     {
         .data = s_combined_report_map,
-        .len = sizeof(s_combined_report_map),
+        .len = 0,
     }
 };
 
-static const esp_hid_device_config_t s_hid_config = {
+static esp_hid_device_config_t s_hid_config = {
     .vendor_id = 0x16C0,
     .product_id = 0x05DF,
     .version = 0x0100,
@@ -76,37 +145,9 @@ static const esp_hid_device_config_t s_hid_config = {
     .report_maps_len = 1,
 };
 
-/* UUID del servicio HID - CRÍTICO para que el host detecte el HID */
-static uint8_t s_hid_service_uuid[16] = {
-    /* LSB <------------------------------------> MSB */
-    0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
-    0x00, 0x10, 0x00, 0x00, 0x12, 0x18, 0x00, 0x00,
-};
-
-static esp_ble_adv_data_t s_adv_data = {
-    .set_scan_rsp = false,
-    .include_name = true,
-    .include_txpower = true,
-    .min_interval = 0x20,
-    .max_interval = 0x40,
-    .appearance = 0x03C2,  // Mouse appearance
-    .manufacturer_len = 0,
-    .p_manufacturer_data = NULL,
-    .service_data_len = 0,
-    .p_service_data = NULL,
-    .service_uuid_len = sizeof(s_hid_service_uuid),
-    .p_service_uuid = s_hid_service_uuid,
-    .flag = (ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT),
-};
-
-static esp_ble_adv_params_t s_adv_params = {
-    .adv_int_min = 0x20,
-    .adv_int_max = 0x40,
-    .adv_type = ADV_TYPE_IND,
-    .own_addr_type = BLE_ADDR_TYPE_PUBLIC,
-    .channel_map = ADV_CHNL_ALL,
-    .adv_filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY,
-};
+/* Servicio HID (0x1812) y apariencia de ratón en el advertising */
+#define HID_SERVICE_UUID16      0x1812
+#define HID_APPEARANCE_MOUSE    0x03C2
 
 /* Callbacks HID */
 static void hid_event_handler(void *handler_arg, esp_event_base_t base,
@@ -130,8 +171,7 @@ static void hid_event_handler(void *handler_arg, esp_event_base_t base,
 
     switch (ev) {
     case ESP_HIDD_START_EVENT:
-        ESP_LOGI(TAG, ">>> HID START - iniciando advertising");
-        esp_ble_gap_config_adv_data(&s_adv_data);
+        ESP_LOGI(TAG, ">>> HID START");
         break;
 
     case ESP_HIDD_CONNECT_EVENT:
@@ -158,10 +198,6 @@ static void hid_event_handler(void *handler_arg, esp_event_base_t base,
         s_connected = false;
         s_sec_conn = false;
         s_hid_conn_id = 0;
-        memset(s_peer_bd_addr, 0, sizeof(esp_bd_addr_t));
-
-        ESP_LOGI(TAG, ">>> Reiniciando advertising...");
-        esp_ble_gap_start_advertising(&s_adv_params);
         break;
 
     case ESP_HIDD_OUTPUT_EVENT:
@@ -183,146 +219,52 @@ static void hid_event_handler(void *handler_arg, esp_event_base_t base,
 }
 
 
-/* Callback GAP - Aceptar emparejamiento automaticamente */
-static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
-{
-    ESP_LOGI(TAG, "!!! GAP EVENT: %d !!!", (int)event);
-
-    switch (event) {
-    case ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT:
-        ESP_LOGI(TAG, ">>> ADV configurado, iniciando advertising");
-        esp_ble_gap_start_advertising(&s_adv_params);
-        break;
-
-    case ESP_GAP_BLE_ADV_START_COMPLETE_EVT:
-        if (param->adv_start_cmpl.status == ESP_BT_STATUS_SUCCESS) {
-            ESP_LOGI(TAG, ">>> Advertising BLE OK - Dispositivo: %s", s_device_name);
-            ESP_LOGI(TAG, "*** EMPAREJAMIENTO SIN PIN (Just Works) ***");
-        }
-        break;
-
-    case ESP_GAP_BLE_ADV_STOP_COMPLETE_EVT:
-        ESP_LOGI(TAG, ">>> Advertising DETENIDO");
-        break;
-
-    case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
-        ESP_LOGI(TAG, ">>> Parametros de conexion actualizados");
-        ESP_LOGI(TAG, "    Status: %d, Min interval: %d, Max interval: %d, Latency: %d, Timeout: %d",
-                 param->update_conn_params.status,
-                 param->update_conn_params.min_int,
-                 param->update_conn_params.max_int,
-                 param->update_conn_params.latency,
-                 param->update_conn_params.timeout);
-
-        // WORKAROUND para bug conocido de ESP-IDF (Issue #11806):
-        // ESP_HIDD_CONNECT_EVENT no se dispara en el primer emparejamiento,
-        // solo en reconexiones posteriores.
-        //
-        // Cuando los parametros de conexion se actualizan DESPUES del emparejamiento,
-        // es muy probable que HID ya este listo pero el evento no se haya disparado.
-        if (s_hid_dev && s_sec_conn && !s_connected && param->update_conn_params.status == ESP_BT_STATUS_SUCCESS) {
-            ESP_LOGW(TAG, "    ========================================");
-            ESP_LOGW(TAG, "    APLICANDO WORKAROUND PARA BUG ESP-IDF #11806");
-            ESP_LOGW(TAG, "    ========================================");
-            ESP_LOGW(TAG, "    >>> Conexion segura OK + Parametros actualizados OK");
-            ESP_LOGW(TAG, "    >>> ESP_HIDD_CONNECT_EVENT no se ha disparado (bug conocido)");
-
-            // Esperar un momento para que el sistema termine de configurar HID
-            vTaskDelay(pdMS_TO_TICKS(500));
-
-            // Verificar si el SDK dice que esta conectado
-            bool sdk_connected = esp_hidd_dev_connected(s_hid_dev);
-            ESP_LOGW(TAG, "    >>> Verificacion SDK: esp_hidd_dev_connected() = %s",
-                     sdk_connected ? "true" : "false");
-
-            // SOLO aplicar workaround si el SDK confirma la conexion HID
-            // No asumir conexion HID basandose solo en emparejamiento exitoso
-            if (sdk_connected) {
-                // Aplicar workaround: marcar como conectado manualmente
-                s_connected = true;
-                s_hid_conn_id++;
-
-                ESP_LOGW(TAG, "    ========================================");
-                ESP_LOGW(TAG, "    !!! WORKAROUND APLICADO !!!");
-                ESP_LOGW(TAG, "    >>> HID marcado como CONECTADO manualmente");
-                ESP_LOGW(TAG, "    >>> ID de conexion HID: %d", s_hid_conn_id);
-                ESP_LOGW(TAG, "    >>> El dispositivo ahora puede enviar eventos");
-                ESP_LOGW(TAG, "    ========================================");
-            } else {
-                ESP_LOGW(TAG, "    [INFO] SDK todavia no reporta conexion HID");
-                ESP_LOGW(TAG, "    >>> Esperando evento ESP_HIDD_CONNECT_EVENT...");
-            }
-        }
-        break;
-
-    case ESP_GAP_BLE_SEC_REQ_EVT:
-        ESP_LOGI(TAG, "!!! Solicitud de seguridad recibida - ACEPTANDO AUTOMATICAMENTE !!!");
-        esp_ble_gap_security_rsp(param->ble_security.ble_req.bd_addr, true);
-        break;
-
-    case ESP_GAP_BLE_NC_REQ_EVT:
-        ESP_LOGI(TAG, "!!! Confirmacion numerica solicitada - ACEPTANDO AUTOMATICAMENTE !!!");
-        ESP_LOGI(TAG, "    Codigo: %06" PRIu32, param->ble_security.key_notif.passkey);
-        esp_ble_confirm_reply(param->ble_security.ble_req.bd_addr, true);
-        break;
+/* Handles del servicio HID (los registra esp_hidd, así que se buscan en
+ * ble_host la primera vez que hacen falta; 0 = aún sin resolver) */
+static uint16_t s_hid_first_hdl = 0;
+static uint16_t s_hid_last_hdl = 0;
 
-    case ESP_GAP_BLE_PASSKEY_NOTIF_EVT:
-        ESP_LOGI(TAG, "Passkey notificacion: %06" PRIu32, param->ble_security.key_notif.passkey);
-        break;
+static bool is_hid_attr(uint16_t attr_handle)
+{
+    if (!s_hid_first_hdl &&
+        ble_host_svc_handles(BLE_UUID16_DECLARE(HID_SERVICE_UUID16),
+                             &s_hid_first_hdl, &s_hid_last_hdl) != ESP_OK) {
+        return false;
+    }
+    return attr_handle >= s_hid_first_hdl && attr_handle <= s_hid_last_hdl;
+}
 
-    case ESP_GAP_BLE_KEY_EVT:
-        ESP_LOGI(TAG, "Key recibida, type: %d", param->ble_security.ble_key.key_type);
-        break;
+/* Eventos GAP de la conexión compartida (los reparte ble_host, que ya se
+ * ocupa del advertising). Solo las notificaciones de los reports HID
+ * despiertan a la tarea de envío; las del UART van por el mismo enlace
+ * pero no confirman nada de lo que espera. */
+static int hid_gap_event(struct ble_gap_event *event, void *arg)
+{
+    (void)arg;
 
-    case ESP_GAP_BLE_PASSKEY_REQ_EVT:
-        ESP_LOGI(TAG, "Passkey solicitado");
+    switch (event->type) {
+    case BLE_GAP_EVENT_NOTIFY_TX:
+        if (s_tx_task && is_hid_attr(event->notify_tx.attr_handle)) xTaskNotifyGive(s_tx_task);
         break;
 
-    case ESP_GAP_BLE_AUTH_CMPL_EVT:
-        if (param->ble_security.auth_cmpl.success) {
-            ESP_LOGI(TAG, "========================================");
-            ESP_LOGI(TAG, ">>> EMPAREJAMIENTO EXITOSO! <<<");
-            ESP_LOGI(TAG, "    Direccion: %02X:%02X:%02X:%02X:%02X:%02X",
-                     param->ble_security.auth_cmpl.bd_addr[0],
-                     param->ble_security.auth_cmpl.bd_addr[1],
-                     param->ble_security.auth_cmpl.bd_addr[2],
-                     param->ble_security.auth_cmpl.bd_addr[3],
-                     param->ble_security.auth_cmpl.bd_addr[4],
-                     param->ble_security.auth_cmpl.bd_addr[5]);
-
-            // Guardar direccion del peer
-            memcpy(s_peer_bd_addr, param->ble_security.auth_cmpl.bd_addr, sizeof(esp_bd_addr_t));
-
-            // Setear flag de conexion segura cuando autenticacion es exitosa
-            s_sec_conn = true;
-            ESP_LOGI(TAG, "    [OK] CONEXION SEGURA ESTABLECIDA (s_sec_conn=true)");
-            ESP_LOGI(TAG, "    >>> El sistema actualizara parametros de conexion automaticamente...");
-            ESP_LOGI(TAG, "    >>> Esperando evento ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT...");
-
-            // FIX: NO llamar manualmente a esp_ble_gap_update_conn_params() aqui
-            // El sistema BLE ya lo hace automaticamente despues del emparejamiento
-            // Llamarlo manualmente causa el warning "l2cble_start_conn_update, the last connection update command still pending"
-            // y puede interferir con el establecimiento de la conexion HID
-
-            ESP_LOGI(TAG, "========================================");
+    case BLE_GAP_EVENT_ENC_CHANGE:
+        s_sec_conn = event->enc_change.status == 0;
+        if (s_sec_conn) {
+            ESP_LOGI(TAG, ">>> EMPAREJAMIENTO EXITOSO! Conexion cifrada");
         } else {
-            ESP_LOGE(TAG, "!!! EMPAREJAMIENTO FALLIDO !!!");
-            ESP_LOGE(TAG, "    Codigo error: 0x%02X", param->ble_security.auth_cmpl.fail_reason);
-            s_connected = false;
-            s_sec_conn = false;
-            s_hid_conn_id = 0;
-            esp_ble_gap_start_advertising(&s_adv_params);
+            ESP_LOGE(TAG, "!!! EMPAREJAMIENTO FALLIDO !!! Codigo error: %d",
+                     event->enc_change.status);
         }
         break;
 
-    case ESP_GAP_BLE_REMOVE_BOND_DEV_COMPLETE_EVT:
-        ESP_LOGI(TAG, "Bond eliminado, reiniciando advertising");
-        esp_ble_gap_start_advertising(&s_adv_params);
+    case BLE_GAP_EVENT_DISCONNECT:
+        s_sec_conn = false;
         break;
 
     default:
         break;
     }
+    return 0;
 }
 
 esp_err_t ble_hid_combined_init(const char *device_name, bool use_pin)
@@ -334,51 +276,46 @@ esp_err_t ble_hid_combined_init(const char *device_name, bool use_pin)
 
     ESP_LOGI(TAG, "Inicializando BLE HID Mouse...");
 
-    if (!s_ble_started) {
-        ESP_LOGI(TAG, "Configurando controlador BT...");
-
-        // NO llamar a mem_release aquí, ya se hizo en main
-        // esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
+    s_report_maps[0].len = hid_desc_build(HID_DESC_ALL, s_combined_report_map,
+                                          sizeof(s_combined_report_map));
 
-        esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
-        ESP_ERROR_CHECK(esp_bt_controller_init(&bt_cfg));
-        ESP_ERROR_CHECK(esp_bt_controller_enable(ESP_BT_MODE_BLE));
-        ESP_ERROR_CHECK(esp_bluedroid_init());
-        ESP_ERROR_CHECK(esp_bluedroid_enable());
-        ESP_ERROR_CHECK(esp_ble_gap_register_callback(gap_event_handler));
+    // Un solo host NimBLE para el HID y el UART de sincronización: aquí
+    // solo se añade el servicio HID, lo arranca quien llame a ble_host_start()
+    esp_err_t err = ble_host_init(s_device_name);
+    if (err != ESP_OK) return err;
 
-        s_ble_started = true;
+    if (!s_trace_hist) {
+        s_trace_hist = heap_caps_calloc(HID_TRACE_STAGES, sizeof(hid_lat_hist_t),
+                                        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_trace_hist) s_trace_hist = calloc(HID_TRACE_STAGES, sizeof(hid_lat_hist_t));
     }
 
-    ESP_ERROR_CHECK(esp_ble_gap_set_device_name(s_device_name));
-
-    // Configurar seguridad - SIEMPRE SIN PIN para empezar
-    ESP_LOGI(TAG, "Configurando seguridad (SIN PIN)...");
-
-    esp_ble_auth_req_t auth_req = ESP_LE_AUTH_REQ_SC_BOND;
-    esp_ble_io_cap_t iocap = ESP_IO_CAP_NONE;
-    uint8_t key_size = 16;
-    uint8_t init_key = ESP_BLE_ENC_KEY_MASK | ESP_BLE_ID_KEY_MASK;
-    uint8_t resp_key = ESP_BLE_ENC_KEY_MASK | ESP_BLE_ID_KEY_MASK;
-
-    esp_ble_gap_set_security_param(ESP_BLE_SM_AUTHEN_REQ_MODE, &auth_req, sizeof(auth_req));
-    esp_ble_gap_set_security_param(ESP_BLE_SM_IOCAP_MODE, &iocap, sizeof(iocap));
-    esp_ble_gap_set_security_param(ESP_BLE_SM_MAX_KEY_SIZE, &key_size, sizeof(key_size));
-    esp_ble_gap_set_security_param(ESP_BLE_SM_SET_INIT_KEY, &init_key, sizeof(init_key));
-    esp_ble_gap_set_security_param(ESP_BLE_SM_SET_RSP_KEY, &resp_key, sizeof(resp_key));
+    if (!s_tx_queue) {
+        hid_motion_init(&s_motion, NULL);
+        hid_scroll_init(&s_scroll, 1, HID_SCROLL_TAU_MS);
+        if (!s_macro_table) s_macro_table = hid_macro_default_table(&s_macro_n);
+        s_tx_queue = xQueueCreate(HID_TX_QUEUE_LEN, sizeof(hid_tx_item_t));
+        if (!s_tx_queue ||
+            xTaskCreate(hid_tx_task, "hid_tx", 3072, NULL, 6, &s_tx_task) != pdPASS) {
+            ESP_LOGE(TAG, "No se pudo crear la tarea de envio HID");
+            return ESP_ERR_NO_MEM;
+        }
+    }
 
-    ESP_LOGI(TAG, "Inicializando dispositivo HID...");
-    ESP_ERROR_CHECK(esp_hidd_dev_init(&s_hid_config, ESP_HID_TRANSPORT_BLE,
-                                      hid_event_handler, &s_hid_dev));
+    if (!s_ble_started) {
+        ESP_LOGI(TAG, "Inicializando dispositivo HID...");
+        err = esp_hidd_dev_init(&s_hid_config, ESP_HID_TRANSPORT_BLE, hid_event_handler, &s_hid_dev);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "esp_hidd_dev_init: %s", esp_err_to_name(err));
+            return err;
+        }
+        ble_host_add_listener(hid_gap_event, NULL);
+        ble_host_set_appearance(HID_APPEARANCE_MOUSE);
+        ble_host_advertise_uuid(BLE_UUID16_DECLARE(HID_SERVICE_UUID16));
+        s_ble_started = true;
+    }
 
     ESP_LOGI(TAG, "✓ HID Mouse inicializado: %s (SIN PIN)", s_device_name);
-
-    // FORZAR inicio de advertising (el evento START a veces no se dispara)
-    ESP_LOGI(TAG, "Forzando inicio de advertising con UUID servicio HID (0x1812)...");
-    ESP_LOGI(TAG, "    UUID length: %d bytes", s_adv_data.service_uuid_len);
-    vTaskDelay(pdMS_TO_TICKS(100));  // Pequeño delay
-    esp_ble_gap_config_adv_data(&s_adv_data);
-
     return ESP_OK;
 }
 
@@ -410,6 +347,204 @@ bool ble_hid_combined_is_connected(void)
     return sdk_connected;
 }
 
+/* Envío (solo desde la tarea hid_tx) */
+static bool tx_send(uint8_t report_id, const uint8_t *data, size_t len, int64_t *sent_us)
+{
+    static int consecutive_failures = 0;
+
+    if (!s_hid_dev || !ble_hid_combined_is_connected()) {
+        s_tx_stats.dropped++;
+        return false;
+    }
+
+    ulTaskNotifyTake(pdTRUE, 0);    // descartar confirmaciones antiguas
+    esp_err_t ret = esp_hidd_dev_input_set(s_hid_dev, 0, report_id, (uint8_t *)data, len);
+    if (sent_us) *sent_us = esp_timer_get_time();
+    if (ret != ESP_OK) {
+        s_tx_stats.dropped++;
+        consecutive_failures++;
+        if (consecutive_failures <= 5) {
+            ESP_LOGE(TAG, "[FAIL] Error enviando report %d: %s", report_id, esp_err_to_name(ret));
+        }
+        return false;
+    }
+    if (consecutive_failures > 0) {
+        ESP_LOGI(TAG, "[OK] Report HID enviado exitosamente");
+        consecutive_failures = 0;
+    }
+    s_tx_stats.reports++;
+    // Mientras salen reports ble_host mantiene el intervalo corto
+    ble_host_conn_interactive();
+
+    // Un report por evento de conexión: esperar a que salga
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HID_TX_CONF_TIMEOUT_MS)) == 0) {
+        s_tx_stats.conf_timeouts++;
+    }
+    return true;
+}
+
+static void tx_type_text(const char *text)
+{
+    hid_kbd_seq_t seq;
+    uint8_t report[HID_KBD_REPORT_LEN];
+    int64_t t0 = esp_timer_get_time();
+
+    hid_kbd_seq_init(&seq, text, s_kbd_layout);
+    while (hid_kbd_seq_next(&seq, report)) {
+        tx_send(HID_REPORT_ID_KEYBOARD, report, sizeof(report), NULL);
+    }
+
+    uint32_t ms = (uint32_t)((esp_timer_get_time() - t0) / 1000);
+    s_tx_stats.last_text_chars = (uint32_t)seq.typed;
+    s_tx_stats.last_text_ms = ms;
+    ESP_LOGI(TAG, "Texto enviado: %u caracteres en %u ms (%u caracteres/s)",
+             (unsigned)s_tx_stats.last_text_chars, (unsigned)ms,
+             ms ? (unsigned)(s_tx_stats.last_text_chars * 1000 / ms) : 0);
+}
+
+static void trace_add(hid_trace_stage_t stage, int64_t from_us, int64_t to_us)
+{
+    if (!s_trace_hist || to_us < from_us) return;
+    taskENTER_CRITICAL(&s_trace_mux);
+    hid_lat_add(&s_trace_hist[stage], (uint32_t)(to_us - from_us));
+    taskEXIT_CRITICAL(&s_trace_mux);
+}
+
+static void tx_motion(hid_tx_item_t *item)
+{
+    int8_t dx = 0, dy = 0;
+    int64_t start_us = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_motion_mux);
+    bool have = hid_motion_take(&s_motion, &dx, &dy, start_us);
+    bool more = hid_motion_pending(&s_motion);
+    s_motion_queued = more;
+    hid_trace_sample_t trace = s_trace_pending;
+    s_trace_pending.valid = false;
+    taskEXIT_CRITICAL(&s_motion_mux);
+
+    if (have) {
+        // Formato: [Buttons, X, Y, Wheel]
+        uint8_t report[4] = {0x00, (uint8_t)dx, (uint8_t)dy, 0x00};
+        int64_t sent_us = 0;
+        if (tx_send(HID_REPORT_ID_MOUSE, report, sizeof(report), &sent_us) && trace.valid) {
+            trace_add(HID_TRACE_TO_CALLBACK, trace.read_end_us, trace.callback_us);
+            trace_add(HID_TRACE_QUEUED, trace.callback_us, start_us);
+            trace_add(HID_TRACE_SEND, start_us, sent_us);
+            trace_add(HID_TRACE_TOTAL, trace.read_start_us, sent_us);
+        }
+    }
+    if (more && xQueueSend(s_tx_queue, item, 0) != pdTRUE) {
+        taskENTER_CRITICAL(&s_motion_mux);
+        s_motion_queued = false;    // el siguiente delta lo vuelve a encolar
+        taskEXIT_CRITICAL(&s_motion_mux);
+    }
+}
+
+static void tx_abs(const hid_tx_item_t *item)
+{
+    uint8_t report[HID_ABS_REPORT_LEN];
+
+    taskENTER_CRITICAL(&s_motion_mux);
+    bool have = s_abs.valid && item->seq == s_abs.seq;
+    if (have) hid_abs_report(report, s_abs.buttons, s_abs.x, s_abs.y);
+    if (item->seq == s_abs.seq) {
+        s_abs.valid = false;
+        s_abs.queued = false;
+    }
+    taskEXIT_CRITICAL(&s_motion_mux);
+
+    if (have) tx_send(HID_REPORT_ID_ABS, report, sizeof(report), NULL);
+}
+
+/* Pasos de rueda pendientes o de la inercia */
+static void tx_scroll(void)
+{
+    int8_t wheel;
+    if (hid_scroll_step(&s_scroll, esp_timer_get_time(), &wheel)) {
+        uint8_t report[4] = {0x00, 0x00, 0x00, (uint8_t)wheel};
+        tx_send(HID_REPORT_ID_MOUSE, report, sizeof(report), NULL);
+    }
+}
+
+static void tx_gesture(const hid_tx_item_t *item)
+{
+    hid_gesture_t gesture = (hid_gesture_t)item->data[0];
+    hid_gesture_phase_t phase = (hid_gesture_phase_t)item->data[1];
+
+    taskENTER_CRITICAL(&s_macro_mux);
+    const hid_macro_t *found = hid_macro_find(s_macro_table, s_macro_n, gesture);
+    hid_macro_t m = found ? *found : (hid_macro_t){ .action = HID_ACTION_NONE };
+    taskEXIT_CRITICAL(&s_macro_mux);
+
+    if (m.action == HID_ACTION_SCROLL) {
+        s_scroll.px_per_detent = m.code ? m.code : 1;
+        if (phase == HID_PHASE_MOVE) {
+            hid_scroll_drag(&s_scroll, item->value, esp_timer_get_time());
+        } else {
+            hid_scroll_release(&s_scroll, esp_timer_get_time());
+        }
+        tx_scroll();
+    } else if (m.action != HID_ACTION_NONE && phase == HID_PHASE_END) {
+        hid_macro_report_t r[HID_MACRO_MAX_REPORTS];
+        size_t n = hid_macro_expand(&m, r);
+        for (size_t i = 0; i < n; ++i) tx_send(r[i].report_id, r[i].data, r[i].len, NULL);
+        if (n) s_tx_stats.macros++;
+    }
+}
+
+static void hid_tx_task(void *arg)
+{
+    (void)arg;
+    hid_tx_item_t item;
+
+    for (;;) {
+        // Con la rueda en marcha la cola se atiende entre paso y paso
+        TickType_t wait = hid_scroll_active(&s_scroll) ? pdMS_TO_TICKS(HID_SCROLL_TICK_MS)
+                                                       : portMAX_DELAY;
+        if (xQueueReceive(s_tx_queue, &item, wait) != pdTRUE) {
+            tx_scroll();
+            continue;
+        }
+
+        if (item.kind == HID_TX_TEXT) {
+            tx_type_text(item.text);
+            free(item.text);
+        } else if (item.kind == HID_TX_MOTION) {
+            tx_motion(&item);
+        } else if (item.kind == HID_TX_ABS) {
+            tx_abs(&item);
+        } else if (item.kind == HID_TX_GESTURE) {
+            tx_gesture(&item);
+        } else {
+            tx_send(item.report_id, item.data, item.len, NULL);
+        }
+    }
+}
+
+/* Encolar sin esperar: si la cola está llena el evento se pierde */
+static bool tx_enqueue(const hid_tx_item_t *item)
+{
+    int64_t t0 = esp_timer_get_time();
+    bool ok = s_tx_queue && xQueueSend(s_tx_queue, item, 0) == pdTRUE;
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    if (us > s_tx_stats.enqueue_max_us) s_tx_stats.enqueue_max_us = us;
+    if (!ok) s_tx_stats.dropped++;
+    return ok;
+}
+
+static bool tx_enqueue_report(uint8_t report_id, const uint8_t *data, size_t len)
+{
+    hid_tx_item_t item = {
+        .kind = HID_TX_REPORT,
+        .report_id = report_id,
+        .len = (uint8_t)len,
+    };
+    memcpy(item.data, data, len);
+    return tx_enqueue(&item);
+}
+
 /* Mouse functions */
 void ble_hid_mouse_move(int8_t dx, int8_t dy, int8_t wheel)
 {
@@ -431,25 +566,103 @@ void ble_hid_mouse_move(int8_t dx, int8_t dy, int8_t wheel)
         }
         return;
     }
+    consecutive_failures = 0;
 
     // Formato: [Buttons, X, Y, Wheel]
     uint8_t report[4] = {0x00, (uint8_t)dx, (uint8_t)dy, (uint8_t)wheel};
+    tx_enqueue_report(HID_REPORT_ID_MOUSE, report, sizeof(report));
+}
 
-    // Report ID = 0x01 (definido en el descriptor con 0x85, 0x01)
-    esp_err_t ret = esp_hidd_dev_input_set(s_hid_dev, 0, 0x01, report, sizeof(report));
-
-    if (ret != ESP_OK) {
-        consecutive_failures++;
-        if (consecutive_failures <= 5) {
-            ESP_LOGE(TAG, "[FAIL] Error enviando mouse (%d,%d,%d): %s",
-                     dx, dy, wheel, esp_err_to_name(ret));
+void ble_hid_mouse_motion(int32_t dx, int32_t dy)
+{
+    if (!s_tx_queue || (dx == 0 && dy == 0)) return;
+
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&s_motion_mux);
+    hid_motion_add(&s_motion, dx, dy, now);
+    bool enqueue = !s_motion_queued && hid_motion_pending(&s_motion);
+    if (enqueue) s_motion_queued = true;
+    // La muestra que deja movimiento pendiente es la que se traza, si
+    // viene de una lectura del táctil de este mismo trazo
+    if (!s_trace_pending.valid && hid_motion_pending(&s_motion) && s_last_read_pressed &&
+        s_last_read_end_us && s_last_read_end_us <= now) {
+        s_trace_pending = (hid_trace_sample_t){
+            .valid = true,
+            .read_start_us = s_last_read_start_us,
+            .read_end_us = s_last_read_end_us,
+            .callback_us = now,
+        };
+    }
+    taskEXIT_CRITICAL(&s_motion_mux);
+
+    if (enqueue) {
+        hid_tx_item_t item = { .kind = HID_TX_MOTION };
+        if (!tx_enqueue(&item)) {
+            taskENTER_CRITICAL(&s_motion_mux);
+            s_motion_queued = false;
+            taskEXIT_CRITICAL(&s_motion_mux);
         }
+    }
+}
+
+void ble_hid_mouse_motion_end(void)
+{
+    taskENTER_CRITICAL(&s_motion_mux);
+    hid_motion_end(&s_motion);
+    taskEXIT_CRITICAL(&s_motion_mux);
+}
+
+void ble_hid_mouse_set_curve(const hid_motion_curve_t *curve)
+{
+    hid_motion_curve_t c = curve ? *curve : hid_motion_default_curve();
+    taskENTER_CRITICAL(&s_motion_mux);
+    s_motion.curve = c;
+    taskEXIT_CRITICAL(&s_motion_mux);
+}
+
+void ble_hid_mouse_get_motion_stats(hid_motion_stats_t *out)
+{
+    taskENTER_CRITICAL(&s_motion_mux);
+    *out = s_motion.stats;
+    taskEXIT_CRITICAL(&s_motion_mux);
+}
+
+void ble_hid_abs_pointer(uint16_t x, uint16_t y, bool down)
+{
+    if (!s_tx_queue) return;
+    if (x > HID_ABS_MAX) x = HID_ABS_MAX;
+    if (y > HID_ABS_MAX) y = HID_ABS_MAX;
+    uint8_t buttons = down ? 0x01 : 0x00;
+
+    hid_tx_item_t item = { .kind = HID_TX_ABS };
+    bool enqueue = false;
+    taskENTER_CRITICAL(&s_motion_mux);
+    bool press = buttons != s_abs.buttons;
+    if (press) {
+        // Pulsar / soltar: report propio, invalida la posición pendiente
+        s_abs.seq++;
+        s_abs.valid = false;
+        s_abs.queued = false;
+        s_abs.buttons = buttons;
     } else {
-        // Reset contador de fallos en el primer éxito
-        if (consecutive_failures > 0) {
-            ESP_LOGI(TAG, "[OK] Mouse report enviado exitosamente");
-            consecutive_failures = 0;
-        }
+        if (s_abs.valid) s_tx_stats.abs_coalesced++;
+        s_abs.valid = true;
+        s_abs.x = x;
+        s_abs.y = y;
+        enqueue = !s_abs.queued;
+        s_abs.queued = true;
+        item.seq = s_abs.seq;
+    }
+    taskEXIT_CRITICAL(&s_motion_mux);
+
+    if (press) {
+        uint8_t report[HID_ABS_REPORT_LEN];
+        hid_abs_report(report, buttons, x, y);
+        tx_enqueue_report(HID_REPORT_ID_ABS, report, sizeof(report));
+    } else if (enqueue && !tx_enqueue(&item)) {
+        taskENTER_CRITICAL(&s_motion_mux);
+        if (item.seq == s_abs.seq) s_abs.queued = false;
+        taskEXIT_CRITICAL(&s_motion_mux);
     }
 }
 
@@ -464,69 +677,154 @@ void ble_hid_mouse_buttons(bool left, bool right, bool middle)
 
     // Report format: [Buttons, X, Y, Wheel]
     uint8_t report[4] = {buttons, 0x00, 0x00, 0x00};
-    // Report ID = 0x01 (Mouse)
-    esp_hidd_dev_input_set(s_hid_dev, 0, 0x01, report, sizeof(report));
+    tx_enqueue_report(HID_REPORT_ID_MOUSE, report, sizeof(report));
 
     ESP_LOGI(TAG, "✓ Mouse buttons: L=%d R=%d M=%d (0x%02X)", left, right, middle, buttons);
 }
 
 /* Keyboard functions */
-static const uint8_t ascii_to_hid[128] = {
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x2A, 0x2B, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x2C, 0x1E, 0x34, 0x20, 0x21, 0x22, 0x24, 0x34,
-    0x26, 0x27, 0x25, 0x2E, 0x36, 0x2D, 0x37, 0x38,
-    0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24,
-    0x25, 0x26, 0x33, 0x33, 0x36, 0x2E, 0x37, 0x38,
-    0x1F, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-    0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
-    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A,
-    0x1B, 0x1C, 0x1D, 0x2F, 0x31, 0x30, 0x23, 0x2D,
-    0x35, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-    0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
-    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A,
-    0x1B, 0x1C, 0x1D, 0x2F, 0x31, 0x30, 0x35, 0x00
-};
-
-static void send_keyboard_report(uint8_t modifier, uint8_t keycode)
+void ble_hid_keyboard_send_key(uint8_t keycode)
 {
     if (!s_hid_dev || !ble_hid_combined_is_connected()) return;
 
-    // Report format: [Modifier, Reserved, Key1, Key2, Key3, Key4, Key5, Key6] - SIN Report ID
-    uint8_t report[8] = {modifier, 0x00, keycode, 0x00, 0x00, 0x00, 0x00, 0x00};
-    esp_hidd_dev_input_set(s_hid_dev, 0, 0x02, report, sizeof(report));
-    vTaskDelay(pdMS_TO_TICKS(20));
+    // Pulsar y soltar: [Modificador, Reservado, Tecla1..Tecla6]
+    uint8_t report[HID_KBD_REPORT_LEN] = {0x00, 0x00, keycode};
+    tx_enqueue_report(HID_REPORT_ID_KEYBOARD, report, sizeof(report));
+    memset(report, 0, sizeof(report));
+    tx_enqueue_report(HID_REPORT_ID_KEYBOARD, report, sizeof(report));
+}
 
-    // Release
-    memset(report, 0, 8);
-    esp_hidd_dev_input_set(s_hid_dev, 0, 0x02, report, sizeof(report));
-    vTaskDelay(pdMS_TO_TICKS(20));
+void ble_hid_keyboard_send_text(const char *text)
+{
+    if (!text || !*text || !s_hid_dev || !ble_hid_combined_is_connected()) return;
+
+    // La tarea hid_tx genera los reports sobre su propia copia del texto
+    hid_tx_item_t item = {
+        .kind = HID_TX_TEXT,
+        .text = strdup(text),
+    };
+    if (!item.text) {
+        s_tx_stats.dropped++;
+        return;
+    }
+    if (!tx_enqueue(&item)) free(item.text);
 }
 
-void ble_hid_keyboard_send_key(uint8_t keycode)
+void ble_hid_keyboard_set_layout(hid_kbd_layout_t layout)
 {
-    send_keyboard_report(0x00, keycode);
+    if (layout >= HID_KBD_LAYOUT_COUNT) return;
+    s_kbd_layout = layout;
+    ESP_LOGI(TAG, "Layout de teclado: %s", hid_keymap_name(layout));
 }
 
-void ble_hid_keyboard_send_text(const char *text)
+hid_kbd_layout_t ble_hid_keyboard_get_layout(void)
 {
-    if (!text) return;
+    return s_kbd_layout;
+}
 
-    for (size_t i = 0; text[i] != '\0'; i++) {
-        uint8_t ch = (uint8_t)text[i];
-        if (ch >= 128) continue;
+/* Gestos */
+void ble_hid_gesture(hid_gesture_t gesture, hid_gesture_phase_t phase, int32_t value)
+{
+    if (gesture >= HID_GESTURE_COUNT || !s_hid_dev || !ble_hid_combined_is_connected()) return;
+
+    hid_tx_item_t item = {
+        .kind = HID_TX_GESTURE,
+        .data = { (uint8_t)gesture, (uint8_t)phase },
+        .value = value,
+    };
+    tx_enqueue(&item);
+}
 
-        uint8_t modifier = 0x00;
-        uint8_t keycode = ascii_to_hid[ch];
+void ble_hid_macro_set_table(const hid_macro_t *table, size_t n)
+{
+    size_t def_n;
+    const hid_macro_t *def = hid_macro_default_table(&def_n);
+    taskENTER_CRITICAL(&s_macro_mux);
+    s_macro_table = table ? table : def;
+    s_macro_n = table ? n : def_n;
+    taskEXIT_CRITICAL(&s_macro_mux);
+}
 
-        if (ch >= 'A' && ch <= 'Z') {
-            modifier = 0x02;  // Shift
-        }
+/* Trazas de latencia */
+void ble_hid_trace_touch_read(int64_t start_us, int64_t end_us, bool pressed)
+{
+    if (pressed) {
+        trace_add(HID_TRACE_TOUCH_READ, start_us, end_us);
+        if (s_last_read_pressed) trace_add(HID_TRACE_READ_PERIOD, s_last_read_start_us, start_us);
+    }
+    taskENTER_CRITICAL(&s_motion_mux);
+    s_last_read_start_us = start_us;
+    s_last_read_end_us = end_us;
+    s_last_read_pressed = pressed;
+    taskEXIT_CRITICAL(&s_motion_mux);
+}
 
-        if (keycode != 0x00) {
-            send_keyboard_report(modifier, keycode);
-        }
+void ble_hid_trace_get(hid_trace_stage_t stage, hid_trace_summary_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!s_trace_hist || stage >= HID_TRACE_STAGES) return;
+
+    // Copia para no calcular percentiles con el spinlock tomado
+    hid_lat_hist_t *h = malloc(sizeof(*h));
+    if (!h) return;
+    taskENTER_CRITICAL(&s_trace_mux);
+    *h = s_trace_hist[stage];
+    taskEXIT_CRITICAL(&s_trace_mux);
+
+    out->count = h->count;
+    out->p50_us = hid_lat_percentile(h, 50);
+    out->p95_us = hid_lat_percentile(h, 95);
+    out->p99_us = hid_lat_percentile(h, 99);
+    out->max_us = h->max_us;
+    free(h);
+}
+
+void ble_hid_trace_reset(void)
+{
+    if (!s_trace_hist) return;
+    taskENTER_CRITICAL(&s_trace_mux);
+    memset(s_trace_hist, 0, HID_TRACE_STAGES * sizeof(hid_lat_hist_t));
+    taskEXIT_CRITICAL(&s_trace_mux);
+}
+
+const char *ble_hid_trace_stage_name(hid_trace_stage_t stage)
+{
+    return stage < HID_TRACE_STAGES ? s_trace_names[stage] : "?";
+}
+
+void ble_hid_trace_dump(void)
+{
+    ESP_LOGI(TAG, "%-12s %6s %8s %8s %8s %8s", "etapa", "n", "p50 us", "p95 us", "p99 us", "max us");
+    for (int i = 0; i < HID_TRACE_STAGES; ++i) {
+        hid_trace_summary_t t;
+        ble_hid_trace_get((hid_trace_stage_t)i, &t);
+        ESP_LOGI(TAG, "%-12s %6u %8u %8u %8u %8u", s_trace_names[i], (unsigned)t.count,
+                 (unsigned)t.p50_us, (unsigned)t.p95_us, (unsigned)t.p99_us, (unsigned)t.max_us);
+    }
+}
+
+void ble_hid_tx_get_stats(ble_hid_tx_stats_t *out)
+{
+    *out = s_tx_stats;
+}
+
+void ble_hid_tx_dump_stats(void)
+{
+    ESP_LOGI(TAG, "HID TX: %u reports, %u perdidos, %u sin confirmacion, encolar max %u us",
+             (unsigned)s_tx_stats.reports, (unsigned)s_tx_stats.dropped,
+             (unsigned)s_tx_stats.conf_timeouts, (unsigned)s_tx_stats.enqueue_max_us);
+    ESP_LOGI(TAG, "Puntero absoluto: %u posiciones sustituidas antes de salir",
+             (unsigned)s_tx_stats.abs_coalesced);
+    ESP_LOGI(TAG, "Macros de gestos: %u", (unsigned)s_tx_stats.macros);
+    hid_motion_stats_t m;
+    ble_hid_mouse_get_motion_stats(&m);
+    ESP_LOGI(TAG, "Raton: %u muestras -> %u reports (%u partidos), %u px descartados, "
+             "latencia media %u us max %u us",
+             (unsigned)m.samples, (unsigned)m.reports, (unsigned)m.splits, (unsigned)m.dropped_px,
+             m.reports ? (unsigned)(m.latency_sum_us / m.reports) : 0, (unsigned)m.latency_max_us);
+    if (s_tx_stats.last_text_ms) {
+        ESP_LOGI(TAG, "Ultimo texto: %u caracteres en %u ms (%u caracteres/s)",
+                 (unsigned)s_tx_stats.last_text_chars, (unsigned)s_tx_stats.last_text_ms,
+                 (unsigned)(s_tx_stats.last_text_chars * 1000 / s_tx_stats.last_text_ms));
     }
 }
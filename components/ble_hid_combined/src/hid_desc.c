@@ -0,0 +1,154 @@
+#include "hid_desc.h"
+#include <string.h>
+
+/* Ratón relativo - Report ID 0x01 para compatibilidad universal */
+static const uint8_t k_mouse[] = {
+    0x05, 0x01,       // Usage Page (Generic Desktop)
+    0x09, 0x02,       // Usage (Mouse)
+    0xA1, 0x01,       // Collection (Application)
+    0x85, HID_REPORT_ID_MOUSE, //   Report ID (1)
+    0x09, 0x01,       //   Usage (Pointer)
+    0xA1, 0x00,       //   Collection (Physical)
+    0x05, 0x09,       //     Usage Page (Buttons)
+    0x19, 0x01,       //     Usage Minimum (1)
+    0x29, 0x03,       //     Usage Maximum (3)
+    0x15, 0x00,       //     Logical Minimum (0)
+    0x25, 0x01,       //     Logical Maximum (1)
+    0x95, 0x03,       //     Report Count (3)
+    0x75, 0x01,       //     Report Size (1)
+    0x81, 0x02,       //     Input (Data,Var,Abs)
+    0x95, 0x01,       //     Report Count (1)
+    0x75, 0x05,       //     Report Size (5)
+    0x81, 0x01,       //     Input (Const)
+    0x05, 0x01,       //     Usage Page (Generic Desktop)
+    0x09, 0x30,       //     Usage (X)
+    0x09, 0x31,       //     Usage (Y)
+    0x09, 0x38,       //     Usage (Wheel)
+    0x15, 0x81,       //     Logical Minimum (-127)
+    0x25, 0x7F,       //     Logical Maximum (127)
+    0x75, 0x08,       //     Report Size (8)
+    0x95, 0x03,       //     Report Count (3)
+    0x81, 0x06,       //     Input (Data,Var,Rel)
+    0xC0,             //   End Collection
+    0xC0,             // End Collection
+};
+
+/* Teclado - Report ID 0x02 */
+static const uint8_t k_keyboard[] = {
+    0x05, 0x01,       // Usage Page (Generic Desktop)
+    0x09, 0x06,       // Usage (Keyboard)
+    0xA1, 0x01,       // Collection (Application)
+    0x85, HID_REPORT_ID_KEYBOARD, // Report ID (2)
+    0x05, 0x07,       //   Usage Page (Key Codes)
+    0x19, 0xE0,       //   Usage Minimum (224)
+    0x29, 0xE7,       //   Usage Maximum (231)
+    0x15, 0x00,       //   Logical Minimum (0)
+    0x25, 0x01,       //   Logical Maximum (1)
+    0x75, 0x01,       //   Report Size (1)
+    0x95, 0x08,       //   Report Count (8)
+    0x81, 0x02,       //   Input (Data,Var,Abs) - Modificadores
+    0x95, 0x01,       //   Report Count (1)
+    0x75, 0x08,       //   Report Size (8)
+    0x81, 0x01,       //   Input (Const) - Reservado
+    0x95, 0x06,       //   Report Count (6)
+    0x75, 0x08,       //   Report Size (8)
+    0x15, 0x00,       //   Logical Minimum (0)
+    0x25, 0x65,       //   Logical Maximum (101)
+    0x05, 0x07,       //   Usage Page (Key Codes)
+    0x19, 0x00,       //   Usage Minimum (0)
+    0x29, 0x65,       //   Usage Maximum (101)
+    0x81, 0x00,       //   Input (Data,Array) - Teclas
+    0xC0,             // End Collection
+};
+
+/* Puntero absoluto - Report ID 0x03 */
+static const uint8_t k_abs[] = {
+    0x05, 0x01,       // Usage Page (Generic Desktop)
+    0x09, 0x02,       // Usage (Mouse)
+    0xA1, 0x01,       // Collection (Application)
+    0x85, HID_REPORT_ID_ABS, //   Report ID (3)
+    0x09, 0x01,       //   Usage (Pointer)
+    0xA1, 0x00,       //   Collection (Physical)
+    0x05, 0x09,       //     Usage Page (Buttons)
+    0x19, 0x01,       //     Usage Minimum (1)
+    0x29, 0x03,       //     Usage Maximum (3)
+    0x15, 0x00,       //     Logical Minimum (0)
+    0x25, 0x01,       //     Logical Maximum (1)
+    0x95, 0x03,       //     Report Count (3)
+    0x75, 0x01,       //     Report Size (1)
+    0x81, 0x02,       //     Input (Data,Var,Abs)
+    0x95, 0x01,       //     Report Count (1)
+    0x75, 0x05,       //     Report Size (5)
+    0x81, 0x01,       //     Input (Const)
+    0x05, 0x01,       //     Usage Page (Generic Desktop)
+    0x09, 0x30,       //     Usage (X)
+    0x09, 0x31,       //     Usage (Y)
+    0x15, 0x00,       //     Logical Minimum (0)
+    0x26, HID_ABS_MAX & 0xFF, HID_ABS_MAX >> 8, // Logical Maximum (32767)
+    0x75, 0x10,       //     Report Size (16)
+    0x95, 0x02,       //     Report Count (2)
+    0x81, 0x02,       //     Input (Data,Var,Abs)
+    0xC0,             //   End Collection
+    0xC0,             // End Collection
+};
+
+/* Multimedia (Consumer) - Report ID 0x04: un uso de 16 bits */
+static const uint8_t k_consumer[] = {
+    0x05, 0x0C,       // Usage Page (Consumer)
+    0x09, 0x01,       // Usage (Consumer Control)
+    0xA1, 0x01,       // Collection (Application)
+    0x85, HID_REPORT_ID_CONSUMER, // Report ID (4)
+    0x15, 0x00,       //   Logical Minimum (0)
+    0x26, 0xFF, 0x03, //   Logical Maximum (1023)
+    0x19, 0x00,       //   Usage Minimum (0)
+    0x2A, 0xFF, 0x03, //   Usage Maximum (1023)
+    0x75, 0x10,       //   Report Size (16)
+    0x95, 0x01,       //   Report Count (1)
+    0x81, 0x00,       //   Input (Data,Array)
+    0xC0,             // End Collection
+};
+
+static const struct {
+    uint32_t flag;
+    const uint8_t *data;
+    size_t len;
+} k_parts[] = {
+    { HID_DESC_MOUSE,    k_mouse,    sizeof(k_mouse) },
+    { HID_DESC_KEYBOARD, k_keyboard, sizeof(k_keyboard) },
+    { HID_DESC_ABS,      k_abs,      sizeof(k_abs) },
+    { HID_DESC_CONSUMER, k_consumer, sizeof(k_consumer) },
+};
+
+_Static_assert(sizeof(k_mouse) + sizeof(k_keyboard) + sizeof(k_abs) + sizeof(k_consumer) <=
+               HID_DESC_MAX_LEN,
+               "HID_DESC_MAX_LEN too small");
+
+size_t hid_desc_build(uint32_t collections, uint8_t *out, size_t cap)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < sizeof(k_parts) / sizeof(k_parts[0]); ++i) {
+        if (!(collections & k_parts[i].flag)) continue;
+        if (len + k_parts[i].len > cap) return 0;
+        memcpy(out + len, k_parts[i].data, k_parts[i].len);
+        len += k_parts[i].len;
+    }
+    return len;
+}
+
+uint16_t hid_abs_scale(int32_t v, int32_t origin, int32_t size)
+{
+    if (size <= 1) return 0;
+    int64_t d = (int64_t)v - origin;
+    if (d <= 0) return 0;
+    if (d >= size - 1) return HID_ABS_MAX;
+    return (uint16_t)((d * HID_ABS_MAX + (size - 1) / 2) / (size - 1));
+}
+
+void hid_abs_report(uint8_t out[HID_ABS_REPORT_LEN], uint8_t buttons, uint16_t x, uint16_t y)
+{
+    out[0] = buttons & 0x07;
+    out[1] = (uint8_t)(x & 0xFF);
+    out[2] = (uint8_t)(x >> 8);
+    out[3] = (uint8_t)(y & 0xFF);
+    out[4] = (uint8_t)(y >> 8);
+}
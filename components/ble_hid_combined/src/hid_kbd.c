@@ -0,0 +1,55 @@
+#include "hid_kbd.h"
+#include <string.h>
+
+void hid_kbd_seq_init(hid_kbd_seq_t *seq, const char *text, hid_kbd_layout_t layout)
+{
+    memset(seq, 0, sizeof(*seq));
+    seq->next = text ? text : "";
+    seq->layout = layout;
+}
+
+static void put_report(uint8_t report[HID_KBD_REPORT_LEN], hid_kbd_stroke_t s)
+{
+    memset(report, 0, HID_KBD_REPORT_LEN);
+    report[0] = s.mod;
+    report[2] = s.key;
+}
+
+/* Pulsaciones del siguiente carácter con tecla; false al final del texto */
+static bool load_next(hid_kbd_seq_t *seq)
+{
+    hid_kbd_chord_t c;
+    uint32_t cp;
+    while ((cp = hid_utf8_next(&seq->next)) != 0) {
+        if (!hid_keymap_encode(seq->layout, cp, &c)) continue;
+        seq->npending = 0;
+        if (c.dead.key) seq->pending[seq->npending++] = c.dead;
+        seq->pending[seq->npending++] = c.key;
+        seq->typed++;
+        return true;
+    }
+    return false;
+}
+
+bool hid_kbd_seq_next(hid_kbd_seq_t *seq, uint8_t report[HID_KBD_REPORT_LEN])
+{
+    const hid_kbd_stroke_t none = {0};
+    if (seq->npending == 0 && !load_next(seq)) {
+        if (seq->held.key == 0) return false;
+        seq->held = none;                   // soltar la última tecla
+        put_report(report, none);
+        return true;
+    }
+
+    hid_kbd_stroke_t s = seq->pending[0];
+    if (seq->held.key != 0 && (seq->held.key == s.key || seq->held.mod != s.mod)) {
+        seq->held = none;                   // tecla repetida o cambio de modificador
+        put_report(report, none);
+        return true;
+    }
+    seq->held = s;
+    seq->pending[0] = seq->pending[1];
+    seq->npending--;
+    put_report(report, s);
+    return true;
+}
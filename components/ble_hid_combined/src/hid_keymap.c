@@ -0,0 +1,181 @@
+#include "hid_keymap.h"
+#include <stddef.h>
+
+#define S   HID_KBD_MOD_LSHIFT
+#define AG  HID_KBD_MOD_RALT
+
+/*
+ * Cada layout es una lista de K(carácter, modificador, tecla) y
+ * D(carácter, tecla muerta, modificador, tecla) que se expande a
+ * inicializadores de la tabla [U+0000..U+00FF]. Un carácter repetido en la
+ * lista sería un aviso de -Woverride-init. La tecla muerta se nombra
+ * (ES_ACUTE) y se define como DEAD_ES_ACUTE, así no se expande antes de
+ * tiempo al pasar por las macros intermedias.
+ */
+#define TABLE_KEY(cp, mod, code)        [cp] = { {0, 0}, {mod, code} },
+#define TABLE_DEAD(cp, dead, mod, code) [cp] = { DEAD_##dead, {mod, code} },
+
+#define LETTER(K, lo, up, code)     K(lo, 0, code) K(up, S, code)
+
+#define LETTERS(K) \
+    LETTER(K, 'a', 'A', 0x04) LETTER(K, 'b', 'B', 0x05) LETTER(K, 'c', 'C', 0x06) \
+    LETTER(K, 'd', 'D', 0x07) LETTER(K, 'e', 'E', 0x08) LETTER(K, 'f', 'F', 0x09) \
+    LETTER(K, 'g', 'G', 0x0A) LETTER(K, 'h', 'H', 0x0B) LETTER(K, 'i', 'I', 0x0C) \
+    LETTER(K, 'j', 'J', 0x0D) LETTER(K, 'k', 'K', 0x0E) LETTER(K, 'l', 'L', 0x0F) \
+    LETTER(K, 'm', 'M', 0x10) LETTER(K, 'n', 'N', 0x11) LETTER(K, 'o', 'O', 0x12) \
+    LETTER(K, 'p', 'P', 0x13) LETTER(K, 'q', 'Q', 0x14) LETTER(K, 'r', 'R', 0x15) \
+    LETTER(K, 's', 'S', 0x16) LETTER(K, 't', 'T', 0x17) LETTER(K, 'u', 'U', 0x18) \
+    LETTER(K, 'v', 'V', 0x19) LETTER(K, 'w', 'W', 0x1A) LETTER(K, 'x', 'X', 0x1B) \
+    LETTER(K, 'y', 'Y', 0x1C) LETTER(K, 'z', 'Z', 0x1D)
+
+#define DIGITS(K) \
+    K('1', 0, 0x1E) K('2', 0, 0x1F) K('3', 0, 0x20) K('4', 0, 0x21) K('5', 0, 0x22) \
+    K('6', 0, 0x23) K('7', 0, 0x24) K('8', 0, 0x25) K('9', 0, 0x26) K('0', 0, 0x27)
+
+#define CONTROLS(K) \
+    K('\n', 0, 0x28) K('\b', 0, 0x2A) K('\t', 0, 0x2B) K(' ', 0, 0x2C)
+
+/* US */
+#define US_KEYS(K, D) \
+    LETTERS(K) DIGITS(K) CONTROLS(K) \
+    K('!', S, 0x1E) K('@', S, 0x1F) K('#', S, 0x20) K('$', S, 0x21) K('%', S, 0x22) \
+    K('^', S, 0x23) K('&', S, 0x24) K('*', S, 0x25) K('(', S, 0x26) K(')', S, 0x27) \
+    K('-', 0, 0x2D) K('_', S, 0x2D) K('=', 0, 0x2E) K('+', S, 0x2E) \
+    K('[', 0, 0x2F) K('{', S, 0x2F) K(']', 0, 0x30) K('}', S, 0x30) \
+    K('\\', 0, 0x31) K('|', S, 0x31) K(';', 0, 0x33) K(':', S, 0x33) \
+    K('\'', 0, 0x34) K('"', S, 0x34) K('`', 0, 0x35) K('~', S, 0x35) \
+    K(',', 0, 0x36) K('<', S, 0x36) K('.', 0, 0x37) K('>', S, 0x37) \
+    K('/', 0, 0x38) K('?', S, 0x38)
+
+/* ES: teclas muertas y vocales que se escriben con ellas */
+#define DEAD_ES_ACUTE       { 0, 0x34 }
+#define DEAD_ES_DIAERESIS   { S, 0x34 }
+#define DEAD_ES_GRAVE       { 0, 0x2F }
+#define DEAD_ES_CIRCUMFLEX  { S, 0x2F }
+
+// Minúscula y mayúscula (cp - 0x20 en Latin-1)
+#define VOWEL(D, dead, lo, code)    D(lo, dead, 0, code) D((lo) - 0x20, dead, S, code)
+#define VOWELS(D, dead, a, e, i, o, u) \
+    VOWEL(D, dead, a, 0x04) VOWEL(D, dead, e, 0x08) VOWEL(D, dead, i, 0x0C) \
+    VOWEL(D, dead, o, 0x12) VOWEL(D, dead, u, 0x18)
+
+#define ES_KEYS(K, D) \
+    LETTERS(K) DIGITS(K) CONTROLS(K) \
+    K(0xBA, 0, 0x35) K(0xAA, S, 0x35) K('\\', AG, 0x35)          /* º ª */ \
+    K('!', S, 0x1E) K('|', AG, 0x1E) K('"', S, 0x1F) K('@', AG, 0x1F) \
+    K(0xB7, S, 0x20) K('#', AG, 0x20) K('$', S, 0x21) K('~', AG, 0x21) /* · */ \
+    K('%', S, 0x22) K('&', S, 0x23) K(0xAC, AG, 0x23)              /* ¬ */ \
+    K('/', S, 0x24) K('(', S, 0x25) K(')', S, 0x26) K('=', S, 0x27) \
+    K('\'', 0, 0x2D) K('?', S, 0x2D) K(0xA1, 0, 0x2E) K(0xBF, S, 0x2E) /* ¡ ¿ */ \
+    K('[', AG, 0x2F) K('+', 0, 0x30) K('*', S, 0x30) K(']', AG, 0x30) \
+    K(0xF1, 0, 0x33) K(0xD1, S, 0x33) K('{', AG, 0x34)             /* ñ Ñ */ \
+    K(0xE7, 0, 0x32) K(0xC7, S, 0x32) K('}', AG, 0x32)             /* ç Ç */ \
+    K('<', 0, 0x64) K('>', S, 0x64) K(',', 0, 0x36) K(';', S, 0x36) \
+    K('.', 0, 0x37) K(':', S, 0x37) K('-', 0, 0x38) K('_', S, 0x38) \
+    /* El acento solo: tecla muerta y espacio */ \
+    D('`', ES_GRAVE, 0, 0x2C) D('^', ES_CIRCUMFLEX, 0, 0x2C) \
+    D(0xB4, ES_ACUTE, 0, 0x2C) D(0xA8, ES_DIAERESIS, 0, 0x2C)      /* ´ ¨ */ \
+    VOWELS(D, ES_ACUTE, 0xE1, 0xE9, 0xED, 0xF3, 0xFA)              /* á é í ó ú */ \
+    VOWELS(D, ES_GRAVE, 0xE0, 0xE8, 0xEC, 0xF2, 0xF9)              /* à è ì ò ù */ \
+    VOWELS(D, ES_CIRCUMFLEX, 0xE2, 0xEA, 0xEE, 0xF4, 0xFB)         /* â ê î ô û */ \
+    VOWELS(D, ES_DIAERESIS, 0xE4, 0xEB, 0xEF, 0xF6, 0xFC)          /* ä ë ï ö ü */ \
+    D(0xFD, ES_ACUTE, 0, 0x1C) D(0xDD, ES_ACUTE, S, 0x1C)          /* ý Ý */ \
+    D(0xFF, ES_DIAERESIS, 0, 0x1C)                                 /* ÿ */
+
+static const hid_kbd_chord_t k_us[256] = { US_KEYS(TABLE_KEY, TABLE_DEAD) };
+static const hid_kbd_chord_t k_es[256] = { ES_KEYS(TABLE_KEY, TABLE_DEAD) };
+
+/* Fuera de Latin-1: pocos, se recorren */
+typedef struct {
+    uint16_t cp;
+    hid_kbd_chord_t chord;
+} hid_keymap_extra_t;
+
+static const hid_keymap_extra_t k_es_extra[] = {
+    { 0x20AC, { {0, 0}, {AG, 0x08} } },     // € (AltGr+E)
+};
+
+static const struct {
+    const char *name;
+    const hid_kbd_chord_t *table;
+    const hid_keymap_extra_t *extra;
+    size_t extra_n;
+} k_layouts[HID_KBD_LAYOUT_COUNT] = {
+    [HID_KBD_LAYOUT_US] = { "US", k_us, NULL, 0 },
+    [HID_KBD_LAYOUT_ES] = { "ES", k_es, k_es_extra, sizeof(k_es_extra) / sizeof(k_es_extra[0]) },
+};
+
+/* Sustituto ASCII de U+00C0..U+00FF (letra sin acento), 0 si no hay */
+static const char k_fold_latin1[] =
+    "AAAAAAACEEEEIIIIDNOOOOO" "\0" "OUUUUY" "\0" "s"
+    "aaaaaaaceeeeiiiidnooooo" "\0" "ouuuuy" "\0" "y";
+
+static uint32_t fold(uint32_t cp)
+{
+    if (cp >= 0xC0 && cp <= 0xFF) return (uint8_t)k_fold_latin1[cp - 0xC0];
+    switch (cp) {
+    case 0x00A0: return ' ';                    // espacio duro
+    case 0x00AB: case 0x00BB:                   // « »
+    case 0x201C: case 0x201D: return '"';
+    case 0x00B4:
+    case 0x2018: case 0x2019: return '\'';
+    case 0x2010: case 0x2013: case 0x2014: return '-';
+    case 0x2026: return '.';                    // …
+    default: return 0;
+    }
+}
+
+bool hid_keymap_lookup(hid_kbd_layout_t layout, uint32_t cp, hid_kbd_chord_t *out)
+{
+    if (layout >= HID_KBD_LAYOUT_COUNT) return false;
+    if (cp < 256) {
+        *out = k_layouts[layout].table[cp];
+        return out->key.key != 0;
+    }
+    for (size_t i = 0; i < k_layouts[layout].extra_n; ++i) {
+        if (k_layouts[layout].extra[i].cp == cp) {
+            *out = k_layouts[layout].extra[i].chord;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hid_keymap_encode(hid_kbd_layout_t layout, uint32_t cp, hid_kbd_chord_t *out)
+{
+    if (hid_keymap_lookup(layout, cp, out)) return true;
+    uint32_t f = fold(cp);
+    return f && hid_keymap_lookup(layout, f, out);
+}
+
+const char *hid_keymap_name(hid_kbd_layout_t layout)
+{
+    return layout < HID_KBD_LAYOUT_COUNT ? k_layouts[layout].name : "?";
+}
+
+uint32_t hid_utf8_next(const char **p)
+{
+    static const uint32_t k_min[4] = { 0, 0x80, 0x800, 0x10000 };
+    const uint8_t *s = (const uint8_t *)*p;
+    uint32_t c = s[0];
+
+    if (c < 0x80) {
+        if (c) (*p)++;
+        return c;
+    }
+    int n = c >= 0xF8 ? -1 : c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : -1;
+    if (n < 0) goto bad;
+
+    uint32_t cp = c & (0x3Fu >> n);
+    for (int i = 1; i <= n; ++i) {
+        if ((s[i] & 0xC0) != 0x80) goto bad;    // también para en el '\0'
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    if (cp < k_min[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) goto bad;
+    *p += n + 1;
+    return cp;
+
+bad:
+    (*p)++;
+    return 0xFFFD;
+}
@@ -0,0 +1,48 @@
+#include "hid_lat.h"
+
+static unsigned bucket_of(uint32_t us)
+{
+    if (us < HID_LAT_EXACT) return us;
+    unsigned e = 31 - (unsigned)__builtin_clz(us);          // 4.. (us >= 16)
+    unsigned sub = (us >> (e - 3)) & (HID_LAT_SUB - 1);
+    unsigned b = HID_LAT_EXACT + (e - 4) * HID_LAT_SUB + sub;
+    return b < HID_LAT_BUCKETS ? b : HID_LAT_BUCKETS - 1;
+}
+
+/* Mayor valor que cae en la cubeta b */
+static uint32_t bucket_top(unsigned b)
+{
+    if (b < HID_LAT_EXACT) return b;
+    unsigned e = (b - HID_LAT_EXACT) / HID_LAT_SUB + 4;
+    unsigned sub = (b - HID_LAT_EXACT) % HID_LAT_SUB;
+    return ((uint32_t)(HID_LAT_SUB + sub + 1) << (e - 3)) - 1;
+}
+
+void hid_lat_add(hid_lat_hist_t *h, uint32_t us)
+{
+    h->count++;
+    h->sum_us += us;
+    if (us > h->max_us) h->max_us = us;
+    h->bucket[bucket_of(us)]++;
+}
+
+uint32_t hid_lat_percentile(const hid_lat_hist_t *h, unsigned pct)
+{
+    if (h->count == 0) return 0;
+    if (pct > 100) pct = 100;
+
+    // Rango de la muestra pedida (1..count), redondeando hacia arriba
+    uint32_t rank = (uint32_t)(((uint64_t)h->count * pct + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (unsigned b = 0; b < HID_LAT_BUCKETS; ++b) {
+        seen += h->bucket[b];
+        if (seen >= rank) {
+            if (b == HID_LAT_BUCKETS - 1) break;   // desbordamiento: sin límite
+            uint32_t top = bucket_top(b);
+            return top < h->max_us ? top : h->max_us;
+        }
+    }
+    return h->max_us;
+}
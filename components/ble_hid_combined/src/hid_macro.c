@@ -0,0 +1,49 @@
+#include "hid_macro.h"
+#include "hid_desc.h"
+#include "hid_kbd.h"
+#include <string.h>
+
+static const hid_macro_t k_default[] = {
+    { HID_GESTURE_SCROLL_DRAG,       HID_ACTION_SCROLL,   0,            24 },
+    { HID_GESTURE_EDGE_SWIPE_RIGHT,  HID_ACTION_KEY,      HID_MOD_LALT, HID_KEY_LEFT_ARROW },
+    { HID_GESTURE_EDGE_SWIPE_LEFT,   HID_ACTION_KEY,      HID_MOD_LALT, HID_KEY_RIGHT_ARROW },
+    { HID_GESTURE_WRIST_FLICK_RIGHT, HID_ACTION_CONSUMER, 0,            HID_CONSUMER_NEXT_TRACK },
+    { HID_GESTURE_WRIST_FLICK_LEFT,  HID_ACTION_CONSUMER, 0,            HID_CONSUMER_PREV_TRACK },
+};
+
+const hid_macro_t *hid_macro_default_table(size_t *n)
+{
+    *n = sizeof(k_default) / sizeof(k_default[0]);
+    return k_default;
+}
+
+const hid_macro_t *hid_macro_find(const hid_macro_t *table, size_t n, hid_gesture_t gesture)
+{
+    for (size_t i = 0; table && i < n; ++i) {
+        if (table[i].gesture == gesture) return &table[i];
+    }
+    return NULL;
+}
+
+size_t hid_macro_expand(const hid_macro_t *m, hid_macro_report_t out[HID_MACRO_MAX_REPORTS])
+{
+    memset(out, 0, HID_MACRO_MAX_REPORTS * sizeof(out[0]));
+    switch (m ? m->action : HID_ACTION_NONE) {
+    case HID_ACTION_KEY:
+        // [Modificador, Reservado, Tecla1..Tecla6]: pulsar y soltar
+        out[0].report_id = out[1].report_id = HID_REPORT_ID_KEYBOARD;
+        out[0].len = out[1].len = HID_KBD_REPORT_LEN;
+        out[0].data[0] = m->mod;
+        out[0].data[2] = (uint8_t)m->code;
+        return 2;
+    case HID_ACTION_CONSUMER:
+        // [Uso lo, Uso hi], 0 = soltar
+        out[0].report_id = out[1].report_id = HID_REPORT_ID_CONSUMER;
+        out[0].len = out[1].len = HID_CONSUMER_REPORT_LEN;
+        out[0].data[0] = (uint8_t)(m->code & 0xFF);
+        out[0].data[1] = (uint8_t)(m->code >> 8);
+        return 2;
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,110 @@
+#include "hid_motion.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ACC  ((int32_t)HID_MOTION_MAX_PENDING * HID_MOTION_ONE)
+
+hid_motion_curve_t hid_motion_default_curve(void)
+{
+    hid_motion_curve_t c = {
+        .base_gain = HID_MOTION_ONE / 2,
+        .max_gain = HID_MOTION_ONE * 3 / 2,
+        .accel_start = 300,
+        .accel_full = 1500,
+    };
+    return c;
+}
+
+void hid_motion_init(hid_motion_t *m, const hid_motion_curve_t *curve)
+{
+    memset(m, 0, sizeof(*m));
+    m->curve = curve ? *curve : hid_motion_default_curve();
+}
+
+uint32_t hid_motion_gain(const hid_motion_curve_t *c, uint32_t speed)
+{
+    if (speed <= c->accel_start || c->max_gain <= c->base_gain) return c->base_gain;
+    if (speed >= c->accel_full || c->accel_full <= c->accel_start) return c->max_gain;
+    return c->base_gain + (uint32_t)(c->max_gain - c->base_gain) * (speed - c->accel_start) /
+                          (uint32_t)(c->accel_full - c->accel_start);
+}
+
+/* Suma con saturación: devuelve los px descartados */
+static uint32_t acc_add(int32_t *acc, int64_t v)
+{
+    int64_t sum = (int64_t)*acc + v;
+    int64_t over = 0;
+    if (sum > MAX_ACC) over = sum - MAX_ACC;
+    if (sum < -MAX_ACC) over = -MAX_ACC - sum;
+    *acc = (int32_t)(sum > MAX_ACC ? MAX_ACC : sum < -MAX_ACC ? -MAX_ACC : sum);
+    return (uint32_t)(over >> HID_MOTION_FRAC_BITS);
+}
+
+/* px enteros de un acumulador (hacia cero) */
+static int32_t whole(int32_t acc)
+{
+    return acc >= 0 ? acc >> HID_MOTION_FRAC_BITS : -((-acc) >> HID_MOTION_FRAC_BITS);
+}
+
+bool hid_motion_pending(const hid_motion_t *m)
+{
+    return whole(m->acc_x) != 0 || whole(m->acc_y) != 0;
+}
+
+void hid_motion_add(hid_motion_t *m, int32_t dx, int32_t dy, int64_t now_us)
+{
+    m->stats.samples++;
+    if (dx == 0 && dy == 0) return;
+
+    // Velocidad con la muestra anterior del mismo trazo
+    uint32_t speed = 0;
+    if (m->last_us && now_us > m->last_us) {
+        uint64_t dist = (uint64_t)abs(dx) + (uint64_t)abs(dy);
+        uint64_t s = dist * 1000000u / (uint64_t)(now_us - m->last_us);
+        speed = s > UINT32_MAX ? UINT32_MAX : (uint32_t)s;
+    }
+    m->last_us = now_us;
+
+    bool was_pending = hid_motion_pending(m);
+    uint32_t gain = hid_motion_gain(&m->curve, speed);
+    m->stats.dropped_px += acc_add(&m->acc_x, (int64_t)dx * gain);
+    m->stats.dropped_px += acc_add(&m->acc_y, (int64_t)dy * gain);
+    if (!was_pending && hid_motion_pending(m)) m->first_us = now_us;
+}
+
+static int8_t take_axis(int32_t *acc)
+{
+    int32_t px = whole(*acc);
+    if (px > 127) px = 127;
+    if (px < -127) px = -127;
+    *acc -= px * HID_MOTION_ONE;
+    return (int8_t)px;
+}
+
+bool hid_motion_take(hid_motion_t *m, int8_t *dx, int8_t *dy, int64_t now_us)
+{
+    if (!hid_motion_pending(m)) return false;
+
+    *dx = take_axis(&m->acc_x);
+    *dy = take_axis(&m->acc_y);
+    m->stats.reports++;
+
+    uint32_t lat = now_us > m->first_us ? (uint32_t)(now_us - m->first_us) : 0;
+    m->stats.latency_sum_us += lat;
+    if (lat > m->stats.latency_max_us) m->stats.latency_max_us = lat;
+
+    if (hid_motion_pending(m)) {
+        m->stats.splits++;
+        m->first_us = now_us;   // el resto sale en el siguiente evento
+    } else {
+        m->first_us = 0;
+    }
+    return true;
+}
+
+void hid_motion_end(hid_motion_t *m)
+{
+    m->acc_x = whole(m->acc_x) * HID_MOTION_ONE;
+    m->acc_y = whole(m->acc_y) * HID_MOTION_ONE;
+    m->last_us = 0;
+}
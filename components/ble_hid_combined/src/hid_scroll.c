@@ -0,0 +1,87 @@
+#include "hid_scroll.h"
+#include <string.h>
+
+#define ONE (1 << HID_SCROLL_FRAC_BITS)
+
+void hid_scroll_init(hid_scroll_t *s, uint16_t px_per_detent, uint16_t tau_ms)
+{
+    memset(s, 0, sizeof(*s));
+    s->px_per_detent = px_per_detent ? px_per_detent : 1;
+    s->tau_ms = tau_ms ? tau_ms : 1;
+}
+
+static int32_t abs32(int32_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+void hid_scroll_drag(hid_scroll_t *s, int32_t dpx, int64_t now_us)
+{
+    if (!s->dragging) {
+        // Toque nuevo: para la inercia anterior
+        s->fling = false;
+        s->vel = 0;
+        s->dragging = true;
+        s->last_us = 0;
+    }
+    int32_t q = dpx * ONE;
+    s->acc += q;
+
+    // Velocidad: media entre la anterior y la de esta muestra
+    if (s->last_us && now_us > s->last_us) {
+        int64_t inst = (int64_t)q * 1000000 / (now_us - s->last_us);
+        s->vel = (int32_t)((s->vel + inst) / 2);
+    }
+    s->last_us = now_us;
+}
+
+void hid_scroll_release(hid_scroll_t *s, int64_t now_us)
+{
+    bool fresh = s->last_us && now_us - s->last_us <= HID_SCROLL_STALE_MS * 1000;
+    s->dragging = false;
+    s->fling = fresh && abs32(s->vel) >= HID_SCROLL_FLING_MIN * s->px_per_detent;
+    if (!s->fling) s->vel = 0;
+    s->last_us = now_us;
+}
+
+void hid_scroll_stop(hid_scroll_t *s)
+{
+    s->acc = 0;
+    s->vel = 0;
+    s->fling = false;
+    s->dragging = false;
+}
+
+bool hid_scroll_active(const hid_scroll_t *s)
+{
+    return s->fling || abs32(s->acc) >= (int32_t)s->px_per_detent * ONE;
+}
+
+bool hid_scroll_step(hid_scroll_t *s, int64_t now_us, int8_t *wheel)
+{
+    if (s->fling && now_us > s->last_us) {
+        int64_t dt_ms = (now_us - s->last_us) / 1000;
+        if (dt_ms > 0) {
+            if (dt_ms > s->tau_ms) dt_ms = s->tau_ms;   // nunca invierte el sentido
+            s->acc += (int32_t)((int64_t)s->vel * dt_ms / 1000);
+            s->vel -= (int32_t)((int64_t)s->vel * dt_ms / s->tau_ms);
+            s->last_us += dt_ms * 1000;
+            if (abs32(s->vel) < HID_SCROLL_FLING_MIN / 2 * s->px_per_detent) {
+                s->fling = false;
+                s->vel = 0;
+            }
+        }
+    }
+
+    int32_t detent = (int32_t)s->px_per_detent * ONE;
+    int32_t whole = s->acc >= 0 ? s->acc / detent : -(-s->acc / detent);
+    if (whole == 0) {
+        if (!s->fling && !s->dragging) s->acc = 0;     // resto de la inercia
+        return false;
+    }
+    if (whole > 127) whole = 127;
+    if (whole < -127) whole = -127;
+    s->acc -= whole * detent;
+    *wheel = (int8_t)whole;
+    return true;
+}
@@ -0,0 +1,102 @@
+#include "unity.h"
+
+#include "hid_desc.h"
+#include "hid_kbd.h"
+
+#include <string.h>
+
+// Lo justo de un parser de report maps (items cortos) para comprobar lo
+// que vería el host: colecciones cerradas y bits de Input por Report ID
+typedef struct {
+  unsigned input_bits[8];
+  int32_t logical_max[8];     // del último Input de datos de cada id
+  unsigned collections;
+  bool ok;
+} parsed_t;
+
+static parsed_t parse(const uint8_t* d, size_t len) {
+  parsed_t p;
+  memset(&p, 0, sizeof(p));
+  unsigned id = 0, size = 0, count = 0, depth = 0;
+  int32_t lmax = 0;
+  size_t i = 0;
+  p.ok = true;
+  while (i < len) {
+    uint8_t b = d[i++];
+    unsigned n = (b & 3) == 3 ? 4 : (b & 3);
+    if (i + n > len || b == 0xFE) { p.ok = false; break; }
+    uint32_t v = 0;
+    for (unsigned k = 0; k < n; ++k) v |= (uint32_t)d[i + k] << (8 * k);
+    int32_t sv = n == 1 ? (int8_t)v : n == 2 ? (int16_t)v : (int32_t)v;
+    i += n;
+    switch (b & 0xFC) {
+      case 0x84: id = v; break;                  // Report ID
+      case 0x74: size = v; break;                // Report Size
+      case 0x94: count = v; break;               // Report Count
+      case 0x24: lmax = sv; break;               // Logical Maximum
+      case 0x80:                                 // Input
+        if (id >= 8) { p.ok = false; break; }
+        p.input_bits[id] += size * count;
+        if (!(v & 1)) p.logical_max[id] = lmax;
+        break;
+      case 0xA0: depth++; p.collections++; break;
+      case 0xC0: if (depth == 0) p.ok = false; else depth--; break;
+      default: break;
+    }
+  }
+  if (depth != 0) p.ok = false;
+  return p;
+}
+
+TEST_CASE("report map declares every report with its size", "[hid_desc]") {
+  uint8_t d[HID_DESC_MAX_LEN];
+  size_t len = hid_desc_build(HID_DESC_ALL, d, sizeof(d));
+  TEST_ASSERT_TRUE(len > 0);
+  parsed_t p = parse(d, len);
+  TEST_ASSERT_TRUE(p.ok);
+  TEST_ASSERT_EQUAL(6, p.collections);
+  TEST_ASSERT_EQUAL(8 * HID_MOUSE_REPORT_LEN, p.input_bits[HID_REPORT_ID_MOUSE]);
+  TEST_ASSERT_EQUAL(8 * HID_KBD_REPORT_LEN, p.input_bits[HID_REPORT_ID_KEYBOARD]);
+  TEST_ASSERT_EQUAL(8 * HID_ABS_REPORT_LEN, p.input_bits[HID_REPORT_ID_ABS]);
+  TEST_ASSERT_EQUAL(8 * HID_CONSUMER_REPORT_LEN, p.input_bits[HID_REPORT_ID_CONSUMER]);
+  TEST_ASSERT_EQUAL(HID_ABS_MAX, p.logical_max[HID_REPORT_ID_ABS]);
+  TEST_ASSERT_EQUAL(0, p.input_bits[0]);   // nada sin Report ID
+}
+
+TEST_CASE("report map only holds the collections asked for", "[hid_desc]") {
+  uint8_t d[HID_DESC_MAX_LEN];
+  size_t all = hid_desc_build(HID_DESC_ALL, d, sizeof(d));
+  size_t abs_only = hid_desc_build(HID_DESC_ABS, d, sizeof(d));
+  parsed_t p = parse(d, abs_only);
+  TEST_ASSERT_TRUE(p.ok);
+  TEST_ASSERT_EQUAL(0, p.input_bits[HID_REPORT_ID_MOUSE]);
+  TEST_ASSERT_EQUAL(40, p.input_bits[HID_REPORT_ID_ABS]);
+  size_t no_abs = hid_desc_build(HID_DESC_ALL & ~HID_DESC_ABS, d, sizeof(d));
+  TEST_ASSERT_EQUAL(all, abs_only + no_abs);
+  TEST_ASSERT_EQUAL(0, hid_desc_build(HID_DESC_ALL, d, all - 1));
+  TEST_ASSERT_EQUAL(0, hid_desc_build(0, d, sizeof(d)));
+}
+
+TEST_CASE("touch coordinates scale to the full absolute range", "[hid_desc]") {
+  // Área de 390 px empezando en x=10
+  TEST_ASSERT_EQUAL(0, hid_abs_scale(10, 10, 390));
+  TEST_ASSERT_EQUAL(HID_ABS_MAX, hid_abs_scale(399, 10, 390));
+  TEST_ASSERT_EQUAL(0, hid_abs_scale(-50, 10, 390));            // fuera: recorta
+  TEST_ASSERT_EQUAL(HID_ABS_MAX, hid_abs_scale(5000, 10, 390));
+  TEST_ASSERT_EQUAL(16384, hid_abs_scale(195, 0, 391));       // centro, redondeado
+  TEST_ASSERT_EQUAL(0, hid_abs_scale(3, 0, 1));
+
+  // Monótona y sin huecos mayores que un paso
+  uint16_t prev = 0;
+  for (int32_t x = 10; x < 400; ++x) {
+    uint16_t s = hid_abs_scale(x, 10, 390);
+    TEST_ASSERT_TRUE(s >= prev);
+    TEST_ASSERT_TRUE(s - prev <= HID_ABS_MAX / 389 + 1);
+    prev = s;
+  }
+
+  uint8_t r[HID_ABS_REPORT_LEN];
+  hid_abs_report(r, 0xFF, 0x1234, HID_ABS_MAX);
+  static const uint8_t want[] = {0x07, 0x34, 0x12, 0xFF, 0x7F};
+  TEST_ASSERT_EQUAL_MEMORY(want, r, sizeof(want));
+}
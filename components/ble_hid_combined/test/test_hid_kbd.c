@@ -0,0 +1,224 @@
+#include "unity.h"
+
+#include "hid_kbd.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+// Host simulado con el layout dado: escribe un carácter cuando aparece una
+// tecla que no estaba en el report anterior, con el modificador de ese
+// report. Una tecla muerta se guarda y se combina con la pulsación
+// siguiente, como hace el host.
+static bool same_stroke(hid_kbd_stroke_t a, hid_kbd_stroke_t b) {
+  return a.mod == b.mod && a.key == b.key;
+}
+
+// Latin-1 y los pocos caracteres de fuera que tienen los layouts
+static const uint32_t k_beyond_latin1[] = { 0x20AC };
+
+static bool chord_is(hid_kbd_layout_t layout, uint32_t cp, hid_kbd_stroke_t dead,
+                     hid_kbd_stroke_t key) {
+  hid_kbd_chord_t c;
+  return hid_keymap_lookup(layout, cp, &c) && same_stroke(c.dead, dead) && same_stroke(c.key, key);
+}
+
+static uint32_t host_char(hid_kbd_layout_t layout, hid_kbd_stroke_t dead, hid_kbd_stroke_t key) {
+  for (uint32_t cp = 1; cp < 256; ++cp) {
+    if (chord_is(layout, cp, dead, key)) return cp;
+  }
+  for (size_t i = 0; i < sizeof(k_beyond_latin1) / sizeof(k_beyond_latin1[0]); ++i) {
+    if (chord_is(layout, k_beyond_latin1[i], dead, key)) return k_beyond_latin1[i];
+  }
+  return '?';
+}
+
+static bool host_is_dead(hid_kbd_layout_t layout, hid_kbd_stroke_t s) {
+  hid_kbd_chord_t c;
+  for (uint32_t cp = 1; cp < 256; ++cp) {
+    if (hid_keymap_lookup(layout, cp, &c) && c.dead.key && same_stroke(c.dead, s)) return true;
+  }
+  return false;
+}
+
+static size_t put_utf8(char* out, size_t len, size_t cap, uint32_t cp) {
+  char b[4];
+  size_t n;
+  if (cp < 0x80) {
+    b[0] = (char)cp; n = 1;
+  } else if (cp < 0x800) {
+    b[0] = (char)(0xC0 | cp >> 6); b[1] = (char)(0x80 | (cp & 0x3F)); n = 2;
+  } else {
+    b[0] = (char)(0xE0 | cp >> 12); b[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    b[2] = (char)(0x80 | (cp & 0x3F)); n = 3;
+  }
+  if (len + n < cap) {
+    memcpy(out + len, b, n);
+    len += n;
+  }
+  return len;
+}
+
+static unsigned type_on_host(hid_kbd_layout_t layout, const char* text, char* out, size_t cap) {
+  hid_kbd_seq_t seq;
+  uint8_t rep[HID_KBD_REPORT_LEN], prev[HID_KBD_REPORT_LEN] = {0};
+  hid_kbd_stroke_t dead = {0};
+  unsigned n = 0;
+  size_t len = 0;
+  hid_kbd_seq_init(&seq, text, layout);
+  while (hid_kbd_seq_next(&seq, rep)) {
+    for (int i = 3; i < HID_KBD_REPORT_LEN; ++i) TEST_ASSERT_EQUAL(0, rep[i]);
+    if (rep[2] && rep[2] != prev[2]) {
+      hid_kbd_stroke_t s = {rep[0], rep[2]};
+      if (!dead.key && host_is_dead(layout, s)) {
+        dead = s;
+      } else {
+        len = put_utf8(out, len, cap, host_char(layout, dead, s));
+        dead = (hid_kbd_stroke_t){0};
+      }
+    }
+    memcpy(prev, rep, sizeof(rep));
+    n++;
+  }
+  TEST_ASSERT_EQUAL(0, prev[0]);
+  TEST_ASSERT_EQUAL(0, prev[2]);            // termina con todo suelto
+  TEST_ASSERT_EQUAL(0, dead.key);           // ninguna tecla muerta colgando
+  out[len] = '\0';
+  return n;
+}
+
+static size_t typed(hid_kbd_layout_t layout, const char* text) {
+  hid_kbd_seq_t seq;
+  uint8_t rep[HID_KBD_REPORT_LEN];
+  hid_kbd_seq_init(&seq, text, layout);
+  while (hid_kbd_seq_next(&seq, rep)) {
+  }
+  return seq.typed;
+}
+
+TEST_CASE("typed text reaches the host unchanged", "[hid_kbd]") {
+  static const char* texts[] = {
+    "hello", "aaa", "Hello World", "HELLO", "hElLo", "11 22",
+    "Mississippi", "ab\ncd", "a!1!A", "",
+    "~!@#$%^&*()_+{}|:\"<>? `-=[]\\;',./",
+  };
+  char out[64];
+  for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i) {
+    type_on_host(HID_KBD_LAYOUT_US, texts[i], out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING(texts[i], out);
+    type_on_host(HID_KBD_LAYOUT_ES, texts[i], out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING(texts[i], out);
+  }
+}
+
+TEST_CASE("spanish text with dead keys reaches an ES host", "[hid_kbd]") {
+  static const char* texts[] = {
+    "¿Qué tal? ¡Año nuevo, pingüino!",
+    "ÁÉÍÓÚ áéíóú Ññ Çç Üü",
+    "À bientôt, très grâce, naïve",
+    "5 € · 1º 2ª ¬ ´ ¨ ^ `",
+    "TRÉBOLES de CORAZÓN",
+  };
+  char out[96];
+  for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i) {
+    type_on_host(HID_KBD_LAYOUT_ES, texts[i], out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING(texts[i], out);
+  }
+}
+
+TEST_CASE("every character of a layout types back to itself", "[hid_kbd]") {
+  for (int l = 0; l < HID_KBD_LAYOUT_COUNT; ++l) {
+    unsigned n = 0;
+    for (uint32_t cp = 0x20; cp < 0x10000; ++cp) {
+      hid_kbd_chord_t c;
+      if (!hid_keymap_lookup((hid_kbd_layout_t)l, cp, &c)) continue;
+      char in[8], out[8];
+      in[put_utf8(in, 0, sizeof(in), cp)] = '\0';
+      type_on_host((hid_kbd_layout_t)l, in, out, sizeof(out));
+      TEST_ASSERT_EQUAL_STRING(in, out);
+      n++;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(95, n);    // al menos todo el ASCII imprimible
+  }
+}
+
+TEST_CASE("release only between repeats and modifier changes", "[hid_kbd]") {
+  char out[64];
+  TEST_ASSERT_EQUAL(7, type_on_host(HID_KBD_LAYOUT_US, "hello", out, sizeof(out)));   // h e l - l o -
+  TEST_ASSERT_EQUAL(6, type_on_host(HID_KBD_LAYOUT_US, "aaa", out, sizeof(out)));
+  TEST_ASSERT_EQUAL(4, type_on_host(HID_KBD_LAYOUT_US, "aB", out, sizeof(out)));      // a - B -
+  TEST_ASSERT_EQUAL(3, type_on_host(HID_KBD_LAYOUT_US, "AB", out, sizeof(out)));
+  TEST_ASSERT_EQUAL(0, type_on_host(HID_KBD_LAYOUT_US, "", out, sizeof(out)));
+  // Tecla muerta y letra: ´ a -
+  TEST_ASSERT_EQUAL(3, type_on_host(HID_KBD_LAYOUT_ES, "á", out, sizeof(out)));
+  TEST_ASSERT_EQUAL(5, type_on_host(HID_KBD_LAYOUT_ES, "éé", out, sizeof(out)));
+  // Mayúscula: ´ - Shift+A -
+  TEST_ASSERT_EQUAL(4, type_on_host(HID_KBD_LAYOUT_ES, "Á", out, sizeof(out)));
+}
+
+TEST_CASE("characters without a key are skipped or replaced", "[hid_kbd]") {
+  char out[64];
+  // Control, muñeco de nieve, DEL y byte suelto: sin tecla
+  TEST_ASSERT_EQUAL(3, type_on_host(HID_KBD_LAYOUT_US, "\x01" "\xe2\x98\x83" "ab\x7f\xff", out,
+                                    sizeof(out)));
+  TEST_ASSERT_EQUAL_STRING("ab", out);
+  TEST_ASSERT_EQUAL(2, typed(HID_KBD_LAYOUT_US, "\x01" "\xe2\x98\x83" "ab\x7f\xff"));
+  TEST_ASSERT_EQUAL(0, typed(HID_KBD_LAYOUT_US, NULL));
+
+  // US no tiene acentos: sale la letra sola
+  type_on_host(HID_KBD_LAYOUT_US, "TRÉBOLES “año” – ¡ya!", out, sizeof(out));
+  TEST_ASSERT_EQUAL_STRING("TREBOLES \"ano\" - ya!", out);
+  // ES no tiene tilde ni comillas tipográficas
+  type_on_host(HID_KBD_LAYOUT_ES, "São “ok”", out, sizeof(out));
+  TEST_ASSERT_EQUAL_STRING("Sao \"ok\"", out);
+}
+
+TEST_CASE("reports per character", "[hid_kbd][bench]") {
+  // Texto típico del truco de magia
+  static const char* text = "The card you chose is the Queen of Hearts, 7 of Clubs and Ace of Spades";
+  char out[96];
+  int64_t t0 = esp_timer_get_time();
+  unsigned reports = 0;
+  for (int i = 0; i < 1000; ++i) reports = type_on_host(HID_KBD_LAYOUT_US, text, out, sizeof(out));
+  int64_t dt = esp_timer_get_time() - t0;
+  TEST_ASSERT_EQUAL_STRING(text, out);
+
+  size_t chars = typed(HID_KBD_LAYOUT_US, text);
+  // Un report por evento de conexión (7.5 ms) frente a 2 x 20 ms por carácter antes
+  unsigned cps_new = (unsigned)(chars * 1000 * 1000 / (reports * 7500));
+  unsigned cps_old = 1000 / 40;
+  printf("hid_kbd: %u chars -> %u reports (%u before), ~%u chars/s at 7.5 ms vs %u chars/s, "
+         "%u ns/report\n",
+         (unsigned)chars, reports, (unsigned)(2 * chars), cps_new, cps_old,
+         (unsigned)(dt * 1000 / (1000 * reports)));
+  TEST_ASSERT_LESS_THAN(2 * chars, reports);
+}
+
+TEST_CASE("encode throughput", "[hid_kbd][bench]") {
+  // Solo el encoder (sin host simulado): UTF-8 -> reports, layout ES
+  static const char* text =
+      "El As de Corazones, la Reina de Tréboles y el Siete de Picas: ¿cuál has elegido? "
+      "Pingüino, año, corazón, ÉXITO.";
+  const int rounds = 20000;
+  hid_kbd_seq_t seq;
+  uint8_t rep[HID_KBD_REPORT_LEN];
+  unsigned reports = 0, sum = 0;
+
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < rounds; ++i) {
+    hid_kbd_seq_init(&seq, text, HID_KBD_LAYOUT_ES);
+    while (hid_kbd_seq_next(&seq, rep)) {
+      reports++;
+      sum += rep[2];
+    }
+  }
+  int64_t dt = esp_timer_get_time() - t0;
+
+  size_t chars = seq.typed;
+  printf("hid_kbd: ES encode %u chars -> %u reports, %u ns/char, %u ns/report (sum %u)\n",
+         (unsigned)chars, reports / rounds,
+         (unsigned)(dt * 1000 / ((int64_t)chars * rounds)),
+         (unsigned)(dt * 1000 / reports), sum);
+  TEST_ASSERT_EQUAL(strlen(text) - 7, chars);   // 7 caracteres de 2 bytes
+  TEST_ASSERT_GREATER_THAN(chars, reports / rounds);
+}
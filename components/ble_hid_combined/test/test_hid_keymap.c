@@ -0,0 +1,95 @@
+#include "unity.h"
+
+#include "hid_keymap.h"
+
+#define S   HID_KBD_MOD_LSHIFT
+#define AG  HID_KBD_MOD_RALT
+
+static void assert_chord(hid_kbd_layout_t layout, uint32_t cp, uint8_t dead_mod, uint8_t dead_key,
+                         uint8_t mod, uint8_t key) {
+  hid_kbd_chord_t c;
+  TEST_ASSERT_TRUE(hid_keymap_lookup(layout, cp, &c));
+  TEST_ASSERT_EQUAL_HEX8(dead_mod, c.dead.mod);
+  TEST_ASSERT_EQUAL_HEX8(dead_key, c.dead.key);
+  TEST_ASSERT_EQUAL_HEX8(mod, c.key.mod);
+  TEST_ASSERT_EQUAL_HEX8(key, c.key.key);
+}
+
+TEST_CASE("US layout keys", "[hid_keymap]") {
+  assert_chord(HID_KBD_LAYOUT_US, 'a', 0, 0, 0, 0x04);
+  assert_chord(HID_KBD_LAYOUT_US, 'Z', 0, 0, S, 0x1D);
+  assert_chord(HID_KBD_LAYOUT_US, '@', 0, 0, S, 0x1F);
+  assert_chord(HID_KBD_LAYOUT_US, '?', 0, 0, S, 0x38);
+  assert_chord(HID_KBD_LAYOUT_US, '"', 0, 0, S, 0x34);
+  assert_chord(HID_KBD_LAYOUT_US, '\n', 0, 0, 0, 0x28);
+
+  hid_kbd_chord_t c;
+  TEST_ASSERT_FALSE(hid_keymap_lookup(HID_KBD_LAYOUT_US, 0xF1, &c));     // ñ
+  TEST_ASSERT_FALSE(hid_keymap_lookup(HID_KBD_LAYOUT_US, 0x7F, &c));
+  TEST_ASSERT_FALSE(hid_keymap_lookup(HID_KBD_LAYOUT_US, 0x20AC, &c));
+}
+
+TEST_CASE("ES layout keys and dead keys", "[hid_keymap]") {
+  assert_chord(HID_KBD_LAYOUT_ES, 'a', 0, 0, 0, 0x04);
+  assert_chord(HID_KBD_LAYOUT_ES, '@', 0, 0, AG, 0x1F);
+  assert_chord(HID_KBD_LAYOUT_ES, '?', 0, 0, S, 0x2D);
+  assert_chord(HID_KBD_LAYOUT_ES, '"', 0, 0, S, 0x1F);
+  assert_chord(HID_KBD_LAYOUT_ES, '-', 0, 0, 0, 0x38);
+  assert_chord(HID_KBD_LAYOUT_ES, 0xF1, 0, 0, 0, 0x33);                  // ñ
+  assert_chord(HID_KBD_LAYOUT_ES, 0xBF, 0, 0, S, 0x2E);                  // ¿
+  assert_chord(HID_KBD_LAYOUT_ES, 0x20AC, 0, 0, AG, 0x08);               // €
+  // Vocales con tecla muerta: acento y después la letra
+  assert_chord(HID_KBD_LAYOUT_ES, 0xE1, 0, 0x34, 0, 0x04);               // á
+  assert_chord(HID_KBD_LAYOUT_ES, 0xC9, 0, 0x34, S, 0x08);               // É
+  assert_chord(HID_KBD_LAYOUT_ES, 0xFC, S, 0x34, 0, 0x18);               // ü
+  assert_chord(HID_KBD_LAYOUT_ES, 0xE0, 0, 0x2F, 0, 0x04);               // à
+  assert_chord(HID_KBD_LAYOUT_ES, 0xF4, S, 0x2F, 0, 0x12);               // ô
+  // El acento solo: tecla muerta y espacio
+  assert_chord(HID_KBD_LAYOUT_ES, '^', S, 0x2F, 0, 0x2C);
+  assert_chord(HID_KBD_LAYOUT_ES, 0xB4, 0, 0x34, 0, 0x2C);               // ´
+}
+
+TEST_CASE("missing characters fall back to ASCII", "[hid_keymap]") {
+  hid_kbd_chord_t c;
+  TEST_ASSERT_TRUE(hid_keymap_encode(HID_KBD_LAYOUT_US, 0xE9, &c));      // é -> e
+  TEST_ASSERT_EQUAL_HEX8(0, c.dead.key);
+  TEST_ASSERT_EQUAL_HEX8(0x08, c.key.key);
+  TEST_ASSERT_TRUE(hid_keymap_encode(HID_KBD_LAYOUT_US, 0xD1, &c));      // Ñ -> N
+  TEST_ASSERT_EQUAL_HEX8(S, c.key.mod);
+  TEST_ASSERT_EQUAL_HEX8(0x11, c.key.key);
+  TEST_ASSERT_TRUE(hid_keymap_encode(HID_KBD_LAYOUT_ES, 0x201C, &c));    // “ -> "
+  TEST_ASSERT_EQUAL_HEX8(S, c.key.mod);
+  TEST_ASSERT_EQUAL_HEX8(0x1F, c.key.key);
+  // ES tiene é: no se sustituye
+  TEST_ASSERT_TRUE(hid_keymap_encode(HID_KBD_LAYOUT_ES, 0xE9, &c));
+  TEST_ASSERT_EQUAL_HEX8(0x34, c.dead.key);
+
+  TEST_ASSERT_FALSE(hid_keymap_encode(HID_KBD_LAYOUT_US, 0xD7, &c));     // ×
+  TEST_ASSERT_FALSE(hid_keymap_encode(HID_KBD_LAYOUT_ES, 0x2603, &c));   // ☃
+  TEST_ASSERT_FALSE(hid_keymap_encode(HID_KBD_LAYOUT_COUNT, 'a', &c));
+}
+
+TEST_CASE("utf8 decoding", "[hid_keymap]") {
+  const char* p = "a\xc3\xb1\xe2\x82\xac\xf0\x9f\x98\x80";   // a ñ € 😀
+  TEST_ASSERT_EQUAL('a', hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0xF1, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0x20AC, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0x1F600, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0, hid_utf8_next(&p));       // se queda al final
+
+  // Mal formados: un U+FFFD por byte que no encaja
+  p = "\xc0\xaf" "b";                             // overlong
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL('b', hid_utf8_next(&p));
+  p = "\xed\xa0\x80";                             // surrogate
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0, hid_utf8_next(&p));
+  p = "\xe2\x82";                                 // cortado al final
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0xFFFD, hid_utf8_next(&p));
+  TEST_ASSERT_EQUAL(0, hid_utf8_next(&p));
+}
@@ -0,0 +1,53 @@
+#include "unity.h"
+
+#include "hid_lat.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return x < y ? -1 : x > y;
+}
+
+TEST_CASE("small latencies are exact", "[hid_lat]") {
+  hid_lat_hist_t h;
+  memset(&h, 0, sizeof(h));
+  TEST_ASSERT_EQUAL(0, hid_lat_percentile(&h, 50));
+  for (uint32_t us = 1; us <= 10; ++us) hid_lat_add(&h, us);
+  TEST_ASSERT_EQUAL(5, hid_lat_percentile(&h, 50));
+  TEST_ASSERT_EQUAL(10, hid_lat_percentile(&h, 95));
+  TEST_ASSERT_EQUAL(10, hid_lat_percentile(&h, 100));
+  TEST_ASSERT_EQUAL(1, hid_lat_percentile(&h, 0));
+  TEST_ASSERT_EQUAL(55, (uint32_t)h.sum_us);
+}
+
+TEST_CASE("percentiles stay within one bucket of the exact value", "[hid_lat]") {
+  static uint32_t v[5000];
+  hid_lat_hist_t h;
+  memset(&h, 0, sizeof(h));
+  srand(7);
+  for (int i = 0; i < 5000; ++i) {
+    // Sobre todo 5-30 ms, con una cola larga
+    v[i] = 5000 + rand() % 25000 + (i % 50 == 0 ? rand() % 200000 : 0);
+    hid_lat_add(&h, v[i]);
+  }
+  qsort(v, 5000, sizeof(v[0]), cmp_u32);
+  static const unsigned pcts[] = {50, 95, 99};
+  for (unsigned i = 0; i < 3; ++i) {
+    uint32_t exact = v[(5000 * pcts[i] + 99) / 100 - 1];
+    uint32_t got = hid_lat_percentile(&h, pcts[i]);
+    TEST_ASSERT_TRUE(got >= exact);
+    TEST_ASSERT_TRUE(got - exact <= exact / 8);
+  }
+  TEST_ASSERT_EQUAL(v[4999], hid_lat_percentile(&h, 100));
+}
+
+TEST_CASE("huge latencies land in the last bucket", "[hid_lat]") {
+  hid_lat_hist_t h;
+  memset(&h, 0, sizeof(h));
+  hid_lat_add(&h, 5000000);
+  hid_lat_add(&h, UINT32_MAX);
+  TEST_ASSERT_EQUAL(2, h.bucket[HID_LAT_BUCKETS - 1]);
+  TEST_ASSERT_EQUAL(UINT32_MAX, hid_lat_percentile(&h, 99));
+}
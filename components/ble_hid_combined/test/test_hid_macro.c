@@ -0,0 +1,121 @@
+#include "unity.h"
+
+#include "hid_desc.h"
+#include "hid_kbd.h"
+#include "hid_macro.h"
+#include "hid_scroll.h"
+
+#include <string.h>
+
+TEST_CASE("default table maps every gesture once", "[hid_macro]") {
+  size_t n;
+  const hid_macro_t* t = hid_macro_default_table(&n);
+  for (int g = 0; g < HID_GESTURE_COUNT; ++g) {
+    const hid_macro_t* m = hid_macro_find(t, n, (hid_gesture_t)g);
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_EQUAL(g, m->gesture);
+  }
+  TEST_ASSERT_NULL(hid_macro_find(t, n, HID_GESTURE_COUNT));
+  TEST_ASSERT_NULL(hid_macro_find(NULL, 0, HID_GESTURE_WRIST_FLICK_LEFT));
+}
+
+TEST_CASE("shortcut and media key streams press then release", "[hid_macro]") {
+  size_t n;
+  const hid_macro_t* t = hid_macro_default_table(&n);
+  hid_macro_report_t r[HID_MACRO_MAX_REPORTS];
+
+  // Borde izquierdo hacia dentro: Alt + Izquierda (atrás)
+  TEST_ASSERT_EQUAL(2, hid_macro_expand(hid_macro_find(t, n, HID_GESTURE_EDGE_SWIPE_RIGHT), r));
+  static const uint8_t back[HID_KBD_REPORT_LEN] = {HID_MOD_LALT, 0, HID_KEY_LEFT_ARROW};
+  static const uint8_t none[HID_KBD_REPORT_LEN] = {0};
+  TEST_ASSERT_EQUAL(HID_REPORT_ID_KEYBOARD, r[0].report_id);
+  TEST_ASSERT_EQUAL(HID_KBD_REPORT_LEN, r[0].len);
+  TEST_ASSERT_EQUAL_MEMORY(back, r[0].data, HID_KBD_REPORT_LEN);
+  TEST_ASSERT_EQUAL(HID_REPORT_ID_KEYBOARD, r[1].report_id);
+  TEST_ASSERT_EQUAL_MEMORY(none, r[1].data, HID_KBD_REPORT_LEN);
+
+  // Giro de muñeca a la derecha: pista siguiente (0x00B5) y soltar
+  TEST_ASSERT_EQUAL(2, hid_macro_expand(hid_macro_find(t, n, HID_GESTURE_WRIST_FLICK_RIGHT), r));
+  TEST_ASSERT_EQUAL(HID_REPORT_ID_CONSUMER, r[0].report_id);
+  TEST_ASSERT_EQUAL(HID_CONSUMER_REPORT_LEN, r[0].len);
+  TEST_ASSERT_EQUAL(0xB5, r[0].data[0]);
+  TEST_ASSERT_EQUAL(0x00, r[0].data[1]);
+  TEST_ASSERT_EQUAL(HID_REPORT_ID_CONSUMER, r[1].report_id);
+  TEST_ASSERT_EQUAL(0, r[1].data[0] | r[1].data[1]);
+
+  // La rueda no se expande aquí
+  TEST_ASSERT_EQUAL(0, hid_macro_expand(hid_macro_find(t, n, HID_GESTURE_SCROLL_DRAG), r));
+  TEST_ASSERT_EQUAL(0, hid_macro_expand(NULL, r));
+}
+
+// Corre la rueda como la tarea HID: un paso cada HID_SCROLL_TICK_MS
+static int run_scroll(hid_scroll_t* s, int64_t* now, int8_t* out, int cap, int* sum) {
+  int n = 0;
+  int8_t w;
+  for (int i = 0; i < 1000 && hid_scroll_active(s); ++i) {
+    *now += HID_SCROLL_TICK_MS * 1000;
+    if (hid_scroll_step(s, *now, &w)) {
+      if (n < cap) out[n] = w;
+      n++;
+      *sum += w;
+    }
+  }
+  return n;
+}
+
+TEST_CASE("slow drag scrolls exactly, without momentum", "[hid_macro]") {
+  hid_scroll_t s;
+  hid_scroll_init(&s, 24, 300);
+  int64_t now = 0;
+  int sum = 0;
+  int8_t out[64];
+  int8_t w;
+  for (int i = 0; i < 48; ++i) {                  // 240 px en 480 ms: 10 pasos
+    now += 10000;
+    hid_scroll_drag(&s, 5, now);
+    if (hid_scroll_step(&s, now, &w)) sum += w;
+  }
+  now += 200000;                                   // el dedo se para antes de soltar
+  hid_scroll_release(&s, now);
+  run_scroll(&s, &now, out, 64, &sum);
+  TEST_ASSERT_EQUAL(10, sum);
+  TEST_ASSERT_FALSE(hid_scroll_active(&s));
+}
+
+TEST_CASE("fling keeps scrolling and slows down", "[hid_macro]") {
+  hid_scroll_t s;
+  hid_scroll_init(&s, 24, 300);
+  int64_t now = 0;
+  int sum = 0;
+  int8_t w;
+  for (int i = 0; i < 10; ++i) {                  // 40 px cada 16 ms: ~100 pasos/s
+    now += 16000;
+    hid_scroll_drag(&s, -40, now);
+    while (hid_scroll_step(&s, now, &w)) sum += w;
+  }
+  TEST_ASSERT_EQUAL(-16, sum);                     // 400 / 24
+  hid_scroll_release(&s, now);
+  TEST_ASSERT_TRUE(hid_scroll_active(&s));
+
+  int8_t out[256];
+  int tail = 0;
+  int n = run_scroll(&s, &now, out, 256, &tail);
+  TEST_ASSERT_TRUE(n > 3);
+  TEST_ASSERT_TRUE(tail <= -20 && tail >= -40);    // ~ v * tau = 30 pasos
+  for (int i = 0; i < n && i < 256; ++i) TEST_ASSERT_TRUE(out[i] < 0);   // siempre el mismo sentido
+  TEST_ASSERT_TRUE(out[0] <= out[n - 1]);          // frena: pasos más cortos al final
+  TEST_ASSERT_FALSE(hid_scroll_active(&s));
+  TEST_ASSERT_TRUE(now < 3000000);                 // se para sola
+
+  // Un toque nuevo corta la inercia
+  hid_scroll_release(&s, now);
+  for (int i = 0; i < 5; ++i) {
+    now += 16000;
+    hid_scroll_drag(&s, 40, now);
+  }
+  hid_scroll_release(&s, now);
+  TEST_ASSERT_TRUE(hid_scroll_active(&s));
+  hid_scroll_drag(&s, 0, now + 1000);
+  hid_scroll_stop(&s);
+  TEST_ASSERT_FALSE(hid_scroll_active(&s));
+}
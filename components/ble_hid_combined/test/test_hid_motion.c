@@ -0,0 +1,137 @@
+#include "unity.h"
+
+#include "hid_motion.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Curva plana: ganancia fija, sin aceleración
+static hid_motion_t flat(uint16_t gain) {
+  hid_motion_curve_t c = {gain, gain, 0, 0};
+  hid_motion_t m;
+  hid_motion_init(&m, &c);
+  return m;
+}
+
+// Vacía el acumulador; devuelve el número de reports
+static int drain(hid_motion_t* m, int64_t now, int32_t* sx, int32_t* sy) {
+  int8_t dx, dy;
+  int n = 0;
+  while (hid_motion_take(m, &dx, &dy, now)) {
+    TEST_ASSERT_TRUE(dx != -128 && dy != -128);
+    *sx += dx;
+    *sy += dy;
+    n++;
+  }
+  return n;
+}
+
+TEST_CASE("sub-pixel deltas add up", "[hid_motion]") {
+  hid_motion_t m = flat(HID_MOTION_ONE / 2);
+  int32_t sx = 0, sy = 0;
+  for (int i = 0; i < 1000; ++i) {
+    hid_motion_add(&m, 1, -1, (i + 1) * 10000);
+    drain(&m, (i + 1) * 10000, &sx, &sy);
+  }
+  // dx / 2 por muestra habría dado 0
+  TEST_ASSERT_EQUAL(500, sx);
+  TEST_ASSERT_EQUAL(-500, sy);
+  TEST_ASSERT_EQUAL(500, m.stats.reports);
+}
+
+TEST_CASE("large deltas split into 127 steps without loss", "[hid_motion]") {
+  hid_motion_t m = flat(HID_MOTION_ONE);
+  int32_t sx = 0, sy = 0;
+  hid_motion_add(&m, 500, -300, 1000);
+  TEST_ASSERT_EQUAL(4, drain(&m, 2000, &sx, &sy));
+  TEST_ASSERT_EQUAL(500, sx);
+  TEST_ASSERT_EQUAL(-300, sy);
+  TEST_ASSERT_EQUAL(3, m.stats.splits);
+  TEST_ASSERT_EQUAL(0, m.stats.dropped_px);
+}
+
+TEST_CASE("pending motion saturates and counts the rest", "[hid_motion]") {
+  hid_motion_t m = flat(HID_MOTION_ONE);
+  hid_motion_add(&m, HID_MOTION_MAX_PENDING + 100, -(HID_MOTION_MAX_PENDING + 7), 1000);
+  TEST_ASSERT_EQUAL(107, m.stats.dropped_px);
+  int32_t sx = 0, sy = 0;
+  drain(&m, 2000, &sx, &sy);
+  TEST_ASSERT_EQUAL(HID_MOTION_MAX_PENDING, sx);
+  TEST_ASSERT_EQUAL(-HID_MOTION_MAX_PENDING, sy);
+}
+
+TEST_CASE("stroke end drops only the fraction", "[hid_motion]") {
+  hid_motion_t m = flat(HID_MOTION_ONE / 2);
+  hid_motion_add(&m, 3, -3, 1000);            // 1.5, -1.5
+  hid_motion_end(&m);
+  int32_t sx = 0, sy = 0;
+  drain(&m, 2000, &sx, &sy);
+  TEST_ASSERT_EQUAL(1, sx);
+  TEST_ASSERT_EQUAL(-1, sy);
+  hid_motion_add(&m, 1, 1, 3000);             // 0.5: sin el resto anterior
+  TEST_ASSERT_FALSE(hid_motion_pending(&m));
+}
+
+TEST_CASE("acceleration curve", "[hid_motion]") {
+  hid_motion_curve_t c = hid_motion_default_curve();
+  TEST_ASSERT_EQUAL(c.base_gain, hid_motion_gain(&c, 0));
+  TEST_ASSERT_EQUAL(c.base_gain, hid_motion_gain(&c, c.accel_start));
+  TEST_ASSERT_EQUAL(c.max_gain, hid_motion_gain(&c, c.accel_full));
+  TEST_ASSERT_EQUAL(c.max_gain, hid_motion_gain(&c, 100000));
+  TEST_ASSERT_EQUAL((c.base_gain + c.max_gain) / 2,
+                    hid_motion_gain(&c, (c.accel_start + c.accel_full) / 2));
+  uint32_t prev = 0;
+  for (uint32_t s = 0; s < 3000; s += 10) {
+    TEST_ASSERT_TRUE(hid_motion_gain(&c, s) >= prev);
+    prev = hid_motion_gain(&c, s);
+  }
+
+  // Lento: como antes (0.5x); rápido: 1.5x
+  hid_motion_t m;
+  hid_motion_init(&m, NULL);
+  int32_t sx = 0, sy = 0;
+  hid_motion_add(&m, 2, 0, 10000);            // primera muestra: ganancia base
+  hid_motion_add(&m, 2, 0, 20000);            // 200 px/s
+  drain(&m, 20000, &sx, &sy);
+  TEST_ASSERT_EQUAL(2, sx);
+  sx = 0;
+  hid_motion_add(&m, 40, 0, 30000);           // 4000 px/s
+  drain(&m, 30000, &sx, &sy);
+  TEST_ASSERT_EQUAL(60, sx);
+}
+
+TEST_CASE("one report per connection event", "[hid_motion][bench]") {
+  // Táctil a 60 Hz con un trazo rápido hacia la derecha, eventos de conexión cada 7.5 ms
+  hid_motion_t m = flat(HID_MOTION_ONE / 2);
+  srand(42);
+  int64_t next_touch = 0, next_event = 7500;
+  int32_t in_x = 0, sx = 0, sy = 0, legacy = 0;
+  int events = 0;
+  while (next_touch < 2000000) {
+    if (next_touch <= next_event) {
+      int32_t dx = 1 + rand() % 400;         // a veces más de 254: el recorte perdía
+      hid_motion_add(&m, dx, 0, next_touch);
+      in_x += dx;
+      int32_t old = dx / 2;                   // camino anterior: truncar y recortar
+      legacy += old > 127 ? 127 : old < -127 ? -127 : old;
+      next_touch += 16667;
+    } else {
+      int8_t dx, dy;
+      if (hid_motion_take(&m, &dx, &dy, next_event)) {
+        sx += dx;
+        sy += dy;
+      }
+      events++;
+      next_event += 7500;
+    }
+  }
+  drain(&m, next_event, &sx, &sy);
+  TEST_ASSERT_TRUE(abs(in_x / 2 - sx) <= 1);
+  TEST_ASSERT_TRUE(m.stats.splits > 0);
+  TEST_ASSERT_EQUAL(0, m.stats.dropped_px);
+  printf("hid_motion: %u samples -> %u reports (%u splits), error %d px vs %d px before, "
+         "latency avg %u us max %u us\n",
+         (unsigned)m.stats.samples, (unsigned)m.stats.reports, (unsigned)m.stats.splits,
+         (int)(in_x / 2 - sx), (int)(in_x / 2 - legacy),
+         (unsigned)(m.stats.latency_sum_us / m.stats.reports), (unsigned)m.stats.latency_max_us);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Advertising governor: how hard the watch advertises while nobody is
+// connected. Three tiers:
+//   fast     BLE_ADV_GOV_FAST_ITVL_*, right after a disconnect (and at
+//            start), for a moment after the screen turns on, and during a
+//            "pair now" burst
+//   slow     BLE_ADV_GOV_SLOW_ITVL_*, while the screen is on or charging,
+//            and for BLE_ADV_GOV_SLOW_MS after the screen went off
+//   paused   not advertising; waking the screen brings back fast
+// Below BLE_ADV_GOV_LOW_BATT_PCT there is no fast tier and below
+// BLE_ADV_GOV_CRITICAL_BATT_PCT nothing is advertised, unless charging.
+// "Pair now" overrides both.
+// Plain C, no locking (ble_host.c holds a lock around it), tested on the
+// host. Times are in ms on any monotonic clock.
+
+#ifndef BLE_ADV_GOV_FAST_MS
+#define BLE_ADV_GOV_FAST_MS             5000
+#endif
+#ifndef BLE_ADV_GOV_PAIRING_FAST_MS
+#define BLE_ADV_GOV_PAIRING_FAST_MS     30000   // nothing bonded yet
+#endif
+#ifndef BLE_ADV_GOV_WAKE_FAST_MS
+#define BLE_ADV_GOV_WAKE_FAST_MS        3000
+#endif
+#ifndef BLE_ADV_GOV_SLOW_MS
+#define BLE_ADV_GOV_SLOW_MS             (10 * 60 * 1000)
+#endif
+#ifndef BLE_ADV_GOV_PAIR_BURST_MS
+#define BLE_ADV_GOV_PAIR_BURST_MS       60000
+#endif
+#ifndef BLE_ADV_GOV_LOW_BATT_PCT
+#define BLE_ADV_GOV_LOW_BATT_PCT        20
+#endif
+#ifndef BLE_ADV_GOV_CRITICAL_BATT_PCT
+#define BLE_ADV_GOV_CRITICAL_BATT_PCT   5
+#endif
+
+// Advertising intervals, 0.625 ms units
+#ifndef BLE_ADV_GOV_FAST_ITVL_MIN
+#define BLE_ADV_GOV_FAST_ITVL_MIN       0x20    // 20 ms
+#endif
+#ifndef BLE_ADV_GOV_FAST_ITVL_MAX
+#define BLE_ADV_GOV_FAST_ITVL_MAX       0x40    // 40 ms
+#endif
+#ifndef BLE_ADV_GOV_SLOW_ITVL_MIN
+#define BLE_ADV_GOV_SLOW_ITVL_MIN       0x0640  // 1 s
+#endif
+#ifndef BLE_ADV_GOV_SLOW_ITVL_MAX
+#define BLE_ADV_GOV_SLOW_ITVL_MAX       0x0800  // 1.28 s
+#endif
+
+// Charge of one advertising event (three channels, connectable, with the
+// wake-up from light sleep), in microcoulombs. Estimate for the ESP32-S3 at
+// 0 dBm from datasheet figures; replace with a bench measurement.
+#ifndef BLE_ADV_GOV_EVENT_UC
+#define BLE_ADV_GOV_EVENT_UC            150
+#endif
+
+#define BLE_ADV_GOV_NEVER               UINT32_MAX
+
+typedef enum {
+    BLE_ADV_TIER_PAUSED = 0,
+    BLE_ADV_TIER_SLOW,
+    BLE_ADV_TIER_FAST,
+    BLE_ADV_TIERS,
+} ble_adv_tier_t;
+
+typedef struct {
+    uint16_t itvl_min[BLE_ADV_TIERS];   // 0.625 ms units, unused when paused
+    uint16_t itvl_max[BLE_ADV_TIERS];
+    uint32_t fast_ms;
+    uint32_t pairing_fast_ms;
+    uint32_t wake_fast_ms;
+    uint32_t slow_ms;
+    uint32_t pair_burst_ms;
+    uint8_t low_batt_pct;
+    uint8_t critical_batt_pct;
+    uint32_t event_uc;
+} ble_adv_gov_cfg_t;
+
+typedef struct {
+    ble_adv_gov_cfg_t cfg;
+
+    bool connected;
+    bool bonded;
+    bool screen_on;
+    bool charging;
+    uint8_t batt_pct;
+
+    int64_t fast_until_ms;
+    int64_t slow_until_ms;              // with the screen off
+    int64_t burst_until_ms;
+
+    ble_adv_tier_t tier;
+    int64_t tier_since_ms;
+    uint64_t tier_ms[BLE_ADV_TIERS];    // disconnected time spent in each tier
+    uint32_t pair_bursts;
+} ble_adv_gov_t;
+
+// Filled with the BLE_ADV_GOV_* defaults
+void ble_adv_gov_default_cfg(ble_adv_gov_cfg_t* cfg);
+
+// Starts disconnected (as after a disconnect at now_ms), with the screen on
+// and the battery full. cfg NULL = defaults.
+void ble_adv_gov_init(ble_adv_gov_t* g, const ble_adv_gov_cfg_t* cfg, bool bonded, int64_t now_ms);
+
+// Inputs. None of them changes the tier by itself: call
+// ble_adv_gov_update() afterwards.
+void ble_adv_gov_set_connected(ble_adv_gov_t* g, bool connected, int64_t now_ms);
+void ble_adv_gov_set_bonded(ble_adv_gov_t* g, bool bonded);
+void ble_adv_gov_set_screen(ble_adv_gov_t* g, bool on, int64_t now_ms);
+void ble_adv_gov_set_battery(ble_adv_gov_t* g, uint8_t pct, bool charging);
+void ble_adv_gov_pair_now(ble_adv_gov_t* g, int64_t now_ms);
+
+// Tier for now_ms (PAUSED while connected). Accounts the time since the
+// last update to the previous tier.
+ble_adv_tier_t ble_adv_gov_update(ble_adv_gov_t* g, int64_t now_ms);
+
+// ms until the tier can change without a new input, BLE_ADV_GOV_NEVER if
+// only an input can change it
+uint32_t ble_adv_gov_next_ms(const ble_adv_gov_t* g, int64_t now_ms);
+
+// Estimated average current while advertising in a tier, in microamps
+uint32_t ble_adv_gov_tier_ua(const ble_adv_gov_cfg_t* cfg, ble_adv_tier_t tier);
+
+// Estimated charge spent in a tier so far, in microamp-hours
+uint32_t ble_adv_gov_tier_uah(const ble_adv_gov_t* g, ble_adv_tier_t tier);
+
+const char* ble_adv_gov_tier_name(ble_adv_tier_t tier);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Connection parameter arbiter. HID and the Nordic UART share one link but
+// want different things from it: HID sends one report per connection
+// event, so its rate is the interval, while the UART only cares during a
+// history sync and would otherwise rather save power. Neither role sets
+// parameters itself; they tell ble_host what they need and ble_host asks
+// the central for the winner:
+//   fast      7.5-15 ms, no latency: HID reports went out in the last
+//             BLE_CONN_ARB_HOLD_MS, or the UART has a bulk transfer
+//   relaxed   500-1000 ms, latency 8: the UART asked to save power and
+//             HID is quiet
+//   idle      30-50 ms: nothing asked for, after we moved the link
+//   central   nothing asked for since connecting: whatever the central
+//             picked stays and no update is sent
+// Plain C, no locking (ble_host.c holds a lock around it), tested on the
+// host. Times are in ms on any monotonic clock.
+
+#ifndef BLE_CONN_ARB_HOLD_MS
+#define BLE_CONN_ARB_HOLD_MS    5000    // last HID report -> may slow down
+#endif
+#ifndef BLE_CONN_ARB_RETRY_MS
+#define BLE_CONN_ARB_RETRY_MS   1000    // update refused (procedure pending)
+#endif
+
+#define BLE_CONN_ARB_NEVER      UINT32_MAX
+
+typedef enum {
+    BLE_CONN_CENTRAL = 0,
+    BLE_CONN_IDLE,
+    BLE_CONN_FAST,
+    BLE_CONN_RELAXED,
+    BLE_CONN_PROFILES,
+} ble_conn_profile_t;
+
+// What the UART may ask for
+typedef enum {
+    BLE_CONN_REQ_NONE = 0,
+    BLE_CONN_REQ_BULK,
+    BLE_CONN_REQ_RELAXED,
+} ble_conn_req_t;
+
+typedef struct {
+    uint16_t itvl_min;              // 1.25 ms units
+    uint16_t itvl_max;
+    uint16_t latency;
+    uint16_t supervision_timeout;   // 10 ms units, 0 = keep the current one
+} ble_conn_params_t;
+
+typedef struct {
+    ble_conn_req_t uart;
+    int64_t interactive_until_ms;
+    ble_conn_profile_t applied;     // last profile the central was asked for
+} ble_conn_arb_t;
+
+// New link: the central's parameters, nothing asked for
+void ble_conn_arb_init(ble_conn_arb_t* a);
+
+// Inputs. None of them changes the profile by itself: call
+// ble_conn_arb_update() afterwards.
+void ble_conn_arb_interactive(ble_conn_arb_t* a, int64_t now_ms);
+void ble_conn_arb_request(ble_conn_arb_t* a, ble_conn_req_t req);
+// The central was asked for p
+void ble_conn_arb_applied(ble_conn_arb_t* a, ble_conn_profile_t p);
+
+bool ble_conn_arb_is_interactive(const ble_conn_arb_t* a, int64_t now_ms);
+
+// Profile wanted at now_ms. Differs from a->applied when an update is due.
+ble_conn_profile_t ble_conn_arb_update(const ble_conn_arb_t* a, int64_t now_ms);
+
+// ms until the profile can change without a new input, BLE_CONN_ARB_NEVER
+// if only an input can change it
+uint32_t ble_conn_arb_next_ms(const ble_conn_arb_t* a, int64_t now_ms);
+
+// NULL for BLE_CONN_CENTRAL
+const ble_conn_params_t* ble_conn_arb_params(ble_conn_profile_t p);
+const char* ble_conn_arb_name(ble_conn_profile_t p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ble_adv_gov.h"
+#include "ble_conn_arb.h"
+#include "esp_err.h"
+#include "host/ble_hs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The one NimBLE host of the watch. HID-over-GATT (ble_hid_combined) and
+// the Nordic UART sync link (nimble-nordic-uart) are GATT services of the
+// same server and share its single connection. This module owns the port,
+// security, advertising, the connection and its parameters; the roles only
+// add services, listen to GAP events and say what the link should do:
+//
+//   ble_host_init(name)         port, GAP/GATT services, security
+//   <role>                      ble_host_add_services() or its own
+//                               ble_gatts_add_svcs() (esp_hidd), plus
+//                               ble_host_add_listener()
+//   ble_host_start()            host task; advertises once synced
+//
+// Services can only be added between init and start. Advertising carries
+// the appearance and the 16-bit service UUIDs the roles ask for, and the
+// 128-bit ones go in the scan response.
+
+#ifndef BLE_HOST_MAX_LISTENERS
+#define BLE_HOST_MAX_LISTENERS  4
+#endif
+
+#ifndef BLE_HOST_MAX_ADV_UUIDS
+#define BLE_HOST_MAX_ADV_UUIDS  4
+#endif
+
+// GAP, GATT, device information, battery, HID, Nordic UART and room to grow
+#ifndef BLE_HOST_MAX_SVCS
+#define BLE_HOST_MAX_SVCS       8
+#endif
+
+// Reconnection. Bonds persist in NVS (NimBLE store) and the last bonded
+// peers are remembered (ble_peer_cache.h). How hard the host advertises is
+// up to the governor (ble_adv_gov.h): fast, slow or paused, from the time
+// since the disconnect, the screen, the battery and "pair now". After a
+// disconnect, and at start, the first advertising of any tier is directed
+// at the last peer (high duty cycle, BLE_HOST_DIRECTED_MS); a peer that
+// resolves private addresses in its controller may only answer undirected,
+// which follows.
+#ifndef BLE_HOST_DIRECTED_MS
+#define BLE_HOST_DIRECTED_MS        1280    // controller limit for high duty
+#endif
+
+typedef enum {
+    BLE_HOST_ADV_OFF = 0,               // connected, paused, disabled or not synced
+    BLE_HOST_ADV_DIRECTED,
+    BLE_HOST_ADV_FAST,
+    BLE_HOST_ADV_SLOW,
+    BLE_HOST_ADV_PHASES,
+} ble_host_adv_phase_t;
+
+typedef struct {
+    uint32_t reconnects;                        // connections after a disconnect or start
+    uint32_t by_phase[BLE_HOST_ADV_PHASES];     // phase the peer connected in
+    uint32_t last_ms;                           // disconnect -> connected
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint32_t sum_ms;
+    uint32_t tier_ms[BLE_ADV_TIERS];            // disconnected time in each governor tier
+    uint32_t tier_uah[BLE_ADV_TIERS];           // estimated charge spent advertising
+    uint32_t pair_bursts;
+    uint8_t cached_peers;
+    uint32_t conn_updates[BLE_CONN_PROFILES];   // parameter updates asked, by profile
+    uint32_t conn_update_fails;                 // refused by the stack, retried
+} ble_host_stats_t;
+
+// Gets every GAP event of the connection after the host has handled it.
+// The return value is ignored (the host answers repeat pairing itself).
+typedef int (*ble_host_gap_cb_t)(struct ble_gap_event* event, void* arg);
+
+// Idempotent; the first caller names the device
+esp_err_t ble_host_init(const char* device_name);
+
+// svcs must stay valid while the host runs. ESP_ERR_INVALID_STATE after
+// ble_host_start().
+esp_err_t ble_host_add_services(const struct ble_gatt_svc_def* svcs);
+esp_err_t ble_host_add_listener(ble_host_gap_cb_t cb, void* arg);
+
+// Advertise a service (copied)
+esp_err_t ble_host_advertise_uuid(const ble_uuid_t* uuid);
+void ble_host_set_appearance(uint16_t appearance);
+
+// Idempotent
+esp_err_t ble_host_start(void);
+// Stops and deinitialises the host for every role. Roles register again
+// after the next ble_host_init().
+esp_err_t ble_host_stop(void);
+bool ble_host_is_started(void);
+
+// Attribute handles [first, last] of the first service with this UUID,
+// including services other components registered (esp_hidd). Known once
+// the host task has registered the GATT table, so always from a GAP
+// listener; ESP_ERR_NOT_FOUND before that or for an unknown service.
+esp_err_t ble_host_svc_handles(const ble_uuid_t* uuid, uint16_t* first, uint16_t* last);
+
+// BLE_HS_CONN_HANDLE_NONE when disconnected
+uint16_t ble_host_conn_handle(void);
+// The Bluetooth switch of the watch: advertising and the link are shared,
+// so these act for every role. A role that only wants to go quiet gates its
+// own service (e.g. nordic_uart_set_enabled()).
+esp_err_t ble_host_set_advertising_enabled(bool enable);
+esp_err_t ble_host_disconnect(void);
+
+// Advertising governor inputs, from any task
+void ble_host_adv_set_screen(bool on);
+void ble_host_adv_set_battery(uint8_t pct, bool charging);
+// Fast advertising for BLE_ADV_GOV_PAIR_BURST_MS whatever the power state
+void ble_host_pair_now(void);
+
+// Connection parameter inputs (ble_conn_arb.h), from any task. A HID
+// report went out: keep the link fast for BLE_CONN_ARB_HOLD_MS.
+void ble_host_conn_interactive(void);
+// What the UART needs; the latest request replaces the previous one and
+// is dropped at the next connection
+void ble_host_conn_request(ble_conn_req_t req);
+
+ble_host_adv_phase_t ble_host_adv_phase(void);
+void ble_host_get_stats(ble_host_stats_t* out);
+void ble_host_dump_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
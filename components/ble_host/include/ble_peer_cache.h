@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The last few bonded peers (identity addresses), most recent first. The
+// keys live in NimBLE's store; this only remembers who connected last so
+// that advertising after a disconnect can be directed at that peer. Kept
+// in NVS as one blob.
+// Plain C, no locking (ble_host.c only touches it from the host task),
+// tested on the host.
+
+#define BLE_PEER_CACHE_MAX      4
+#define BLE_PEER_CACHE_VERSION  1
+
+// Same layout as NimBLE's ble_addr_t
+typedef struct {
+    uint8_t type;
+    uint8_t val[6];
+} ble_peer_addr_t;
+
+typedef struct {
+    uint8_t version;
+    uint8_t n;
+    ble_peer_addr_t e[BLE_PEER_CACHE_MAX];
+} ble_peer_cache_t;
+
+void ble_peer_cache_init(ble_peer_cache_t* c);
+
+// False for a blob that is not a cache of this version (reset it then)
+bool ble_peer_cache_valid(const ble_peer_cache_t* c);
+
+// Move the peer to the front, inserting it (and dropping the oldest when
+// full) if it is new. True if the cache changed.
+bool ble_peer_cache_touch(ble_peer_cache_t* c, const ble_peer_addr_t* addr);
+
+// True if the peer was there
+bool ble_peer_cache_forget(ble_peer_cache_t* c, const ble_peer_addr_t* addr);
+
+// Keep only the peers found in bonded[] (the store may have evicted some).
+// True if the cache changed.
+bool ble_peer_cache_retain(ble_peer_cache_t* c, const ble_peer_addr_t* bonded, int n);
+
+// Most recent peer, NULL when empty
+const ble_peer_addr_t* ble_peer_cache_last(const ble_peer_cache_t* c);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,150 @@
+#include "ble_adv_gov.h"
+
+#include <string.h>
+
+// Mean gap between advertising events: the interval plus the 0-10 ms
+// advDelay the controller adds to every event
+#define ADV_DELAY_MEAN_US   5000
+
+static int64_t max64(int64_t a, int64_t b)
+{
+    return a > b ? a : b;
+}
+
+static ble_adv_tier_t decide(const ble_adv_gov_t* g, int64_t now)
+{
+    if (g->connected) return BLE_ADV_TIER_PAUSED;
+    if (now < g->burst_until_ms) return BLE_ADV_TIER_FAST;
+    if (!g->charging && g->batt_pct <= g->cfg.critical_batt_pct) return BLE_ADV_TIER_PAUSED;
+
+    bool low = !g->charging && g->batt_pct <= g->cfg.low_batt_pct;
+    if (now < g->fast_until_ms && !low) return BLE_ADV_TIER_FAST;
+    if (g->screen_on || g->charging || now < g->slow_until_ms) return BLE_ADV_TIER_SLOW;
+    return BLE_ADV_TIER_PAUSED;
+}
+
+// Time since the last update goes to the tier that was on
+static void account(ble_adv_gov_t* g, int64_t now)
+{
+    if (now <= g->tier_since_ms) return;
+    // Connected time is nobody's advertising time
+    if (!g->connected) g->tier_ms[g->tier] += (uint64_t)(now - g->tier_since_ms);
+    g->tier_since_ms = now;
+}
+
+void ble_adv_gov_default_cfg(ble_adv_gov_cfg_t* cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->itvl_min[BLE_ADV_TIER_SLOW] = BLE_ADV_GOV_SLOW_ITVL_MIN;
+    cfg->itvl_max[BLE_ADV_TIER_SLOW] = BLE_ADV_GOV_SLOW_ITVL_MAX;
+    cfg->itvl_min[BLE_ADV_TIER_FAST] = BLE_ADV_GOV_FAST_ITVL_MIN;
+    cfg->itvl_max[BLE_ADV_TIER_FAST] = BLE_ADV_GOV_FAST_ITVL_MAX;
+    cfg->fast_ms = BLE_ADV_GOV_FAST_MS;
+    cfg->pairing_fast_ms = BLE_ADV_GOV_PAIRING_FAST_MS;
+    cfg->wake_fast_ms = BLE_ADV_GOV_WAKE_FAST_MS;
+    cfg->slow_ms = BLE_ADV_GOV_SLOW_MS;
+    cfg->pair_burst_ms = BLE_ADV_GOV_PAIR_BURST_MS;
+    cfg->low_batt_pct = BLE_ADV_GOV_LOW_BATT_PCT;
+    cfg->critical_batt_pct = BLE_ADV_GOV_CRITICAL_BATT_PCT;
+    cfg->event_uc = BLE_ADV_GOV_EVENT_UC;
+}
+
+void ble_adv_gov_init(ble_adv_gov_t* g, const ble_adv_gov_cfg_t* cfg, bool bonded, int64_t now_ms)
+{
+    memset(g, 0, sizeof(*g));
+    if (cfg) {
+        g->cfg = *cfg;
+    } else {
+        ble_adv_gov_default_cfg(&g->cfg);
+    }
+    g->bonded = bonded;
+    g->screen_on = true;
+    g->batt_pct = 100;
+    g->connected = true;
+    ble_adv_gov_set_connected(g, false, now_ms);
+    g->tier = decide(g, now_ms);
+    g->tier_since_ms = now_ms;
+}
+
+void ble_adv_gov_set_connected(ble_adv_gov_t* g, bool connected, int64_t now_ms)
+{
+    if (connected == g->connected) return;
+    account(g, now_ms);
+    g->connected = connected;
+    if (!connected) {
+        g->fast_until_ms = now_ms + (g->bonded ? g->cfg.fast_ms : g->cfg.pairing_fast_ms);
+        g->slow_until_ms = g->fast_until_ms + g->cfg.slow_ms;
+    }
+}
+
+void ble_adv_gov_set_bonded(ble_adv_gov_t* g, bool bonded)
+{
+    g->bonded = bonded;
+}
+
+void ble_adv_gov_set_screen(ble_adv_gov_t* g, bool on, int64_t now_ms)
+{
+    if (on == g->screen_on) return;
+    g->screen_on = on;
+    if (on) {
+        // The user is looking at the watch: a peer in range finds it now
+        g->fast_until_ms = max64(g->fast_until_ms, now_ms + g->cfg.wake_fast_ms);
+    } else {
+        g->slow_until_ms = max64(g->slow_until_ms, now_ms + g->cfg.slow_ms);
+    }
+}
+
+void ble_adv_gov_set_battery(ble_adv_gov_t* g, uint8_t pct, bool charging)
+{
+    g->batt_pct = pct > 100 ? 100 : pct;
+    g->charging = charging;
+}
+
+void ble_adv_gov_pair_now(ble_adv_gov_t* g, int64_t now_ms)
+{
+    g->burst_until_ms = now_ms + g->cfg.pair_burst_ms;
+    g->pair_bursts++;
+}
+
+ble_adv_tier_t ble_adv_gov_update(ble_adv_gov_t* g, int64_t now_ms)
+{
+    account(g, now_ms);
+    g->tier = decide(g, now_ms);
+    return g->tier;
+}
+
+uint32_t ble_adv_gov_next_ms(const ble_adv_gov_t* g, int64_t now_ms)
+{
+    if (g->connected) return BLE_ADV_GOV_NEVER;
+
+    const int64_t deadlines[] = { g->burst_until_ms, g->fast_until_ms, g->slow_until_ms };
+    int64_t next = -1;
+    for (size_t i = 0; i < sizeof(deadlines) / sizeof(deadlines[0]); ++i) {
+        int64_t d = deadlines[i] - now_ms;
+        if (d > 0 && (next < 0 || d < next)) next = d;
+    }
+    if (next < 0) return BLE_ADV_GOV_NEVER;
+    return next >= BLE_ADV_GOV_NEVER ? BLE_ADV_GOV_NEVER - 1 : (uint32_t)next;
+}
+
+uint32_t ble_adv_gov_tier_ua(const ble_adv_gov_cfg_t* cfg, ble_adv_tier_t tier)
+{
+    if (tier <= BLE_ADV_TIER_PAUSED || tier >= BLE_ADV_TIERS) return 0;
+    // (min + max) / 2 * 625 us
+    uint64_t period_us = ((uint64_t)cfg->itvl_min[tier] + cfg->itvl_max[tier]) * 625 / 2
+                         + ADV_DELAY_MEAN_US;
+    return (uint32_t)(((uint64_t)cfg->event_uc * 1000000u + period_us / 2) / period_us);
+}
+
+uint32_t ble_adv_gov_tier_uah(const ble_adv_gov_t* g, ble_adv_tier_t tier)
+{
+    if (tier < 0 || tier >= BLE_ADV_TIERS) return 0;
+    uint64_t ua_ms = (uint64_t)ble_adv_gov_tier_ua(&g->cfg, tier) * g->tier_ms[tier];
+    return (uint32_t)((ua_ms + 1800000u) / 3600000u);
+}
+
+const char* ble_adv_gov_tier_name(ble_adv_tier_t tier)
+{
+    static const char* const names[BLE_ADV_TIERS] = { "paused", "slow", "fast" };
+    return (tier >= 0 && tier < BLE_ADV_TIERS) ? names[tier] : "?";
+}
@@ -0,0 +1,65 @@
+#include "ble_conn_arb.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// Supervision timeout must exceed (1 + latency) * itvl_max * 2: 18 s for
+// the relaxed profile
+static const ble_conn_params_t s_params[BLE_CONN_PROFILES] = {
+    [BLE_CONN_IDLE]    = { .itvl_min = 24,  .itvl_max = 40,  .latency = 0, .supervision_timeout = 0 },
+    [BLE_CONN_FAST]    = { .itvl_min = 6,   .itvl_max = 12,  .latency = 0, .supervision_timeout = 0 },
+    [BLE_CONN_RELAXED] = { .itvl_min = 400, .itvl_max = 800, .latency = 8, .supervision_timeout = 2000 },
+};
+
+void ble_conn_arb_init(ble_conn_arb_t* a)
+{
+    memset(a, 0, sizeof(*a));
+    a->applied = BLE_CONN_CENTRAL;
+}
+
+void ble_conn_arb_interactive(ble_conn_arb_t* a, int64_t now_ms)
+{
+    a->interactive_until_ms = now_ms + BLE_CONN_ARB_HOLD_MS;
+}
+
+void ble_conn_arb_request(ble_conn_arb_t* a, ble_conn_req_t req)
+{
+    a->uart = req;
+}
+
+void ble_conn_arb_applied(ble_conn_arb_t* a, ble_conn_profile_t p)
+{
+    a->applied = p;
+}
+
+bool ble_conn_arb_is_interactive(const ble_conn_arb_t* a, int64_t now_ms)
+{
+    return now_ms < a->interactive_until_ms;
+}
+
+ble_conn_profile_t ble_conn_arb_update(const ble_conn_arb_t* a, int64_t now_ms)
+{
+    // A history sync never slows the mouse down, and the mouse never has
+    // to wait for a relaxed link
+    if (ble_conn_arb_is_interactive(a, now_ms) || a->uart == BLE_CONN_REQ_BULK) return BLE_CONN_FAST;
+    if (a->uart == BLE_CONN_REQ_RELAXED) return BLE_CONN_RELAXED;
+    return a->applied == BLE_CONN_CENTRAL ? BLE_CONN_CENTRAL : BLE_CONN_IDLE;
+}
+
+uint32_t ble_conn_arb_next_ms(const ble_conn_arb_t* a, int64_t now_ms)
+{
+    int64_t d = a->interactive_until_ms - now_ms;
+    if (d <= 0) return BLE_CONN_ARB_NEVER;
+    return d >= BLE_CONN_ARB_NEVER ? BLE_CONN_ARB_NEVER - 1 : (uint32_t)d;
+}
+
+const ble_conn_params_t* ble_conn_arb_params(ble_conn_profile_t p)
+{
+    return (p > BLE_CONN_CENTRAL && p < BLE_CONN_PROFILES) ? &s_params[p] : NULL;
+}
+
+const char* ble_conn_arb_name(ble_conn_profile_t p)
+{
+    static const char* const names[BLE_CONN_PROFILES] = { "central", "idle", "fast", "relaxed" };
+    return (p >= 0 && p < BLE_CONN_PROFILES) ? names[p] : "?";
+}
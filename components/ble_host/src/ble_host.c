@@ -0,0 +1,837 @@
+#include "ble_host.h"
+
+#include <string.h>
+
+#include "ble_peer_cache.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "nimble/nimble_port.h"
+#include "nimble/nimble_npl.h"
+#include "nimble/nimble_port_freertos.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "store/config/ble_store_config.h"
+#include "services/gap/ble_svc_gap.h"
+#include "services/gatt/ble_svc_gatt.h"
+
+static const char* TAG = "BLE_HOST";
+
+#define ADV_MAX_LEN 31      // legacy advertising / scan response payload
+
+#define PEERS_NVS_NAMESPACE "ble_host"
+#define PEERS_NVS_KEY       "peers"
+
+_Static_assert(sizeof(ble_peer_addr_t) == sizeof(ble_addr_t), "ble_peer_addr_t must match ble_addr_t");
+
+typedef struct {
+    ble_host_gap_cb_t cb;
+    void* arg;
+} listener_t;
+
+static bool s_inited;
+static bool s_started;
+static bool s_adv_enabled = true;
+static uint8_t s_own_addr_type;
+static volatile uint16_t s_conn_hdl = BLE_HS_CONN_HANDLE_NONE;
+static uint16_t s_appearance;
+
+static listener_t s_listeners[BLE_HOST_MAX_LISTENERS];
+static int s_n_listeners;
+
+static ble_uuid16_t s_uuid16[BLE_HOST_MAX_ADV_UUIDS];
+static int s_n_uuid16;
+static ble_uuid128_t s_uuid128[BLE_HOST_MAX_ADV_UUIDS];
+static int s_n_uuid128;
+
+// Attribute handles of each service, recorded on the host task while the
+// GATT table is registered (before the first GAP event)
+typedef struct {
+    const struct ble_gatt_svc_def* def;
+    ble_uuid_any_t uuid;
+    uint16_t first;
+    uint16_t last;
+} svc_range_t;
+static svc_range_t s_svc_ranges[BLE_HOST_MAX_SVCS];
+static int s_n_svc_ranges;
+
+// Reconnection state, host task only (stats are read under the lock)
+static ble_peer_cache_t s_peers;
+static ble_host_adv_phase_t s_phase = BLE_HOST_ADV_OFF;        // on air
+static ble_host_adv_phase_t s_last_phase = BLE_HOST_ADV_OFF;   // last one put on air
+static bool s_directed_pending;     // directed goes first after a disconnect
+static int64_t s_down_us;           // link lost (or host started), 0 while connected
+static ble_host_stats_t s_stats;
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Inputs come from other tasks; the host task applies the tier when the
+// timer fires (at the next deadline, or right away after an input)
+static ble_adv_gov_t s_gov;
+static portMUX_TYPE s_gov_mux = portMUX_INITIALIZER_UNLOCKED;
+static struct ble_npl_callout s_gov_timer;
+
+// Connection parameters, same pattern: the roles' inputs from their tasks,
+// the update requests on the host task
+static ble_conn_arb_t s_arb;
+static portMUX_TYPE s_arb_mux = portMUX_INITIALIZER_UNLOCKED;
+static struct ble_npl_callout s_arb_timer;
+
+static int gap_event(struct ble_gap_event* event, void* arg);
+
+
+/* ================== SECURITY ================== */
+
+static void configure_security(void)
+{
+    // "Just Works" pairing + bonding: the watch has no way to confirm a
+    // passkey. HID hosts insist on an encrypted, bonded link.
+    ble_hs_cfg.sm_io_cap = BLE_HS_IO_NO_INPUT_OUTPUT;
+    ble_hs_cfg.sm_bonding = 1;
+    ble_hs_cfg.sm_mitm = 0;
+    ble_hs_cfg.sm_sc = 1;
+    ble_hs_cfg.sm_our_key_dist = BLE_SM_PAIR_KEY_DIST_ENC | BLE_SM_PAIR_KEY_DIST_ID;
+    ble_hs_cfg.sm_their_key_dist = BLE_SM_PAIR_KEY_DIST_ENC | BLE_SM_PAIR_KEY_DIST_ID;
+}
+
+
+/* ================== PEER CACHE ================== */
+
+static void peers_load(void)
+{
+    nvs_handle_t h;
+    size_t len = sizeof(s_peers);
+    bool ok = false;
+    if (nvs_open(PEERS_NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+        ok = nvs_get_blob(h, PEERS_NVS_KEY, &s_peers, &len) == ESP_OK
+             && len == sizeof(s_peers) && ble_peer_cache_valid(&s_peers);
+        nvs_close(h);
+    }
+    if (!ok) ble_peer_cache_init(&s_peers);
+}
+
+static void peers_save(void)
+{
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(PEERS_NVS_NAMESPACE, NVS_READWRITE, &h);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(h, PEERS_NVS_KEY, &s_peers, sizeof(s_peers));
+        if (err == ESP_OK) err = nvs_commit(h);
+        nvs_close(h);
+    }
+    if (err != ESP_OK) ESP_LOGW(TAG, "Saving peer cache failed: %s", esp_err_to_name(err));
+
+    portENTER_CRITICAL(&s_stats_mux);
+    s_stats.cached_peers = s_peers.n;
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
+// The store may have dropped bonds (evicted, or deleted on repeat pairing)
+static void peers_sync_with_store(void)
+{
+    ble_addr_t bonded[BLE_PEER_CACHE_MAX];
+    int n = 0;
+    if (ble_store_util_bonded_peers(bonded, &n, BLE_PEER_CACHE_MAX) != 0) n = 0;
+    if (ble_peer_cache_retain(&s_peers, (const ble_peer_addr_t*)bonded, n)) {
+        peers_save();
+    } else {
+        portENTER_CRITICAL(&s_stats_mux);
+        s_stats.cached_peers = s_peers.n;
+        portEXIT_CRITICAL(&s_stats_mux);
+    }
+}
+
+
+/* ================== RECONNECT STATS ================== */
+
+static void record_connect(int64_t now, ble_host_adv_phase_t phase)
+{
+    if (!s_down_us) return;
+    uint32_t ms = (uint32_t)((now - s_down_us) / 1000);
+    s_down_us = 0;
+
+    portENTER_CRITICAL(&s_stats_mux);
+    if (s_stats.reconnects == 0 || ms < s_stats.min_ms) s_stats.min_ms = ms;
+    if (ms > s_stats.max_ms) s_stats.max_ms = ms;
+    s_stats.reconnects++;
+    s_stats.by_phase[phase]++;
+    s_stats.last_ms = ms;
+    s_stats.sum_ms += ms;
+    portEXIT_CRITICAL(&s_stats_mux);
+
+    ESP_LOGI(TAG, "Reconnected in %u ms", (unsigned)ms);
+}
+
+
+/* ================== ADVERTISING ================== */
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static void gov_kick(void)
+{
+    if (s_inited) ble_npl_callout_reset(&s_gov_timer, 0);
+}
+
+static void adv_stop(void)
+{
+    if (s_phase == BLE_HOST_ADV_OFF) return;
+    s_phase = BLE_HOST_ADV_OFF;
+    int rc = ble_gap_adv_stop();
+    if (rc != 0 && rc != BLE_HS_EALREADY) ESP_LOGD(TAG, "ble_gap_adv_stop: %d", rc);
+}
+
+static int advertise_directed(const ble_addr_t* peer)
+{
+    struct ble_gap_adv_params params;
+    memset(&params, 0, sizeof(params));
+    params.conn_mode = BLE_GAP_CONN_MODE_DIR;
+    params.high_duty_cycle = 1;
+    return ble_gap_adv_start(s_own_addr_type, peer, BLE_HOST_DIRECTED_MS, &params, gap_event, NULL);
+}
+
+// Until the governor changes tier (timer) or something connects
+static int advertise_undirected(ble_adv_tier_t tier)
+{
+    // Flags, appearance, 16-bit services and TX power; the name gets what
+    // is left and is shortened if it does not fit
+    struct ble_hs_adv_fields fields;
+    memset(&fields, 0, sizeof(fields));
+    size_t used = 3 + 3;
+    fields.flags = BLE_HS_ADV_F_DISC_GEN | BLE_HS_ADV_F_BREDR_UNSUP;
+    fields.tx_pwr_lvl_is_present = 1;
+    fields.tx_pwr_lvl = BLE_HS_ADV_TX_PWR_LVL_AUTO;
+    if (s_appearance) {
+        fields.appearance = s_appearance;
+        fields.appearance_is_present = 1;
+        used += 4;
+    }
+    if (s_n_uuid16) {
+        fields.uuids16 = s_uuid16;
+        fields.num_uuids16 = s_n_uuid16;
+        fields.uuids16_is_complete = 1;
+        used += 2 + 2 * s_n_uuid16;
+    }
+    const char* name = ble_svc_gap_device_name();
+    size_t name_len = name ? strlen(name) : 0;
+    size_t room = used + 2 < ADV_MAX_LEN ? ADV_MAX_LEN - used - 2 : 0;
+    fields.name = (uint8_t*)name;
+    fields.name_len = name_len < room ? name_len : room;
+    fields.name_is_complete = fields.name_len == name_len;
+
+    int rc = ble_gap_adv_set_fields(&fields);
+    if (rc) {
+        ESP_LOGE(TAG, "ble_gap_adv_set_fields, err %d", rc);
+        return rc;
+    }
+
+    struct ble_hs_adv_fields rsp;
+    memset(&rsp, 0, sizeof(rsp));
+    if (s_n_uuid128) {
+        rsp.uuids128 = s_uuid128;
+        rsp.num_uuids128 = 1;                   // only one fits
+        rsp.uuids128_is_complete = s_n_uuid128 == 1;
+    }
+    rc = ble_gap_adv_rsp_set_fields(&rsp);
+    if (rc) ESP_LOGE(TAG, "ble_gap_adv_rsp_set_fields, err %d", rc);
+
+    struct ble_gap_adv_params params;
+    memset(&params, 0, sizeof(params));
+    params.conn_mode = BLE_GAP_CONN_MODE_UND;
+    params.disc_mode = BLE_GAP_DISC_MODE_GEN;
+    params.itvl_min = s_gov.cfg.itvl_min[tier];
+    params.itvl_max = s_gov.cfg.itvl_max[tier];
+
+    rc = ble_gap_adv_start(s_own_addr_type, NULL, BLE_HS_FOREVER, &params, gap_event, NULL);
+    if (rc == BLE_HS_EALREADY) {
+        rc = 0;
+    } else if (rc) {
+        ESP_LOGE(TAG, "Advertising start failed: err %d", rc);
+    }
+    return rc;
+}
+
+// Puts on air what the governor asks for. Host task only.
+static void adv_apply(void)
+{
+    int64_t now = now_ms();
+    portENTER_CRITICAL(&s_gov_mux);
+    ble_adv_tier_t tier = ble_adv_gov_update(&s_gov, now);
+    uint32_t next = ble_adv_gov_next_ms(&s_gov, now);
+    portEXIT_CRITICAL(&s_gov_mux);
+
+    if (next == BLE_ADV_GOV_NEVER) {
+        ble_npl_callout_stop(&s_gov_timer);
+    } else {
+        ble_npl_callout_reset(&s_gov_timer, ble_npl_time_ms_to_ticks32(next));
+    }
+
+    ble_host_adv_phase_t want = BLE_HOST_ADV_OFF;
+    if (s_adv_enabled && ble_hs_synced() && s_conn_hdl == BLE_HS_CONN_HANDLE_NONE) {
+        if (tier == BLE_ADV_TIER_FAST) want = BLE_HOST_ADV_FAST;
+        if (tier == BLE_ADV_TIER_SLOW) want = BLE_HOST_ADV_SLOW;
+    }
+    if (want != BLE_HOST_ADV_OFF && s_directed_pending) want = BLE_HOST_ADV_DIRECTED;
+    if (want == s_phase) return;
+
+    adv_stop();
+    if (want == BLE_HOST_ADV_DIRECTED) {
+        // Only at a peer we are bonded with: it needs the peer's identity
+        // address and nothing else is sent
+        const ble_peer_addr_t* last = ble_peer_cache_last(&s_peers);
+        int rc = last ? advertise_directed((const ble_addr_t*)last) : BLE_HS_ENOENT;
+        if (rc == 0) {
+            s_phase = s_last_phase = BLE_HOST_ADV_DIRECTED;
+            ESP_LOGI(TAG, "Directed advertising to last peer");
+            return;
+        }
+        if (rc != BLE_HS_ENOENT) ESP_LOGW(TAG, "Directed advertising failed: %d", rc);
+        s_directed_pending = false;
+        want = tier == BLE_ADV_TIER_FAST ? BLE_HOST_ADV_FAST : BLE_HOST_ADV_SLOW;
+    }
+    if (want == BLE_HOST_ADV_OFF) return;
+
+    if (advertise_undirected(tier) == 0) {
+        s_phase = s_last_phase = want;
+        ESP_LOGI(TAG, "Advertising %s", ble_adv_gov_tier_name(tier));
+    }
+}
+
+static void gov_timer_cb(struct ble_npl_event* ev)
+{
+    (void)ev;
+    adv_apply();
+}
+
+
+/* ================== CONNECTION PARAMETERS ================== */
+
+static void conn_kick(void)
+{
+    if (s_inited) ble_npl_callout_reset(&s_arb_timer, 0);
+}
+
+// Asks the central for what the arbiter wants. Host task only.
+static void conn_apply(void)
+{
+    if (s_conn_hdl == BLE_HS_CONN_HANDLE_NONE) {
+        ble_npl_callout_stop(&s_arb_timer);
+        return;
+    }
+
+    int64_t now = now_ms();
+    portENTER_CRITICAL(&s_arb_mux);
+    ble_conn_profile_t want = ble_conn_arb_update(&s_arb, now);
+    ble_conn_profile_t applied = s_arb.applied;
+    uint32_t next = ble_conn_arb_next_ms(&s_arb, now);
+    portEXIT_CRITICAL(&s_arb_mux);
+
+    const ble_conn_params_t* p = ble_conn_arb_params(want);
+    if (want != applied && p) {
+        struct ble_gap_conn_desc desc;
+        int rc = ble_gap_conn_find(s_conn_hdl, &desc);
+        if (rc == 0) {
+            struct ble_gap_upd_params params = {
+                .itvl_min = p->itvl_min,
+                .itvl_max = p->itvl_max,
+                .latency = p->latency,
+                .supervision_timeout = p->supervision_timeout ? p->supervision_timeout
+                                                              : desc.supervision_timeout,
+            };
+            rc = ble_gap_update_params(s_conn_hdl, &params);
+        }
+        portENTER_CRITICAL(&s_stats_mux);
+        if (rc == 0) {
+            s_stats.conn_updates[want]++;
+        } else {
+            s_stats.conn_update_fails++;
+        }
+        portEXIT_CRITICAL(&s_stats_mux);
+
+        if (rc == 0) {
+            portENTER_CRITICAL(&s_arb_mux);
+            ble_conn_arb_applied(&s_arb, want);
+            portEXIT_CRITICAL(&s_arb_mux);
+            ESP_LOGI(TAG, "Conn params -> %s (%u-%u x1.25 ms, latency %u)",
+                     ble_conn_arb_name(want), p->itvl_min, p->itvl_max, p->latency);
+        } else {
+            // Usually another update still in progress: ask again shortly
+            ESP_LOGD(TAG, "ble_gap_update_params(%s) rc=%d", ble_conn_arb_name(want), rc);
+            if (next > BLE_CONN_ARB_RETRY_MS) next = BLE_CONN_ARB_RETRY_MS;
+        }
+    }
+
+    if (next == BLE_CONN_ARB_NEVER) {
+        ble_npl_callout_stop(&s_arb_timer);
+    } else {
+        ble_npl_callout_reset(&s_arb_timer, ble_npl_time_ms_to_ticks32(next));
+    }
+}
+
+static void arb_timer_cb(struct ble_npl_event* ev)
+{
+    (void)ev;
+    conn_apply();
+}
+
+
+/* ================== GAP EVENTS ================== */
+
+static int gap_event(struct ble_gap_event* event, void* arg)
+{
+    (void)arg;
+    int rc = 0;
+
+    switch (event->type) {
+    case BLE_GAP_EVENT_CONNECT: {
+        ESP_LOGI(TAG, "Connect %s", event->connect.status == 0 ? "OK" : "failed");
+        // A connection (or a failed one) ends the advertising phase
+        s_phase = BLE_HOST_ADV_OFF;
+        if (event->connect.status == 0) {
+            s_conn_hdl = event->connect.conn_handle;
+            s_directed_pending = false;
+            record_connect(esp_timer_get_time(), s_last_phase);
+            portENTER_CRITICAL(&s_gov_mux);
+            ble_adv_gov_set_connected(&s_gov, true, now_ms());
+            portEXIT_CRITICAL(&s_gov_mux);
+            // The roles ask again from their listeners if they need to
+            portENTER_CRITICAL(&s_arb_mux);
+            ble_conn_arb_init(&s_arb);
+            portEXIT_CRITICAL(&s_arb_mux);
+        }
+        break;
+    }
+
+    case BLE_GAP_EVENT_DISCONNECT:
+        ESP_LOGI(TAG, "Disconnect, reason 0x%03x", event->disconnect.reason);
+        s_conn_hdl = BLE_HS_CONN_HANDLE_NONE;
+        s_down_us = esp_timer_get_time();
+        s_directed_pending = s_peers.n > 0;
+        portENTER_CRITICAL(&s_gov_mux);
+        ble_adv_gov_set_connected(&s_gov, false, now_ms());
+        portEXIT_CRITICAL(&s_gov_mux);
+        break;
+
+    case BLE_GAP_EVENT_ENC_CHANGE: {
+        ESP_LOGI(TAG, "Encryption change, status %d", event->enc_change.status);
+        // Bonded peers go to the front of the cache for directed advertising
+        struct ble_gap_conn_desc desc;
+        if (event->enc_change.status == 0
+            && ble_gap_conn_find(event->enc_change.conn_handle, &desc) == 0
+            && desc.sec_state.bonded
+            && ble_peer_cache_touch(&s_peers, (const ble_peer_addr_t*)&desc.peer_id_addr)) {
+            peers_save();
+            portENTER_CRITICAL(&s_gov_mux);
+            ble_adv_gov_set_bonded(&s_gov, true);
+            portEXIT_CRITICAL(&s_gov_mux);
+        }
+        break;
+    }
+
+    case BLE_GAP_EVENT_CONN_UPDATE:
+        if (event->conn_update.status != 0) {
+            ESP_LOGW(TAG, "Conn params update failed: %d", event->conn_update.status);
+        }
+        break;
+
+    case BLE_GAP_EVENT_ADV_COMPLETE:
+        // Only directed advertising has a duration; after it, undirected
+        if (s_phase == BLE_HOST_ADV_DIRECTED) s_directed_pending = false;
+        s_phase = BLE_HOST_ADV_OFF;
+        break;
+
+    case BLE_GAP_EVENT_REPEAT_PAIRING: {
+        // The peer lost its keys: forget ours and pair again
+        struct ble_gap_conn_desc desc;
+        if (ble_gap_conn_find(event->repeat_pairing.conn_handle, &desc) == 0) {
+            ble_store_util_delete_peer(&desc.peer_id_addr);
+            if (ble_peer_cache_forget(&s_peers, (const ble_peer_addr_t*)&desc.peer_id_addr)) {
+                peers_save();
+            }
+        }
+        ESP_LOGW(TAG, "Repeat pairing, old bond deleted");
+        rc = BLE_GAP_REPEAT_PAIRING_RETRY;
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    for (int i = 0; i < s_n_listeners; ++i) {
+        s_listeners[i].cb(event, s_listeners[i].arg);
+    }
+
+    switch (event->type) {
+    case BLE_GAP_EVENT_CONNECT:
+    case BLE_GAP_EVENT_DISCONNECT:
+        conn_apply();
+        adv_apply();
+        break;
+    case BLE_GAP_EVENT_ADV_COMPLETE:
+        adv_apply();
+        break;
+    default:
+        break;
+    }
+    return rc;
+}
+
+
+/* ================== SYNC + TASK ================== */
+
+static void gatts_register_cb(struct ble_gatt_register_ctxt* ctxt, void* arg)
+{
+    (void)arg;
+    const struct ble_gatt_svc_def* def;
+    uint16_t handle;
+
+    switch (ctxt->op) {
+    case BLE_GATT_REGISTER_OP_SVC: {
+        if (s_n_svc_ranges >= BLE_HOST_MAX_SVCS) {
+            ESP_LOGW(TAG, "More than %d services, handle ranges not kept", BLE_HOST_MAX_SVCS);
+            return;
+        }
+        svc_range_t* r = &s_svc_ranges[s_n_svc_ranges++];
+        r->def = ctxt->svc.svc_def;
+        ble_uuid_copy(&r->uuid, ctxt->svc.svc_def->uuid);
+        r->first = r->last = ctxt->svc.handle;
+        return;
+    }
+    case BLE_GATT_REGISTER_OP_CHR:
+        def = ctxt->chr.svc_def;
+        handle = ctxt->chr.val_handle;
+        break;
+    case BLE_GATT_REGISTER_OP_DSC:
+        def = ctxt->dsc.svc_def;
+        handle = ctxt->dsc.handle;
+        break;
+    default:
+        return;
+    }
+    for (int i = 0; i < s_n_svc_ranges; ++i) {
+        if (s_svc_ranges[i].def == def && handle > s_svc_ranges[i].last) s_svc_ranges[i].last = handle;
+    }
+}
+
+static void on_sync(void)
+{
+    int rc = ble_hs_id_infer_auto(0, &s_own_addr_type);
+    if (rc != 0) {
+        ESP_LOGE(TAG, "Error ble_hs_id_infer_auto: %d", rc);
+    }
+    peers_sync_with_store();
+    if (!s_down_us) s_down_us = esp_timer_get_time();
+    s_directed_pending = s_peers.n > 0;
+    portENTER_CRITICAL(&s_gov_mux);
+    ble_adv_gov_set_bonded(&s_gov, s_peers.n > 0);
+    portEXIT_CRITICAL(&s_gov_mux);
+    adv_apply();
+}
+
+static void on_reset(int reason)
+{
+    ESP_LOGW(TAG, "Host reset, reason %d", reason);
+}
+
+static void host_task(void* param)
+{
+    (void)param;
+    ESP_LOGI(TAG, "BLE Host Task Started");
+    nimble_port_run();      // returns after nimble_port_stop()
+    nimble_port_freertos_deinit();
+}
+
+
+/* ================== API ================== */
+
+esp_err_t ble_host_init(const char* device_name)
+{
+    if (s_inited) return ESP_OK;
+
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_LOGW(TAG, "NVS init failed (%s); erasing and retrying", esp_err_to_name(err));
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to nvs_flash_init: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nimble_port_init();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "nimble_port_init() failed with error: %d", err);
+        return err;
+    }
+
+    ble_hs_cfg.sync_cb = on_sync;
+    ble_hs_cfg.reset_cb = on_reset;
+    ble_hs_cfg.gatts_register_cb = gatts_register_cb;
+    // Bonds persist in NVS; when the store is full the oldest bond goes
+    ble_hs_cfg.store_status_cb = ble_store_util_status_rr;
+    configure_security();
+
+    ble_svc_gap_init();
+    ble_svc_gatt_init();
+    ble_store_config_init();
+    peers_load();
+
+    portENTER_CRITICAL(&s_gov_mux);
+    ble_adv_gov_init(&s_gov, NULL, s_peers.n > 0, now_ms());
+    portEXIT_CRITICAL(&s_gov_mux);
+    ble_npl_callout_init(&s_gov_timer, nimble_port_get_dflt_eventq(), gov_timer_cb, NULL);
+    ble_conn_arb_init(&s_arb);
+    ble_npl_callout_init(&s_arb_timer, nimble_port_get_dflt_eventq(), arb_timer_cb, NULL);
+    if (ble_svc_gap_device_name_set(device_name ? device_name : "S3Watch") != 0) {
+        ESP_LOGW(TAG, "Device name too long: %s", device_name);
+    }
+
+    s_inited = true;
+    ESP_LOGI(TAG, "NimBLE host ready: %s", ble_svc_gap_device_name());
+    return ESP_OK;
+}
+
+esp_err_t ble_host_add_services(const struct ble_gatt_svc_def* svcs)
+{
+    if (!s_inited || s_started) return ESP_ERR_INVALID_STATE;
+
+    int rc = ble_gatts_count_cfg(svcs);
+    if (rc == 0) rc = ble_gatts_add_svcs(svcs);
+    if (rc != 0) {
+        ESP_LOGE(TAG, "Adding GATT services failed: %d", rc);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_host_add_listener(ble_host_gap_cb_t cb, void* arg)
+{
+    if (!cb) return ESP_ERR_INVALID_ARG;
+    if (s_started) return ESP_ERR_INVALID_STATE;
+    if (s_n_listeners >= BLE_HOST_MAX_LISTENERS) return ESP_ERR_NO_MEM;
+
+    s_listeners[s_n_listeners++] = (listener_t){ .cb = cb, .arg = arg };
+    return ESP_OK;
+}
+
+esp_err_t ble_host_advertise_uuid(const ble_uuid_t* uuid)
+{
+    if (!uuid) return ESP_ERR_INVALID_ARG;
+
+    if (uuid->type == BLE_UUID_TYPE_16 && s_n_uuid16 < BLE_HOST_MAX_ADV_UUIDS) {
+        s_uuid16[s_n_uuid16++] = *BLE_UUID16(uuid);
+    } else if (uuid->type == BLE_UUID_TYPE_128 && s_n_uuid128 < BLE_HOST_MAX_ADV_UUIDS) {
+        s_uuid128[s_n_uuid128++] = *BLE_UUID128(uuid);
+    } else {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void ble_host_set_appearance(uint16_t appearance)
+{
+    s_appearance = appearance;
+    if (s_inited) ble_svc_gap_device_appearance_set(appearance);
+}
+
+esp_err_t ble_host_start(void)
+{
+    if (!s_inited) return ESP_ERR_INVALID_STATE;
+    if (s_started) return ESP_OK;
+
+    s_started = true;
+    nimble_port_freertos_init(host_task);
+    return ESP_OK;
+}
+
+esp_err_t ble_host_stop(void)
+{
+    if (!s_inited) return ESP_OK;
+
+    s_adv_enabled = false;
+    if (s_started) {
+        if (s_conn_hdl != BLE_HS_CONN_HANDLE_NONE) {
+            int rc = ble_gap_terminate(s_conn_hdl, BLE_ERR_REM_USER_CONN_TERM);
+            if (rc != 0) ESP_LOGW(TAG, "ble_gap_terminate failed: %d", rc);
+        }
+        int rc = ble_gap_adv_stop();
+        if (rc != 0 && rc != BLE_HS_EALREADY && rc != BLE_HS_EINVAL) {
+            ESP_LOGW(TAG, "Error stopping advertisement: %d", rc);
+        }
+    }
+
+    int ret = s_started ? nimble_port_stop() : 0;
+    if (ret == 0) {
+        ble_npl_callout_stop(&s_gov_timer);
+        ble_npl_callout_deinit(&s_gov_timer);
+        ble_npl_callout_stop(&s_arb_timer);
+        ble_npl_callout_deinit(&s_arb_timer);
+        ret = nimble_port_deinit();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "nimble_port_deinit() failed with error: %d", ret);
+            return ESP_FAIL;
+        }
+    }
+
+    s_inited = false;
+    s_started = false;
+    s_adv_enabled = true;
+    s_conn_hdl = BLE_HS_CONN_HANDLE_NONE;
+    s_phase = BLE_HOST_ADV_OFF;
+    s_directed_pending = false;
+    s_down_us = 0;
+    s_n_listeners = 0;
+    s_n_uuid16 = 0;
+    s_n_uuid128 = 0;
+    s_n_svc_ranges = 0;
+    return ESP_OK;
+}
+
+bool ble_host_is_started(void)
+{
+    return s_started;
+}
+
+esp_err_t ble_host_svc_handles(const ble_uuid_t* uuid, uint16_t* first, uint16_t* last)
+{
+    if (!uuid || !first || !last) return ESP_ERR_INVALID_ARG;
+    for (int i = 0; i < s_n_svc_ranges; ++i) {
+        if (ble_uuid_cmp(&s_svc_ranges[i].uuid.u, uuid) == 0) {
+            *first = s_svc_ranges[i].first;
+            *last = s_svc_ranges[i].last;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+uint16_t ble_host_conn_handle(void)
+{
+    return s_conn_hdl;
+}
+
+esp_err_t ble_host_set_advertising_enabled(bool enable)
+{
+    // Applied on the host task
+    s_adv_enabled = enable;
+    gov_kick();
+    return ESP_OK;
+}
+
+void ble_host_adv_set_screen(bool on)
+{
+    if (!s_inited) return;
+    portENTER_CRITICAL(&s_gov_mux);
+    ble_adv_gov_set_screen(&s_gov, on, now_ms());
+    portEXIT_CRITICAL(&s_gov_mux);
+    gov_kick();
+}
+
+void ble_host_adv_set_battery(uint8_t pct, bool charging)
+{
+    if (!s_inited) return;
+    portENTER_CRITICAL(&s_gov_mux);
+    ble_adv_gov_set_battery(&s_gov, pct, charging);
+    portEXIT_CRITICAL(&s_gov_mux);
+    gov_kick();
+}
+
+void ble_host_pair_now(void)
+{
+    if (!s_inited) return;
+    portENTER_CRITICAL(&s_gov_mux);
+    ble_adv_gov_pair_now(&s_gov, now_ms());
+    portEXIT_CRITICAL(&s_gov_mux);
+    ESP_LOGI(TAG, "Pair now: fast advertising for %u s", (unsigned)(s_gov.cfg.pair_burst_ms / 1000));
+    gov_kick();
+}
+
+void ble_host_conn_interactive(void)
+{
+    if (!s_inited) return;
+    // Called for every report: only the first one of a burst kicks
+    int64_t now = now_ms();
+    portENTER_CRITICAL(&s_arb_mux);
+    bool was = ble_conn_arb_is_interactive(&s_arb, now);
+    ble_conn_arb_interactive(&s_arb, now);
+    portEXIT_CRITICAL(&s_arb_mux);
+    if (!was) conn_kick();
+}
+
+void ble_host_conn_request(ble_conn_req_t req)
+{
+    if (!s_inited) return;
+    portENTER_CRITICAL(&s_arb_mux);
+    ble_conn_arb_request(&s_arb, req);
+    portEXIT_CRITICAL(&s_arb_mux);
+    conn_kick();
+}
+
+esp_err_t ble_host_disconnect(void)
+{
+    if (s_conn_hdl == BLE_HS_CONN_HANDLE_NONE) return ESP_OK;
+
+    int rc = ble_gap_terminate(s_conn_hdl, BLE_ERR_REM_USER_CONN_TERM);
+    if (rc != 0) {
+        if (rc == BLE_HS_EALREADY || rc == BLE_HS_ENOTCONN) {
+            ESP_LOGD(TAG, "Disconnect benign code: %d", rc);
+            return ESP_OK;
+        }
+        ESP_LOGW(TAG, "ble_gap_terminate failed: %d", rc);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+ble_host_adv_phase_t ble_host_adv_phase(void)
+{
+    return s_phase;
+}
+
+void ble_host_get_stats(ble_host_stats_t* out)
+{
+    if (!out) return;
+    portENTER_CRITICAL(&s_stats_mux);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_stats_mux);
+
+    // Governor copy brought up to now, so the current tier counts too
+    ble_adv_gov_t gov;
+    portENTER_CRITICAL(&s_gov_mux);
+    gov = s_gov;
+    portEXIT_CRITICAL(&s_gov_mux);
+    (void)ble_adv_gov_update(&gov, now_ms());
+    for (int t = 0; t < BLE_ADV_TIERS; ++t) {
+        out->tier_ms[t] = (uint32_t)gov.tier_ms[t];
+        out->tier_uah[t] = ble_adv_gov_tier_uah(&gov, (ble_adv_tier_t)t);
+    }
+    out->pair_bursts = gov.pair_bursts;
+}
+
+void ble_host_dump_stats(void)
+{
+    ble_host_stats_t st;
+    ble_host_get_stats(&st);
+    ESP_LOGI(TAG, "Reconnects: %u (directed %u, fast %u, slow %u), %u peers cached",
+             (unsigned)st.reconnects, (unsigned)st.by_phase[BLE_HOST_ADV_DIRECTED],
+             (unsigned)st.by_phase[BLE_HOST_ADV_FAST], (unsigned)st.by_phase[BLE_HOST_ADV_SLOW],
+             (unsigned)st.cached_peers);
+    if (st.reconnects) {
+        ESP_LOGI(TAG, "Reconnect time: last %u ms, avg %u ms, min %u ms, max %u ms",
+                 (unsigned)st.last_ms, (unsigned)(st.sum_ms / st.reconnects),
+                 (unsigned)st.min_ms, (unsigned)st.max_ms);
+    }
+    for (int t = BLE_ADV_TIERS - 1; t >= 0; --t) {
+        ESP_LOGI(TAG, "Advertising %-6s %8u ms, ~%u uA, ~%u uAh",
+                 ble_adv_gov_tier_name((ble_adv_tier_t)t), (unsigned)st.tier_ms[t],
+                 (unsigned)ble_adv_gov_tier_ua(&s_gov.cfg, (ble_adv_tier_t)t),
+                 (unsigned)st.tier_uah[t]);
+    }
+    ESP_LOGI(TAG, "Pair now bursts: %u", (unsigned)st.pair_bursts);
+    ESP_LOGI(TAG, "Conn param updates: fast %u, idle %u, relaxed %u, refused %u",
+             (unsigned)st.conn_updates[BLE_CONN_FAST], (unsigned)st.conn_updates[BLE_CONN_IDLE],
+             (unsigned)st.conn_updates[BLE_CONN_RELAXED], (unsigned)st.conn_update_fails);
+}
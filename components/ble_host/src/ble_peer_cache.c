@@ -0,0 +1,68 @@
+#include "ble_peer_cache.h"
+
+#include <string.h>
+
+static bool addr_eq(const ble_peer_addr_t* a, const ble_peer_addr_t* b)
+{
+    return a->type == b->type && memcmp(a->val, b->val, sizeof(a->val)) == 0;
+}
+
+static int find(const ble_peer_cache_t* c, const ble_peer_addr_t* addr)
+{
+    for (int i = 0; i < c->n; ++i) {
+        if (addr_eq(&c->e[i], addr)) return i;
+    }
+    return -1;
+}
+
+void ble_peer_cache_init(ble_peer_cache_t* c)
+{
+    memset(c, 0, sizeof(*c));
+    c->version = BLE_PEER_CACHE_VERSION;
+}
+
+bool ble_peer_cache_valid(const ble_peer_cache_t* c)
+{
+    return c->version == BLE_PEER_CACHE_VERSION && c->n <= BLE_PEER_CACHE_MAX;
+}
+
+bool ble_peer_cache_touch(ble_peer_cache_t* c, const ble_peer_addr_t* addr)
+{
+    int i = find(c, addr);
+    if (i == 0) return false;
+    if (i < 0) {
+        i = c->n < BLE_PEER_CACHE_MAX ? c->n++ : BLE_PEER_CACHE_MAX - 1;
+    }
+    memmove(&c->e[1], &c->e[0], (size_t)i * sizeof(c->e[0]));
+    c->e[0] = *addr;
+    return true;
+}
+
+bool ble_peer_cache_forget(ble_peer_cache_t* c, const ble_peer_addr_t* addr)
+{
+    int i = find(c, addr);
+    if (i < 0) return false;
+    memmove(&c->e[i], &c->e[i + 1], (size_t)(c->n - i - 1) * sizeof(c->e[0]));
+    c->n--;
+    memset(&c->e[c->n], 0, sizeof(c->e[0]));
+    return true;
+}
+
+bool ble_peer_cache_retain(ble_peer_cache_t* c, const ble_peer_addr_t* bonded, int n)
+{
+    bool changed = false;
+    for (int i = c->n - 1; i >= 0; --i) {
+        bool keep = false;
+        for (int j = 0; j < n && !keep; ++j) keep = addr_eq(&c->e[i], &bonded[j]);
+        if (!keep) {
+            ble_peer_addr_t gone = c->e[i];
+            changed |= ble_peer_cache_forget(c, &gone);
+        }
+    }
+    return changed;
+}
+
+const ble_peer_addr_t* ble_peer_cache_last(const ble_peer_cache_t* c)
+{
+    return c->n ? &c->e[0] : NULL;
+}
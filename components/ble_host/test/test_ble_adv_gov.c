@@ -0,0 +1,110 @@
+#include "unity.h"
+
+#include "ble_adv_gov.h"
+
+#define T0 1000
+
+static ble_adv_gov_t gov(bool bonded) {
+  ble_adv_gov_t g;
+  ble_adv_gov_init(&g, NULL, bonded, T0);
+  return g;
+}
+
+TEST_CASE("disconnect: fast, then slow with the screen on", "[adv_gov]") {
+  ble_adv_gov_t g = gov(true);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_FAST, ble_adv_gov_update(&g, T0));
+  TEST_ASSERT_EQUAL_UINT32(BLE_ADV_GOV_FAST_MS, ble_adv_gov_next_ms(&g, T0));
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_FAST, ble_adv_gov_update(&g, T0 + BLE_ADV_GOV_FAST_MS - 1));
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, T0 + BLE_ADV_GOV_FAST_MS));
+  // Screen on: slow for as long as it stays on
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, T0 + 10 * BLE_ADV_GOV_SLOW_MS));
+}
+
+TEST_CASE("nothing bonded: longer window to pair", "[adv_gov]") {
+  ble_adv_gov_t g = gov(false);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_FAST, ble_adv_gov_update(&g, T0 + BLE_ADV_GOV_PAIRING_FAST_MS - 1));
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, T0 + BLE_ADV_GOV_PAIRING_FAST_MS));
+
+  // Once bonded, the next disconnect gets the short window
+  int64_t t = T0 + BLE_ADV_GOV_PAIRING_FAST_MS;
+  ble_adv_gov_set_connected(&g, true, t);
+  ble_adv_gov_set_bonded(&g, true);
+  ble_adv_gov_set_connected(&g, false, t + 1000);
+  TEST_ASSERT_EQUAL_UINT32(BLE_ADV_GOV_FAST_MS, ble_adv_gov_next_ms(&g, t + 1000));
+}
+
+TEST_CASE("screen off pauses after the slow window, wake brings fast", "[adv_gov]") {
+  ble_adv_gov_t g = gov(true);
+  int64_t off = T0 + BLE_ADV_GOV_FAST_MS + 1000;
+  ble_adv_gov_set_screen(&g, false, off);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, off));
+  TEST_ASSERT_EQUAL_UINT32(BLE_ADV_GOV_SLOW_MS, ble_adv_gov_next_ms(&g, off));
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_PAUSED, ble_adv_gov_update(&g, off + BLE_ADV_GOV_SLOW_MS));
+  TEST_ASSERT_EQUAL_UINT32(BLE_ADV_GOV_NEVER, ble_adv_gov_next_ms(&g, off + BLE_ADV_GOV_SLOW_MS));
+
+  int64_t wake = off + 2 * BLE_ADV_GOV_SLOW_MS;
+  ble_adv_gov_set_screen(&g, true, wake);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_FAST, ble_adv_gov_update(&g, wake));
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, wake + BLE_ADV_GOV_WAKE_FAST_MS));
+}
+
+TEST_CASE("charging keeps slow advertising with the screen off", "[adv_gov]") {
+  ble_adv_gov_t g = gov(true);
+  ble_adv_gov_set_screen(&g, false, T0);
+  ble_adv_gov_set_battery(&g, 50, true);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, T0 + 2 * BLE_ADV_GOV_SLOW_MS));
+}
+
+TEST_CASE("low battery drops fast, critical pauses", "[adv_gov]") {
+  ble_adv_gov_t g = gov(true);
+  ble_adv_gov_set_battery(&g, BLE_ADV_GOV_LOW_BATT_PCT, false);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_SLOW, ble_adv_gov_update(&g, T0));
+  ble_adv_gov_set_battery(&g, BLE_ADV_GOV_CRITICAL_BATT_PCT, false);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_PAUSED, ble_adv_gov_update(&g, T0));
+  // Plugged in: back to normal
+  ble_adv_gov_set_battery(&g, BLE_ADV_GOV_CRITICAL_BATT_PCT, true);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_FAST, ble_adv_gov_update(&g, T0));
+}
+
+TEST_CASE("pair now overrides battery and screen", "[adv_gov]") {
+  ble_adv_gov_t g = gov(true);
+  ble_adv_gov_set_screen(&g, false, T0);
+  ble_adv_gov_set_battery(&g, 1, false);
+  int64_t t = T0 + 3 * BLE_ADV_GOV_SLOW_MS;
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_PAUSED, ble_adv_gov_update(&g, t));
+
+  ble_adv_gov_pair_now(&g, t);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_FAST, ble_adv_gov_update(&g, t));
+  TEST_ASSERT_EQUAL_UINT32(BLE_ADV_GOV_PAIR_BURST_MS, ble_adv_gov_next_ms(&g, t));
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_PAUSED, ble_adv_gov_update(&g, t + BLE_ADV_GOV_PAIR_BURST_MS));
+  TEST_ASSERT_EQUAL_UINT32(1, g.pair_bursts);
+}
+
+TEST_CASE("connected: paused and no time accounted", "[adv_gov]") {
+  ble_adv_gov_t g = gov(true);
+  ble_adv_gov_update(&g, T0 + 1000);
+  ble_adv_gov_set_connected(&g, true, T0 + 2000);
+  TEST_ASSERT_EQUAL(BLE_ADV_TIER_PAUSED, ble_adv_gov_update(&g, T0 + 2000));
+  TEST_ASSERT_EQUAL_UINT32(BLE_ADV_GOV_NEVER, ble_adv_gov_next_ms(&g, T0 + 2000));
+  ble_adv_gov_update(&g, T0 + 60000);
+
+  TEST_ASSERT_EQUAL_UINT64(2000, g.tier_ms[BLE_ADV_TIER_FAST]);
+  TEST_ASSERT_EQUAL_UINT64(0, g.tier_ms[BLE_ADV_TIER_SLOW]);
+  TEST_ASSERT_EQUAL_UINT64(0, g.tier_ms[BLE_ADV_TIER_PAUSED]);
+}
+
+TEST_CASE("slow tier costs a fraction of fast", "[adv_gov]") {
+  ble_adv_gov_cfg_t cfg;
+  ble_adv_gov_default_cfg(&cfg);
+  uint32_t fast = ble_adv_gov_tier_ua(&cfg, BLE_ADV_TIER_FAST);
+  uint32_t slow = ble_adv_gov_tier_ua(&cfg, BLE_ADV_TIER_SLOW);
+  TEST_ASSERT_EQUAL_UINT32(0, ble_adv_gov_tier_ua(&cfg, BLE_ADV_TIER_PAUSED));
+  // 150 uC every 30 + 5 ms
+  TEST_ASSERT_EQUAL_UINT32(4286, fast);
+  TEST_ASSERT_TRUE(slow * 20 < fast);
+
+  // One hour of fast advertising
+  ble_adv_gov_t g = gov(true);
+  g.tier_ms[BLE_ADV_TIER_FAST] = 3600000;
+  TEST_ASSERT_EQUAL_UINT32(fast, ble_adv_gov_tier_uah(&g, BLE_ADV_TIER_FAST));
+}
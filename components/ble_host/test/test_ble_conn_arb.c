@@ -0,0 +1,82 @@
+#include "unity.h"
+
+#include "ble_conn_arb.h"
+
+#define T0 1000
+
+static ble_conn_arb_t arb(void) {
+  ble_conn_arb_t a;
+  ble_conn_arb_init(&a);
+  return a;
+}
+
+// What ble_host does on the host task
+static ble_conn_profile_t apply(ble_conn_arb_t* a, int64_t now) {
+  ble_conn_profile_t p = ble_conn_arb_update(a, now);
+  if (p != a->applied) ble_conn_arb_applied(a, p);
+  return p;
+}
+
+TEST_CASE("connect: the central's parameters stay", "[conn_arb]") {
+  ble_conn_arb_t a = arb();
+  TEST_ASSERT_EQUAL(BLE_CONN_CENTRAL, ble_conn_arb_update(&a, T0));
+  TEST_ASSERT_EQUAL_UINT32(BLE_CONN_ARB_NEVER, ble_conn_arb_next_ms(&a, T0));
+  TEST_ASSERT_NULL(ble_conn_arb_params(BLE_CONN_CENTRAL));
+}
+
+TEST_CASE("HID reports keep the link fast for the hold time", "[conn_arb]") {
+  ble_conn_arb_t a = arb();
+  ble_conn_arb_interactive(&a, T0);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0));
+  TEST_ASSERT_EQUAL_UINT32(BLE_CONN_ARB_HOLD_MS, ble_conn_arb_next_ms(&a, T0));
+
+  // Still moving: the hold slides
+  ble_conn_arb_interactive(&a, T0 + 4000);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0 + 4000 + BLE_CONN_ARB_HOLD_MS - 1));
+  // Quiet: back to idle, not to whatever the central had picked
+  TEST_ASSERT_EQUAL(BLE_CONN_IDLE, apply(&a, T0 + 4000 + BLE_CONN_ARB_HOLD_MS));
+  TEST_ASSERT_EQUAL_UINT32(BLE_CONN_ARB_NEVER, ble_conn_arb_next_ms(&a, T0 + 4000 + BLE_CONN_ARB_HOLD_MS));
+}
+
+TEST_CASE("a history sync under the mouse changes nothing", "[conn_arb]") {
+  ble_conn_arb_t a = arb();
+  ble_conn_arb_interactive(&a, T0);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0));
+  ble_conn_arb_request(&a, BLE_CONN_REQ_BULK);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0 + 10));
+  ble_conn_arb_request(&a, BLE_CONN_REQ_NONE);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0 + 20));
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, a.applied);
+}
+
+TEST_CASE("the UART can relax the link only while HID is quiet", "[conn_arb]") {
+  ble_conn_arb_t a = arb();
+  ble_conn_arb_request(&a, BLE_CONN_REQ_RELAXED);
+  TEST_ASSERT_EQUAL(BLE_CONN_RELAXED, apply(&a, T0));
+
+  ble_conn_arb_interactive(&a, T0 + 100);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0 + 100));
+  TEST_ASSERT_EQUAL(BLE_CONN_RELAXED, apply(&a, T0 + 100 + BLE_CONN_ARB_HOLD_MS));
+
+  // Bulk wins over relaxed
+  ble_conn_arb_request(&a, BLE_CONN_REQ_BULK);
+  TEST_ASSERT_EQUAL(BLE_CONN_FAST, apply(&a, T0 + 20000));
+}
+
+TEST_CASE("profiles are valid connection parameters", "[conn_arb]") {
+  const ble_conn_params_t* fast = ble_conn_arb_params(BLE_CONN_FAST);
+  const ble_conn_params_t* idle = ble_conn_arb_params(BLE_CONN_IDLE);
+  TEST_ASSERT_TRUE(fast->itvl_min >= 6);  // 7.5 ms, spec minimum
+  TEST_ASSERT_TRUE(fast->itvl_max <= 12); // at least ~66 HID reports/s
+  TEST_ASSERT_TRUE(fast->itvl_max < idle->itvl_min);
+
+  for (int p = BLE_CONN_IDLE; p < BLE_CONN_PROFILES; ++p) {
+    const ble_conn_params_t* c = ble_conn_arb_params((ble_conn_profile_t)p);
+    TEST_ASSERT_TRUE(c->itvl_min <= c->itvl_max);
+    if (c->supervision_timeout) {
+      // Timeout (10 ms) > (1 + latency) * itvl_max (1.25 ms) * 2
+      TEST_ASSERT_TRUE((uint32_t)c->supervision_timeout * 8 > (1u + c->latency) * c->itvl_max * 2);
+      TEST_ASSERT_TRUE(c->supervision_timeout <= 3200);
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#include "unity.h"
+
+#include "ble_peer_cache.h"
+
+#include <string.h>
+
+static ble_peer_addr_t peer(uint8_t type, uint8_t last) {
+  ble_peer_addr_t a = { .type = type, .val = { last, 0x22, 0x33, 0x44, 0x55, 0x66 } };
+  return a;
+}
+
+TEST_CASE("touch keeps the most recent peer first", "[peer_cache]") {
+  ble_peer_cache_t c;
+  ble_peer_cache_init(&c);
+  TEST_ASSERT_TRUE(ble_peer_cache_valid(&c));
+  TEST_ASSERT_NULL(ble_peer_cache_last(&c));
+
+  ble_peer_addr_t a = peer(0, 1), b = peer(0, 2);
+  TEST_ASSERT_TRUE(ble_peer_cache_touch(&c, &a));
+  TEST_ASSERT_TRUE(ble_peer_cache_touch(&c, &b));
+  TEST_ASSERT_EQUAL(2, c.n);
+  TEST_ASSERT_EQUAL_MEMORY(&b, ble_peer_cache_last(&c), sizeof(b));
+
+  // Reconnecting the front peer changes nothing (no NVS write)
+  TEST_ASSERT_FALSE(ble_peer_cache_touch(&c, &b));
+  TEST_ASSERT_TRUE(ble_peer_cache_touch(&c, &a));
+  TEST_ASSERT_EQUAL(2, c.n);
+  TEST_ASSERT_EQUAL_MEMORY(&a, &c.e[0], sizeof(a));
+  TEST_ASSERT_EQUAL_MEMORY(&b, &c.e[1], sizeof(b));
+}
+
+TEST_CASE("address type is part of the identity", "[peer_cache]") {
+  ble_peer_cache_t c;
+  ble_peer_cache_init(&c);
+  ble_peer_addr_t pub = peer(0, 7), rnd = peer(1, 7);
+  ble_peer_cache_touch(&c, &pub);
+  ble_peer_cache_touch(&c, &rnd);
+  TEST_ASSERT_EQUAL(2, c.n);
+}
+
+TEST_CASE("full cache drops the oldest peer", "[peer_cache]") {
+  ble_peer_cache_t c;
+  ble_peer_cache_init(&c);
+  for (int i = 0; i <= BLE_PEER_CACHE_MAX; ++i) {
+    ble_peer_addr_t a = peer(0, (uint8_t)i);
+    ble_peer_cache_touch(&c, &a);
+  }
+  TEST_ASSERT_EQUAL(BLE_PEER_CACHE_MAX, c.n);
+  ble_peer_addr_t first = peer(0, 0), newest = peer(0, BLE_PEER_CACHE_MAX);
+  TEST_ASSERT_FALSE(ble_peer_cache_forget(&c, &first));
+  TEST_ASSERT_EQUAL_MEMORY(&newest, ble_peer_cache_last(&c), sizeof(newest));
+  ble_peer_addr_t oldest = peer(0, 1);
+  TEST_ASSERT_EQUAL_MEMORY(&oldest, &c.e[BLE_PEER_CACHE_MAX - 1], sizeof(oldest));
+}
+
+TEST_CASE("forget and retain follow the bond store", "[peer_cache]") {
+  ble_peer_cache_t c;
+  ble_peer_cache_init(&c);
+  ble_peer_addr_t a = peer(0, 1), b = peer(0, 2), x = peer(1, 3);
+  ble_peer_cache_touch(&c, &a);
+  ble_peer_cache_touch(&c, &b);
+  ble_peer_cache_touch(&c, &x);
+
+  TEST_ASSERT_TRUE(ble_peer_cache_forget(&c, &b));
+  TEST_ASSERT_FALSE(ble_peer_cache_forget(&c, &b));
+  TEST_ASSERT_EQUAL(2, c.n);
+  TEST_ASSERT_EQUAL_MEMORY(&x, &c.e[0], sizeof(x));
+  TEST_ASSERT_EQUAL_MEMORY(&a, &c.e[1], sizeof(a));
+
+  // The store evicted x: only a survives, order kept
+  ble_peer_addr_t bonded[] = { a, b };
+  TEST_ASSERT_TRUE(ble_peer_cache_retain(&c, bonded, 2));
+  TEST_ASSERT_EQUAL(1, c.n);
+  TEST_ASSERT_EQUAL_MEMORY(&a, ble_peer_cache_last(&c), sizeof(a));
+  TEST_ASSERT_FALSE(ble_peer_cache_retain(&c, bonded, 2));
+
+  TEST_ASSERT_TRUE(ble_peer_cache_retain(&c, NULL, 0));
+  TEST_ASSERT_NULL(ble_peer_cache_last(&c));
+}
+
+TEST_CASE("blob from NVS is checked", "[peer_cache]") {
+  ble_peer_cache_t c;
+  memset(&c, 0xFF, sizeof(c));
+  TEST_ASSERT_FALSE(ble_peer_cache_valid(&c));
+  ble_peer_cache_init(&c);
+  c.n = BLE_PEER_CACHE_MAX + 1;
+  TEST_ASSERT_FALSE(ble_peer_cache_valid(&c));
+}
@@ -0,0 +1,189 @@
+// Chunk reassembly pool for large BLE messages (see ble_chunk.h)
+
+#include "ble_chunk.h"
+
+#include <string.h>
+
+// XFER(2+2) SEQ(2+1) COUNT(2+1) OFFSET(2+4) INNER(2+1) DATA(2+n)
+#define CHUNK_HDR_MAX (4 + 3 + 3 + 6 + 3 + 2)
+
+void ble_chunk_pool_init(ble_chunk_pool_t* pool, uint8_t* storage, unsigned nslots, size_t slot_bytes)
+{
+    memset(pool, 0, sizeof(*pool));
+    if (nslots > BLE_CHUNK_MAX_SLOTS) nslots = BLE_CHUNK_MAX_SLOTS;
+    if (!storage) nslots = 0;
+    pool->nslots = nslots;
+    pool->slot_bytes = slot_bytes;
+    for (unsigned i = 0; i < nslots; ++i) {
+        pool->slot[i].buf = storage + i * slot_bytes;
+    }
+}
+
+static bool recently_completed(const ble_chunk_pool_t* pool, uint16_t xfer)
+{
+    for (unsigned i = 0; i < pool->recent_n; ++i) {
+        if (pool->recent[i] == xfer) return true;
+    }
+    return false;
+}
+
+static void remember(ble_chunk_pool_t* pool, uint16_t xfer)
+{
+    pool->recent[pool->recent_pos] = xfer;
+    pool->recent_pos = (pool->recent_pos + 1) % BLE_CHUNK_RECENT;
+    if (pool->recent_n < BLE_CHUNK_RECENT) pool->recent_n++;
+}
+
+static ble_chunk_slot_t* slot_for(ble_chunk_pool_t* pool, uint16_t xfer, uint32_t now_ms)
+{
+    ble_chunk_slot_t* free_slot = NULL;
+    ble_chunk_slot_t* oldest = NULL;
+    for (unsigned i = 0; i < pool->nslots; ++i) {
+        ble_chunk_slot_t* s = &pool->slot[i];
+        if (s->used && s->xfer == xfer) return s;
+        if (!s->used) {
+            if (!free_slot) free_slot = s;
+        } else if (s->count != 0 && (!oldest || s->last_ms < oldest->last_ms)) {
+            oldest = s;  // count == 0 marks a slot lent out as COMPLETE
+        }
+    }
+    ble_chunk_slot_t* s = free_slot;
+    if (!s && oldest) {
+        pool->stats.evicted++;
+        s = oldest;
+    }
+    if (!s) return NULL;
+    memset(s, 0, offsetof(ble_chunk_slot_t, buf));
+    s->used = true;
+    s->xfer = xfer;
+    s->first_ms = now_ms;
+    return s;
+}
+
+ble_chunk_result_t ble_chunk_feed(ble_chunk_pool_t* pool, const ble_proto_frame_t* f, uint32_t now_ms,
+                                  ble_chunk_msg_t* out)
+{
+    if (f->type != BLE_MSG_CHUNK) return BLE_CHUNK_REJECTED;
+    pool->stats.chunks++;
+    ble_chunk_expire(pool, now_ms);
+
+    uint32_t xfer = 0, seq = 0, count = 0, offset = 0, inner = 0;
+    bool has[5] = { false };
+    const uint8_t* data = NULL;
+    size_t dlen = 0;
+
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        switch (t.tag) {
+        case BLE_TAG_XFER:   xfer = ble_proto_tlv_uint(&t); has[0] = true; break;
+        case BLE_TAG_SEQ:    seq = ble_proto_tlv_uint(&t); has[1] = true; break;
+        case BLE_TAG_COUNT:  count = ble_proto_tlv_uint(&t); has[2] = true; break;
+        case BLE_TAG_OFFSET: offset = ble_proto_tlv_uint(&t); has[3] = true; break;
+        case BLE_TAG_INNER:  inner = ble_proto_tlv_uint(&t); has[4] = true; break;
+        case BLE_TAG_DATA:   data = t.val; dlen = t.len; break;
+        default: break;
+        }
+    }
+    if (!has[0] || !has[1] || !has[2] || !has[3] || !has[4] || !data || xfer > 0xFFFF ||
+        count == 0 || count > BLE_CHUNK_MAX_PARTS || seq >= count ||
+        (uint64_t)offset + dlen > pool->slot_bytes) {
+        pool->stats.rejected++;
+        return BLE_CHUNK_REJECTED;
+    }
+    if (recently_completed(pool, (uint16_t)xfer)) {
+        pool->stats.duplicates++;
+        return BLE_CHUNK_DUPLICATE;
+    }
+
+    ble_chunk_slot_t* s = slot_for(pool, (uint16_t)xfer, now_ms);
+    if (!s) {
+        pool->stats.rejected++;
+        return BLE_CHUNK_REJECTED;
+    }
+    if (s->count == 0) {
+        s->count = (uint8_t)count;
+        s->inner = (uint8_t)inner;
+    } else if (s->count != count || s->inner != inner) {
+        // Same id reused for a different message: start over with this one
+        memset(s, 0, offsetof(ble_chunk_slot_t, buf));
+        s->used = true;
+        s->xfer = (uint16_t)xfer;
+        s->first_ms = now_ms;
+        s->count = (uint8_t)count;
+        s->inner = (uint8_t)inner;
+        pool->stats.rejected++;
+    }
+
+    uint32_t bit = 1u << seq;
+    s->last_ms = now_ms;
+    if (s->have & bit) {
+        pool->stats.duplicates++;
+        return BLE_CHUNK_DUPLICATE;
+    }
+    memcpy(s->buf + offset, data, dlen);
+    s->have |= bit;
+    if (offset + dlen > s->len) s->len = offset + dlen;
+
+    uint32_t all = count == 32 ? 0xFFFFFFFFu : ((1u << count) - 1);
+    if (s->have != all) return BLE_CHUNK_PENDING;
+
+    pool->stats.completed++;
+    remember(pool, s->xfer);
+    s->count = 0;  // lent out: not matched, expired or evicted until released
+    out->type = s->inner;
+    out->data = s->buf;
+    out->len = s->len;
+    out->slot = (int)(s - pool->slot);
+    return BLE_CHUNK_COMPLETE;
+}
+
+void ble_chunk_release(ble_chunk_pool_t* pool, const ble_chunk_msg_t* msg)
+{
+    if (msg->slot < 0 || (unsigned)msg->slot >= pool->nslots) return;
+    pool->slot[msg->slot].used = false;
+}
+
+unsigned ble_chunk_expire(ble_chunk_pool_t* pool, uint32_t now_ms)
+{
+    unsigned n = 0;
+    for (unsigned i = 0; i < pool->nslots; ++i) {
+        ble_chunk_slot_t* s = &pool->slot[i];
+        if (s->used && s->count != 0 && (uint32_t)(now_ms - s->last_ms) >= BLE_CHUNK_TIMEOUT_MS) {
+            s->used = false;
+            n++;
+        }
+    }
+    pool->stats.timeouts += n;
+    return n;
+}
+
+void ble_chunk_as_frame(const ble_chunk_msg_t* msg, ble_proto_frame_t* f)
+{
+    f->type = msg->type;
+    f->len = (uint16_t)(msg->len > 0xFFFF ? 0xFFFF : msg->len);
+    f->payload = msg->data;
+}
+
+size_t ble_chunk_encode(uint8_t* buf, size_t cap, uint16_t xfer, uint8_t seq, uint8_t count,
+                        uint32_t offset, uint8_t inner, const uint8_t* data, size_t len)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_CHUNK);
+    ble_proto_put_uint(&w, BLE_TAG_XFER, xfer);
+    ble_proto_put_uint(&w, BLE_TAG_SEQ, seq);
+    ble_proto_put_uint(&w, BLE_TAG_COUNT, count);
+    ble_proto_put_uint(&w, BLE_TAG_OFFSET, offset);
+    ble_proto_put_uint(&w, BLE_TAG_INNER, inner);
+    ble_proto_put_bytes(&w, BLE_TAG_DATA, data, len);
+    return ble_proto_finish(&w);
+}
+
+size_t ble_chunk_data_max(size_t frame_cap)
+{
+    size_t hdr = BLE_PROTO_OVERHEAD + CHUNK_HDR_MAX;
+    if (frame_cap <= hdr) return 0;
+    size_t n = frame_cap - hdr;
+    return n > 255 ? 255 : n;
+}
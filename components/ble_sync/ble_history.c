@@ -0,0 +1,212 @@
+// History log and resumable batch sender (see ble_history.h)
+
+#include "ble_history.h"
+
+#include <string.h>
+
+// CURSOR(2+4) MORE(2+1) ID(2+4) PREV(2+4) written after the records
+#define BATCH_TAIL (6 + 3 + 6 + 6)
+
+void ble_hist_log_init(ble_hist_log_t* log, ble_hist_rec_t* storage, unsigned cap, uint32_t epoch)
+{
+    log->recs = storage;
+    log->cap = storage ? cap : 0;
+    log->next_seq = 1;
+    log->epoch = epoch;
+    if (log->cap) memset(storage, 0, sizeof(*storage) * cap);
+}
+
+uint32_t ble_hist_log_append(ble_hist_log_t* log, uint8_t kind, uint32_t ts, const void* data, size_t len)
+{
+    if (!log->cap) return 0;
+    uint32_t seq = log->next_seq++;
+    ble_hist_rec_t* r = &log->recs[(seq - 1) % log->cap];
+    if (len > BLE_HIST_REC_DATA) len = BLE_HIST_REC_DATA;
+    r->seq = seq;
+    r->ts = ts;
+    r->kind = kind;
+    r->len = (uint8_t)len;
+    if (len) memcpy(r->data, data, len);
+    return seq;
+}
+
+uint32_t ble_hist_log_newest(const ble_hist_log_t* log)
+{
+    return log->next_seq - 1;
+}
+
+uint32_t ble_hist_log_oldest(const ble_hist_log_t* log)
+{
+    uint32_t n = log->next_seq - 1;
+    if (n == 0) return 0;
+    return n > log->cap ? n - log->cap + 1 : 1;
+}
+
+const ble_hist_rec_t* ble_hist_log_get(const ble_hist_log_t* log, uint32_t seq)
+{
+    uint32_t oldest = ble_hist_log_oldest(log);
+    if (oldest == 0 || seq < oldest || seq > ble_hist_log_newest(log)) return NULL;
+    return &log->recs[(seq - 1) % log->cap];
+}
+
+// ------------------------------------------------------------------ sender
+
+void ble_hist_tx_start(ble_hist_tx_t* tx, const ble_hist_log_t* log, uint32_t since, uint32_t max,
+                       uint32_t now_ms)
+{
+    ble_hist_stats_t stats = tx->stats;
+    memset(tx, 0, sizeof(*tx));
+    tx->stats = stats;
+
+    uint32_t newest = ble_hist_log_newest(log);
+    // A cursor from before a reboot (or another log) is ahead of us: resend all
+    if (since > newest) since = 0;
+    uint32_t end = newest;
+    if (max && end - since > max) end = since + max;
+
+    tx->active = true;
+    tx->acked = since;
+    tx->sent = since;
+    tx->end = end;
+    tx->last_progress_ms = now_ms;
+}
+
+void ble_hist_tx_abort(ble_hist_tx_t* tx)
+{
+    tx->active = false;
+    tx->ninflight = 0;
+}
+
+bool ble_hist_tx_ack(ble_hist_tx_t* tx, uint32_t cursor, uint32_t now_ms)
+{
+    if (!tx->active) return false;
+    if (cursor > tx->sent) cursor = tx->sent;
+    if (cursor > tx->acked) {
+        tx->acked = cursor;
+        tx->last_progress_ms = now_ms;
+    }
+    unsigned k = 0;
+    while (k < tx->ninflight && tx->inflight[k] <= tx->acked) k++;
+    if (k) {
+        memmove(tx->inflight, tx->inflight + k, (tx->ninflight - k) * sizeof(tx->inflight[0]));
+        tx->ninflight -= k;
+    }
+    if (tx->acked >= tx->end && tx->announced) {
+        tx->active = false;
+        return true;
+    }
+    return false;
+}
+
+bool ble_hist_tx_poll(ble_hist_tx_t* tx, uint32_t now_ms)
+{
+    if (!tx->active || tx->ninflight == 0) return false;
+    if ((uint32_t)(now_ms - tx->last_progress_ms) < BLE_HIST_TIMEOUT_MS) return false;
+    tx->sent = tx->acked;
+    tx->ninflight = 0;
+    tx->last_progress_ms = now_ms;
+    tx->stats.retransmits++;
+    return true;
+}
+
+size_t ble_hist_tx_next(ble_hist_tx_t* tx, const ble_hist_log_t* log, uint8_t* buf, size_t cap,
+                        uint32_t now_ms)
+{
+    if (!tx->active || tx->ninflight >= BLE_HIST_WINDOW) return 0;
+    // Everything sent: only an empty transfer still owes its single batch
+    if (tx->sent >= tx->end && tx->announced) return 0;
+
+    const uint32_t prev = tx->sent;
+    uint32_t seq = prev + 1;
+    uint32_t oldest = ble_hist_log_oldest(log);
+    if (seq <= tx->end && oldest && seq < oldest) {
+        uint32_t skip = (oldest <= tx->end ? oldest : tx->end + 1) - seq;
+        tx->stats.lost += skip;
+        seq += skip;
+    }
+
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_HIST_BATCH);
+    uint32_t last = seq - 1;
+    unsigned nrec = 0;
+    for (; seq <= tx->end; ++seq) {
+        const ble_hist_rec_t* r = ble_hist_log_get(log, seq);
+        if (!r) break;
+        size_t need = 2 + BLE_HIST_REC_HDR + r->len;
+        if (w.len + need + BATCH_TAIL + BLE_PROTO_CRC_LEN > cap) break;
+        uint8_t v[BLE_HIST_REC_HDR + BLE_HIST_REC_DATA];
+        v[0] = (uint8_t)r->seq;
+        v[1] = (uint8_t)(r->seq >> 8);
+        v[2] = (uint8_t)(r->seq >> 16);
+        v[3] = (uint8_t)(r->seq >> 24);
+        v[4] = (uint8_t)r->ts;
+        v[5] = (uint8_t)(r->ts >> 8);
+        v[6] = (uint8_t)(r->ts >> 16);
+        v[7] = (uint8_t)(r->ts >> 24);
+        v[8] = r->kind;
+        memcpy(v + BLE_HIST_REC_HDR, r->data, r->len);
+        ble_proto_put_bytes(&w, BLE_TAG_REC, v, BLE_HIST_REC_HDR + r->len);
+        last = seq;
+        nrec++;
+    }
+    // Records skipped as lost still count as sent
+    if (nrec == 0 && last < tx->end && tx->announced) return 0;
+
+    ble_proto_put_uint(&w, BLE_TAG_ID, log->epoch);
+    ble_proto_put_uint(&w, BLE_TAG_PREV, prev);
+    ble_proto_put_uint(&w, BLE_TAG_CURSOR, last);
+    ble_proto_put_uint(&w, BLE_TAG_MORE, last < tx->end);
+    size_t n = ble_proto_finish(&w);
+    if (n == 0) return 0;
+
+    if (tx->ninflight == 0) tx->last_progress_ms = now_ms;
+    tx->inflight[tx->ninflight++] = last;
+    tx->sent = last;
+    tx->announced = true;
+    tx->stats.batches++;
+    tx->stats.records += nrec;
+    tx->stats.bytes += (uint32_t)n;
+    return n;
+}
+
+// -------------------------------------------------------------- peer side
+
+bool ble_hist_rec_decode(const ble_proto_tlv_t* t, ble_hist_rec_view_t* out)
+{
+    if (t->tag != BLE_TAG_REC || t->len < BLE_HIST_REC_HDR) return false;
+    const uint8_t* v = t->val;
+    out->seq = (uint32_t)v[0] | ((uint32_t)v[1] << 8) | ((uint32_t)v[2] << 16) | ((uint32_t)v[3] << 24);
+    out->ts = (uint32_t)v[4] | ((uint32_t)v[5] << 8) | ((uint32_t)v[6] << 16) | ((uint32_t)v[7] << 24);
+    out->kind = v[8];
+    out->data = v + BLE_HIST_REC_HDR;
+    out->len = (uint8_t)(t->len - BLE_HIST_REC_HDR);
+    return true;
+}
+
+uint32_t ble_hist_frame_cursor(const ble_proto_frame_t* f)
+{
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        if (t.tag == BLE_TAG_CURSOR) return ble_proto_tlv_uint(&t);
+    }
+    return 0;
+}
+
+size_t ble_hist_encode_request(uint8_t* buf, size_t cap, uint32_t since, uint32_t max)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_HISTORY);
+    ble_proto_put_uint(&w, BLE_TAG_CURSOR, since);
+    if (max) ble_proto_put_uint(&w, BLE_TAG_COUNT, max);
+    return ble_proto_finish(&w);
+}
+
+size_t ble_hist_encode_ack(uint8_t* buf, size_t cap, uint32_t cursor)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_HIST_ACK);
+    ble_proto_put_uint(&w, BLE_TAG_CURSOR, cursor);
+    return ble_proto_finish(&w);
+}
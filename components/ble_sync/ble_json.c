@@ -0,0 +1,342 @@
+// In-place JSON tokenizer for BLE messages (see ble_json.h)
+
+#include "ble_json.h"
+
+#include <string.h>
+
+typedef struct {
+    const char* js;
+    unsigned len;
+    unsigned pos;
+    unsigned next;      // next free token
+    int super;          // current container, or key awaiting its value
+    int depth;
+    bool root_done;
+} parser_t;
+
+static int tok_alloc(parser_t* p, ble_json_tok_t* toks, unsigned max, ble_json_type_t type,
+                     unsigned start, unsigned end)
+{
+    if (p->next >= max) return BLE_JSON_ERR_NOMEM;
+    int i = (int)p->next++;
+    toks[i].type = (uint8_t)type;
+    toks[i].start = (uint16_t)start;
+    toks[i].end = (uint16_t)end;
+    toks[i].size = 0;
+    toks[i].parent = (int16_t)p->super;
+    return i;
+}
+
+// A value (not a key) is about to be added under p->super
+static int value_slot_ok(const parser_t* p, const ble_json_tok_t* toks)
+{
+    if (p->super < 0) return p->root_done ? BLE_JSON_ERR_INVAL : 0;
+    const ble_json_tok_t* s = &toks[p->super];
+    if (s->type == BLE_JSON_OBJECT) return BLE_JSON_ERR_INVAL;           // keys must be strings
+    if (s->type == BLE_JSON_STRING && s->size > 0) return BLE_JSON_ERR_INVAL;  // key already has a value
+    return 0;
+}
+
+static void add_child(parser_t* p, ble_json_tok_t* toks)
+{
+    if (p->super >= 0) toks[p->super].size++;
+    else p->root_done = true;
+}
+
+static bool is_hex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static int parse_string(parser_t* p, ble_json_tok_t* toks, unsigned max)
+{
+    unsigned start = p->pos + 1;
+    for (unsigned i = start; i < p->len; ++i) {
+        char c = p->js[i];
+        if (c == '\0') break;
+        if (c == '"') {
+            bool is_key = p->super >= 0 && toks[p->super].type == BLE_JSON_OBJECT;
+            if (!is_key) {
+                int e = value_slot_ok(p, toks);
+                if (e) return e;
+            }
+            int t = tok_alloc(p, toks, max, BLE_JSON_STRING, start, i);
+            if (t < 0) return t;
+            add_child(p, toks);
+            p->pos = i;
+            return 0;
+        }
+        if ((unsigned char)c < 0x20) return BLE_JSON_ERR_INVAL;
+        if (c == '\\') {
+            if (++i >= p->len || p->js[i] == '\0') break;
+            switch (p->js[i]) {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                break;
+            case 'u':
+                for (int k = 0; k < 4; ++k) {
+                    if (++i >= p->len || p->js[i] == '\0') return BLE_JSON_ERR_PART;
+                    if (!is_hex(p->js[i])) return BLE_JSON_ERR_INVAL;
+                }
+                break;
+            default:
+                return BLE_JSON_ERR_INVAL;
+            }
+        }
+    }
+    return BLE_JSON_ERR_PART;
+}
+
+static int parse_primitive(parser_t* p, ble_json_tok_t* toks, unsigned max)
+{
+    char c0 = p->js[p->pos];
+    if (!(c0 == '-' || (c0 >= '0' && c0 <= '9') || c0 == 't' || c0 == 'f' || c0 == 'n')) {
+        return BLE_JSON_ERR_INVAL;
+    }
+    int e = value_slot_ok(p, toks);
+    if (e) return e;
+
+    unsigned i = p->pos;
+    for (; i < p->len; ++i) {
+        char c = p->js[i];
+        if (c == '\0' || c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' ||
+            c == '\r' || c == '\n') {
+            break;
+        }
+        if ((unsigned char)c < 0x20 || (unsigned char)c >= 0x7F || c == ':' || c == '"' ||
+            c == '{' || c == '[') {
+            return BLE_JSON_ERR_INVAL;
+        }
+    }
+    int t = tok_alloc(p, toks, max, BLE_JSON_PRIMITIVE, p->pos, i);
+    if (t < 0) return t;
+    add_child(p, toks);
+    p->pos = i - 1;
+    return 0;
+}
+
+int ble_json_parse(const char* js, size_t len, ble_json_tok_t* toks, unsigned max_toks)
+{
+    parser_t p = {
+        .js = js,
+        .len = len > 0xFFFF ? 0xFFFF : (unsigned)len,
+        .super = -1,
+    };
+
+    for (; p.pos < p.len && js[p.pos] != '\0'; ++p.pos) {
+        char c = js[p.pos];
+        int e = 0;
+        switch (c) {
+        case '{':
+        case '[': {
+            bool is_key = p.super >= 0 && toks[p.super].type == BLE_JSON_OBJECT;
+            if (is_key) return BLE_JSON_ERR_INVAL;
+            e = value_slot_ok(&p, toks);
+            if (e) return e;
+            if (p.depth >= BLE_JSON_MAX_DEPTH) return BLE_JSON_ERR_DEPTH;
+            int t = tok_alloc(&p, toks, max_toks, c == '{' ? BLE_JSON_OBJECT : BLE_JSON_ARRAY,
+                              p.pos, 0);
+            if (t < 0) return t;
+            add_child(&p, toks);
+            p.super = t;
+            p.depth++;
+            break;
+        }
+        case '}':
+        case ']': {
+            int s = p.super;
+            if (s >= 0 && toks[s].type == BLE_JSON_STRING) {
+                if (toks[s].size == 0) return BLE_JSON_ERR_INVAL;  // key without value
+                s = toks[s].parent;
+            }
+            if (s < 0 || toks[s].type != (c == '}' ? BLE_JSON_OBJECT : BLE_JSON_ARRAY)) {
+                return BLE_JSON_ERR_INVAL;
+            }
+            toks[s].end = (uint16_t)(p.pos + 1);
+            p.super = toks[s].parent;
+            p.depth--;
+            break;
+        }
+        case '"':
+            e = parse_string(&p, toks, max_toks);
+            break;
+        case ':': {
+            int k = (int)p.next - 1;
+            if (p.super < 0 || toks[p.super].type != BLE_JSON_OBJECT || k < 0 ||
+                toks[k].type != BLE_JSON_STRING || toks[k].parent != p.super) {
+                return BLE_JSON_ERR_INVAL;
+            }
+            p.super = k;
+            break;
+        }
+        case ',':
+            if (p.super >= 0 && toks[p.super].type == BLE_JSON_STRING) {
+                if (toks[p.super].size == 0) return BLE_JSON_ERR_INVAL;
+                p.super = toks[p.super].parent;
+            }
+            if (p.super < 0) return BLE_JSON_ERR_INVAL;
+            break;
+        case ' ': case '\t': case '\r': case '\n':
+            break;
+        default:
+            e = parse_primitive(&p, toks, max_toks);
+            break;
+        }
+        if (e) return e;
+    }
+
+    if (p.depth != 0) return BLE_JSON_ERR_PART;
+    return (int)p.next;
+}
+
+int ble_json_find(const char* js, const ble_json_tok_t* toks, int ntok, const char* key)
+{
+    if (ntok < 2 || toks[0].type != BLE_JSON_OBJECT) return -1;
+    size_t klen = strlen(key);
+    for (int i = 1; i + 1 < ntok; ++i) {
+        const ble_json_tok_t* t = &toks[i];
+        if (t->parent != 0 || t->type != BLE_JSON_STRING) continue;
+        if ((size_t)(t->end - t->start) == klen && memcmp(js + t->start, key, klen) == 0 &&
+            toks[i + 1].parent == i) {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+static unsigned hex4(const char* s)
+{
+    unsigned v = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = s[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') v |= (unsigned)(c - '0');
+        else if (c >= 'a' && c <= 'f') v |= (unsigned)(c - 'a' + 10);
+        else v |= (unsigned)(c - 'A' + 10);
+    }
+    return v;
+}
+
+static size_t utf8_encode(unsigned cp, char out[4])
+{
+    if (cp < 0x80) { out[0] = (char)cp; return 1; }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+size_t ble_json_copy_str(const char* js, const ble_json_tok_t* t, char* dst, size_t cap)
+{
+    if (!dst || cap == 0) return 0;
+    size_t o = 0;
+    if (t && t->type == BLE_JSON_STRING) {
+        unsigned i = t->start;
+        while (i < t->end) {
+            char seq[4];
+            size_t n;
+            char c = js[i];
+            if (c == '\\' && i + 1 < t->end) {
+                char e = js[i + 1];
+                i += 2;
+                switch (e) {
+                case 'b': seq[0] = '\b'; n = 1; break;
+                case 'f': seq[0] = '\f'; n = 1; break;
+                case 'n': seq[0] = '\n'; n = 1; break;
+                case 'r': seq[0] = '\r'; n = 1; break;
+                case 't': seq[0] = '\t'; n = 1; break;
+                case 'u': {
+                    if (i + 4 > t->end) { i = t->end; continue; }
+                    unsigned cp = hex4(js + i);
+                    i += 4;
+                    if (cp >= 0xD800 && cp < 0xDC00 && i + 6 <= t->end && js[i] == '\\' &&
+                        js[i + 1] == 'u') {
+                        unsigned lo = hex4(js + i + 2);
+                        if (lo >= 0xDC00 && lo < 0xE000) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    if (cp >= 0xD800 && cp < 0xE000) cp = 0xFFFD;  // lone surrogate
+                    n = utf8_encode(cp, seq);
+                    break;
+                }
+                default: seq[0] = e; n = 1; break;  // " \ /
+                }
+            } else {
+                // Raw UTF-8: move whole sequences so truncation never splits one
+                unsigned char u = (unsigned char)c;
+                n = u < 0x80 ? 1 : (u >> 5) == 0x6 ? 2 : (u >> 4) == 0xE ? 3 : (u >> 3) == 0x1E ? 4 : 1;
+                if (i + n > t->end) n = t->end - i;
+                memcpy(seq, js + i, n);
+                i += (unsigned)n;
+            }
+            if (o + n > cap - 1) break;
+            memcpy(dst + o, seq, n);
+            o += n;
+        }
+    }
+    dst[o] = '\0';
+    return o;
+}
+
+bool ble_json_get_int(const char* js, const ble_json_tok_t* t, int32_t* out)
+{
+    if (!t || t->type != BLE_JSON_PRIMITIVE) return false;
+    unsigned i = t->start;
+    bool neg = false;
+    if (i < t->end && js[i] == '-') { neg = true; ++i; }
+    if (i >= t->end) return false;
+    int64_t v = 0;
+    for (; i < t->end; ++i) {
+        char c = js[i];
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+        if (v > INT32_MAX) return false;
+    }
+    *out = (int32_t)(neg ? -v : v);
+    return true;
+}
+
+bool ble_json_extract(const char* js, size_t len, ble_json_msg_t* out, ble_notif_slot_t* slot)
+{
+    ble_json_tok_t toks[BLE_JSON_MAX_TOKENS];
+    memset(out, 0, sizeof(*out));
+
+    int n = ble_json_parse(js, len, toks, BLE_JSON_MAX_TOKENS);
+    if (n < 1 || toks[0].type != BLE_JSON_OBJECT) return false;
+
+    int v = ble_json_find(js, toks, n, "datetime");
+    if (v >= 0 && toks[v].type == BLE_JSON_STRING) {
+        out->has_datetime = true;
+        ble_json_copy_str(js, &toks[v], out->datetime, sizeof(out->datetime));
+    }
+
+    v = ble_json_find(js, toks, n, "notification");
+    if (v >= 0 && toks[v].type == BLE_JSON_STRING && slot) {
+        out->has_notification = true;
+        ble_json_copy_str(js, &toks[v], slot->ts, sizeof(slot->ts));
+        // Absent or non-string fields come out as "" instead of NULL
+        int f = ble_json_find(js, toks, n, "app");
+        ble_json_copy_str(js, f >= 0 ? &toks[f] : NULL, slot->app, sizeof(slot->app));
+        f = ble_json_find(js, toks, n, "title");
+        ble_json_copy_str(js, f >= 0 ? &toks[f] : NULL, slot->title, sizeof(slot->title));
+        f = ble_json_find(js, toks, n, "message");
+        ble_json_copy_str(js, f >= 0 ? &toks[f] : NULL, slot->message, sizeof(slot->message));
+    }
+
+    v = ble_json_find(js, toks, n, "status");
+    out->has_status = v >= 0 && toks[v].type == BLE_JSON_STRING;
+    return true;
+}
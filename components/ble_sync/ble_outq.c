@@ -0,0 +1,65 @@
+// Coalescing outbound queue (see ble_outq.h)
+
+#include "ble_outq.h"
+
+#include <string.h>
+
+void ble_outq_init(ble_outq_t* q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+void ble_outq_set_interval(ble_outq_t* q, ble_out_kind_t kind, uint32_t min_interval_ms)
+{
+    if ((unsigned)kind < BLE_OUT_KIND_COUNT) q->slot[kind].min_interval_ms = min_interval_ms;
+}
+
+bool ble_outq_put(ble_outq_t* q, ble_out_kind_t kind, const void* data, size_t len, bool urgent)
+{
+    if ((unsigned)kind >= BLE_OUT_KIND_COUNT || len > BLE_OUTQ_PAYLOAD_MAX) return false;
+    q->stats.enqueued++;
+    if (q->slot[kind].pending) {
+        q->stats.coalesced++;
+    }
+    q->slot[kind].pending = true;
+    q->slot[kind].urgent |= urgent;
+    q->slot[kind].item.kind = (uint8_t)kind;
+    q->slot[kind].item.len = (uint8_t)len;
+    if (len) memcpy(q->slot[kind].item.data, data, len);
+    return true;
+}
+
+// Time left before this slot may be sent
+static uint32_t slot_wait(const ble_outq_t* q, unsigned k, uint32_t now_ms)
+{
+    if (q->slot[k].urgent || !q->slot[k].ever_sent) return 0;
+    uint32_t since = now_ms - q->slot[k].last_sent_ms;
+    return since >= q->slot[k].min_interval_ms ? 0 : q->slot[k].min_interval_ms - since;
+}
+
+uint32_t ble_outq_next_due(const ble_outq_t* q, uint32_t now_ms)
+{
+    uint32_t best = UINT32_MAX;
+    for (unsigned k = 0; k < BLE_OUT_KIND_COUNT; ++k) {
+        if (!q->slot[k].pending) continue;
+        uint32_t w = slot_wait(q, k, now_ms);
+        if (w < best) best = w;
+    }
+    return best;
+}
+
+unsigned ble_outq_take(ble_outq_t* q, uint32_t now_ms, ble_outq_item_t* out, unsigned max)
+{
+    unsigned n = 0;
+    for (unsigned k = 0; k < BLE_OUT_KIND_COUNT && n < max; ++k) {
+        if (!q->slot[k].pending || slot_wait(q, k, now_ms) > BLE_OUTQ_SLACK_MS) continue;
+        out[n++] = q->slot[k].item;
+        q->slot[k].pending = false;
+        q->slot[k].urgent = false;
+        q->slot[k].ever_sent = true;
+        q->slot[k].last_sent_ms = now_ms;
+    }
+    q->stats.sent += n;
+    if (n) q->stats.flushes++;
+    return n;
+}
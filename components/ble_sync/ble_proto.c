@@ -0,0 +1,348 @@
+// TLV frame codec for the BLE UART link (see ble_proto.h)
+
+#include "ble_proto.h"
+
+#include <string.h>
+
+uint16_t ble_proto_crc16(const uint8_t* data, size_t len, uint16_t crc)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; ++i) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// ---------------------------------------------------------------- encoding
+
+void ble_proto_begin(ble_proto_writer_t* w, uint8_t* buf, size_t cap, ble_msg_type_t type)
+{
+    w->buf = buf;
+    w->cap = cap;
+    w->len = BLE_PROTO_HDR_LEN;
+    w->overflow = cap < BLE_PROTO_OVERHEAD;
+    if (!w->overflow) {
+        buf[0] = BLE_PROTO_MAGIC;
+        buf[1] = (uint8_t)type;
+    }
+}
+
+void ble_proto_put_bytes(ble_proto_writer_t* w, uint8_t tag, const void* v, size_t len)
+{
+    if (w->overflow) return;
+    if (len > 255 || w->len + 2 + len + BLE_PROTO_CRC_LEN > w->cap) {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->len++] = tag;
+    w->buf[w->len++] = (uint8_t)len;
+    if (len) memcpy(w->buf + w->len, v, len);
+    w->len += len;
+}
+
+void ble_proto_put_uint(ble_proto_writer_t* w, uint8_t tag, uint32_t v)
+{
+    uint8_t le[4];
+    size_t n = 0;
+    do {
+        le[n++] = (uint8_t)v;
+        v >>= 8;
+    } while (v && n < 4);
+    ble_proto_put_bytes(w, tag, le, n);
+}
+
+void ble_proto_put_str(ble_proto_writer_t* w, uint8_t tag, const char* s)
+{
+    if (!s) return;
+    size_t n = strlen(s);
+    ble_proto_put_bytes(w, tag, s, n > 255 ? 255 : n);
+}
+
+void ble_proto_put_long_bytes(ble_proto_writer_t* w, uint8_t tag, const void* v, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)v;
+    do {
+        size_t k = len > 255 ? 255 : len;
+        ble_proto_put_bytes(w, tag, p, k);
+        p += k;
+        len -= k;
+    } while (len > 0);
+}
+
+void ble_proto_put_long_str(ble_proto_writer_t* w, uint8_t tag, const char* s)
+{
+    if (!s) return;
+    ble_proto_put_long_bytes(w, tag, s, strlen(s));
+}
+
+size_t ble_proto_finish(ble_proto_writer_t* w)
+{
+    if (w->overflow) return 0;
+    size_t plen = w->len - BLE_PROTO_HDR_LEN;
+    if (plen > 0xFFFF) return 0;
+    w->buf[2] = (uint8_t)plen;
+    w->buf[3] = (uint8_t)(plen >> 8);
+    uint16_t crc = ble_proto_crc16(w->buf + 1, w->len - 1, 0xFFFF);
+    w->buf[w->len++] = (uint8_t)crc;
+    w->buf[w->len++] = (uint8_t)(crc >> 8);
+    return w->len;
+}
+
+// ---------------------------------------------------------------- decoding
+
+ble_proto_err_t ble_proto_parse(const uint8_t* data, size_t len, ble_proto_frame_t* out, size_t* used)
+{
+    if (len < BLE_PROTO_OVERHEAD) return BLE_PROTO_ERR_SHORT;
+    if (data[0] != BLE_PROTO_MAGIC) return BLE_PROTO_ERR_MAGIC;
+    uint16_t plen = (uint16_t)(data[2] | (data[3] << 8));
+    size_t total = (size_t)plen + BLE_PROTO_OVERHEAD;
+    if (len < total) return BLE_PROTO_ERR_SHORT;
+
+    const uint8_t* c = data + BLE_PROTO_HDR_LEN + plen;
+    uint16_t crc = (uint16_t)(c[0] | (c[1] << 8));
+    if (ble_proto_crc16(data + 1, BLE_PROTO_HDR_LEN - 1 + plen, 0xFFFF) != crc) {
+        return BLE_PROTO_ERR_CRC;
+    }
+
+    // Reject payloads whose TLVs don't end exactly at the frame boundary
+    const uint8_t* p = data + BLE_PROTO_HDR_LEN;
+    const uint8_t* end = p + plen;
+    while (p < end) {
+        if (end - p < 2 || end - p - 2 < p[1]) return BLE_PROTO_ERR_TLV;
+        p += 2 + p[1];
+    }
+
+    out->type = data[1];
+    out->len = plen;
+    out->payload = data + BLE_PROTO_HDR_LEN;
+    if (used) *used = total;
+    return BLE_PROTO_OK;
+}
+
+void ble_proto_iter_init(ble_proto_iter_t* it, const ble_proto_frame_t* f)
+{
+    it->p = f->payload;
+    it->end = f->payload + f->len;
+}
+
+bool ble_proto_iter_next(ble_proto_iter_t* it, ble_proto_tlv_t* out)
+{
+    if (it->end - it->p < 2) return false;
+    uint8_t vlen = it->p[1];
+    if (it->end - it->p - 2 < vlen) return false;
+    out->tag = it->p[0];
+    out->len = vlen;
+    out->val = it->p + 2;
+    it->p += 2 + vlen;
+    return true;
+}
+
+uint32_t ble_proto_tlv_uint(const ble_proto_tlv_t* t)
+{
+    uint32_t v = 0;
+    for (int i = (t->len > 4 ? 4 : t->len) - 1; i >= 0; --i) {
+        v = (v << 8) | t->val[i];
+    }
+    return v;
+}
+
+static ble_proto_str_t tlv_str(const ble_proto_tlv_t* t)
+{
+    ble_proto_str_t s = { (const char*)t->val, t->len };
+    return s;
+}
+
+// --------------------------------------------------------------- messages
+
+size_t ble_proto_encode_hello(uint8_t* buf, size_t cap, const ble_msg_hello_t* m)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_HELLO);
+    ble_proto_put_uint(&w, BLE_TAG_VERSION, m->version);
+    ble_proto_put_uint(&w, BLE_TAG_CAPS, m->caps);
+    if (m->mtu) ble_proto_put_uint(&w, BLE_TAG_MTU, m->mtu);
+    return ble_proto_finish(&w);
+}
+
+size_t ble_proto_encode_time(uint8_t* buf, size_t cap, const ble_msg_time_t* m)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_TIME_SYNC);
+    if (m) {
+        const uint8_t dt[7] = { (uint8_t)m->year, (uint8_t)(m->year >> 8), m->month,
+                                m->day, m->hour, m->min, m->sec };
+        ble_proto_put_bytes(&w, BLE_TAG_DATETIME, dt, sizeof(dt));
+    }
+    return ble_proto_finish(&w);
+}
+
+size_t ble_proto_encode_notification(uint8_t* buf, size_t cap, const ble_msg_notification_t* m)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_NOTIFICATION);
+    if (m->id) ble_proto_put_uint(&w, BLE_TAG_ID, m->id);
+    ble_proto_put_str(&w, BLE_TAG_APP, m->app.p);
+    ble_proto_put_str(&w, BLE_TAG_TITLE, m->title.p);
+    ble_proto_put_str(&w, BLE_TAG_BODY, m->body.p);
+    ble_proto_put_str(&w, BLE_TAG_TS, m->ts.p);
+    return ble_proto_finish(&w);
+}
+
+size_t ble_proto_encode_status(uint8_t* buf, size_t cap, const ble_msg_status_t* m)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_STATUS);
+    ble_proto_put_uint(&w, BLE_TAG_BATTERY, m->battery);
+    ble_proto_put_uint(&w, BLE_TAG_CHARGING, m->charging ? 1 : 0);
+    ble_proto_put_uint(&w, BLE_TAG_STEPS, m->steps);
+    return ble_proto_finish(&w);
+}
+
+size_t ble_proto_encode_history(uint8_t* buf, size_t cap, const ble_msg_history_t* m)
+{
+    ble_proto_writer_t w;
+    ble_proto_begin(&w, buf, cap, BLE_MSG_HISTORY);
+    ble_proto_put_uint(&w, BLE_TAG_CURSOR, m->cursor);
+    ble_proto_put_uint(&w, BLE_TAG_COUNT, m->count);
+    return ble_proto_finish(&w);
+}
+
+bool ble_proto_decode_hello(const ble_proto_frame_t* f, ble_msg_hello_t* m)
+{
+    if (f->type != BLE_MSG_HELLO) return false;
+    memset(m, 0, sizeof(*m));
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        switch (t.tag) {
+        case BLE_TAG_VERSION: m->version = (uint8_t)ble_proto_tlv_uint(&t); break;
+        case BLE_TAG_CAPS:    m->caps = ble_proto_tlv_uint(&t); break;
+        case BLE_TAG_MTU:     m->mtu = (uint16_t)ble_proto_tlv_uint(&t); break;
+        default: break;
+        }
+    }
+    return m->version != 0;
+}
+
+bool ble_proto_decode_time(const ble_proto_frame_t* f, ble_msg_time_t* m)
+{
+    if (f->type != BLE_MSG_TIME_SYNC) return false;
+    memset(m, 0, sizeof(*m));
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        if (t.tag == BLE_TAG_DATETIME && t.len == 7) {
+            m->year = (uint16_t)(t.val[0] | (t.val[1] << 8));
+            m->month = t.val[2];
+            m->day = t.val[3];
+            m->hour = t.val[4];
+            m->min = t.val[5];
+            m->sec = t.val[6];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ble_proto_decode_notification(const ble_proto_frame_t* f, ble_msg_notification_t* m)
+{
+    if (f->type != BLE_MSG_NOTIFICATION) return false;
+    memset(m, 0, sizeof(*m));
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        switch (t.tag) {
+        case BLE_TAG_ID:    m->id = ble_proto_tlv_uint(&t); break;
+        case BLE_TAG_APP:   m->app = tlv_str(&t); break;
+        case BLE_TAG_TITLE: m->title = tlv_str(&t); break;
+        case BLE_TAG_BODY:  m->body = tlv_str(&t); break;
+        case BLE_TAG_TS:    m->ts = tlv_str(&t); break;
+        default: break;
+        }
+    }
+    return true;
+}
+
+bool ble_proto_decode_status(const ble_proto_frame_t* f, ble_msg_status_t* m)
+{
+    if (f->type != BLE_MSG_STATUS) return false;
+    memset(m, 0, sizeof(*m));
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        switch (t.tag) {
+        case BLE_TAG_BATTERY:  m->battery = (uint8_t)ble_proto_tlv_uint(&t); break;
+        case BLE_TAG_CHARGING: m->charging = ble_proto_tlv_uint(&t) != 0; break;
+        case BLE_TAG_STEPS:    m->steps = ble_proto_tlv_uint(&t); break;
+        default: break;
+        }
+    }
+    return true;
+}
+
+bool ble_proto_decode_history(const ble_proto_frame_t* f, ble_msg_history_t* m)
+{
+    if (f->type != BLE_MSG_HISTORY) return false;
+    memset(m, 0, sizeof(*m));
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        switch (t.tag) {
+        case BLE_TAG_CURSOR: m->cursor = ble_proto_tlv_uint(&t); break;
+        case BLE_TAG_COUNT:  m->count = (uint16_t)ble_proto_tlv_uint(&t); break;
+        default: break;
+        }
+    }
+    return true;
+}
+
+void ble_proto_str_copy(char* dst, size_t cap, ble_proto_str_t s)
+{
+    if (!dst || cap == 0) return;
+    size_t n = (s.p && s.len) ? s.len : 0;
+    if (n > cap - 1) n = cap - 1;
+    if (n) memcpy(dst, s.p, n);
+    dst[n] = '\0';
+}
+
+size_t ble_proto_str_concat(const ble_proto_frame_t* f, uint8_t tag, char* dst, size_t cap)
+{
+    if (!dst || cap == 0) return 0;
+    size_t o = 0;
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        if (t.tag != tag) continue;
+        size_t k = t.len;
+        if (k > cap - 1 - o) k = cap - 1 - o;
+        memcpy(dst + o, t.val, k);
+        o += k;
+    }
+    dst[o] = '\0';
+    return o;
+}
+
+size_t ble_proto_bytes_concat(const ble_proto_frame_t* f, uint8_t tag, uint8_t* dst, size_t cap)
+{
+    size_t total = 0;
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        if (t.tag != tag) continue;
+        if (total < cap) {
+            size_t k = t.len < cap - total ? t.len : cap - total;
+            memcpy(dst + total, t.val, k);
+        }
+        total += t.len;
+    }
+    return total;
+}
@@ -1,23 +1,29 @@
 #include "ble_sync.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <time.h>
 
 #include "bsp_power.h"
-#include "cJSON.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_random.h"
 #include "esp_log.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/ringbuf.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "freertos/timers.h"
 
 #include "nimble-nordic-uart.h"     // BLE REAL
+#include "ble_host.h"
 #include "rtc_lib.h"
 #include "esp-bsp.h"
+#include "esp_lvgl_port.h"
 #include "sensors.h"
 #include "esp_event.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
@@ -25,21 +31,158 @@
 #include "display_manager.h"
 #include "ui.h"
 #include "audio_alert.h"
+#include "power_manager.h"
+#include "ble_proto.h"
+#include "ble_json.h"
+#include "ble_chunk.h"
+#include "ble_history.h"
+#include "ble_outq.h"
+#include "notif_pipe.h"
+#include "app_registry.h"
+
+// Preallocated notification slots: one is filled straight from the parser
+// and travels through the pipeline below until the UI has copied it. No
+// heap use on the receive path. Each slot holds a 4 KB body, so the pool
+// is allocated once in PSRAM by ble_sync_init(). The last few slots are
+// kept for high priority notifications so a chat burst can't lock out a
+// call.
+#define NOTIF_SLOTS         12
+#define NOTIF_SLOTS_HIGH    2
+static ble_notif_slot_t* s_notif_slots;
+static volatile bool s_notif_busy[NOTIF_SLOTS];
+
+// Notification pipeline. uartTask parses and pushes into s_notif_pipe
+// without blocking; the alert task wakes the panel and plays the sound
+// (one chime per burst); the UI drain timer runs on the LVGL task and
+// renders whatever is queued within a time budget. It never pauses, so the
+// producer doesn't touch LVGL at all; while the panel is off the display
+// manager stops LVGL and with it the timer.
+#define NOTIF_UI_PERIOD_MS  20
+#define NOTIF_UI_BUDGET_US  10000
+static notif_pipe_t s_notif_pipe;
+static TaskHandle_t s_alert_task;
+static lv_timer_t* s_notif_ui_timer;
+static uint32_t s_rx_start_us;      // uartTask: current line started processing
+static uint32_t s_notif_no_slot;    // uartTask: dropped, pool exhausted
+static notif_stage_t s_stage_parse; // uartTask: line received -> queued
+static notif_stage_t s_stage_render;// LVGL task: notifications_show()
+static notif_stage_t s_stage_wake;  // alert task: display_manager_turn_on()
+static notif_stage_t s_stage_audio; // alert task: audio_alert_notify() (queues only)
+static uint32_t s_alerts_coalesced; // alert task: chimes folded into one
+
+static inline uint32_t now_us(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+// Reassembly of chunked messages (long notifications, app icons): two
+// transfers in flight, each big enough for the largest of those payloads
+#define CHUNK_SLOTS      2
+#define CHUNK_BIG_FIELD  (APP_ICON_RLE_MAX > BLE_NOTIF_MESSAGE_MAX ? APP_ICON_RLE_MAX : BLE_NOTIF_MESSAGE_MAX)
+#define CHUNK_SLOT_BYTES (CHUNK_BIG_FIELD + CHUNK_BIG_FIELD / 255 * 2 + 256)
+static ble_chunk_pool_t s_chunks;
+
+// Icon of the BLE_MSG_APP_ICON being handled (uartTask only), PSRAM
+static uint8_t* s_icon_rle;
+
+// History log (activity samples every status period, notification log),
+// fetched by the phone with BLE_MSG_HISTORY. 1024 x 64 B in PSRAM.
+#define HIST_RECORDS 1024
+static ble_hist_log_t s_hist;
+static ble_hist_tx_t s_hist_tx;
+static SemaphoreHandle_t s_hist_lock;
+static uint8_t s_hist_frame[BLE_HIST_FRAME_MAX];
+
+// Outbound status / time requests: one pending message per kind, the latest
+// wins, sent at most every STATUS_MIN_INTERVAL_MS. The sends can wait for
+// mbufs, so they go out from their own task, never from the timer service
+// or the NimBLE host task.
+#define STATUS_MIN_INTERVAL_MS 5000
+static ble_outq_t s_outq;
+static portMUX_TYPE s_outq_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_tx_task;
+static volatile bool s_offer_pending;   // TLV offer owed to a new link
 
 typedef struct {
-    char* ts; char* app; char* title; char* msg;
-} notif_async_t;
+    uint8_t battery;
+    uint8_t charging;
+} out_status_t;
+
+static void* psram_calloc(size_t n, size_t size)
+{
+    void* p = heap_caps_calloc(n, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : calloc(n, size);
+}
+
+static ble_notif_slot_t* notif_slot_get(void)
+{
+    if (!s_notif_slots) return NULL;
+    for (int i = 0; i < NOTIF_SLOTS; ++i) {
+        if (!s_notif_busy[i]) {
+            s_notif_busy[i] = true;
+            return &s_notif_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void notif_slot_put(ble_notif_slot_t* slot)
+{
+    s_notif_busy[slot - s_notif_slots] = false;
+}
+
+// Called with the slot already taken: a normal notification may not dig
+// into the high priority reserve
+static bool notif_slot_admit(notif_prio_t prio)
+{
+    if (prio == NOTIF_PRIO_HIGH) return true;
+    int free_slots = 0;
+    for (int i = 0; i < NOTIF_SLOTS; ++i) {
+        if (!s_notif_busy[i]) free_slots++;
+    }
+    return free_slots >= NOTIF_SLOTS_HIGH;
+}
+
+// LVGL task, display lock held by the port
+static void notif_ui_timer_cb(lv_timer_t* t)
+{
+    (void)t;
+    if (notif_pipe_depth(&s_notif_pipe) == 0) return;
+
+    uint32_t start = now_us();
+    bool shown = false;
+    ble_notif_slot_t* slot;
+
+    while ((uint32_t)(now_us() - start) < NOTIF_UI_BUDGET_US &&
+           (slot = notif_pipe_pop(&s_notif_pipe, now_us(), NULL)) != NULL) {
+        uint32_t t0 = now_us();
+        if (!shown) ui_show_messages_tile();
+        notifications_show(slot->app, slot->title, slot->message, slot->ts);
+        notif_slot_put(slot);
+        notif_stage_record(&s_stage_render, now_us() - t0);
+        shown = true;
+    }
+    // Left over work runs on the next period
+}
 
-static void notif_async_cb(void* p)
+// Wake the panel, then play one chime for everything that arrived
+// meanwhile. Runs apart from uartTask so neither the panel wake-up nor the
+// audio playback holds up BLE RX.
+static void notif_alert_task(void* arg)
 {
-    notif_async_t* c = (notif_async_t*)p;
-    ui_show_messages_tile();
-    notifications_show(c->app, c->title, c->msg, c->ts);
-    free(c->ts);
-    free(c->app);
-    free(c->title);
-    free(c->msg);
-    free(c);
+    (void)arg;
+    for (;;) {
+        uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (pending > 1) s_alerts_coalesced += pending - 1;
+
+        uint32_t t0 = now_us();
+        display_manager_turn_on();
+        notif_stage_record(&s_stage_wake, now_us() - t0);
+
+        t0 = now_us();
+        audio_alert_notify();
+        notif_stage_record(&s_stage_audio, now_us() - t0);
+    }
 }
 
 static const char* TAG = "BLE_SYNC";
@@ -53,77 +196,246 @@ static TimerHandle_t s_status_timer = NULL;
 static TimerHandle_t s_time_sync_timer = NULL;
 static bool s_time_sync_requested = false;
 static bool s_ble_enabled = false;
-static bool s_ble_stack_started = false;
+static bool s_uart_started = false;
+// Peer answered our HELLO: talk TLV frames instead of JSON lines
+static bool s_binary_peer = false;
+
+// Unix seconds from the RTC fields (0 until the clock has been set)
+static uint32_t hist_now(void)
+{
+    int y = rtc_get_year(), m = rtc_get_month(), d = rtc_get_day();
+    if (y < 1970 || m <= 0 || d <= 0) return 0;
+    // Days from civil (proleptic Gregorian)
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153u * (unsigned)(m + (m > 2 ? -3 : 9)) + 2) / 5 + (unsigned)d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = (int64_t)era * 146097 + doe - 719468;
+    return (uint32_t)(days * 86400 + rtc_get_hour() * 3600 + rtc_get_minute() * 60 + rtc_get_second());
+}
+
+static void hist_append(uint8_t kind, const void* data, size_t len)
+{
+    if (!s_hist_lock) return;
+    xSemaphoreTake(s_hist_lock, portMAX_DELAY);
+    ble_hist_log_append(&s_hist, kind, hist_now(), data, len);
+    xSemaphoreGive(s_hist_lock);
+}
+
+static void hist_log_activity(void)
+{
+    uint32_t steps = sensors_get_step_count();
+    uint8_t rec[6] = {
+        (uint8_t)steps, (uint8_t)(steps >> 8), (uint8_t)(steps >> 16), (uint8_t)(steps >> 24),
+        (uint8_t)bsp_power_get_battery_percent(), (uint8_t)bsp_power_is_charging(),
+    };
+    hist_append(BLE_HIST_ACTIVITY, rec, sizeof(rec));
+}
+
+// Send batches while the window allows. Runs on uartTask only.
+static void hist_pump(void)
+{
+    for (;;) {
+        xSemaphoreTake(s_hist_lock, portMAX_DELAY);
+        uint32_t now_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+        size_t n = ble_hist_tx_next(&s_hist_tx, &s_hist, s_hist_frame, sizeof(s_hist_frame), now_ms);
+        xSemaphoreGive(s_hist_lock);
+        if (n == 0) break;
+        if (nordic_uart_send_bytes(s_hist_frame, n) != ESP_OK) {
+            ESP_LOGW(TAG, "History batch not sent; retry after timeout");
+            break;
+        }
+    }
+}
+
+static void hist_finish(bool complete)
+{
+    nordic_uart_tx_report_t rep;
+    nordic_uart_tx_bulk_end(&rep);
+    ESP_LOGI(TAG, "History sync %s up to #%u: %u records, %u batches, %u retransmits, %u lost, %u B/s",
+             complete ? "done" : "interrupted", (unsigned)s_hist_tx.acked,
+             (unsigned)s_hist_tx.stats.records, (unsigned)s_hist_tx.stats.batches,
+             (unsigned)s_hist_tx.stats.retransmits, (unsigned)s_hist_tx.stats.lost,
+             (unsigned)rep.bytes_per_s);
+}
+
+static void hist_handle_request(const ble_proto_frame_t* f)
+{
+    ble_msg_history_t req;
+    if (!s_hist_lock || !ble_proto_decode_history(f, &req)) return;
+
+    if (s_hist_tx.active) hist_finish(false);
+    memset(&s_hist_tx.stats, 0, sizeof(s_hist_tx.stats));
+    xSemaphoreTake(s_hist_lock, portMAX_DELAY);
+    ble_hist_tx_start(&s_hist_tx, &s_hist, req.cursor, req.count, pdTICKS_TO_MS(xTaskGetTickCount()));
+    uint32_t pending = s_hist_tx.end - s_hist_tx.sent;
+    xSemaphoreGive(s_hist_lock);
+
+    ESP_LOGI(TAG, "History request after #%u: %u records", (unsigned)req.cursor, (unsigned)pending);
+    nordic_uart_tx_bulk_begin(pending * (2 + BLE_HIST_REC_HDR + BLE_HIST_REC_DATA / 2));
+    hist_pump();
+}
+
+static void hist_handle_ack(const ble_proto_frame_t* f)
+{
+    if (!s_hist_tx.active) return;
+    if (ble_hist_tx_ack(&s_hist_tx, ble_hist_frame_cursor(f), pdTICKS_TO_MS(xTaskGetTickCount()))) {
+        hist_finish(true);
+    } else {
+        hist_pump();
+    }
+}
 
 static void status_timer_cb(TimerHandle_t xTimer)
 {
     (void)xTimer;
+    hist_log_activity();
     if (s_ble_connected) {
         ble_sync_send_status(bsp_power_get_battery_percent(), bsp_power_is_charging());
     }
 }
 
-static void time_sync_timer_cb(TimerHandle_t xTimer)
+static void send_out_item(const ble_outq_item_t* it)
 {
-    (void)xTimer;
+    if (it->kind == BLE_OUT_TIME_REQ) {
+        if (s_binary_peer) {
+            uint8_t frame[BLE_PROTO_OVERHEAD];
+            size_t n = ble_proto_encode_time(frame, sizeof(frame), NULL);
+            nordic_uart_send_bytes(frame, n);
+        } else {
+            const char* sync_cmd = "{\"cmd\":\"time_sync\"}\n";
+            nordic_uart_sendln(sync_cmd);
+        }
+        ESP_LOGI(TAG, "Requested time sync on connect (delayed)");
+        return;
+    }
+
+    out_status_t st;
+    memcpy(&st, it->data, sizeof(st));
+    if (s_binary_peer) {
+        uint8_t frame[32];
+        const ble_msg_status_t m = {
+            .battery = st.battery,
+            .charging = st.charging,
+            .steps = sensors_get_step_count(),
+        };
+        size_t n = ble_proto_encode_status(frame, sizeof(frame), &m);
+        if (n) nordic_uart_send_bytes(frame, n);
+        return;
+    }
 
-    const char* sync_cmd = "{\"cmd\":\"time_sync\"}\n";
-    nordic_uart_sendln(sync_cmd);
-    ESP_LOGI(TAG, "Requested time sync on connect (delayed)");
+    char json[64];
+    snprintf(json, sizeof(json), "{\"battery\":%d,\"charging\":%s,\"steps\":%u}",
+             st.battery, st.charging ? "true" : "false",
+             (unsigned)sensors_get_step_count());
+    nordic_uart_sendln(json);
 }
 
-static void handle_notification_fields(const char* timestamp,
-                                       const char* app,
-                                       const char* title,
-                                       const char* message)
+// Let the TX task look at the queue again
+static void outq_kick(void)
 {
-    ESP_LOGI(TAG, "Notification: app='%s' title='%s' msg='%s' ts='%s'",
-             app, title, message, timestamp);
+    if (s_tx_task) xTaskNotifyGive(s_tx_task);
+}
 
-    display_manager_turn_on();
+// Sleeps until kicked or until the next queued message is due
+static void ble_tx_task(void* arg)
+{
+    (void)arg;
+    ble_outq_item_t items[BLE_OUT_KIND_COUNT];
 
-    bool locked = false;
-    for (int i = 0; i < 3 && !locked; ++i) {
-        locked = bsp_display_lock(150);
-        if (!locked) vTaskDelay(pdMS_TO_TICKS(10));
-    }
+    for (;;) {
+        taskENTER_CRITICAL(&s_outq_mux);
+        uint32_t due = ble_outq_next_due(&s_outq, pdTICKS_TO_MS(xTaskGetTickCount()));
+        taskEXIT_CRITICAL(&s_outq_mux);
+        ulTaskNotifyTake(pdTRUE, due == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(due));
+
+        if (s_offer_pending && s_ble_connected) {
+            s_offer_pending = false;
+            // Offer binary framing; a phone that supports it answers with a
+            // HELLO frame, older apps ignore the line and stay on JSON
+            nordic_uart_sendln("{\"proto\":\"tlv\",\"v\":1}");
+        }
 
-    if (locked) {
-        ui_show_messages_tile();
-        notifications_show(app, title, message, timestamp);
-        bsp_display_unlock();
-    } else {
-        notif_async_t* ctx = calloc(1, sizeof(notif_async_t));
-        if (ctx) {
-            ctx->ts    = timestamp ? strdup(timestamp) : NULL;
-            ctx->app   = app       ? strdup(app)       : NULL;
-            ctx->title = title     ? strdup(title)     : NULL;
-            ctx->msg   = message   ? strdup(message)   : NULL;
-            lv_async_call(notif_async_cb, ctx);
+        taskENTER_CRITICAL(&s_outq_mux);
+        unsigned n = ble_outq_take(&s_outq, pdTICKS_TO_MS(xTaskGetTickCount()), items, BLE_OUT_KIND_COUNT);
+        taskEXIT_CRITICAL(&s_outq_mux);
+
+        // Back to back: they share the next connection event. Stale updates
+        // queued before a disconnect are dropped.
+        for (unsigned i = 0; i < n && s_ble_connected; ++i) {
+            send_out_item(&items[i]);
         }
     }
+}
 
-    audio_alert_notify();
+static esp_err_t outq_put(ble_out_kind_t kind, const void* data, size_t len, bool urgent)
+{
+    if (!s_ble_enabled) return ESP_ERR_INVALID_STATE;
+    taskENTER_CRITICAL(&s_outq_mux);
+    bool ok = ble_outq_put(&s_outq, kind, data, len, urgent);
+    taskEXIT_CRITICAL(&s_outq_mux);
+    outq_kick();
+    return ok ? ESP_OK : ESP_ERR_INVALID_ARG;
 }
 
-static void process_one_json_object(const char* json, size_t len)
+static esp_err_t queue_status(int battery_percent, bool charging, bool urgent)
 {
-    char* tmp = malloc(len + 1);
-    if (!tmp) return;
+    const out_status_t st = {
+        .battery = (uint8_t)battery_percent,
+        .charging = charging,
+    };
+    return outq_put(BLE_OUT_STATUS, &st, sizeof(st), urgent);
+}
 
-    memcpy(tmp, json, len);
-    tmp[len] = '\0';
+static void time_sync_timer_cb(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+    outq_put(BLE_OUT_TIME_REQ, NULL, 0, true);
+}
 
-    cJSON* root = cJSON_Parse(tmp);
-    if (!root) {
-        free(tmp);
+// Takes ownership of slot (returned to the pool here or by the UI drain).
+// uartTask: log, queue for the UI and kick the alert task. Never blocks.
+static void handle_notification(ble_notif_slot_t* slot)
+{
+    ESP_LOGI(TAG, "Notification: app='%s' title='%s' msg=%u bytes ts='%s'",
+             slot->app, slot->title, (unsigned)strlen(slot->message), slot->ts);
+
+    char rec[BLE_HIST_REC_DATA];
+    int n = snprintf(rec, sizeof(rec), "%s\x1f%s", slot->app, slot->title);
+    hist_append(BLE_HIST_NOTIF, rec, n < 0 ? 0 : (size_t)n < sizeof(rec) ? (size_t)n : sizeof(rec) - 1);
+
+    notif_prio_t prio = notif_pipe_classify(slot->app);
+    if (!notif_slot_admit(prio) || !notif_pipe_push(&s_notif_pipe, slot, prio, now_us())) {
+        // Backlog full: the record above still reaches the phone history
+        ESP_LOGW(TAG, "Notification backlog full, '%s' not shown", slot->title);
+        notif_slot_put(slot);
+        s_notif_no_slot++;
         return;
     }
+    notif_stage_record(&s_stage_parse, now_us() - s_rx_start_us);
+
+    // No LVGL call here: the drain timer finds it on its next period. The
+    // wake only cuts the LVGL task's sleep short.
+    lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
+    if (s_alert_task) xTaskNotifyGive(s_alert_task);
+}
 
-    cJSON* datetime = cJSON_GetObjectItem(root, "datetime");
-    if (cJSON_IsString(datetime)) {
+// Parse in place over the ring-buffer item (which need not be NUL terminated)
+static void process_one_json_object(const char* json, size_t len)
+{
+    ble_json_msg_t msg;
+    ble_notif_slot_t* slot = notif_slot_get();
+
+    if (!ble_json_extract(json, len, &msg, slot)) {
+        ESP_LOGW(TAG, "Malformed JSON (%u bytes) dropped", (unsigned)len);
+        if (slot) notif_slot_put(slot);
+        return;
+    }
+
+    if (msg.has_datetime) {
         int y, m, d, h, mi, s;
-        if (sscanf(datetime->valuestring, "%d-%d-%dT%d:%d:%d",
+        if (sscanf(msg.datetime, "%d-%d-%dT%d:%d:%d",
                    &y, &m, &d, &h, &mi, &s) == 6) {
             struct tm t = {
                 .tm_year = y,
@@ -137,41 +449,185 @@ static void process_one_json_object(const char* json, size_t len)
         }
     }
 
-    cJSON* notif = cJSON_GetObjectItem(root, "notification");
-    if (cJSON_IsString(notif)) {
-        handle_notification_fields(
-            notif->valuestring,
-            cJSON_GetObjectItem(root, "app")->valuestring,
-            cJSON_GetObjectItem(root, "title")->valuestring,
-            cJSON_GetObjectItem(root, "message")->valuestring);
+    if (msg.has_notification) {
+        handle_notification(slot);
+    } else if (slot) {
+        notif_slot_put(slot);
+    } else {
+        ESP_LOGW(TAG, "No free notification slot");
     }
 
-    cJSON* status = cJSON_GetObjectItem(root, "status");
-    if (cJSON_IsString(status)) {
-        ble_sync_send_status(bsp_power_get_battery_percent(), bsp_power_is_charging());
+    if (msg.has_status) {
+        // Explicit request from the phone: answer without waiting for the rate limit
+        queue_status(bsp_power_get_battery_percent(), bsp_power_is_charging(), true);
+    }
+}
+
+static void send_hello_frame(void)
+{
+    uint8_t frame[32];
+    const ble_msg_hello_t hello = {
+        .version = BLE_PROTO_VERSION,
+        .caps = BLE_PROTO_CAP_TLV,
+        .mtu = CONFIG_NORDIC_UART_MAX_LINE_LENGTH,
+    };
+    size_t n = ble_proto_encode_hello(frame, sizeof(frame), &hello);
+    if (n) nordic_uart_send_bytes(frame, n);
+}
+
+static void dispatch_frame(const ble_proto_frame_t* fp);
+
+// Feed one chunk; a completed transfer is dispatched like a single frame
+static void handle_chunk(const ble_proto_frame_t* f)
+{
+    ble_chunk_msg_t msg;
+    uint32_t now_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+    ble_chunk_result_t r = ble_chunk_feed(&s_chunks, f, now_ms, &msg);
+
+    if (r == BLE_CHUNK_REJECTED) {
+        ESP_LOGW(TAG, "Chunk rejected (%u timeouts, %u evicted so far)",
+                 (unsigned)s_chunks.stats.timeouts, (unsigned)s_chunks.stats.evicted);
+    } else if (r == BLE_CHUNK_COMPLETE) {
+        ble_proto_frame_t inner;
+        ble_chunk_as_frame(&msg, &inner);
+        ESP_LOGD(TAG, "Reassembled type 0x%02x, %u bytes", inner.type, (unsigned)msg.len);
+        if (inner.type != BLE_MSG_CHUNK) dispatch_frame(&inner);
+        ble_chunk_release(&s_chunks, &msg);
     }
+}
 
-    cJSON_Delete(root);
-    free(tmp);
+static void process_one_frame(const uint8_t* data, size_t len)
+{
+    ble_proto_frame_t f;
+    ble_proto_err_t err = ble_proto_parse(data, len, &f, NULL);
+    if (err != BLE_PROTO_OK) {
+        ESP_LOGW(TAG, "Bad frame (%d), %u bytes", (int)err, (unsigned)len);
+        return;
+    }
+    dispatch_frame(&f);
+}
+
+// The phone registers an app the watch doesn't know: id, display name and
+// optionally an icon (app_icon_encode stream, usually sent chunked)
+static void handle_app_icon(const ble_proto_frame_t* f)
+{
+    char id[APP_ID_MAX] = {0};
+    char name[APP_NAME_MAX] = {0};
+    uint32_t w = 0, h = 0;
+    ble_proto_iter_t it;
+    ble_proto_tlv_t t;
+    ble_proto_iter_init(&it, f);
+    while (ble_proto_iter_next(&it, &t)) {
+        switch (t.tag) {
+        case BLE_TAG_APP:    ble_proto_str_copy(id, sizeof(id), (ble_proto_str_t){(const char*)t.val, t.len}); break;
+        case BLE_TAG_NAME:   ble_proto_str_copy(name, sizeof(name), (ble_proto_str_t){(const char*)t.val, t.len}); break;
+        case BLE_TAG_WIDTH:  w = ble_proto_tlv_uint(&t); break;
+        case BLE_TAG_HEIGHT: h = ble_proto_tlv_uint(&t); break;
+        default: break;
+        }
+    }
+    size_t len = ble_proto_bytes_concat(f, BLE_TAG_DATA, s_icon_rle, APP_ICON_RLE_MAX);
+    if (len > APP_ICON_RLE_MAX) {
+        ESP_LOGW(TAG, "Icon of %s too large (%u B)", id, (unsigned)len);
+        return;
+    }
+    app_registry_put(id, name[0] ? name : NULL, len ? s_icon_rle : NULL, len,
+                     (uint16_t)w, (uint16_t)h);
+}
+
+static void dispatch_frame(const ble_proto_frame_t* fp)
+{
+    const ble_proto_frame_t f = *fp;
+
+    switch (f.type) {
+    case BLE_MSG_HELLO: {
+        ble_msg_hello_t h;
+        if (ble_proto_decode_hello(&f, &h) && (h.caps & BLE_PROTO_CAP_TLV)) {
+            if (!s_binary_peer) send_hello_frame();
+            s_binary_peer = true;
+            ESP_LOGI(TAG, "Peer speaks TLV v%u", h.version);
+        }
+        break;
+    }
+    case BLE_MSG_TIME_SYNC: {
+        ble_msg_time_t t;
+        if (ble_proto_decode_time(&f, &t)) {
+            struct tm tmv = {
+                .tm_year = t.year,
+                .tm_mon  = t.month,
+                .tm_mday = t.day,
+                .tm_hour = t.hour,
+                .tm_min  = t.min,
+                .tm_sec  = t.sec
+            };
+            rtc_set_time(&tmv);
+        }
+        break;
+    }
+    case BLE_MSG_NOTIFICATION: {
+        // The strings in the frame aren't NUL terminated: copy into a slot
+        ble_msg_notification_t n;
+        ble_notif_slot_t* slot;
+        if (ble_proto_decode_notification(&f, &n) && (slot = notif_slot_get()) != NULL) {
+            ble_proto_str_copy(slot->ts, sizeof(slot->ts), n.ts);
+            ble_proto_str_copy(slot->app, sizeof(slot->app), n.app);
+            ble_proto_str_copy(slot->title, sizeof(slot->title), n.title);
+            // Long bodies come as several BODY TLVs
+            ble_proto_str_concat(&f, BLE_TAG_BODY, slot->message, sizeof(slot->message));
+            handle_notification(slot);
+        }
+        break;
+    }
+    case BLE_MSG_APP_ICON:
+        handle_app_icon(&f);
+        break;
+    case BLE_MSG_CHUNK:
+        handle_chunk(&f);
+        break;
+    case BLE_MSG_HISTORY:
+        hist_handle_request(&f);
+        break;
+    case BLE_MSG_HIST_ACK:
+        hist_handle_ack(&f);
+        break;
+    default:
+        ESP_LOGD(TAG, "Frame type 0x%02x ignored", f.type);
+        break;
+    }
 }
 
 void uartTask(void* parameter)
 {
     (void)parameter;
-    static char mbuf[CONFIG_NORDIC_UART_MAX_LINE_LENGTH + 1];
 
     for (;;) {
         size_t item_size;
+        // Wake up periodically while a history transfer waits for acks
         const char* item = xRingbufferReceive(nordic_uart_rx_buf_handle,
                                               &item_size,
-                                              portMAX_DELAY);
+                                              s_hist_tx.active ? pdMS_TO_TICKS(250) : portMAX_DELAY);
 
         if (item) {
-            memcpy(mbuf, item, item_size);
-            mbuf[item_size] = '\0';
+            s_rx_start_us = now_us();
+            // Decode straight from the ring buffer, then hand the item back
+            power_manager_boost_begin(PM_BOOST_BLE_RX);
+            if (item_size > 0 && (uint8_t)item[0] == BLE_PROTO_MAGIC) {
+                process_one_frame((const uint8_t*)item, item_size);
+            } else {
+                process_one_json_object(item, item_size);
+            }
+            power_manager_boost_end(PM_BOOST_BLE_RX);
             vRingbufferReturnItem(nordic_uart_rx_buf_handle, (void*)item);
+        }
 
-            process_one_json_object(mbuf, item_size);
+        if (s_hist_tx.active) {
+            if (!s_ble_connected) {
+                // The phone resumes from its last acked cursor on reconnect
+                hist_finish(false);
+                ble_hist_tx_abort(&s_hist_tx);
+            } else if (ble_hist_tx_poll(&s_hist_tx, pdTICKS_TO_MS(xTaskGetTickCount()))) {
+                hist_pump();
+            }
         }
     }
 }
@@ -185,6 +641,11 @@ static void nordic_uart_callback(enum nordic_uart_callback_type type)
 
         ESP_LOGI(TAG, "BLE CONNECTED");
         s_ble_connected = true;
+        s_binary_peer = false;
+
+        // NimBLE host task: the TLV offer goes out from the TX task
+        s_offer_pending = true;
+        outq_kick();
 
         (void)esp_event_post(BLE_SYNC_EVENT_BASE, BLE_SYNC_EVT_CONNECTED, NULL, 0, 0);
 
@@ -218,6 +679,8 @@ static void nordic_uart_callback(enum nordic_uart_callback_type type)
     } else if (type == NORDIC_UART_DISCONNECTED) {
         ESP_LOGI(TAG, "BLE DISCONNECTED");
         s_ble_connected = false;
+        s_binary_peer = false;
+        s_offer_pending = false;
         s_time_sync_requested = false;
         (void)esp_event_post(BLE_SYNC_EVENT_BASE, BLE_SYNC_EVT_DISCONNECTED, NULL, 0, 0);
     }
@@ -231,12 +694,71 @@ static void power_ble_evt(void* handler_arg, esp_event_base_t base, int32_t id,
 
     bsp_power_event_payload_t* pl = event_data;
     if (pl) {
+        ble_host_adv_set_battery((uint8_t)pl->battery_percent, pl->charging);
         ble_sync_send_status(pl->battery_percent, pl->charging);
     }
 }
 
+// The advertising governor slows down and pauses with the screen off
+static bool screen_on(power_state_t st)
+{
+    return st == PM_STATE_ACTIVE || st == PM_STATE_DIMMED;
+}
+
+static void power_state_evt(void* handler_arg, esp_event_base_t base, int32_t id, void* event_data)
+{
+    (void)handler_arg;
+    (void)base;
+    (void)id;
+
+    const power_state_t* st = event_data;
+    if (st) ble_host_adv_set_screen(screen_on(*st));
+}
+
 esp_err_t ble_sync_init(void)
 {
+    if (!s_notif_slots) {
+        s_notif_slots = psram_calloc(NOTIF_SLOTS, sizeof(ble_notif_slot_t));
+        uint8_t* chunk_mem = psram_calloc(CHUNK_SLOTS, CHUNK_SLOT_BYTES);
+        s_icon_rle = psram_calloc(1, APP_ICON_RLE_MAX);
+        if (!s_notif_slots || !chunk_mem || !s_icon_rle) {
+            free(s_notif_slots);
+            free(chunk_mem);
+            free(s_icon_rle);
+            s_notif_slots = NULL;
+            s_icon_rle = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+        app_registry_init();
+        ble_chunk_pool_init(&s_chunks, chunk_mem, CHUNK_SLOTS, CHUNK_SLOT_BYTES);
+    }
+    if (!s_alert_task) {
+        notif_pipe_init(&s_notif_pipe);
+        if (bsp_display_lock(0)) {
+            s_notif_ui_timer = lv_timer_create(notif_ui_timer_cb, NOTIF_UI_PERIOD_MS, NULL);
+            bsp_display_unlock();
+        }
+        if (!s_notif_ui_timer) return ESP_FAIL;
+        xTaskCreate(notif_alert_task, "notif_alert", 4096, NULL, 2, &s_alert_task);
+        if (!s_alert_task) return ESP_ERR_NO_MEM;
+    }
+    if (!s_tx_task) {
+        ble_outq_init(&s_outq);
+        ble_outq_set_interval(&s_outq, BLE_OUT_STATUS, STATUS_MIN_INTERVAL_MS);
+        xTaskCreate(ble_tx_task, "ble_tx", 4096, NULL, 3, &s_tx_task);
+        if (!s_tx_task) return ESP_ERR_NO_MEM;
+    }
+    if (!s_hist_lock) {
+        ble_hist_rec_t* recs = psram_calloc(HIST_RECORDS, sizeof(ble_hist_rec_t));
+        s_hist_lock = recs ? xSemaphoreCreateMutex() : NULL;
+        if (!s_hist_lock) {
+            free(recs);
+            return ESP_ERR_NO_MEM;
+        }
+        // New epoch per boot: the phone drops its cursor when it changes
+        ble_hist_log_init(&s_hist, recs, HIST_RECORDS, esp_random());
+    }
+
     esp_err_t err = ble_sync_set_enabled(true);
     if (err != ESP_OK) return err;
 
@@ -252,30 +774,18 @@ esp_err_t ble_sync_init(void)
     }
 
     esp_event_handler_register(BSP_POWER_EVENT_BASE, ESP_EVENT_ANY_ID, power_ble_evt, NULL);
+    esp_event_handler_register(POWER_MANAGER_EVENT_BASE, POWER_MANAGER_EVT_STATE, power_state_evt, NULL);
+    ble_host_adv_set_battery((uint8_t)bsp_power_get_battery_percent(), bsp_power_is_charging());
+    ble_host_adv_set_screen(screen_on(power_manager_get_state()));
 
     return ESP_OK;
 }
 
+// Queued: repeated calls within STATUS_MIN_INTERVAL_MS collapse into one
+// message carrying the latest values
 esp_err_t ble_sync_send_status(int battery_percent, bool charging)
 {
-    if (!s_ble_enabled) return ESP_ERR_INVALID_STATE;
-
-    cJSON* root = cJSON_CreateObject();
-    if (!root) return ESP_FAIL;
-
-    cJSON_AddNumberToObject(root, "battery", battery_percent);
-    cJSON_AddBoolToObject(root, "charging", charging);
-    cJSON_AddNumberToObject(root, "steps", sensors_get_step_count());
-
-    char* json = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-
-    if (!json) return ESP_FAIL;
-
-    esp_err_t err = nordic_uart_sendln(json);
-    free(json);
-
-    return err;
+    return queue_status(battery_percent, charging, false);
 }
 
 esp_err_t ble_sync_set_enabled(bool enabled)
@@ -284,24 +794,25 @@ esp_err_t ble_sync_set_enabled(bool enabled)
 
     if (enabled) {
 
-        if (!s_ble_stack_started) {
+        if (!s_uart_started) {
 
             esp_err_t err = nordic_uart_start("ESP32 S3 Watch", nordic_uart_callback);
             if (err != ESP_OK) return err;
 
-            s_ble_stack_started = true;
+            s_uart_started = true;
         }
 
         s_ble_enabled = true;
-        nordic_uart_set_advertising_enabled(true);
+        nordic_uart_set_enabled(true);
 
         return ESP_OK;
     }
 
+    // Only the sync service goes quiet: advertising, the link and HID are
+    // ble_host's and stay as they are
     s_ble_enabled = false;
+    nordic_uart_set_enabled(false);
     s_ble_connected = false;
-    nordic_uart_set_advertising_enabled(false);
-    nordic_uart_disconnect();
 
     return ESP_OK;
 }
@@ -310,3 +821,30 @@ bool ble_sync_is_enabled(void)
 {
     return s_ble_enabled;
 }
+
+esp_err_t ble_sync_pair_now(void)
+{
+    if (!ble_host_is_started()) return ESP_ERR_INVALID_STATE;
+    ble_host_pair_now();
+    return ESP_OK;
+}
+
+static void log_stage(const char* name, const notif_stage_t* s)
+{
+    ESP_LOGI(TAG, "  %-7s n=%-5u avg=%6u us max=%7u us", name, (unsigned)s->count,
+             (unsigned)notif_stage_avg_us(s), (unsigned)s->max_us);
+}
+
+void ble_sync_dump_notif_stats(void)
+{
+    ESP_LOGI(TAG, "Notification pipeline: max backlog %u, no slot %u, lane drops %u/%u, chimes coalesced %u",
+             (unsigned)s_notif_pipe.max_depth, (unsigned)s_notif_no_slot,
+             (unsigned)s_notif_pipe.lane[NOTIF_PRIO_NORMAL].dropped,
+             (unsigned)s_notif_pipe.lane[NOTIF_PRIO_HIGH].dropped,
+             (unsigned)s_alerts_coalesced);
+    log_stage("parse", &s_stage_parse);
+    log_stage("queue", &s_notif_pipe.wait);
+    log_stage("render", &s_stage_render);
+    log_stage("wake", &s_stage_wake);
+    log_stage("audio", &s_stage_audio);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ble_proto.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Chunked transfer over BLE_MSG_CHUNK frames: a message larger than one
+// frame (e.g. a long notification body) is cut into up to
+// BLE_CHUNK_MAX_PARTS pieces, each carrying
+//
+//   XFER (transfer id) SEQ COUNT OFFSET INNER (message type) DATA
+//
+// Chunks may arrive in any order and more than once. They are copied into
+// a slot of a fixed reassembly pool (storage given by the caller, e.g.
+// PSRAM); a slot that sees no chunk for BLE_CHUNK_TIMEOUT_MS is dropped.
+// Recently completed transfer ids are remembered so a retransmitted
+// transfer isn't delivered twice. Plain C, tested on the host.
+
+#ifndef BLE_CHUNK_MAX_PARTS
+#define BLE_CHUNK_MAX_PARTS   32     // bitmap width
+#endif
+#ifndef BLE_CHUNK_MAX_SLOTS
+#define BLE_CHUNK_MAX_SLOTS   4
+#endif
+#ifndef BLE_CHUNK_TIMEOUT_MS
+#define BLE_CHUNK_TIMEOUT_MS  3000
+#endif
+#define BLE_CHUNK_RECENT      8      // completed ids kept for dedup
+
+typedef enum {
+    BLE_CHUNK_PENDING = 0,   // stored, transfer not complete yet
+    BLE_CHUNK_COMPLETE,      // *out holds the reassembled message
+    BLE_CHUNK_DUPLICATE,     // chunk or transfer already seen, ignored
+    BLE_CHUNK_REJECTED,      // malformed, too large or inconsistent
+} ble_chunk_result_t;
+
+typedef struct {
+    bool used;
+    uint16_t xfer;
+    uint8_t inner;
+    uint8_t count;
+    uint32_t have;           // bitmap of received SEQs
+    size_t len;              // highest offset + length seen
+    uint32_t first_ms;
+    uint32_t last_ms;
+    uint8_t* buf;
+} ble_chunk_slot_t;
+
+typedef struct {
+    uint32_t chunks;
+    uint32_t completed;
+    uint32_t duplicates;
+    uint32_t rejected;
+    uint32_t timeouts;
+    uint32_t evicted;        // incomplete transfers pushed out by new ones
+} ble_chunk_stats_t;
+
+typedef struct {
+    ble_chunk_slot_t slot[BLE_CHUNK_MAX_SLOTS];
+    unsigned nslots;
+    size_t slot_bytes;
+    uint16_t recent[BLE_CHUNK_RECENT];
+    unsigned recent_n, recent_pos;
+    ble_chunk_stats_t stats;
+} ble_chunk_pool_t;
+
+// Reassembled message; valid until ble_chunk_release()
+typedef struct {
+    uint8_t type;
+    const uint8_t* data;
+    size_t len;
+    int slot;
+} ble_chunk_msg_t;
+
+// storage holds nslots * slot_bytes bytes (nslots <= BLE_CHUNK_MAX_SLOTS)
+void ble_chunk_pool_init(ble_chunk_pool_t* pool, uint8_t* storage, unsigned nslots, size_t slot_bytes);
+
+ble_chunk_result_t ble_chunk_feed(ble_chunk_pool_t* pool, const ble_proto_frame_t* f, uint32_t now_ms,
+                                  ble_chunk_msg_t* out);
+void ble_chunk_release(ble_chunk_pool_t* pool, const ble_chunk_msg_t* msg);
+
+// Drop transfers idle for BLE_CHUNK_TIMEOUT_MS. Returns how many.
+unsigned ble_chunk_expire(ble_chunk_pool_t* pool, uint32_t now_ms);
+
+// View of a reassembled message as a frame, for the ble_proto decoders
+void ble_chunk_as_frame(const ble_chunk_msg_t* msg, ble_proto_frame_t* f);
+
+// Encode one chunk frame. Returns the frame size, 0 if it doesn't fit.
+size_t ble_chunk_encode(uint8_t* buf, size_t cap, uint16_t xfer, uint8_t seq, uint8_t count,
+                        uint32_t offset, uint8_t inner, const uint8_t* data, size_t len);
+
+// Largest DATA that fits a chunk frame of frame_cap bytes
+size_t ble_chunk_data_max(size_t frame_cap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ble_proto.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// History sync: the watch keeps a ring of small records (activity samples,
+// notification log) numbered by a monotonic sequence. The phone asks for
+// everything after a cursor; the watch streams BLE_MSG_HIST_BATCH frames,
+// each packing as many records as fit, and the phone acknowledges with the
+// last sequence it stored. At most BLE_HIST_WINDOW batches are unacked; on
+// a timeout the sender goes back to the last ack. After a disconnect the
+// phone simply asks again from its last acked cursor.
+//
+//   phone -> watch  BLE_MSG_HISTORY    CURSOR(since) [COUNT(max records)]
+//   watch -> phone  BLE_MSG_HIST_BATCH ID(log epoch) PREV(cursor it follows)
+//                                      CURSOR(last seq in batch) MORE(0/1)
+//                                      REC*: seq(u32) ts(u32) kind(u8) data
+//   phone -> watch  BLE_MSG_HIST_ACK   CURSOR(last seq stored)
+//
+// The phone drops a batch whose PREV is past its cursor (an earlier batch
+// was lost) and re-acks; the sender rewinds on the timeout. A jump in REC
+// seq inside an in-order batch means older records were overwritten in the
+// ring before they were fetched. The log lives in RAM and restarts at seq 1 on
+// boot with a new epoch; a phone cursor ahead of the log gets everything.
+// Plain C, tested on the host.
+
+#define BLE_HIST_REC_DATA    54      // bytes of payload per record
+#define BLE_HIST_REC_HDR     9       // seq + ts + kind inside a REC TLV
+#ifndef BLE_HIST_WINDOW
+#define BLE_HIST_WINDOW      4       // unacked batches in flight
+#endif
+#ifndef BLE_HIST_TIMEOUT_MS
+#define BLE_HIST_TIMEOUT_MS  2000
+#endif
+#ifndef BLE_HIST_FRAME_MAX
+#define BLE_HIST_FRAME_MAX   1024    // outbound batch frame
+#endif
+
+typedef enum {
+    BLE_HIST_ACTIVITY = 1,   // steps(u32) battery(u8) charging(u8)
+    BLE_HIST_NOTIF    = 2,   // app '\x1f' title, truncated
+} ble_hist_kind_t;
+
+typedef struct {
+    uint32_t seq;            // 0 = empty
+    uint32_t ts;             // unix seconds
+    uint8_t kind;
+    uint8_t len;
+    uint8_t data[BLE_HIST_REC_DATA];
+} ble_hist_rec_t;
+
+typedef struct {
+    ble_hist_rec_t* recs;
+    unsigned cap;
+    uint32_t next_seq;       // seq of the next append, starts at 1
+    uint32_t epoch;          // changes when the log is recreated
+} ble_hist_log_t;
+
+// storage holds cap records (e.g. allocated in PSRAM)
+void ble_hist_log_init(ble_hist_log_t* log, ble_hist_rec_t* storage, unsigned cap, uint32_t epoch);
+// Returns the record's seq; data longer than BLE_HIST_REC_DATA is truncated
+uint32_t ble_hist_log_append(ble_hist_log_t* log, uint8_t kind, uint32_t ts, const void* data, size_t len);
+uint32_t ble_hist_log_oldest(const ble_hist_log_t* log);   // 0 if empty
+uint32_t ble_hist_log_newest(const ble_hist_log_t* log);   // 0 if empty
+const ble_hist_rec_t* ble_hist_log_get(const ble_hist_log_t* log, uint32_t seq);
+
+typedef struct {
+    uint32_t batches;
+    uint32_t records;
+    uint32_t bytes;
+    uint32_t retransmits;    // go-back-N rewinds after a timeout
+    uint32_t lost;           // requested records already overwritten
+} ble_hist_stats_t;
+
+typedef struct {
+    bool active;
+    uint32_t acked;          // highest seq the peer confirmed
+    uint32_t sent;           // highest seq put in a batch
+    uint32_t end;            // last seq of this transfer
+    bool announced;          // at least one batch sent
+    uint32_t inflight[BLE_HIST_WINDOW];  // last seq of each unacked batch
+    unsigned ninflight;
+    uint32_t last_progress_ms;
+    ble_hist_stats_t stats;
+} ble_hist_tx_t;
+
+// Start (or restart, e.g. after a reconnect) a transfer of the records after
+// `since`, at most `max` of them (0 = all present now).
+void ble_hist_tx_start(ble_hist_tx_t* tx, const ble_hist_log_t* log, uint32_t since, uint32_t max,
+                       uint32_t now_ms);
+void ble_hist_tx_abort(ble_hist_tx_t* tx);
+// Cumulative ack. Returns true when the transfer is complete.
+bool ble_hist_tx_ack(ble_hist_tx_t* tx, uint32_t cursor, uint32_t now_ms);
+// Go back to the last ack if nothing moved for BLE_HIST_TIMEOUT_MS.
+// Returns true if it rewound.
+bool ble_hist_tx_poll(ble_hist_tx_t* tx, uint32_t now_ms);
+// Encode the next batch into buf. Returns the frame size, 0 when the window
+// is full or everything up to `end` has been sent.
+size_t ble_hist_tx_next(ble_hist_tx_t* tx, const ble_hist_log_t* log, uint8_t* buf, size_t cap,
+                        uint32_t now_ms);
+
+// Peer side helpers (used by the phone stand-in in the tests)
+typedef struct {
+    uint32_t seq;
+    uint32_t ts;
+    uint8_t kind;
+    const uint8_t* data;
+    uint8_t len;
+} ble_hist_rec_view_t;
+
+bool ble_hist_rec_decode(const ble_proto_tlv_t* t, ble_hist_rec_view_t* out);
+// CURSOR of a request, batch or ack (0 if absent)
+uint32_t ble_hist_frame_cursor(const ble_proto_frame_t* f);
+size_t ble_hist_encode_request(uint8_t* buf, size_t cap, uint32_t since, uint32_t max);
+size_t ble_hist_encode_ack(uint8_t* buf, size_t cap, uint32_t cursor);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// In-place JSON tokenizer (jsmn style) for the messages the phone sends over
+// the UART link. Tokens are offsets into the caller's buffer, which is only
+// read, and values are unescaped straight into fixed-size destination
+// buffers: nothing is copied up front and nothing is allocated.
+// Plain C, no ESP-IDF dependency, so it is fuzzed and benchmarked on the host.
+
+#ifndef BLE_JSON_MAX_TOKENS
+#define BLE_JSON_MAX_TOKENS 32
+#endif
+#ifndef BLE_JSON_MAX_DEPTH
+#define BLE_JSON_MAX_DEPTH 8
+#endif
+
+typedef enum {
+    BLE_JSON_UNDEFINED = 0,
+    BLE_JSON_OBJECT,
+    BLE_JSON_ARRAY,
+    BLE_JSON_STRING,      // start/end exclude the quotes, escapes left as is
+    BLE_JSON_PRIMITIVE,   // number, true, false, null
+} ble_json_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint16_t start;
+    uint16_t end;
+    uint16_t size;        // children (object: keys, array: elements)
+    int16_t parent;
+} ble_json_tok_t;
+
+#define BLE_JSON_ERR_NOMEM  (-1)   // more tokens than provided
+#define BLE_JSON_ERR_INVAL  (-2)   // malformed input
+#define BLE_JSON_ERR_PART   (-3)   // input ends inside a value
+#define BLE_JSON_ERR_DEPTH  (-4)   // nested deeper than BLE_JSON_MAX_DEPTH
+
+// Tokenize js[0..len). Parsing stops at a NUL byte or len, whichever comes
+// first; len is capped at 65535. Returns the token count or BLE_JSON_ERR_*.
+int ble_json_parse(const char* js, size_t len, ble_json_tok_t* toks, unsigned max_toks);
+
+// Value token of `key` in the top-level object toks[0], or -1.
+int ble_json_find(const char* js, const ble_json_tok_t* toks, int ntok, const char* key);
+
+// Unescape a string token into dst (always NUL terminated, truncated to
+// cap - 1 on a UTF-8 boundary). Returns the length written.
+size_t ble_json_copy_str(const char* js, const ble_json_tok_t* t, char* dst, size_t cap);
+
+bool ble_json_get_int(const char* js, const ble_json_tok_t* t, int32_t* out);
+
+// ---------------------------------------------------------------------------
+// Fields ble_sync acts on. Sizes match NotificationItem in the UI.
+// ---------------------------------------------------------------------------
+#ifndef BLE_NOTIF_MESSAGE_MAX
+#define BLE_NOTIF_MESSAGE_MAX 4096   // NOTIF_MESSAGE_MAX
+#endif
+
+typedef struct {
+    char ts[40];
+    char app[32];
+    char title[64];
+    char message[BLE_NOTIF_MESSAGE_MAX];
+} ble_notif_slot_t;
+
+typedef struct {
+    bool has_datetime;
+    char datetime[32];
+    bool has_notification;   // "notification" present; missing fields are ""
+    bool has_status;
+} ble_json_msg_t;
+
+// Tokenize one message and fill out (and slot when it carries a
+// notification). Returns false for malformed or oversized input.
+bool ble_json_extract(const char* js, size_t len, ble_json_msg_t* out, ble_notif_slot_t* slot);
+
+#ifdef __cplusplus
+}
+#endif
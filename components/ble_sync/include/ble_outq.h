@@ -0,0 +1,69 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Outbound queue with one slot per message kind. Putting a message while
+// one of the same kind is pending replaces it (only the latest status is
+// worth sending), each kind is rate limited, and everything due within
+// BLE_OUTQ_SLACK_MS is taken together so it leaves in one connection
+// event. Payloads are opaque and encoded by the caller when sent, so the
+// wire format (TLV or JSON) is picked at that point. Plain C, no locking:
+// callers serialise access. Tested on the host.
+
+#define BLE_OUTQ_PAYLOAD_MAX 16
+#ifndef BLE_OUTQ_SLACK_MS
+#define BLE_OUTQ_SLACK_MS    100
+#endif
+
+typedef enum {
+    BLE_OUT_STATUS = 0,      // battery / charging / steps
+    BLE_OUT_TIME_REQ,        // ask the phone for the time
+    BLE_OUT_KIND_COUNT,
+} ble_out_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t len;
+    uint8_t data[BLE_OUTQ_PAYLOAD_MAX];
+} ble_outq_item_t;
+
+typedef struct {
+    uint32_t enqueued;
+    uint32_t coalesced;      // replaced while pending, never sent
+    uint32_t sent;
+    uint32_t flushes;        // takes that returned at least one item
+} ble_outq_stats_t;
+
+typedef struct {
+    struct {
+        bool pending;
+        bool urgent;
+        bool ever_sent;
+        uint32_t min_interval_ms;
+        uint32_t last_sent_ms;
+        ble_outq_item_t item;
+    } slot[BLE_OUT_KIND_COUNT];
+    ble_outq_stats_t stats;
+} ble_outq_t;
+
+void ble_outq_init(ble_outq_t* q);
+void ble_outq_set_interval(ble_outq_t* q, ble_out_kind_t kind, uint32_t min_interval_ms);
+
+// Queue (or replace) the pending message of this kind. urgent skips the
+// rate limit, e.g. for an explicit request from the phone.
+bool ble_outq_put(ble_outq_t* q, ble_out_kind_t kind, const void* data, size_t len, bool urgent);
+
+// Milliseconds until the next message is due (0 = now), UINT32_MAX if idle
+uint32_t ble_outq_next_due(const ble_outq_t* q, uint32_t now_ms);
+
+// Pop every message due by now + BLE_OUTQ_SLACK_MS into out[] (at most
+// max) and mark them sent. Returns how many.
+unsigned ble_outq_take(ble_outq_t* q, uint32_t now_ms, ble_outq_item_t* out, unsigned max);
+
+#ifdef __cplusplus
+}
+#endif
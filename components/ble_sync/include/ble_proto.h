@@ -0,0 +1,207 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary framing for the Nordic UART link, used instead of JSON lines once
+// both ends have exchanged BLE_MSG_HELLO.
+//
+//   frame   = magic(0xA5) type(u8) len(u16 LE) payload[len] crc16(u16 LE)
+//   payload = { tag(u8) vlen(u8) value[vlen] }*
+//
+// Strings longer than 255 bytes are sent as consecutive TLVs with the same
+// tag and concatenated by the reader (ble_proto_str_concat). Messages that
+// don't fit one frame travel as BLE_MSG_CHUNK frames (see ble_chunk.h).
+//
+// The CRC is CRC-16/CCITT-FALSE over type, len and payload. Integers are
+// little endian and may be sent with fewer bytes when the high ones are
+// zero. Strings are UTF-8 without terminator. Encoding writes into a
+// caller buffer and decoding returns views into the frame: no allocation.
+// Plain C, no ESP-IDF dependency, so the codec is tested on the host.
+
+#define BLE_PROTO_MAGIC      0xA5   // must match NORDIC_UART_FRAME_MAGIC
+#define BLE_PROTO_VERSION    1
+#define BLE_PROTO_HDR_LEN    4
+#define BLE_PROTO_CRC_LEN    2
+#define BLE_PROTO_OVERHEAD   (BLE_PROTO_HDR_LEN + BLE_PROTO_CRC_LEN)
+
+// Largest frame the transport delivers in one ring-buffer item
+#ifndef BLE_PROTO_MAX_FRAME
+#define BLE_PROTO_MAX_FRAME  256
+#endif
+
+// Capability bits carried in BLE_MSG_HELLO
+#define BLE_PROTO_CAP_TLV    (1u << 0)
+
+typedef enum {
+    BLE_MSG_HELLO        = 0x01,  // both ways: version, caps, mtu
+    BLE_MSG_TIME_SYNC    = 0x02,  // phone->watch: datetime; watch->phone: empty request
+    BLE_MSG_NOTIFICATION = 0x03,  // phone->watch
+    BLE_MSG_STATUS       = 0x04,  // watch->phone
+    BLE_MSG_HISTORY      = 0x05,  // phone->watch: records after cursor, count max
+    BLE_MSG_CHUNK        = 0x06,  // one piece of a larger message
+    BLE_MSG_HIST_BATCH   = 0x07,  // watch->phone: history records (ble_history.h)
+    BLE_MSG_HIST_ACK     = 0x08,  // phone->watch: last history seq stored
+    BLE_MSG_APP_ICON     = 0x09,  // phone->watch: app name and icon (app_rle.h stream in DATA)
+} ble_msg_type_t;
+
+typedef enum {
+    BLE_TAG_VERSION  = 0x01,
+    BLE_TAG_CAPS     = 0x02,
+    BLE_TAG_MTU      = 0x03,
+
+    BLE_TAG_DATETIME = 0x08,  // year(u16) month day hour min sec, 7 bytes
+
+    BLE_TAG_ID       = 0x10,
+    BLE_TAG_APP      = 0x11,
+    BLE_TAG_TITLE    = 0x12,
+    BLE_TAG_BODY     = 0x13,
+    BLE_TAG_TS       = 0x14,
+
+    BLE_TAG_BATTERY  = 0x20,
+    BLE_TAG_CHARGING = 0x21,
+    BLE_TAG_STEPS    = 0x22,
+
+    BLE_TAG_CURSOR   = 0x30,
+    BLE_TAG_COUNT    = 0x31,  // also: chunks in a transfer
+    BLE_TAG_REC      = 0x32,  // one history record
+    BLE_TAG_MORE     = 0x33,  // more history batches follow
+    BLE_TAG_PREV     = 0x34,  // cursor a history batch continues from
+
+    BLE_TAG_XFER     = 0x40,  // transfer id
+    BLE_TAG_SEQ      = 0x41,  // chunk index, 0..count-1
+    BLE_TAG_OFFSET   = 0x42,  // byte offset of the chunk data
+    BLE_TAG_INNER    = 0x43,  // message type of the reassembled payload
+    BLE_TAG_DATA     = 0x44,
+
+    BLE_TAG_NAME     = 0x50,  // app display name (BLE_TAG_APP is the id)
+    BLE_TAG_WIDTH    = 0x51,
+    BLE_TAG_HEIGHT   = 0x52,
+} ble_tag_t;
+
+typedef enum {
+    BLE_PROTO_OK = 0,
+    BLE_PROTO_ERR_SHORT,     // fewer bytes than the header announces
+    BLE_PROTO_ERR_MAGIC,
+    BLE_PROTO_ERR_CRC,
+    BLE_PROTO_ERR_TLV,       // payload is not a clean TLV sequence
+} ble_proto_err_t;
+
+uint16_t ble_proto_crc16(const uint8_t* data, size_t len, uint16_t crc);
+
+// ---------------------------------------------------------------- encoding
+
+typedef struct {
+    uint8_t* buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+} ble_proto_writer_t;
+
+void ble_proto_begin(ble_proto_writer_t* w, uint8_t* buf, size_t cap, ble_msg_type_t type);
+void ble_proto_put_uint(ble_proto_writer_t* w, uint8_t tag, uint32_t v);
+void ble_proto_put_bytes(ble_proto_writer_t* w, uint8_t tag, const void* v, size_t len);
+// NULL is skipped; strings longer than 255 bytes are truncated
+void ble_proto_put_str(ble_proto_writer_t* w, uint8_t tag, const char* s);
+// NULL is skipped; longer strings are split over several TLVs
+void ble_proto_put_long_str(ble_proto_writer_t* w, uint8_t tag, const char* s);
+// Binary blob split over as many TLVs as needed
+void ble_proto_put_long_bytes(ble_proto_writer_t* w, uint8_t tag, const void* v, size_t len);
+// Patch length and append the CRC. Returns the frame size, 0 on overflow.
+size_t ble_proto_finish(ble_proto_writer_t* w);
+
+// ---------------------------------------------------------------- decoding
+
+typedef struct {
+    uint8_t type;
+    uint16_t len;
+    const uint8_t* payload;
+} ble_proto_frame_t;
+
+typedef struct {
+    uint8_t tag;
+    uint8_t len;
+    const uint8_t* val;
+} ble_proto_tlv_t;
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} ble_proto_iter_t;
+
+// Validate one frame at data[0]; trailing bytes beyond the frame are ignored.
+// *used (optional) receives the frame size.
+ble_proto_err_t ble_proto_parse(const uint8_t* data, size_t len, ble_proto_frame_t* out, size_t* used);
+
+void ble_proto_iter_init(ble_proto_iter_t* it, const ble_proto_frame_t* f);
+// false at the end of the payload or on a truncated TLV
+bool ble_proto_iter_next(ble_proto_iter_t* it, ble_proto_tlv_t* out);
+uint32_t ble_proto_tlv_uint(const ble_proto_tlv_t* t);
+
+// --------------------------------------------------------------- messages
+
+typedef struct {
+    const char* p;   // not NUL terminated
+    uint8_t len;
+} ble_proto_str_t;
+
+typedef struct {
+    uint8_t version;
+    uint32_t caps;
+    uint16_t mtu;
+} ble_msg_hello_t;
+
+typedef struct {
+    uint16_t year;
+    uint8_t month, day, hour, min, sec;
+} ble_msg_time_t;
+
+// Encoding reads the .p strings as NUL terminated (len ignored); decoding
+// fills p/len views into the frame.
+typedef struct {
+    uint32_t id;
+    ble_proto_str_t app, title, body, ts;
+} ble_msg_notification_t;
+
+typedef struct {
+    uint8_t battery;
+    bool charging;
+    uint32_t steps;
+} ble_msg_status_t;
+
+typedef struct {
+    uint32_t cursor;
+    uint16_t count;
+} ble_msg_history_t;
+
+size_t ble_proto_encode_hello(uint8_t* buf, size_t cap, const ble_msg_hello_t* m);
+size_t ble_proto_encode_time(uint8_t* buf, size_t cap, const ble_msg_time_t* m);
+size_t ble_proto_encode_notification(uint8_t* buf, size_t cap, const ble_msg_notification_t* m);
+size_t ble_proto_encode_status(uint8_t* buf, size_t cap, const ble_msg_status_t* m);
+size_t ble_proto_encode_history(uint8_t* buf, size_t cap, const ble_msg_history_t* m);
+
+// Unknown tags are skipped (forward compatible); missing ones stay zero.
+// Return false on a type mismatch or malformed payload.
+bool ble_proto_decode_hello(const ble_proto_frame_t* f, ble_msg_hello_t* m);
+bool ble_proto_decode_time(const ble_proto_frame_t* f, ble_msg_time_t* m);
+bool ble_proto_decode_notification(const ble_proto_frame_t* f, ble_msg_notification_t* m);
+bool ble_proto_decode_status(const ble_proto_frame_t* f, ble_msg_status_t* m);
+bool ble_proto_decode_history(const ble_proto_frame_t* f, ble_msg_history_t* m);
+
+// Copy a string view into dst as a C string, truncating to cap - 1.
+void ble_proto_str_copy(char* dst, size_t cap, ble_proto_str_t s);
+
+// Concatenate every `tag` TLV of the frame into dst as a C string
+// (truncated to cap - 1). Returns the length written.
+size_t ble_proto_str_concat(const ble_proto_frame_t* f, uint8_t tag, char* dst, size_t cap);
+
+// Same for binary data, no terminator. Returns the total length of the
+// TLVs, larger than cap when only the first cap bytes were copied.
+size_t ble_proto_bytes_concat(const ble_proto_frame_t* f, uint8_t tag, uint8_t* dst, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
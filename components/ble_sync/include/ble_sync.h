@@ -14,8 +14,17 @@ extern "C" {
 
 esp_err_t ble_sync_init(void);
 esp_err_t ble_sync_send_status(int battery_percent, bool charging);
+// Sync on/off: gates the UART service only. Advertising, the link and HID
+// stay up (ble_host.h owns those).
 esp_err_t ble_sync_set_enabled(bool enabled);
 bool ble_sync_is_enabled(void);
+// Advertise fast for a while to pair a new host, whatever the power state.
+// ESP_ERR_INVALID_STATE before the host runs.
+esp_err_t ble_sync_pair_now(void);
+
+// Log counters and per-stage timings of the notification pipeline
+// (parse, queue wait, render, display wake, audio)
+void ble_sync_dump_notif_stats(void);
 
 // BLE connection status events for UI/other components
 // Event base published by ble_sync component
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hand-off of parsed notifications from the BLE receive task to the UI.
+// One lock-free single-producer / single-consumer ring per priority lane;
+// the consumer always drains the high lane first. A full lane refuses the
+// push (counted as a drop) instead of blocking the producer, so a burst can
+// never stall BLE RX. Items are opaque pointers owned by the caller.
+// Each entry carries its enqueue time so the consumer can account the
+// queueing delay. Plain C, tested on the host.
+
+#define NOTIF_PIPE_DEPTH 16         // per lane, power of two
+
+typedef enum {
+    NOTIF_PRIO_NORMAL = 0,
+    NOTIF_PRIO_HIGH,                // calls, alarms: never wait behind a chat burst
+    NOTIF_PRIO_COUNT,
+} notif_prio_t;
+
+// Timing of one pipeline stage, in microseconds
+typedef struct {
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint64_t total_us;
+} notif_stage_t;
+
+typedef struct {
+    struct {
+        void* item;
+        uint32_t enq_us;
+    } ring[NOTIF_PIPE_DEPTH];
+    atomic_uint head;               // next write, producer only
+    atomic_uint tail;               // next read, consumer only
+    uint32_t pushed;                // producer only
+    uint32_t dropped;               // producer only
+} notif_lane_t;
+
+typedef struct {
+    notif_lane_t lane[NOTIF_PRIO_COUNT];
+    uint32_t max_depth;             // producer only: deepest backlog seen
+    notif_stage_t wait;             // consumer only: push -> pop
+} notif_pipe_t;
+
+void notif_pipe_init(notif_pipe_t* p);
+
+// Producer side. False when the lane is full.
+bool notif_pipe_push(notif_pipe_t* p, void* item, notif_prio_t prio, uint32_t now_us);
+
+// Consumer side. Oldest item of the highest non-empty lane, NULL if empty.
+void* notif_pipe_pop(notif_pipe_t* p, uint32_t now_us, notif_prio_t* prio);
+
+// Items queued in all lanes (a snapshot, safe from either side)
+unsigned notif_pipe_depth(const notif_pipe_t* p);
+
+// Lane for a notification from this app id (call / alarm apps are high)
+notif_prio_t notif_pipe_classify(const char* app);
+
+void notif_stage_record(notif_stage_t* s, uint32_t us);
+uint32_t notif_stage_avg_us(const notif_stage_t* s);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+// Notification hand-off rings (see notif_pipe.h)
+
+#include "notif_pipe.h"
+
+#include <string.h>
+#include <strings.h>
+
+void notif_pipe_init(notif_pipe_t* p)
+{
+    memset(p, 0, sizeof(*p));
+    for (unsigned l = 0; l < NOTIF_PRIO_COUNT; ++l) {
+        atomic_init(&p->lane[l].head, 0);
+        atomic_init(&p->lane[l].tail, 0);
+    }
+}
+
+bool notif_pipe_push(notif_pipe_t* p, void* item, notif_prio_t prio, uint32_t now_us)
+{
+    if ((unsigned)prio >= NOTIF_PRIO_COUNT) prio = NOTIF_PRIO_NORMAL;
+    notif_lane_t* l = &p->lane[prio];
+    unsigned head = atomic_load_explicit(&l->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&l->tail, memory_order_acquire);
+    if (head - tail >= NOTIF_PIPE_DEPTH) {
+        l->dropped++;
+        return false;
+    }
+    l->ring[head % NOTIF_PIPE_DEPTH].item = item;
+    l->ring[head % NOTIF_PIPE_DEPTH].enq_us = now_us;
+    // Publish the entry before the new head
+    atomic_store_explicit(&l->head, head + 1, memory_order_release);
+    l->pushed++;
+
+    unsigned depth = notif_pipe_depth(p);
+    if (depth > p->max_depth) p->max_depth = depth;
+    return true;
+}
+
+void* notif_pipe_pop(notif_pipe_t* p, uint32_t now_us, notif_prio_t* prio)
+{
+    for (int l = NOTIF_PRIO_COUNT - 1; l >= 0; --l) {
+        notif_lane_t* ln = &p->lane[l];
+        unsigned tail = atomic_load_explicit(&ln->tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&ln->head, memory_order_acquire);
+        if (head == tail) continue;
+
+        void* item = ln->ring[tail % NOTIF_PIPE_DEPTH].item;
+        notif_stage_record(&p->wait, now_us - ln->ring[tail % NOTIF_PIPE_DEPTH].enq_us);
+        // Entry read: hand the slot back to the producer
+        atomic_store_explicit(&ln->tail, tail + 1, memory_order_release);
+        if (prio) *prio = (notif_prio_t)l;
+        return item;
+    }
+    return NULL;
+}
+
+unsigned notif_pipe_depth(const notif_pipe_t* p)
+{
+    unsigned n = 0;
+    for (unsigned l = 0; l < NOTIF_PRIO_COUNT; ++l) {
+        unsigned tail = atomic_load_explicit(&p->lane[l].tail, memory_order_acquire);
+        unsigned head = atomic_load_explicit(&p->lane[l].head, memory_order_acquire);
+        n += head - tail;
+    }
+    return n;
+}
+
+notif_prio_t notif_pipe_classify(const char* app)
+{
+    static const char* const k_high[] = {
+        "call",
+        "com.google.android.dialer",
+        "com.android.dialer",
+        "com.android.incallui",
+        "com.android.server.telecom",
+        "com.google.android.deskclock",
+        "com.android.deskclock",
+    };
+    if (!app) return NOTIF_PRIO_NORMAL;
+    for (size_t i = 0; i < sizeof(k_high) / sizeof(k_high[0]); ++i) {
+        if (strcasecmp(app, k_high[i]) == 0) return NOTIF_PRIO_HIGH;
+    }
+    return NOTIF_PRIO_NORMAL;
+}
+
+void notif_stage_record(notif_stage_t* s, uint32_t us)
+{
+    s->count++;
+    s->last_us = us;
+    s->total_us += us;
+    if (us > s->max_us) s->max_us = us;
+}
+
+uint32_t notif_stage_avg_us(const notif_stage_t* s)
+{
+    return s->count ? (uint32_t)(s->total_us / s->count) : 0;
+}
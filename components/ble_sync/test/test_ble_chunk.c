@@ -0,0 +1,230 @@
+#include "unity.h"
+
+#include "ble_chunk.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT_BYTES 4096
+#define PIECE      200
+
+static uint8_t s_storage[2 * SLOT_BYTES];
+static uint8_t s_frames[32][BLE_PROTO_MAX_FRAME];
+static size_t s_frame_len[32];
+
+// Encode a notification with a long body and cut its payload into chunk
+// frames of PIECE bytes. Returns the number of chunks.
+static unsigned make_chunks(uint16_t xfer, const char* body, uint8_t* msg, size_t cap, size_t* msg_len) {
+  ble_proto_writer_t w;
+  ble_proto_begin(&w, msg, cap, BLE_MSG_NOTIFICATION);
+  ble_proto_put_uint(&w, BLE_TAG_ID, 42);
+  ble_proto_put_str(&w, BLE_TAG_APP, "Mail");
+  ble_proto_put_str(&w, BLE_TAG_TITLE, "Informe");
+  ble_proto_put_long_str(&w, BLE_TAG_BODY, body);
+  size_t n = ble_proto_finish(&w);
+  TEST_ASSERT_GREATER_THAN(0, n);
+  const uint8_t* payload = msg + BLE_PROTO_HDR_LEN;
+  size_t plen = n - BLE_PROTO_OVERHEAD;
+  *msg_len = plen;
+
+  unsigned count = (unsigned)((plen + PIECE - 1) / PIECE);
+  TEST_ASSERT_TRUE(count <= 32);
+  for (unsigned i = 0; i < count; ++i) {
+    size_t off = (size_t)i * PIECE;
+    size_t k = plen - off < PIECE ? plen - off : PIECE;
+    s_frame_len[i] = ble_chunk_encode(s_frames[i], BLE_PROTO_MAX_FRAME, xfer, (uint8_t)i, (uint8_t)count,
+                                      (uint32_t)off, BLE_MSG_NOTIFICATION, payload + off, k);
+    TEST_ASSERT_GREATER_THAN(0, s_frame_len[i]);
+  }
+  return count;
+}
+
+static ble_chunk_result_t feed(ble_chunk_pool_t* pool, unsigned i, uint32_t now, ble_chunk_msg_t* out) {
+  ble_proto_frame_t f;
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(s_frames[i], s_frame_len[i], &f, NULL));
+  return ble_chunk_feed(pool, &f, now, out);
+}
+
+static char* long_body(size_t n) {
+  char* s = malloc(n + 1);
+  for (size_t i = 0; i < n; ++i) s[i] = (char)('a' + i % 26);
+  s[n] = '\0';
+  return s;
+}
+
+static void check_body(const ble_chunk_msg_t* m, const char* body) {
+  ble_proto_frame_t f;
+  ble_chunk_as_frame(m, &f);
+  TEST_ASSERT_EQUAL(BLE_MSG_NOTIFICATION, f.type);
+  ble_msg_notification_t n;
+  TEST_ASSERT_TRUE(ble_proto_decode_notification(&f, &n));
+  TEST_ASSERT_EQUAL_UINT32(42, n.id);
+  static char out[SLOT_BYTES];
+  size_t len = ble_proto_str_concat(&f, BLE_TAG_BODY, out, sizeof(out));
+  TEST_ASSERT_EQUAL(strlen(body), len);
+  TEST_ASSERT_EQUAL_STRING(body, out);
+}
+
+TEST_CASE("chunks in order reassemble a 3 KB notification", "[ble_chunk]") {
+  ble_chunk_pool_t pool;
+  ble_chunk_pool_init(&pool, s_storage, 2, SLOT_BYTES);
+  char* body = long_body(3000);
+  static uint8_t msg[SLOT_BYTES];
+  size_t mlen;
+  unsigned count = make_chunks(1, body, msg, sizeof(msg), &mlen);
+  TEST_ASSERT_GREATER_THAN(10, count);
+
+  ble_chunk_msg_t m;
+  for (unsigned i = 0; i + 1 < count; ++i) {
+    TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, i, 100 + i, &m));
+  }
+  TEST_ASSERT_EQUAL(BLE_CHUNK_COMPLETE, feed(&pool, count - 1, 200, &m));
+  TEST_ASSERT_EQUAL(mlen, m.len);
+  check_body(&m, body);
+  ble_chunk_release(&pool, &m);
+  TEST_ASSERT_EQUAL_UINT32(1, pool.stats.completed);
+  free(body);
+}
+
+TEST_CASE("shuffled and duplicated chunks", "[ble_chunk]") {
+  ble_chunk_pool_t pool;
+  ble_chunk_pool_init(&pool, s_storage, 2, SLOT_BYTES);
+  char* body = long_body(2500);
+  static uint8_t msg[SLOT_BYTES];
+  size_t mlen;
+  unsigned count = make_chunks(7, body, msg, sizeof(msg), &mlen);
+
+  unsigned order[32];
+  for (unsigned i = 0; i < count; ++i) order[i] = i;
+  srand(1234);
+  for (unsigned i = count - 1; i > 0; --i) {
+    unsigned j = (unsigned)rand() % (i + 1);
+    unsigned t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+
+  ble_chunk_msg_t m;
+  ble_chunk_result_t r = BLE_CHUNK_PENDING;
+  for (unsigned i = 0; i < count; ++i) {
+    r = feed(&pool, order[i], 10 + 2 * i, &m);
+    if (i + 1 < count) {
+      TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, r);
+      // Every chunk sent twice: the copy is ignored
+      TEST_ASSERT_EQUAL(BLE_CHUNK_DUPLICATE, feed(&pool, order[i], 11 + 2 * i, &m));
+    }
+  }
+  TEST_ASSERT_EQUAL(BLE_CHUNK_COMPLETE, r);
+  check_body(&m, body);
+  ble_chunk_release(&pool, &m);
+  TEST_ASSERT_EQUAL_UINT32(count - 1, pool.stats.duplicates);
+
+  // The phone retries the whole transfer: not delivered again
+  for (unsigned i = 0; i < count; ++i) {
+    TEST_ASSERT_EQUAL(BLE_CHUNK_DUPLICATE, feed(&pool, i, 100, &m));
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, pool.stats.completed);
+  free(body);
+}
+
+TEST_CASE("lost chunk times out and frees the slot", "[ble_chunk]") {
+  ble_chunk_pool_t pool;
+  ble_chunk_pool_init(&pool, s_storage, 1, SLOT_BYTES);
+  char* body = long_body(1200);
+  static uint8_t msg[SLOT_BYTES];
+  size_t mlen;
+  unsigned count = make_chunks(3, body, msg, sizeof(msg), &mlen);
+
+  ble_chunk_msg_t m;
+  for (unsigned i = 0; i < count; ++i) {
+    if (i == 2) continue;  // lost on the air
+    TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, i, 1000, &m));
+  }
+  TEST_ASSERT_EQUAL(0, ble_chunk_expire(&pool, 1000 + BLE_CHUNK_TIMEOUT_MS - 1));
+  TEST_ASSERT_EQUAL(1, ble_chunk_expire(&pool, 1000 + BLE_CHUNK_TIMEOUT_MS));
+  TEST_ASSERT_EQUAL_UINT32(1, pool.stats.timeouts);
+
+  // Late chunk starts a fresh transfer that never completes on its own
+  TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, 2, 5000, &m));
+
+  // A full retransmission after that goes through
+  for (unsigned i = 0; i < count; ++i) {
+    ble_chunk_result_t r = feed(&pool, i, 5100, &m);
+    if (i == 2) {
+      TEST_ASSERT_EQUAL(BLE_CHUNK_DUPLICATE, r);
+    } else if (i + 1 < count) {
+      TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, r);
+    } else {
+      TEST_ASSERT_EQUAL(BLE_CHUNK_COMPLETE, r);
+    }
+  }
+  check_body(&m, body);
+  ble_chunk_release(&pool, &m);
+  free(body);
+}
+
+TEST_CASE("new transfer evicts the oldest incomplete one", "[ble_chunk]") {
+  ble_chunk_pool_t pool;
+  ble_chunk_pool_init(&pool, s_storage, 2, SLOT_BYTES);
+  static uint8_t msg[SLOT_BYTES];
+  size_t mlen;
+  ble_chunk_msg_t m;
+  char* body = long_body(600);
+
+  make_chunks(10, body, msg, sizeof(msg), &mlen);
+  TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, 0, 100, &m));
+  make_chunks(11, body, msg, sizeof(msg), &mlen);
+  TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, 0, 200, &m));
+  unsigned count = make_chunks(12, body, msg, sizeof(msg), &mlen);
+  for (unsigned i = 0; i + 1 < count; ++i) {
+    TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, i, 300, &m));
+  }
+  TEST_ASSERT_EQUAL(BLE_CHUNK_COMPLETE, feed(&pool, count - 1, 300, &m));
+  TEST_ASSERT_EQUAL_UINT32(1, pool.stats.evicted);
+  check_body(&m, body);
+
+  // A slot lent out as COMPLETE is never evicted: the next transfer takes
+  // the other one and the message stays intact until released
+  ble_chunk_msg_t lent = m;
+  make_chunks(13, body, msg, sizeof(msg), &mlen);
+  TEST_ASSERT_EQUAL(BLE_CHUNK_PENDING, feed(&pool, 0, 400, &m));
+  TEST_ASSERT_EQUAL_UINT32(2, pool.stats.evicted);
+  check_body(&lent, body);
+  ble_chunk_release(&pool, &lent);
+  free(body);
+}
+
+TEST_CASE("malformed and oversize chunks are rejected", "[ble_chunk]") {
+  ble_chunk_pool_t pool;
+  ble_chunk_pool_init(&pool, s_storage, 2, 1024);
+  uint8_t buf[BLE_PROTO_MAX_FRAME];
+  uint8_t data[100] = {0};
+  ble_proto_frame_t f;
+  ble_chunk_msg_t m;
+
+  // Past the end of the slot
+  size_t n = ble_chunk_encode(buf, sizeof(buf), 1, 0, 2, 1000, BLE_MSG_NOTIFICATION, data, sizeof(data));
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+  TEST_ASSERT_EQUAL(BLE_CHUNK_REJECTED, ble_chunk_feed(&pool, &f, 0, &m));
+
+  // seq >= count
+  n = ble_chunk_encode(buf, sizeof(buf), 1, 3, 2, 0, BLE_MSG_NOTIFICATION, data, sizeof(data));
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+  TEST_ASSERT_EQUAL(BLE_CHUNK_REJECTED, ble_chunk_feed(&pool, &f, 0, &m));
+
+  // More parts than the bitmap holds
+  n = ble_chunk_encode(buf, sizeof(buf), 1, 0, BLE_CHUNK_MAX_PARTS + 1, 0, BLE_MSG_NOTIFICATION, data, 10);
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+  TEST_ASSERT_EQUAL(BLE_CHUNK_REJECTED, ble_chunk_feed(&pool, &f, 0, &m));
+
+  // Missing tags
+  ble_proto_writer_t w;
+  ble_proto_begin(&w, buf, sizeof(buf), BLE_MSG_CHUNK);
+  ble_proto_put_uint(&w, BLE_TAG_XFER, 1);
+  n = ble_proto_finish(&w);
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+  TEST_ASSERT_EQUAL(BLE_CHUNK_REJECTED, ble_chunk_feed(&pool, &f, 0, &m));
+
+  TEST_ASSERT_EQUAL_UINT32(4, pool.stats.rejected);
+  TEST_ASSERT_EQUAL(BLE_PROTO_MAX_FRAME - BLE_PROTO_OVERHEAD - 21, ble_chunk_data_max(BLE_PROTO_MAX_FRAME));
+}
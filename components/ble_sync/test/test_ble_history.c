@@ -0,0 +1,274 @@
+#include "unity.h"
+
+#include "ble_history.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_CAP 512
+
+static ble_hist_rec_t s_recs[LOG_CAP];
+
+// Record content derived from its seq so the peer can verify every byte
+static size_t make_payload(uint32_t seq, uint8_t* out) {
+  size_t len = 6 + seq % 40;
+  for (size_t i = 0; i < len; ++i) out[i] = (uint8_t)(seq * 31 + i);
+  return len;
+}
+
+static void fill_log(ble_hist_log_t* log, unsigned n) {
+  uint8_t d[BLE_HIST_REC_DATA];
+  for (unsigned i = 0; i < n; ++i) {
+    uint32_t seq = log->next_seq;
+    size_t len = make_payload(seq, d);
+    ble_hist_log_append(log, seq % 3 ? BLE_HIST_ACTIVITY : BLE_HIST_NOTIF, 1700000000u + seq, d, len);
+  }
+}
+
+// ---------------------------------------------------------- phone stand-in
+
+typedef struct {
+  uint32_t epoch;
+  uint32_t cursor;       // last seq stored, persisted across reconnects
+  uint32_t stored;
+  uint32_t dup;          // records at or below the cursor, ignored
+  uint32_t gaps;         // records missing in the sequence
+  uint32_t bad;          // content or CRC mismatch
+  uint32_t out_of_order; // batches dropped because an earlier one was lost
+  bool done;             // saw MORE = 0
+} peer_t;
+
+// Consume one batch; returns the ack frame size (0 if the batch was bad)
+static size_t peer_on_batch(peer_t* p, const uint8_t* buf, size_t n, uint8_t* ack, size_t ack_cap) {
+  ble_proto_frame_t f;
+  if (ble_proto_parse(buf, n, &f, NULL) != BLE_PROTO_OK || f.type != BLE_MSG_HIST_BATCH) {
+    p->bad++;
+    return 0;
+  }
+  ble_proto_iter_t it;
+  ble_proto_tlv_t t;
+  ble_proto_iter_init(&it, &f);
+  // Epoch and PREV come after the records: look them up first
+  uint32_t prev = 0;
+  while (ble_proto_iter_next(&it, &t)) {
+    if (t.tag == BLE_TAG_ID && ble_proto_tlv_uint(&t) != p->epoch) {
+      p->epoch = ble_proto_tlv_uint(&t);
+      p->cursor = 0;
+    }
+    if (t.tag == BLE_TAG_PREV) prev = ble_proto_tlv_uint(&t);
+  }
+  if (prev > p->cursor) {
+    p->out_of_order++;
+    return ble_hist_encode_ack(ack, ack_cap, p->cursor);
+  }
+  uint32_t more = 1;
+  ble_proto_iter_init(&it, &f);
+  while (ble_proto_iter_next(&it, &t)) {
+    ble_hist_rec_view_t r;
+    if (t.tag == BLE_TAG_MORE) more = ble_proto_tlv_uint(&t);
+    if (!ble_hist_rec_decode(&t, &r)) continue;
+    if (r.seq <= p->cursor) {
+      p->dup++;
+      continue;
+    }
+    p->gaps += r.seq - p->cursor - 1;
+    uint8_t want[BLE_HIST_REC_DATA];
+    size_t len = make_payload(r.seq, want);
+    if (r.len != len || memcmp(r.data, want, len) != 0 || r.ts != 1700000000u + r.seq) p->bad++;
+    p->cursor = r.seq;
+    p->stored++;
+  }
+  if (!more) p->done = true;
+  return ble_hist_encode_ack(ack, ack_cap, p->cursor);
+}
+
+static uint32_t decode_cursor(const uint8_t* buf, size_t n, uint8_t type) {
+  ble_proto_frame_t f;
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+  TEST_ASSERT_EQUAL(type, f.type);
+  return ble_hist_frame_cursor(&f);
+}
+
+// --------------------------------------------------------------- the link
+
+typedef struct {
+  unsigned drop_pct;     // loss on both directions
+  int disconnect_at;     // step at which the link drops, -1 = never
+  unsigned steps;
+  uint32_t air_bytes;
+} link_t;
+
+static bool lossy(link_t* l) {
+  return l->drop_pct && (unsigned)(rand() % 100) < l->drop_pct;
+}
+
+// Run a full sync: request, batches, acks, timeouts and a reconnect.
+// One step is one 10 ms connection event.
+static void run_sync(ble_hist_log_t* log, ble_hist_tx_t* tx, peer_t* p, link_t* l) {
+  static uint8_t frame[BLE_HIST_FRAME_MAX];
+  uint8_t small[32];
+  uint32_t now = 0;
+  bool connected = true;
+
+  size_t n = ble_hist_encode_request(small, sizeof(small), p->cursor, 0);
+  ble_hist_tx_start(tx, log, decode_cursor(small, n, BLE_MSG_HISTORY), 0, now);
+
+  for (l->steps = 0; l->steps < 20000 && (tx->active || !p->done); ++l->steps, now += 10) {
+    if ((int)l->steps == l->disconnect_at) {
+      ble_hist_tx_abort(tx);
+      connected = false;
+      continue;
+    }
+    if (!connected) {
+      // Reconnect a second later; the phone resumes from its cursor
+      if ((int)l->steps < l->disconnect_at + 100) continue;
+      connected = true;
+      p->done = false;
+      n = ble_hist_encode_request(small, sizeof(small), p->cursor, 0);
+      ble_hist_tx_start(tx, log, decode_cursor(small, n, BLE_MSG_HISTORY), 0, now);
+    }
+
+    while ((n = ble_hist_tx_next(tx, log, frame, sizeof(frame), now)) > 0) {
+      l->air_bytes += n;
+      if (lossy(l)) continue;
+      size_t an = peer_on_batch(p, frame, n, small, sizeof(small));
+      if (an && !lossy(l)) ble_hist_tx_ack(tx, decode_cursor(small, an, BLE_MSG_HIST_ACK), now);
+    }
+    ble_hist_tx_poll(tx, now);
+    // The last ack may be lost: the phone asks again when it saw MORE = 0
+    if (!tx->active && p->cursor < ble_hist_log_newest(log)) {
+      ble_hist_tx_start(tx, log, p->cursor, 0, now);
+    }
+  }
+}
+
+TEST_CASE("history log ring and cursors", "[ble_history]") {
+  ble_hist_log_t log;
+  ble_hist_log_init(&log, s_recs, 8, 1);
+  TEST_ASSERT_EQUAL(0, ble_hist_log_oldest(&log));
+  TEST_ASSERT_EQUAL(0, ble_hist_log_newest(&log));
+  TEST_ASSERT_NULL(ble_hist_log_get(&log, 1));
+  fill_log(&log, 5);
+  TEST_ASSERT_EQUAL(1, ble_hist_log_oldest(&log));
+  TEST_ASSERT_EQUAL(5, ble_hist_log_newest(&log));
+  fill_log(&log, 10);
+  TEST_ASSERT_EQUAL(8, ble_hist_log_oldest(&log));
+  TEST_ASSERT_EQUAL(15, ble_hist_log_newest(&log));
+  TEST_ASSERT_NULL(ble_hist_log_get(&log, 7));
+  TEST_ASSERT_EQUAL_UINT32(12, ble_hist_log_get(&log, 12)->seq);
+
+  // Oversized payloads are truncated
+  uint8_t big[100] = {0};
+  uint32_t seq = ble_hist_log_append(&log, BLE_HIST_NOTIF, 0, big, sizeof(big));
+  TEST_ASSERT_EQUAL(BLE_HIST_REC_DATA, ble_hist_log_get(&log, seq)->len);
+}
+
+TEST_CASE("clean link delivers every record once", "[ble_history]") {
+  ble_hist_log_t log;
+  ble_hist_tx_t tx = {0};
+  peer_t p = {0};
+  link_t l = {.drop_pct = 0, .disconnect_at = -1};
+  ble_hist_log_init(&log, s_recs, LOG_CAP, 0x1234);
+  fill_log(&log, 400);
+
+  run_sync(&log, &tx, &p, &l);
+  TEST_ASSERT_FALSE(tx.active);
+  TEST_ASSERT_EQUAL_UINT32(400, p.stored);
+  TEST_ASSERT_EQUAL_UINT32(400, p.cursor);
+  TEST_ASSERT_EQUAL_UINT32(0, p.dup + p.gaps + p.bad);
+  TEST_ASSERT_EQUAL_UINT32(0, tx.stats.retransmits);
+  // Batching: far fewer frames than records
+  TEST_ASSERT_LESS_THAN(400 / 10, tx.stats.batches);
+
+  // Nothing new: one empty batch closes the request
+  p.done = false;
+  ble_hist_tx_start(&tx, &log, p.cursor, 0, 0);
+  uint8_t frame[BLE_HIST_FRAME_MAX], ack[32];
+  size_t n = ble_hist_tx_next(&tx, &log, frame, sizeof(frame), 0);
+  TEST_ASSERT_GREATER_THAN(0, n);
+  TEST_ASSERT_EQUAL(0, ble_hist_tx_next(&tx, &log, frame, sizeof(frame), 0));
+  size_t an = peer_on_batch(&p, frame, n, ack, sizeof(ack));
+  TEST_ASSERT_TRUE(p.done);
+  TEST_ASSERT_TRUE(ble_hist_tx_ack(&tx, decode_cursor(ack, an, BLE_MSG_HIST_ACK), 0));
+}
+
+TEST_CASE("lossy link recovers by going back to the last ack", "[ble_history]") {
+  ble_hist_log_t log;
+  ble_hist_tx_t tx = {0};
+  peer_t p = {0};
+  link_t l = {.drop_pct = 20, .disconnect_at = -1};
+  srand(77);
+  ble_hist_log_init(&log, s_recs, LOG_CAP, 0x1234);
+  fill_log(&log, 500);
+
+  run_sync(&log, &tx, &p, &l);
+  TEST_ASSERT_EQUAL_UINT32(500, p.cursor);
+  TEST_ASSERT_EQUAL_UINT32(500, p.stored);
+  TEST_ASSERT_EQUAL_UINT32(0, p.gaps + p.bad);
+  TEST_ASSERT_GREATER_THAN(0, tx.stats.retransmits);
+  TEST_ASSERT_GREATER_THAN(0, p.out_of_order);
+}
+
+TEST_CASE("interrupted transfer resumes from the acked cursor", "[ble_history]") {
+  ble_hist_log_t log;
+  ble_hist_tx_t tx = {0};
+  peer_t p = {0};
+  link_t l = {.drop_pct = 5, .disconnect_at = 3};
+  srand(5);
+  ble_hist_log_init(&log, s_recs, LOG_CAP, 0x99);
+  fill_log(&log, 450);
+
+  run_sync(&log, &tx, &p, &l);
+  TEST_ASSERT_EQUAL_UINT32(450, p.cursor);
+  TEST_ASSERT_EQUAL_UINT32(450, p.stored);
+  TEST_ASSERT_EQUAL_UINT32(0, p.gaps + p.bad);
+
+  // A cursor from before a reboot (new epoch, ahead of the log) gets everything
+  ble_hist_log_init(&log, s_recs, LOG_CAP, 0x100);
+  fill_log(&log, 30);
+  tx.stats.records = 0;
+  l = (link_t){.drop_pct = 0, .disconnect_at = -1};
+  run_sync(&log, &tx, &p, &l);
+  TEST_ASSERT_EQUAL_UINT32(0x100, p.epoch);
+  TEST_ASSERT_EQUAL_UINT32(30, p.cursor);
+  TEST_ASSERT_EQUAL_UINT32(30, tx.stats.records);
+}
+
+TEST_CASE("records overwritten before the sync show up as a gap", "[ble_history]") {
+  ble_hist_log_t log;
+  ble_hist_tx_t tx = {0};
+  peer_t p = {.epoch = 7, .cursor = 10};
+  link_t l = {.drop_pct = 0, .disconnect_at = -1};
+  ble_hist_log_init(&log, s_recs, 64, 7);
+  fill_log(&log, 200);  // 1..136 are gone
+
+  run_sync(&log, &tx, &p, &l);
+  TEST_ASSERT_EQUAL_UINT32(200, p.cursor);
+  TEST_ASSERT_EQUAL_UINT32(126, p.gaps);
+  TEST_ASSERT_EQUAL_UINT32(126, tx.stats.lost);
+  TEST_ASSERT_EQUAL_UINT32(64, p.stored);
+  TEST_ASSERT_EQUAL_UINT32(0, p.bad);
+}
+
+TEST_CASE("benchmark history sync", "[ble_history][bench]") {
+  ble_hist_log_t log;
+  ble_hist_tx_t tx = {0};
+  peer_t p = {0};
+  link_t l = {.drop_pct = 0, .disconnect_at = -1};
+  ble_hist_log_init(&log, s_recs, LOG_CAP, 1);
+  fill_log(&log, LOG_CAP);
+
+  int64_t t0 = esp_timer_get_time();
+  run_sync(&log, &tx, &p, &l);
+  int64_t dt = esp_timer_get_time() - t0;
+  TEST_ASSERT_EQUAL_UINT32(LOG_CAP, p.stored);
+
+  uint32_t payload = 0;
+  for (uint32_t s = 1; s <= LOG_CAP; ++s) payload += ble_hist_log_get(&log, s)->len;
+  printf("ble_history: %u records in %u batches, %u B on air (%u%% payload), encode+verify %u records/s\n",
+         (unsigned)tx.stats.records, (unsigned)tx.stats.batches, (unsigned)l.air_bytes,
+         (unsigned)(payload * 100 / l.air_bytes),
+         dt > 0 ? (unsigned)((int64_t)LOG_CAP * 1000000 / dt) : 0);
+}
@@ -0,0 +1,164 @@
+#include "unity.h"
+
+#include "ble_json.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* k_notif =
+    "{\"notification\":\"2025-03-01T10:20:30\",\"app\":\"WhatsApp\","
+    "\"title\":\"Ana\",\"message\":\"Hola \\\"qu\\u00e9\\\" tal\\n\\ud83d\\ude00\"}";
+
+TEST_CASE("tokenizer basic object", "[ble_json]") {
+  ble_json_tok_t t[16];
+  const char* js = "{\"a\":1,\"b\":[true,null,\"x\"],\"c\":{\"d\":-2}}";
+  int n = ble_json_parse(js, strlen(js), t, 16);
+  TEST_ASSERT_EQUAL(12, n);
+  TEST_ASSERT_EQUAL(BLE_JSON_OBJECT, t[0].type);
+  TEST_ASSERT_EQUAL(3, t[0].size);
+
+  int v = ble_json_find(js, t, n, "b");
+  TEST_ASSERT_EQUAL(BLE_JSON_ARRAY, t[v].type);
+  TEST_ASSERT_EQUAL(3, t[v].size);
+
+  int32_t a = 0;
+  TEST_ASSERT_TRUE(ble_json_get_int(js, &t[ble_json_find(js, t, n, "a")], &a));
+  TEST_ASSERT_EQUAL(1, a);
+  // Only top-level keys are found
+  TEST_ASSERT_EQUAL(-1, ble_json_find(js, t, n, "d"));
+  TEST_ASSERT_EQUAL(-1, ble_json_find(js, t, n, "zz"));
+}
+
+TEST_CASE("extract notification with escapes", "[ble_json]") {
+  ble_json_msg_t m;
+  static ble_notif_slot_t s;  // ~4 KB, off the test task stack
+  TEST_ASSERT_TRUE(ble_json_extract(k_notif, strlen(k_notif), &m, &s));
+  TEST_ASSERT_TRUE(m.has_notification);
+  TEST_ASSERT_FALSE(m.has_datetime);
+  TEST_ASSERT_FALSE(m.has_status);
+  TEST_ASSERT_EQUAL_STRING("2025-03-01T10:20:30", s.ts);
+  TEST_ASSERT_EQUAL_STRING("WhatsApp", s.app);
+  TEST_ASSERT_EQUAL_STRING("Hola \"qu\xc3\xa9\" tal\n\xf0\x9f\x98\x80", s.message);
+}
+
+TEST_CASE("missing app and title are empty, not NULL", "[ble_json]") {
+  const char* js = "{\"notification\":\"t\",\"message\":\"m\",\"title\":7}";
+  ble_json_msg_t m;
+  static ble_notif_slot_t s;
+  memset(&s, 'x', sizeof(s));
+  TEST_ASSERT_TRUE(ble_json_extract(js, strlen(js), &m, &s));
+  TEST_ASSERT_TRUE(m.has_notification);
+  TEST_ASSERT_EQUAL_STRING("", s.app);
+  TEST_ASSERT_EQUAL_STRING("", s.title);
+  TEST_ASSERT_EQUAL_STRING("m", s.message);
+}
+
+TEST_CASE("datetime and status, NUL terminated item", "[ble_json]") {
+  // Ring-buffer items carry a trailing NUL counted in their size
+  const char js[] = "{\"datetime\":\"2025-01-02T03:04:05\",\"status\":\"get\"}";
+  ble_json_msg_t m;
+  TEST_ASSERT_TRUE(ble_json_extract(js, sizeof(js), &m, NULL));
+  TEST_ASSERT_TRUE(m.has_datetime);
+  TEST_ASSERT_TRUE(m.has_status);
+  TEST_ASSERT_EQUAL_STRING("2025-01-02T03:04:05", m.datetime);
+}
+
+TEST_CASE("truncation keeps UTF-8 whole", "[ble_json]") {
+  ble_json_tok_t t[4];
+  const char* js = "{\"k\":\"ab\xc3\xa9\xc3\xa9\"}";
+  int n = ble_json_parse(js, strlen(js), t, 4);
+  TEST_ASSERT_EQUAL(3, n);
+  char out[5];
+  TEST_ASSERT_EQUAL(4, ble_json_copy_str(js, &t[2], out, sizeof(out)));
+  TEST_ASSERT_EQUAL_STRING("ab\xc3\xa9", out);
+  char small[4];
+  TEST_ASSERT_EQUAL(2, ble_json_copy_str(js, &t[2], small, sizeof(small)));
+}
+
+TEST_CASE("malformed inputs are rejected", "[ble_json]") {
+  static const char* bad[] = {
+      "{",        "{\"a\"",        "{\"a\":}",     "{\"a\":1,}x", "{\"a\":1}}",
+      "[1,2",     "{\"a\":\"x}",   "{1:2}",        "{\"a\":1 2}", "{\"a\":\"\\q\"}",
+      "{\"a\":\"\\u12\"}", "{\"a\":[}]", "{\"a\"::1}", "}", "{\"a\":1}{\"b\":2}",
+      "{\"a\":\"\x01\"}",
+  };
+  ble_json_tok_t t[16];
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+    int n = ble_json_parse(bad[i], strlen(bad[i]), t, 16);
+    if (n >= 0) {
+      fprintf(stderr, "accepted: %s\n", bad[i]);
+    }
+    TEST_ASSERT_LESS_THAN(0, n);
+  }
+
+  // Too many tokens and too deep
+  char big[512];
+  size_t o = 0;
+  big[o++] = '[';
+  for (int i = 0; i < 100; ++i) o += (size_t)snprintf(big + o, sizeof(big) - o, "%d,", i);
+  big[o - 1] = ']';
+  TEST_ASSERT_EQUAL(BLE_JSON_ERR_NOMEM, ble_json_parse(big, o, t, 16));
+  const char* deep = "[[[[[[[[[[1]]]]]]]]]]";
+  TEST_ASSERT_EQUAL(BLE_JSON_ERR_DEPTH, ble_json_parse(deep, strlen(deep), t, 16));
+}
+
+// Random mutations of valid messages plus random bytes: must never crash,
+// read outside the input or overrun the slot (run under ASan on the host)
+TEST_CASE("fuzz tokenizer and extractor", "[ble_json][fuzz]") {
+  enum { ROUNDS = 20000, MAXLEN = 300 };
+  char* buf = malloc(MAXLEN);
+  TEST_ASSERT_NOT_NULL(buf);
+  unsigned seed = 12345;
+  size_t base_len = strlen(k_notif);
+  int accepted = 0;
+
+  for (int r = 0; r < ROUNDS; ++r) {
+    size_t len;
+    seed = seed * 1103515245u + 12345u;
+    if (r & 1) {
+      len = (seed >> 8) % MAXLEN;
+      for (size_t i = 0; i < len; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (char)(seed >> 16);
+      }
+    } else {
+      len = base_len;
+      memcpy(buf, k_notif, len);
+      int flips = 1 + (int)((seed >> 8) % 4);
+      for (int k = 0; k < flips; ++k) {
+        seed = seed * 1103515245u + 12345u;
+        buf[(seed >> 8) % len] = "{}[]\":,\\ u0a\x80"[(seed >> 20) % 14];
+      }
+      seed = seed * 1103515245u + 12345u;
+      if (seed & 0x100) len = (seed >> 9) % len;  // truncated delivery
+    }
+    ble_json_msg_t m;
+    static ble_notif_slot_t s;
+    if (ble_json_extract(buf, len, &m, &s) && m.has_notification) {
+      accepted++;
+      TEST_ASSERT_LESS_THAN(sizeof(s.message), strlen(s.message) + 1);
+      TEST_ASSERT_LESS_THAN(sizeof(s.app), strlen(s.app) + 1);
+    }
+  }
+  free(buf);
+  printf("ble_json fuzz: %d/%d inputs gave a notification\n", accepted, ROUNDS);
+}
+
+TEST_CASE("benchmark extract notification", "[ble_json][bench]") {
+  enum { N = 20000 };
+  size_t len = strlen(k_notif);
+  ble_json_msg_t m;
+  static ble_notif_slot_t s;
+  int ok = 0;
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < N; ++i) {
+    ok += ble_json_extract(k_notif, len, &m, &s);
+  }
+  int64_t dt = esp_timer_get_time() - t0;
+  TEST_ASSERT_EQUAL(N, ok);
+  printf("ble_json: %u B message, %u msg/s, 0 heap allocations, %u B of tokens on the stack\n",
+         (unsigned)len, dt > 0 ? (unsigned)((int64_t)N * 1000000 / dt) : 0,
+         (unsigned)(sizeof(ble_json_tok_t) * BLE_JSON_MAX_TOKENS));
+}
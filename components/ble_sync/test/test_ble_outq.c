@@ -0,0 +1,104 @@
+#include "unity.h"
+
+#include "ble_outq.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+  uint8_t battery;
+  uint8_t charging;
+} status_t;
+
+static void put_status(ble_outq_t* q, uint8_t battery, uint8_t charging, bool urgent) {
+  status_t s = {battery, charging};
+  TEST_ASSERT_TRUE(ble_outq_put(q, BLE_OUT_STATUS, &s, sizeof(s), urgent));
+}
+
+TEST_CASE("first message goes out at once, repeats are coalesced", "[ble_outq]") {
+  ble_outq_t q;
+  ble_outq_item_t out[BLE_OUT_KIND_COUNT];
+  ble_outq_init(&q);
+  ble_outq_set_interval(&q, BLE_OUT_STATUS, 5000);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, ble_outq_next_due(&q, 0));
+
+  put_status(&q, 80, 0, false);
+  TEST_ASSERT_EQUAL_UINT32(0, ble_outq_next_due(&q, 0));
+  TEST_ASSERT_EQUAL(1, ble_outq_take(&q, 0, out, BLE_OUT_KIND_COUNT));
+
+  // Within the interval: held back, each put replaces the previous one
+  put_status(&q, 80, 1, false);
+  put_status(&q, 81, 0, false);
+  put_status(&q, 81, 1, false);
+  TEST_ASSERT_EQUAL_UINT32(4000, ble_outq_next_due(&q, 1000));
+  TEST_ASSERT_EQUAL(0, ble_outq_take(&q, 1000, out, BLE_OUT_KIND_COUNT));
+  TEST_ASSERT_EQUAL(1, ble_outq_take(&q, 5000, out, BLE_OUT_KIND_COUNT));
+  status_t s;
+  memcpy(&s, out[0].data, sizeof(s));
+  TEST_ASSERT_EQUAL(81, s.battery);
+  TEST_ASSERT_EQUAL(1, s.charging);
+  TEST_ASSERT_EQUAL_UINT32(2, q.stats.coalesced);
+  TEST_ASSERT_EQUAL_UINT32(2, q.stats.sent);
+  TEST_ASSERT_EQUAL(0, ble_outq_take(&q, 20000, out, BLE_OUT_KIND_COUNT));
+}
+
+TEST_CASE("urgent skips the rate limit", "[ble_outq]") {
+  ble_outq_t q;
+  ble_outq_item_t out[BLE_OUT_KIND_COUNT];
+  ble_outq_init(&q);
+  ble_outq_set_interval(&q, BLE_OUT_STATUS, 5000);
+  put_status(&q, 50, 0, false);
+  TEST_ASSERT_EQUAL(1, ble_outq_take(&q, 100, out, BLE_OUT_KIND_COUNT));
+  put_status(&q, 50, 0, true);
+  TEST_ASSERT_EQUAL_UINT32(0, ble_outq_next_due(&q, 200));
+  TEST_ASSERT_EQUAL(1, ble_outq_take(&q, 200, out, BLE_OUT_KIND_COUNT));
+  // Urgency doesn't stick to later puts
+  put_status(&q, 49, 0, false);
+  TEST_ASSERT_EQUAL(0, ble_outq_take(&q, 300, out, BLE_OUT_KIND_COUNT));
+}
+
+TEST_CASE("kinds due close together leave in one flush", "[ble_outq]") {
+  ble_outq_t q;
+  ble_outq_item_t out[BLE_OUT_KIND_COUNT];
+  ble_outq_init(&q);
+  ble_outq_set_interval(&q, BLE_OUT_STATUS, 1000);
+  ble_outq_set_interval(&q, BLE_OUT_TIME_REQ, 1000);
+  put_status(&q, 10, 0, false);
+  TEST_ASSERT_TRUE(ble_outq_put(&q, BLE_OUT_TIME_REQ, NULL, 0, false));
+  TEST_ASSERT_EQUAL(2, ble_outq_take(&q, 0, out, BLE_OUT_KIND_COUNT));
+
+  // Status due at 1000, time request at 1050: both go at 1000
+  put_status(&q, 11, 0, false);
+  TEST_ASSERT_TRUE(ble_outq_put(&q, BLE_OUT_TIME_REQ, NULL, 0, false));
+  q.slot[BLE_OUT_TIME_REQ].last_sent_ms = 50;
+  TEST_ASSERT_EQUAL(2, ble_outq_take(&q, 1000, out, BLE_OUT_KIND_COUNT));
+  TEST_ASSERT_EQUAL(BLE_OUT_STATUS, out[0].kind);
+  TEST_ASSERT_EQUAL(BLE_OUT_TIME_REQ, out[1].kind);
+  TEST_ASSERT_EQUAL_UINT32(2, q.stats.flushes);
+
+  TEST_ASSERT_FALSE(ble_outq_put(&q, BLE_OUT_KIND_COUNT, NULL, 0, false));
+  uint8_t big[BLE_OUTQ_PAYLOAD_MAX + 1] = {0};
+  TEST_ASSERT_FALSE(ble_outq_put(&q, BLE_OUT_STATUS, big, sizeof(big), false));
+}
+
+// Charger contact bouncing: a power event every 200 ms for 10 s, each of
+// which used to send a status on its own
+TEST_CASE("charge-state flapping", "[ble_outq][bench]") {
+  ble_outq_t q;
+  ble_outq_item_t out[BLE_OUT_KIND_COUNT];
+  ble_outq_init(&q);
+  ble_outq_set_interval(&q, BLE_OUT_STATUS, 5000);
+  unsigned events = 0, sends = 0;
+  for (uint32_t t = 0; t <= 10000; t += 200) {
+    put_status(&q, 90, (uint8_t)((t / 200) & 1), false);
+    events++;
+    sends += ble_outq_take(&q, t, out, BLE_OUT_KIND_COUNT);
+  }
+  // Drain the last value
+  uint32_t wait = ble_outq_next_due(&q, 10000);
+  if (wait != UINT32_MAX) sends += ble_outq_take(&q, 10000 + wait, out, BLE_OUT_KIND_COUNT);
+  TEST_ASSERT_LESS_OR_EQUAL(4, sends);
+  TEST_ASSERT_EQUAL_UINT32(events, q.stats.enqueued);
+  printf("ble_outq: %u status events -> %u sends (%u coalesced)\n", events, sends,
+         (unsigned)q.stats.coalesced);
+}
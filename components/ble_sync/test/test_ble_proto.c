@@ -0,0 +1,184 @@
+#include "unity.h"
+
+#include "ble_proto.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+static ble_proto_frame_t parse_ok(const uint8_t* buf, size_t len) {
+  ble_proto_frame_t f;
+  size_t used = 0;
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, len, &f, &used));
+  TEST_ASSERT_EQUAL(len, used);
+  return f;
+}
+
+TEST_CASE("crc16 ccitt-false check value", "[ble_proto]") {
+  const char* s = "123456789";
+  TEST_ASSERT_EQUAL_HEX16(0x29B1, ble_proto_crc16((const uint8_t*)s, 9, 0xFFFF));
+}
+
+TEST_CASE("notification round trip", "[ble_proto]") {
+  uint8_t buf[BLE_PROTO_MAX_FRAME];
+  ble_msg_notification_t in = {
+      .id = 70000,
+      .app = {"WhatsApp", 0},
+      .title = {"Ana", 0},
+      .body = {"Llego en 5 min", 0},
+      .ts = {"2025-03-01T10:20:30", 0},
+  };
+  size_t n = ble_proto_encode_notification(buf, sizeof(buf), &in);
+  TEST_ASSERT_GREATER_THAN(0, n);
+  TEST_ASSERT_EQUAL_HEX8(BLE_PROTO_MAGIC, buf[0]);
+
+  ble_proto_frame_t f = parse_ok(buf, n);
+  ble_msg_notification_t out;
+  TEST_ASSERT_TRUE(ble_proto_decode_notification(&f, &out));
+  TEST_ASSERT_EQUAL_UINT32(70000, out.id);
+  TEST_ASSERT_EQUAL(8, out.app.len);
+  TEST_ASSERT_EQUAL_MEMORY("WhatsApp", out.app.p, 8);
+  TEST_ASSERT_EQUAL_MEMORY("Llego en 5 min", out.body.p, 14);
+
+  char title[8];
+  ble_proto_str_copy(title, sizeof(title), out.title);
+  TEST_ASSERT_EQUAL_STRING("Ana", title);
+  char app[5];
+  ble_proto_str_copy(app, sizeof(app), out.app);
+  TEST_ASSERT_EQUAL_STRING("What", app);
+
+  // Views point into the frame: decoding allocated nothing
+  TEST_ASSERT_TRUE((const uint8_t*)out.body.p > buf && (const uint8_t*)out.body.p < buf + n);
+
+  // Wrong decoder for the type
+  ble_msg_status_t st;
+  TEST_ASSERT_FALSE(ble_proto_decode_status(&f, &st));
+}
+
+TEST_CASE("status, time, hello and history round trip", "[ble_proto]") {
+  uint8_t buf[64];
+  ble_proto_frame_t f;
+
+  ble_msg_status_t st = {.battery = 87, .charging = true, .steps = 12345};
+  f = parse_ok(buf, ble_proto_encode_status(buf, sizeof(buf), &st));
+  ble_msg_status_t st2;
+  TEST_ASSERT_TRUE(ble_proto_decode_status(&f, &st2));
+  TEST_ASSERT_EQUAL(87, st2.battery);
+  TEST_ASSERT_TRUE(st2.charging);
+  TEST_ASSERT_EQUAL_UINT32(12345, st2.steps);
+
+  ble_msg_time_t tm = {2025, 12, 31, 23, 59, 58};
+  f = parse_ok(buf, ble_proto_encode_time(buf, sizeof(buf), &tm));
+  ble_msg_time_t tm2;
+  TEST_ASSERT_TRUE(ble_proto_decode_time(&f, &tm2));
+  TEST_ASSERT_EQUAL(2025, tm2.year);
+  TEST_ASSERT_EQUAL(58, tm2.sec);
+
+  // Empty time frame = request from the watch
+  f = parse_ok(buf, ble_proto_encode_time(buf, sizeof(buf), NULL));
+  TEST_ASSERT_EQUAL(BLE_MSG_TIME_SYNC, f.type);
+  TEST_ASSERT_EQUAL(0, f.len);
+  TEST_ASSERT_FALSE(ble_proto_decode_time(&f, &tm2));
+
+  ble_msg_hello_t h = {BLE_PROTO_VERSION, BLE_PROTO_CAP_TLV, 247};
+  f = parse_ok(buf, ble_proto_encode_hello(buf, sizeof(buf), &h));
+  ble_msg_hello_t h2;
+  TEST_ASSERT_TRUE(ble_proto_decode_hello(&f, &h2));
+  TEST_ASSERT_EQUAL(247, h2.mtu);
+  TEST_ASSERT_EQUAL_UINT32(BLE_PROTO_CAP_TLV, h2.caps);
+
+  ble_msg_history_t hi = {.cursor = 0xDEADBEEF, .count = 20};
+  f = parse_ok(buf, ble_proto_encode_history(buf, sizeof(buf), &hi));
+  ble_msg_history_t hi2;
+  TEST_ASSERT_TRUE(ble_proto_decode_history(&f, &hi2));
+  TEST_ASSERT_EQUAL_UINT32(0xDEADBEEF, hi2.cursor);
+  TEST_ASSERT_EQUAL(20, hi2.count);
+}
+
+TEST_CASE("corrupt and short frames are rejected", "[ble_proto]") {
+  uint8_t buf[64];
+  ble_msg_status_t st = {50, false, 10};
+  size_t n = ble_proto_encode_status(buf, sizeof(buf), &st);
+  ble_proto_frame_t f;
+
+  for (size_t i = 0; i < n; ++i) {
+    TEST_ASSERT_NOT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, i, &f, NULL));
+  }
+  for (size_t i = 0; i < n; ++i) {
+    buf[i] ^= 0x40;
+    TEST_ASSERT_NOT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+    buf[i] ^= 0x40;
+  }
+  TEST_ASSERT_EQUAL(BLE_PROTO_OK, ble_proto_parse(buf, n, &f, NULL));
+
+  // JSON line never parses as a frame
+  const char* json = "{\"status\":1}";
+  TEST_ASSERT_EQUAL(BLE_PROTO_ERR_MAGIC,
+                    ble_proto_parse((const uint8_t*)json, strlen(json), &f, NULL));
+}
+
+TEST_CASE("encoder reports overflow", "[ble_proto]") {
+  uint8_t buf[24];
+  ble_msg_notification_t m = {.app = {"app", 0}, .body = {"a body that does not fit", 0}};
+  TEST_ASSERT_EQUAL(0, ble_proto_encode_notification(buf, sizeof(buf), &m));
+  TEST_ASSERT_EQUAL(0, ble_proto_encode_notification(buf, 3, &m));
+}
+
+TEST_CASE("long binary fields split and concatenate", "[ble_proto]") {
+  static uint8_t buf[1024];
+  uint8_t blob[600], out[600];
+  for (size_t i = 0; i < sizeof(blob); ++i) blob[i] = (uint8_t)(i * 7);
+
+  ble_proto_writer_t w;
+  ble_proto_begin(&w, buf, sizeof(buf), BLE_MSG_APP_ICON);
+  ble_proto_put_str(&w, BLE_TAG_APP, "org.signal");
+  ble_proto_put_long_bytes(&w, BLE_TAG_DATA, blob, sizeof(blob));
+  ble_proto_put_uint(&w, BLE_TAG_WIDTH, 48);
+  size_t n = ble_proto_finish(&w);
+  TEST_ASSERT_NOT_EQUAL(0, n);
+
+  ble_proto_frame_t f = parse_ok(buf, n);
+  TEST_ASSERT_EQUAL(sizeof(blob), ble_proto_bytes_concat(&f, BLE_TAG_DATA, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY(blob, out, sizeof(blob));
+  memset(out, 0, sizeof(out));
+  TEST_ASSERT_EQUAL(sizeof(blob), ble_proto_bytes_concat(&f, BLE_TAG_DATA, out, 100));  // too small
+  TEST_ASSERT_EQUAL_MEMORY(blob, out, 100);
+  TEST_ASSERT_EQUAL(0, out[100]);
+  TEST_ASSERT_EQUAL(0, ble_proto_bytes_concat(&f, BLE_TAG_NAME, out, sizeof(out)));
+}
+
+// Throughput and size against the JSON line the phone sends today
+TEST_CASE("benchmark notification codec", "[ble_proto][bench]") {
+  enum { N = 2000 };
+  uint8_t buf[BLE_PROTO_MAX_FRAME];
+  ble_msg_notification_t in = {
+      .app = {"Telegram", 0},
+      .title = {"Grupo familia", 0},
+      .body = {"Mañana comemos en casa de la abuela a las dos", 0},
+      .ts = {"2025-03-01T10:20:30", 0},
+  };
+  char json[BLE_PROTO_MAX_FRAME];
+  int json_len = snprintf(json, sizeof(json),
+                          "{\"notification\":\"%s\",\"app\":\"%s\",\"title\":\"%s\",\"message\":\"%s\"}\n",
+                          in.ts.p, in.app.p, in.title.p, in.body.p);
+
+  size_t n = 0;
+  uint32_t chk = 0;
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < N; ++i) {
+    in.id = (uint32_t)i;
+    n = ble_proto_encode_notification(buf, sizeof(buf), &in);
+    ble_proto_frame_t f;
+    ble_msg_notification_t out;
+    if (ble_proto_parse(buf, n, &f, NULL) == BLE_PROTO_OK &&
+        ble_proto_decode_notification(&f, &out)) {
+      chk += out.id;
+    }
+  }
+  int64_t dt = esp_timer_get_time() - t0;
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)N * (N - 1) / 2, chk);
+  TEST_ASSERT_LESS_THAN(json_len, (int)n);
+
+  printf("ble_proto: %u B/notification (JSON %d B), %u msg/s encode+decode\n",
+         (unsigned)n, json_len, dt > 0 ? (unsigned)((int64_t)N * 1000000 / dt) : 0);
+}
@@ -0,0 +1,94 @@
+#include "unity.h"
+
+#include "notif_pipe.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+static int s_items[64];
+
+TEST_CASE("fifo per lane, high lane first", "[notif_pipe]") {
+  notif_pipe_t p;
+  notif_pipe_init(&p);
+  TEST_ASSERT_NULL(notif_pipe_pop(&p, 0, NULL));
+
+  TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[0], NOTIF_PRIO_NORMAL, 100));
+  TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[1], NOTIF_PRIO_NORMAL, 200));
+  TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[2], NOTIF_PRIO_HIGH, 300));
+  TEST_ASSERT_EQUAL(3, notif_pipe_depth(&p));
+
+  notif_prio_t prio;
+  TEST_ASSERT_EQUAL_PTR(&s_items[2], notif_pipe_pop(&p, 1000, &prio));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_HIGH, prio);
+  TEST_ASSERT_EQUAL_PTR(&s_items[0], notif_pipe_pop(&p, 1000, &prio));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_NORMAL, prio);
+  TEST_ASSERT_EQUAL_PTR(&s_items[1], notif_pipe_pop(&p, 1000, NULL));
+  TEST_ASSERT_NULL(notif_pipe_pop(&p, 1000, NULL));
+
+  TEST_ASSERT_EQUAL_UINT32(3, p.wait.count);
+  TEST_ASSERT_EQUAL_UINT32(900, p.wait.max_us);
+  TEST_ASSERT_EQUAL_UINT32(800, notif_stage_avg_us(&p.wait));
+  TEST_ASSERT_EQUAL_UINT32(3, p.max_depth);
+}
+
+TEST_CASE("full lane refuses without touching the other", "[notif_pipe]") {
+  notif_pipe_t p;
+  notif_pipe_init(&p);
+  for (int i = 0; i < NOTIF_PIPE_DEPTH; ++i) {
+    TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[i], NOTIF_PRIO_NORMAL, 0));
+  }
+  TEST_ASSERT_FALSE(notif_pipe_push(&p, &s_items[40], NOTIF_PRIO_NORMAL, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, p.lane[NOTIF_PRIO_NORMAL].dropped);
+  TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[41], NOTIF_PRIO_HIGH, 0));
+
+  // Wrap around many times: order must hold
+  int next_in = NOTIF_PIPE_DEPTH, next_out = 0;
+  TEST_ASSERT_EQUAL_PTR(&s_items[41], notif_pipe_pop(&p, 0, NULL));
+  for (int round = 0; round < 100; ++round) {
+    TEST_ASSERT_EQUAL_PTR(&s_items[next_out % 32], notif_pipe_pop(&p, 0, NULL));
+    next_out++;
+    TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[next_in % 32], NOTIF_PRIO_NORMAL, 0));
+    next_in++;
+  }
+  TEST_ASSERT_EQUAL(NOTIF_PIPE_DEPTH, notif_pipe_depth(&p));
+}
+
+TEST_CASE("priority classification", "[notif_pipe]") {
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_HIGH, notif_pipe_classify("call"));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_HIGH, notif_pipe_classify("com.google.android.dialer"));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_HIGH, notif_pipe_classify("COM.ANDROID.DESKCLOCK"));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_NORMAL, notif_pipe_classify("com.whatsapp"));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_NORMAL, notif_pipe_classify(""));
+  TEST_ASSERT_EQUAL(NOTIF_PRIO_NORMAL, notif_pipe_classify(NULL));
+}
+
+// 24 chat notifications 1 ms apart with a call in the middle. The UI side
+// runs every 5 ms and renders at most 4 cards per pass. The producer must
+// never be refused and the call must not wait behind the chat backlog.
+TEST_CASE("burst of 24 with a call in the middle", "[notif_pipe][bench]") {
+  notif_pipe_t p;
+  notif_pipe_init(&p);
+  uint32_t call_wait = 0;
+  int sent = 0, shown = 0;
+  for (uint32_t t_ms = 0; t_ms < 200; ++t_ms) {
+    if (sent < 24) {
+      notif_prio_t prio = sent == 12 ? NOTIF_PRIO_HIGH : NOTIF_PRIO_NORMAL;
+      TEST_ASSERT_TRUE(notif_pipe_push(&p, &s_items[sent], prio, t_ms * 1000));
+      sent++;
+    }
+    if (t_ms % 5 == 4) {
+      notif_prio_t prio;
+      void* it;
+      for (int n = 0; n < 4 && (it = notif_pipe_pop(&p, t_ms * 1000, &prio)) != NULL; ++n) {
+        if (prio == NOTIF_PRIO_HIGH) call_wait = p.wait.last_us;
+        shown++;
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL(24, shown);
+  TEST_ASSERT_EQUAL_UINT32(0, p.lane[NOTIF_PRIO_NORMAL].dropped);
+  TEST_ASSERT_LESS_OR_EQUAL(5000, call_wait);
+  printf("notif_pipe: 24 queued, max depth %u, wait avg %u us max %u us, call waited %u us\n",
+         (unsigned)p.max_depth, (unsigned)notif_stage_avg_us(&p.wait),
+         (unsigned)p.wait.max_us, (unsigned)call_wait);
+}
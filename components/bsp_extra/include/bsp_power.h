@@ -13,6 +13,10 @@
 // así que usamos una cadena literal como base de eventos.
 #define BSP_POWER_EVENT_BASE "BSP_POWER"
 
+// 1 cuando bsp_power_poll_pwr_button_short() lee de verdad el PMIC. Con el
+// stub vale 0 y nadie debe sondear la tecla de power.
+#define BSP_POWER_HAS_PWR_BUTTON 0
+
 typedef struct {
     bool  vbus_in;
     bool  charging;
@@ -6,8 +6,12 @@
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 
 #include "driver/gpio.h"
+#include "esp_event.h"
+#include "esp_timer.h"
+#include "input_service.h"
 #include "esp_log.h"
 #include "esp_lvgl_port.h"
+#include "power_manager.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -31,18 +35,69 @@ esp_err_t bsp_display_wake(void);
 esp_err_t bsp_display_clear_black(void);
 #endif
 
-// If the board provides simple GPIO buttons, use one as wake key.
-// On this hardware BSP_CAPS_BUTTONS is 0, so we will use the PMU PWR key
-// instead.
-#define DISPLAY_BUTTON GPIO_NUM_0
-
 static const char *TAG = "DISPLAY_MGR";
 
+// Estados de energía: ACTIVE -> DIMMED (DM_DIM_LEAD_MS antes del timeout)
+// -> SCREEN_OFF (timeout del usuario) -> DEEP_IDLE (DM_DEEP_IDLE_MS con la
+// pantalla apagada). Solo ACTIVE y DIMMED bloquean el light sleep.
+#define DM_DIM_LEAD_MS   5000
+#define DM_DEEP_IDLE_MS  (5 * 60 * 1000)
+#define DM_DIM_DIVISOR   4
+#define DM_DIM_MIN       5
+
 static bool display_on = true;
 static uint32_t timeout_ms;
+static display_manager_state_cb_t s_state_cb = NULL;
+static power_state_t s_pstate = PM_STATE_ACTIVE;
+static esp_timer_handle_t s_idle_timer = NULL;
+static int64_t s_off_since_us = 0;
+#if defined(BSP_LCD_TOUCH_INT)
+static esp_timer_handle_t s_touch_wake_timer = NULL;
+#endif
 #if CONFIG_PM_ENABLE
 static esp_pm_lock_handle_t s_no_ls_lock = NULL;
+static bool s_no_ls_held = false;
+#endif
+
+// Bloquear / permitir light sleep según el estado (idempotente: el lock de
+// ESP-PM cuenta referencias, así que nunca se adquiere dos veces)
+static void display_hold_awake(bool hold) {
+#if CONFIG_PM_ENABLE
+  if (!s_no_ls_lock || s_no_ls_held == hold) {
+    return;
+  }
+  if (hold) {
+    (void)esp_pm_lock_acquire(s_no_ls_lock);
+  } else {
+    (void)esp_pm_lock_release(s_no_ls_lock);
+  }
+  s_no_ls_held = hold;
+#else
+  (void)hold;
 #endif
+}
+
+static void display_set_pstate(power_state_t st) {
+  if (s_pstate == st) {
+    return;
+  }
+  s_pstate = st;
+  display_hold_awake(st == PM_STATE_ACTIVE || st == PM_STATE_DIMMED);
+  power_manager_set_state(st);
+}
+
+static uint8_t dimmed_brightness(void) {
+  uint8_t b = settings_get_brightness() / DM_DIM_DIVISOR;
+  return b < DM_DIM_MIN ? DM_DIM_MIN : b;
+}
+
+static void idle_timer_arm(uint32_t ms) {
+  if (!s_idle_timer) {
+    return;
+  }
+  (void)esp_timer_stop(s_idle_timer);
+  (void)esp_timer_start_once(s_idle_timer, (uint64_t)ms * 1000);
+}
 
 // -----------------------------------------------------------------------------
 // Apagar pantalla internamente (solo panel + brillo, NO LVGL, NO touch)
@@ -53,9 +108,9 @@ static void display_turn_off_internal(void) {
   }
   ESP_LOGI(TAG, "Turning display off");
 
-  // Dejamos LVGL y el touch funcionando.
-  // Sólo apagamos el panel y la retroiluminación para que parezca apagado,
-  // pero el sistema sigue procesando eventos táctiles y BLE sigue vivo.
+  // Sin línea INT del táctil, LVGL sigue funcionando para que un toque
+  // despierte la pantalla. Con INT, paramos LVGL y la interrupción (también
+  // fuente de wake del light sleep) la enciende de nuevo.
 
   // Poner panel en "sleep" (stub o real, según BSP)
   bsp_display_sleep();
@@ -64,6 +119,17 @@ static void display_turn_off_internal(void) {
   bsp_display_brightness_set(0);
 
   display_on = false;
+  if (s_state_cb) {
+    s_state_cb(false);
+  }
+  input_service_set_awake(false);
+#if defined(BSP_LCD_TOUCH_INT)
+  lvgl_port_stop();
+  gpio_intr_enable(BSP_LCD_TOUCH_INT);
+#endif
+  s_off_since_us = esp_timer_get_time();
+  display_set_pstate(PM_STATE_SCREEN_OFF);
+  idle_timer_arm(DM_DEEP_IDLE_MS);
 }
 
 void display_manager_turn_off(void) {
@@ -111,26 +177,127 @@ void display_manager_turn_on(void) {
     vTaskDelay(pdMS_TO_TICKS(5));
 #endif
     display_on = true;
+    if (s_state_cb) {
+      s_state_cb(true);
+    }
+    input_service_set_awake(true);
   }
-  // Prevent light sleep while actively displaying UI for responsiveness
-#if CONFIG_PM_ENABLE
-  if (s_no_ls_lock) {
-    (void)esp_pm_lock_acquire(s_no_ls_lock);
+  if (s_pstate == PM_STATE_DIMMED) {
+    bsp_display_brightness_set(settings_get_brightness());
   }
-#endif
+  // Prevent light sleep while actively displaying UI for responsiveness
+  display_set_pstate(PM_STATE_ACTIVE);
+  idle_timer_arm(0);
   // Restore more responsive BLE params when screen is on
   // nordic_uart_set_low_power_mode(false);
   display_manager_reset_timer();
 }
 
+void display_manager_set_state_cb(display_manager_state_cb_t cb) {
+  s_state_cb = cb;
+}
+
 bool display_manager_is_on(void) {
   return display_on;
 }
 
 void display_manager_reset_timer(void) {
   lv_disp_trig_activity(NULL);
+  // Atenuada: la comprobación de inactividad devuelve el brillo ya
+  if (s_pstate == PM_STATE_DIMMED) {
+    idle_timer_arm(0);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Comprobación de inactividad (esp_timer one-shot, se reprograma para el
+// siguiente umbral; no hay sondeo periódico)
+// -----------------------------------------------------------------------------
+static void idle_check_cb(void *arg) {
+  (void)arg;
+  if (!display_on) {
+    // SCREEN_OFF -> DEEP_IDLE tras DM_DEEP_IDLE_MS sin encender la pantalla
+    int64_t off_ms = (esp_timer_get_time() - s_off_since_us) / 1000;
+    if (s_pstate == PM_STATE_SCREEN_OFF) {
+      if (off_ms >= DM_DEEP_IDLE_MS) {
+        display_set_pstate(PM_STATE_DEEP_IDLE);
+      } else {
+        idle_timer_arm((uint32_t)(DM_DEEP_IDLE_MS - off_ms));
+      }
+    }
+    return;
+  }
+
+  // Tarea de esp_timer: nunca esperar a LVGL sin límite (detrás van los
+  // timers de NimBLE, el antirrebote de input_service...). Si LVGL está
+  // ocupado, se reintenta en 100 ms.
+  if (!lvgl_port_lock(10)) {
+    idle_timer_arm(100);
+    return;
+  }
+  uint32_t idle_ms = lv_disp_get_inactive_time(NULL);
+
+  timeout_ms = settings_get_display_timeout();
+  uint32_t dim_at = timeout_ms > 2 * DM_DIM_LEAD_MS ? timeout_ms - DM_DIM_LEAD_MS
+                                                    : timeout_ms / 2;
+
+  if (idle_ms >= timeout_ms) {
+    // Con el lock (recursivo) aún tomado: s_state_cb vuelve a tomarlo sin
+    // esperar
+    display_turn_off_internal();
+    lvgl_port_unlock();
+    return;
+  }
+  lvgl_port_unlock();
+
+  if (idle_ms >= dim_at) {
+    if (s_pstate != PM_STATE_DIMMED) {
+      bsp_display_brightness_set(dimmed_brightness());
+      display_set_pstate(PM_STATE_DIMMED);
+    }
+    idle_timer_arm(timeout_ms - idle_ms);
+  } else {
+    if (s_pstate == PM_STATE_DIMMED) {
+      bsp_display_brightness_set(settings_get_brightness());
+    }
+    display_set_pstate(PM_STATE_ACTIVE);
+    idle_timer_arm(dim_at - idle_ms);
+  }
 }
 
+#if defined(BSP_LCD_TOUCH_INT)
+// Toque con LVGL parado: la ISR solo desarma la línea y difiere el encendido
+static void touch_wake_cb(void *arg) {
+  (void)arg;
+  display_manager_turn_on();
+}
+
+static void touch_int_isr(void *arg) {
+  (void)arg;
+  gpio_intr_disable(BSP_LCD_TOUCH_INT);
+  (void)esp_timer_start_once(s_touch_wake_timer, 0);
+}
+
+static void touch_wake_setup(void) {
+  const esp_timer_create_args_t args = {
+      .callback = touch_wake_cb,
+      .name = "touch_wake",
+  };
+  if (esp_timer_create(&args, &s_touch_wake_timer) != ESP_OK) {
+    return;
+  }
+  esp_err_t r = gpio_install_isr_service(0);
+  if (r != ESP_OK && r != ESP_ERR_INVALID_STATE) {
+    ESP_LOGW(TAG, "gpio isr service: %s", esp_err_to_name(r));
+    return;
+  }
+  // Nivel bajo: el único tipo que despierta del light sleep
+  gpio_intr_disable(BSP_LCD_TOUCH_INT);
+  (void)gpio_wakeup_enable(BSP_LCD_TOUCH_INT, GPIO_INTR_LOW_LEVEL);
+  (void)gpio_isr_handler_add(BSP_LCD_TOUCH_INT, touch_int_isr, NULL);
+}
+#endif
+
 // -----------------------------------------------------------------------------
 // Callback de eventos táctiles de LVGL
 // -----------------------------------------------------------------------------
@@ -157,65 +324,31 @@ static void touch_event_cb(lv_event_t *e) {
   }
 }
 
-static bool wake_button_pressed(void) {
-#if BSP_CAPS_BUTTONS
-  return gpio_get_level(DISPLAY_BUTTON) == 0;
-#else
-  // Poll AXP2101 power key short-press event
-  return bsp_power_poll_pwr_button_short();
-#endif
-}
-
 // -----------------------------------------------------------------------------
-// Tarea del display manager — AUTO-OFF DESACTIVADO
+// Botones (input_service, por interrupción): una pulsación con la pantalla
+// apagada llega como INPUT_EVT_WAKE y la enciende; con la pantalla encendida
+// cualquier pulsación cuenta como actividad.
 // -----------------------------------------------------------------------------
-static void display_manager_task(void *arg) {
-  ESP_LOGI(TAG, "Display manager task started (auto-off disabled)");
-  TickType_t last = xTaskGetTickCount();
-  while (1) {
-    // Seguimos leyendo el timeout por si hace falta en el futuro,
-    // pero NO lo usamos para apagar automáticamente.
-    timeout_ms = settings_get_display_timeout();
-
-    if (display_on) {
-      // ❌ DESACTIVADO: no apagamos por inactividad
-      // uint32_t inactive = lv_disp_get_inactive_time(NULL);
-      // if (inactive >= timeout_ms) {
-      //   display_turn_off_internal();
-      // }
-
-      // El botón PWR puede seguir usándose para "resetear" actividad si quieres
-      if (wake_button_pressed()) {
-        display_manager_reset_timer();
-        vTaskDelay(pdMS_TO_TICKS(100));
-        last = xTaskGetTickCount();
-      }
-    } else {
-      // Si por cualquier motivo la pantalla está off, el botón PWR la enciende
-      if (wake_button_pressed()) {
-        display_manager_turn_on();
-        vTaskDelay(pdMS_TO_TICKS(100));
-        last = xTaskGetTickCount();
-      }
-    }
-    vTaskDelayUntil(&last, pdMS_TO_TICKS(50));
+static void input_evt(void *arg, esp_event_base_t base, int32_t id, void *data) {
+  (void)arg;
+  (void)base;
+  (void)data;
+  if (id == INPUT_EVT_WAKE) {
+    display_manager_turn_on();
+  } else if (display_on) {
+    display_manager_reset_timer();
   }
 }
 
 void display_manager_init(void) {
+  // Auto-dim / auto-off with the user's timeout, re-read on every check
   timeout_ms = settings_get_display_timeout();
-#if BSP_CAPS_BUTTONS
-  gpio_config_t io_conf = {
-      .pin_bit_mask = 1ULL << DISPLAY_BUTTON,
-      .mode = GPIO_MODE_INPUT,
-      .pull_up_en = GPIO_PULLUP_ENABLE,
-      .pull_down_en = GPIO_PULLDOWN_DISABLE,
-      .intr_type = GPIO_INTR_DISABLE,
-  };
-  gpio_config(&io_conf);
-#else
-  ESP_LOGI(TAG, "Using PMU PWR key to wake display");
-#endif
+
+  // Wake keys: BOOT (GPIO0) and PMU PWR, both interrupt driven
+  ESP_ERROR_CHECK(input_service_init());
+  input_service_set_wake_filter(display_manager_is_on);
+  ESP_ERROR_CHECK(esp_event_handler_register(INPUT_EVENT_BASE, ESP_EVENT_ANY_ID,
+                                             input_evt, NULL));
 
   lv_obj_add_event_cb(
       lv_scr_act(), touch_event_cb,
@@ -225,18 +358,18 @@ void display_manager_init(void) {
       NULL);
 
   // PM lock may be created in early init; if not, create and acquire now
-#if CONFIG_PM_ENABLE
-  if (!s_no_ls_lock) {
-    (void)esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "display",
-                             &s_no_ls_lock);
-  }
-  if (s_no_ls_lock) {
-    (void)esp_pm_lock_acquire(s_no_ls_lock);
-  }
+  display_manager_pm_early_init();
+
+#if defined(BSP_LCD_TOUCH_INT)
+  touch_wake_setup();
 #endif
 
-  // Higher priority so UI updates aren't delayed by other workloads
-  xTaskCreate(display_manager_task, "display_mgr", 4000, NULL, 3, NULL);
+  const esp_timer_create_args_t idle_args = {
+      .callback = idle_check_cb,
+      .name = "disp_idle",
+  };
+  ESP_ERROR_CHECK(esp_timer_create(&idle_args, &s_idle_timer));
+  idle_timer_arm(0);
 }
 
 void display_manager_pm_early_init(void) {
@@ -245,9 +378,7 @@ void display_manager_pm_early_init(void) {
     (void)esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "display",
                              &s_no_ls_lock);
   }
-  if (s_no_ls_lock) {
-    (void)esp_pm_lock_acquire(s_no_ls_lock);
-  }
+  display_hold_awake(display_on);
 #else
   // No power management; nothing to do
   (void)0;
@@ -10,6 +10,13 @@ void display_manager_turn_off(void);
 bool display_manager_is_on(void);
 void display_manager_reset_timer(void);
 
+// Notified after every on/off transition of the panel. Called from the task
+// that switched the display (LVGL task or display manager task). When the
+// idle timeout turns the panel off, the LVGL lock is already held, so the
+// callback's own bsp_display_lock() returns at once.
+typedef void (*display_manager_state_cb_t)(bool on);
+void display_manager_set_state_cb(display_manager_state_cb_t cb);
+
 // Early PM setup: create and acquire a NO_LIGHT_SLEEP lock so the
 // system won’t enter light-sleep during boot/UI init. Safe to call multiple times.
 void display_manager_pm_early_init(void);
@@ -1,5 +1,6 @@
 #pragma once
 #include "lvgl.h"
+#include "screen_manager.h"
 #ifdef __cplusplus
 extern "C" {
 #endif    
@@ -9,6 +10,9 @@ extern "C" {
     // Returns the battery screen object, creating it if necessary
     lv_obj_t* batt_screen_get(void);
 
+    // Descriptor for the screen manager (SCREEN_ID_BATTERY)
+    extern const screen_desc_t batt_screen_desc;
+
 #ifdef __cplusplus
 }
 #endif
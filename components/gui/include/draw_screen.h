@@ -2,6 +2,10 @@
 #define DRAW_SCREEN_H
 
 #include "lvgl.h"
+#include "screen_manager.h"
+
+/* Descriptor para screen_manager (SCREEN_ID_DRAW) */
+extern const screen_desc_t draw_screen_desc;
 
 /* Devuelve el objeto raíz de la pantalla de dibujo (se crea lazy) */
 lv_obj_t *draw_screen_get(void);
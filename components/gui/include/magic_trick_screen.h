@@ -1,6 +1,7 @@
 #pragma once
 
 #include "lvgl.h"
+#include "screen_manager.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,6 +13,9 @@ extern "C" {
  */
 lv_obj_t *magic_trick_screen_get(void);
 
+/* Descriptor para screen_manager (SCREEN_ID_MAGIC_TRICK) */
+extern const screen_desc_t magic_trick_screen_desc;
+
 #ifdef __cplusplus
 }
 #endif
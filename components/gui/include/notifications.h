@@ -4,6 +4,10 @@
 extern "C" {
 #endif
 
+// Longest message body kept per notification (bytes, incl. terminator).
+// Long bodies arrive as chunked BLE transfers; the buffers live in PSRAM.
+#define NOTIF_MESSAGE_MAX 4096
+
 void notifications_screen_create(lv_obj_t* parent);
 lv_obj_t* notifications_screen_get(void);
 
@@ -0,0 +1,58 @@
+#pragma once
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of secondary screens kept built ("warm") while hidden.
+#ifndef SCREEN_MANAGER_MAX_WARM
+#define SCREEN_MANAGER_MAX_WARM 2
+#endif
+
+// RAM ceiling (bytes) for all hidden warm screens together.
+#ifndef SCREEN_MANAGER_RAM_BUDGET
+#define SCREEN_MANAGER_RAM_BUDGET (96 * 1024)
+#endif
+
+// Secondary, full-screen views owned by the screen manager.
+typedef enum {
+    SCREEN_ID_DRAW = 0,
+    SCREEN_ID_MAGIC_TRICK,
+    SCREEN_ID_STEPS,
+    SCREEN_ID_BATTERY,
+    SCREEN_ID_COUNT
+} screen_id_t;
+
+// Hooks provided by each screen module.
+// - create: build the screen with lv_obj_create(NULL) and return its root.
+//   The module must clear its own static pointers in an LV_EVENT_DELETE
+//   handler, since the manager may delete the root at any time it is hidden.
+// - on_show / on_hide: resume / pause the screen's periodic work. Optional.
+typedef struct {
+    const char* name;
+    lv_obj_t* (*create)(void);
+    void (*on_show)(void);
+    void (*on_hide)(void);
+} screen_desc_t;
+
+// Returns the root of the screen, building it on first use or after eviction.
+// Must be called with the LVGL lock held (LVGL task / event callbacks).
+lv_obj_t* screen_manager_get(screen_id_t id);
+
+// Called by load_screen() whenever a new screen becomes active.
+void screen_manager_notify_active(lv_obj_t* screen);
+
+// Drop every hidden warm screen (e.g. on low memory or screen-off).
+void screen_manager_evict_hidden(void);
+
+// Build content into a settings tile and record its latency and heap cost.
+void screen_manager_tile_open(const char* name, void (*create)(lv_obj_t*), lv_obj_t* tile);
+
+// Log open latency, build count and memory per screen.
+void screen_manager_dump_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 #include "lvgl.h"
+#include "screen_manager.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -7,6 +8,9 @@ extern "C" {
 void steps_screen_create(lv_obj_t* parent);
 lv_obj_t* steps_screen_get(void);
 
+// Descriptor for the screen manager (SCREEN_ID_STEPS)
+extern const screen_desc_t steps_screen_desc;
+
 void steps_screen_set_goal(uint32_t goal_steps);
 
 #ifdef __cplusplus
@@ -0,0 +1,62 @@
+#pragma once
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Single coalescing scheduler for the periodic UI work (clock, battery,
+// steps, BLE status...). All jobs share one lv_timer; deadlines are aligned
+// to multiples of their period so jobs with compatible periods fire on the
+// same wakeup. A job bound to an owner object only runs while that object is
+// on screen (active screen and, inside a tileview, the active tile), and no
+// job runs while the display is off.
+//
+// All functions must be called from the LVGL task or with the display lock
+// held. Job callbacks run in the LVGL task with the lock already taken.
+
+// Jobs due within this window of the current wakeup run together.
+#ifndef UI_SCHED_SLACK_MS
+#define UI_SCHED_SLACK_MS 50
+#endif
+
+#ifndef UI_SCHED_MAX_JOBS
+#define UI_SCHED_MAX_JOBS 12
+#endif
+
+typedef struct ui_sched_job ui_sched_job_t;
+typedef void (*ui_sched_cb_t)(void* user);
+
+typedef struct {
+    uint32_t wakeups;       // scheduler timer fires
+    uint32_t runs;          // job callbacks executed
+    uint32_t skipped;       // periods skipped because the owner was hidden / display off
+    uint32_t legacy_wakeups;// wakeups one lv_timer per job would have caused (runs + skipped)
+    uint32_t uptime_ms;     // time since ui_sched_init()
+} ui_sched_stats_t;
+
+void ui_sched_init(void);
+
+// Register a periodic job. owner may be NULL (runs whenever the display is
+// on); otherwise the job is removed automatically when owner is deleted.
+// A new job runs on the next wakeup.
+ui_sched_job_t* ui_sched_add(const char* name, uint32_t period_ms, lv_obj_t* owner,
+                             ui_sched_cb_t cb, void* user);
+void ui_sched_remove(ui_sched_job_t* job);
+
+// Run a job on the next wakeup regardless of its deadline.
+void ui_sched_trigger(ui_sched_job_t* job);
+
+// Visibility may have changed (screen load, tile change): re-evaluate now.
+void ui_sched_refresh(void);
+
+// Suspend every job while the display is off; run the due ones on wake.
+void ui_sched_set_display_on(bool on);
+
+void ui_sched_get_stats(ui_sched_stats_t* out);
+void ui_sched_dump_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,5 @@
 #include "batt_screen.h"
+#include "ui_scheduler.h"
 #include "settings.h"
 #include "ui_fonts.h"
 #include "ui.h"
@@ -22,10 +23,9 @@ static lv_obj_t* row_vbat_val;
 static lv_obj_t* row_vbus_val;
 static lv_obj_t* row_vsys_val;
 static lv_obj_t* row_temp_val;
-static lv_timer_t* batt_timer;
 
 static void batt_screen_events(lv_event_t* e);
-static void batt_update_cb(lv_timer_t* t);
+static void batt_update_cb(void* user);
 static void batt_update_values(void);
 static lv_obj_t* make_chip(lv_obj_t* parent, const char* txt);
 static lv_obj_t* make_row(lv_obj_t* parent, const char* label_txt, lv_obj_t** out_val);
@@ -103,9 +103,8 @@ void lv_smartwatch_batt_create(lv_obj_t* screen)
     (void)make_row(status, "VSYS", &row_vsys_val);
     (void)make_row(status, "Temp", &row_temp_val);
 
-    // Periodic refresh
-    batt_timer = lv_timer_create(batt_update_cb, 5000, NULL);
-    //lv_timer_ready(batt_timer);
+    // Periodic refresh while visible (standalone screen or dynamic tile)
+    ui_sched_add("battery", 5000, batt_screen, batt_update_cb, NULL);
     batt_update_values();
 
     lv_obj_add_event_cb(batt_screen, batt_screen_events, LV_EVENT_ALL, NULL);
@@ -117,19 +116,28 @@ static void on_delete(lv_event_t* e)
 {
     (void)e;
     ESP_LOGI(TAG, "Battery screen deleted");
-    if (batt_timer) { lv_timer_del(batt_timer); batt_timer = NULL; }
     batt_screen = NULL;
 }
 
-lv_obj_t* batt_screen_get(void)
+static lv_obj_t* batt_screen_build(void)
 {
-    if (batt_screen == NULL) {
-        // Create as a standalone screen if not yet created
-        lv_smartwatch_batt_create(NULL);
-    }
+    // Standalone screen, owned by the screen manager
+    lv_smartwatch_batt_create(NULL);
     return batt_screen;
 }
 
+const screen_desc_t batt_screen_desc = {
+    .name = "battery",
+    .create = batt_screen_build,
+    .on_show = NULL,
+    .on_hide = NULL,
+};
+
+lv_obj_t* batt_screen_get(void)
+{
+    return screen_manager_get(SCREEN_ID_BATTERY);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -148,21 +156,16 @@ static void batt_screen_events(lv_event_t* e)
             lv_indev_wait_release(lv_indev_active());
             // Return to controls tile and remove dynamic tile
             ui_dynamic_tile_close();
-            if (batt_timer) { lv_timer_del(batt_timer); batt_timer = NULL; }
             batt_screen = NULL;
             //lv_obj_del_async(batt_screen);
         } 
     }
 }
 
-static void batt_update_cb(lv_timer_t* t)
+static void batt_update_cb(void* user)
 {
-    (void)t;
-    if (active_screen_get() == batt_screen) {
-        bsp_display_lock(0);
-        batt_update_values();
-        bsp_display_unlock();
-    }
+    (void)user;
+    batt_update_values();
 }
 
 static void batt_update_values(void)
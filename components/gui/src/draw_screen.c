@@ -1,8 +1,14 @@
 #include "draw_screen.h"
+#include "ui_scheduler.h"
 #include "esp_log.h"
 #include "lvgl.h"
 #include "ui_fonts.h"
 #include "ble_hid_combined.h"  // 🎯 API del HID Combinado
+#include "bsp/esp32_s3_touch_amoled_2_06.h"
+#include "esp_timer.h"
+#include "esp_event.h"
+#include "sensors.h"
+#include <stdlib.h>
 #include <math.h>
 
 static const char *TAG = "DRAW_SCREEN";
@@ -17,25 +23,177 @@ static lv_point_t s_last_point;
 static bool s_has_last_point = false;
 
 /* Variables para control del mouse */
-static bool s_mouse_mode = true;  // true = modo mouse, false = modo dibujo
-static lv_timer_t *s_status_timer = NULL;
+typedef enum {
+    DRAW_MODE_MOUSE = 0,    // ratón relativo (deltas)
+    DRAW_MODE_TABLET,       // puntero absoluto: el área es la pantalla del host
+    DRAW_MODE_DRAW,         // dibujo local
+    DRAW_MODE_COUNT,
+} draw_mode_t;
+
+static const char *const s_mode_names[DRAW_MODE_COUNT] = { "MOUSE", "TABLET", "DRAW" };
+static draw_mode_t s_mode = DRAW_MODE_MOUSE;
+static ui_sched_job_t *s_status_job = NULL;
+
+/* Trazas de latencia: el read_cb del táctil se envuelve para marcar cada
+ * lectura; una pulsación larga en Mode muestra los percentiles */
+static lv_indev_read_cb_t s_indev_read_orig = NULL;
+static lv_obj_t *s_lbl_trace = NULL;
+
+/* Gestos en modo ratón / tablet. El táctil solo da un punto, así que la
+ * rueda (dos dedos en un trackpad) es un arrastre vertical que empieza en
+ * la franja del borde derecho; un arrastre horizontal desde una franja
+ * hacia dentro es atrás / adelante. Lo que empieza en una franja no mueve
+ * el puntero. Los giros de muñeca llegan de sensors por el event loop. */
+#define EDGE_STRIP_PX   24      // ancho de las franjas laterales del área
+#define EDGE_SLOP_PX    10      // recorrido para decidir rueda o swipe
+#define EDGE_SWIPE_PX   60      // recorrido horizontal mínimo del swipe
+
+static int8_t s_edge = 0;               // franja del toque: -1 izq., +1 der., 0 ninguna
+static bool s_edge_scroll = false;      // el toque es la rueda
+static lv_point_t s_edge_start;
+static volatile bool s_hid_active = false;  // pantalla visible (event loop la lee)
+
+static void trace_overlay_update(void);
 
 /* ============================================================
- * TIMER PARA ACTUALIZAR ESTADO DE CONEXIÓN
+ * JOB PARA ACTUALIZAR ESTADO DE CONEXIÓN (ui_scheduler)
  * ========================================================== */
-static void status_timer_cb(lv_timer_t *timer)
+static void status_job_cb(void *user)
 {
-    (void)timer;
+    (void)user;
     if (!s_lbl_status) return;
 
     bool connected = ble_hid_combined_is_connected();
     if (connected) {
-        lv_label_set_text(s_lbl_status, s_mouse_mode ? "MOUSE [Connected]" : "DRAW [Connected]");
+        lv_label_set_text_fmt(s_lbl_status, "%s [Connected]", s_mode_names[s_mode]);
         lv_obj_set_style_text_color(s_lbl_status, lv_color_hex(0x00FF00), 0);
     } else {
-        lv_label_set_text(s_lbl_status, s_mouse_mode ? "MOUSE [Not Connected]" : "DRAW [Not Connected]");
+        lv_label_set_text_fmt(s_lbl_status, "%s [Not Connected]", s_mode_names[s_mode]);
         lv_obj_set_style_text_color(s_lbl_status, lv_color_hex(0xFF6060), 0);
     }
+    trace_overlay_update();
+}
+
+/* ============================================================
+ * TRAZAS DE LATENCIA (TÁCTIL -> REPORT HID)
+ * ========================================================== */
+static void traced_indev_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    int64_t t0 = esp_timer_get_time();
+    s_indev_read_orig(indev, data);
+
+    if (s_mode == DRAW_MODE_MOUSE && s_draw_screen && lv_screen_active() == s_draw_screen) {
+        ble_hid_trace_touch_read(t0, esp_timer_get_time(),
+                                 data->state == LV_INDEV_STATE_PRESSED);
+    }
+}
+
+static void trace_install(void)
+{
+    lv_indev_t *indev = bsp_display_get_input_dev();
+    if (!indev || s_indev_read_orig) return;
+
+    s_indev_read_orig = lv_indev_get_read_cb(indev);
+    if (s_indev_read_orig) lv_indev_set_read_cb(indev, traced_indev_read);
+}
+
+static void trace_overlay_update(void)
+{
+    if (!s_lbl_trace || lv_obj_has_flag(s_lbl_trace, LV_OBJ_FLAG_HIDDEN)) return;
+
+    // ms con un decimal: p50 / p95 / p99 por etapa
+    char buf[256];
+    size_t len = 0;
+    for (int i = 0; i < HID_TRACE_STAGES && len < sizeof(buf); ++i) {
+        hid_trace_summary_t t;
+        ble_hid_trace_get((hid_trace_stage_t)i, &t);
+        len += snprintf(buf + len, sizeof(buf) - len, "%s%-11s %u.%u %u.%u %u.%u",
+                        i ? "\n" : "", ble_hid_trace_stage_name((hid_trace_stage_t)i),
+                        (unsigned)(t.p50_us / 1000), (unsigned)(t.p50_us / 100 % 10),
+                        (unsigned)(t.p95_us / 1000), (unsigned)(t.p95_us / 100 % 10),
+                        (unsigned)(t.p99_us / 1000), (unsigned)(t.p99_us / 100 % 10));
+    }
+    lv_label_set_text(s_lbl_trace, buf);
+}
+
+static void btn_mode_long_press_cb(lv_event_t *e)
+{
+    (void)e;
+    if (!s_lbl_trace) return;
+
+    if (lv_obj_has_flag(s_lbl_trace, LV_OBJ_FLAG_HIDDEN)) {
+        ble_hid_trace_reset();
+        lv_label_set_text(s_lbl_trace, "latency p50/p95/p99 ms");
+        lv_obj_clear_flag(s_lbl_trace, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        ble_hid_trace_dump();
+        lv_obj_add_flag(s_lbl_trace, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+/* ============================================================
+ * MODO TABLET: POSICIÓN ABSOLUTA ESCALADA AL ÁREA
+ * ========================================================== */
+static void send_abs_point(const lv_point_t *p, bool down)
+{
+    lv_area_t a;
+    lv_obj_get_coords(s_draw_area, &a);
+    uint16_t x = hid_abs_scale(p->x, a.x1, lv_area_get_width(&a));
+    uint16_t y = hid_abs_scale(p->y, a.y1, lv_area_get_height(&a));
+    ble_hid_abs_pointer(x, y, down);
+}
+
+/* ============================================================
+ * GESTOS: FRANJAS DEL BORDE Y GIRO DE MUÑECA
+ * ========================================================== */
+static int8_t edge_of(const lv_point_t *p)
+{
+    lv_area_t a;
+    lv_obj_get_coords(s_draw_area, &a);
+    if (p->x < a.x1 + EDGE_STRIP_PX) return -1;
+    if (p->x > a.x2 - EDGE_STRIP_PX) return 1;
+    return 0;
+}
+
+static void edge_pressing(const lv_point_t *p, lv_coord_t dy)
+{
+    if (s_edge_scroll) {
+        // Dedo hacia abajo = rueda hacia arriba, como en un trackpad
+        if (dy) ble_hid_gesture(HID_GESTURE_SCROLL_DRAG, HID_PHASE_MOVE, dy);
+        return;
+    }
+    lv_coord_t tx = p->x - s_edge_start.x;
+    lv_coord_t ty = p->y - s_edge_start.y;
+    if (s_edge > 0 && abs(ty) > EDGE_SLOP_PX && abs(ty) > abs(tx)) {
+        s_edge_scroll = true;
+        ble_hid_gesture(HID_GESTURE_SCROLL_DRAG, HID_PHASE_MOVE, ty);
+    }
+}
+
+static void edge_released(const lv_point_t *p)
+{
+    lv_coord_t tx = p->x - s_edge_start.x;
+    if (s_edge_scroll) {
+        ble_hid_gesture(HID_GESTURE_SCROLL_DRAG, HID_PHASE_END, 0);
+    } else if (s_edge < 0 && tx >= EDGE_SWIPE_PX) {
+        ble_hid_gesture(HID_GESTURE_EDGE_SWIPE_RIGHT, HID_PHASE_END, 0);
+    } else if (s_edge > 0 && tx <= -EDGE_SWIPE_PX) {
+        ble_hid_gesture(HID_GESTURE_EDGE_SWIPE_LEFT, HID_PHASE_END, 0);
+    }
+    s_edge = 0;
+    s_edge_scroll = false;
+}
+
+/* Desde el event loop: no toca LVGL, solo encola el gesto */
+static void wrist_flick_evt(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    (void)arg; (void)base;
+    if (id != SENSORS_EVT_WRIST_FLICK || !data) return;
+    if (!s_hid_active || s_mode == DRAW_MODE_DRAW) return;
+
+    const sensors_flick_t *f = (const sensors_flick_t *)data;
+    ble_hid_gesture(f->dir > 0 ? HID_GESTURE_WRIST_FLICK_RIGHT : HID_GESTURE_WRIST_FLICK_LEFT,
+                    HID_PHASE_END, 0);
 }
 
 /* ============================================================
@@ -56,12 +214,22 @@ static void draw_area_event_cb(lv_event_t *e)
         s_has_last_point = true;
 
         ESP_LOGI(TAG, ">>> PRESSED: modo=%s, pos=(%d,%d), conectado=%d",
-                 s_mouse_mode ? "MOUSE" : "DRAW",
+                 s_mode_names[s_mode],
                  current_point.x, current_point.y,
                  ble_hid_combined_is_connected());
 
+        // Ratón / tablet: un toque en una franja del borde es un gesto
+        s_edge = s_mode != DRAW_MODE_DRAW ? edge_of(&current_point) : 0;
+        s_edge_scroll = false;
+        s_edge_start = current_point;
+
+        // Modo tablet: el dedo es el botón pulsado en esa posición
+        if (s_mode == DRAW_MODE_TABLET && !s_edge && ble_hid_combined_is_connected()) {
+            send_abs_point(&current_point, true);
+        }
+
         // Si está en modo dibujo, crear punto visual
-        if (!s_mouse_mode) {
+        if (s_mode == DRAW_MODE_DRAW) {
             lv_obj_t *dot = lv_obj_create(s_draw_area);
             lv_obj_remove_style_all(dot);
             lv_obj_set_size(dot, 8, 8);
@@ -76,25 +244,22 @@ static void draw_area_event_cb(lv_event_t *e)
         lv_coord_t dx = current_point.x - s_last_point.x;
         lv_coord_t dy = current_point.y - s_last_point.y;
 
-        if (s_mouse_mode) {
-            // 🎯 MODO MOUSE: Enviar movimiento al HID
+        if (s_edge) {
+            edge_pressing(&current_point, dy);
+        } else if (s_mode == DRAW_MODE_TABLET) {
+            // Solo cuenta la posición actual: sin error acumulado y el HID
+            // envía la última una vez por evento de conexión
+            if ((dx != 0 || dy != 0) && ble_hid_combined_is_connected()) {
+                send_abs_point(&current_point, true);
+            }
+        } else if (s_mode == DRAW_MODE_MOUSE) {
+            // 🎯 MODO MOUSE: el acumulador del HID escala, acelera y envía
+            // al ritmo de la conexión (sin truncar ni recortar deltas)
             if (dx != 0 || dy != 0) {
                 if (!ble_hid_combined_is_connected()) {
                     ESP_LOGW(TAG, "⚠ Mouse NO conectado - movimiento ignorado");
                 } else {
-                    // Escalar movimiento (dividir por 2 para hacerlo más suave)
-                    int8_t mouse_dx = (int8_t)(dx / 2);
-                    int8_t mouse_dy = (int8_t)(dy / 2);
-
-                    // Limitar valores a rango -127 a 127
-                    if (mouse_dx > 127) mouse_dx = 127;
-                    if (mouse_dx < -127) mouse_dx = -127;
-                    if (mouse_dy > 127) mouse_dy = 127;
-                    if (mouse_dy < -127) mouse_dy = -127;
-
-                    ESP_LOGI(TAG, ">>> ENVIANDO Mouse: dx=%d, dy=%d (raw: %d, %d)",
-                             mouse_dx, mouse_dy, dx, dy);
-                    ble_hid_mouse_move(mouse_dx, mouse_dy, 0);
+                    ble_hid_mouse_motion(dx, dy);
                 }
             }
         } else {
@@ -126,6 +291,13 @@ static void draw_area_event_cb(lv_event_t *e)
     }
     else if (code == LV_EVENT_RELEASED) {
         s_has_last_point = false;
+        if (s_edge) {
+            edge_released(&current_point);
+        } else if (s_mode == DRAW_MODE_MOUSE) {
+            ble_hid_mouse_motion_end();
+        } else if (s_mode == DRAW_MODE_TABLET) {
+            send_abs_point(&current_point, false);
+        }
     }
 }
 
@@ -146,7 +318,7 @@ static void btn_clear_event_cb(lv_event_t *e)
 }
 
 /* ============================================================
- * BOTÓN PARA CAMBIAR MODO (MOUSE ↔ DRAW)
+ * BOTÓN PARA CAMBIAR MODO (MOUSE → TABLET → DRAW)
  * ========================================================== */
 static void btn_mode_event_cb(lv_event_t *e)
 {
@@ -154,24 +326,53 @@ static void btn_mode_event_cb(lv_event_t *e)
         return;
     }
 
-    s_mouse_mode = !s_mouse_mode;
-    ESP_LOGI(TAG, "Modo cambiado a: %s", s_mouse_mode ? "MOUSE" : "DRAW");
+    s_mode = (draw_mode_t)((s_mode + 1) % DRAW_MODE_COUNT);
+    ESP_LOGI(TAG, "Modo cambiado a: %s", s_mode_names[s_mode]);
 
     // Actualizar label de estado inmediatamente
-    if (s_status_timer) {
-        lv_timer_ready(s_status_timer);
-    }
+    ui_sched_trigger(s_status_job);
 }
 
 /* ============================================================
- * CREAR LA PANTALLA DRAW MEJORADA
+ * CICLO DE VIDA (gestionado por screen_manager)
  * ========================================================== */
-lv_obj_t *draw_screen_get(void)
+static void draw_screen_on_delete(lv_event_t *e)
+{
+    (void)e;
+    s_hid_active = false;
+    esp_event_handler_unregister(SENSORS_EVENT_BASE, SENSORS_EVT_WRIST_FLICK, wrist_flick_evt);
+    s_status_job = NULL;  // el scheduler lo elimina con la pantalla
+    s_draw_screen = NULL;
+    s_draw_area = NULL;
+    s_btn_clear = NULL;
+    s_lbl_status = NULL;
+    s_lbl_trace = NULL;
+    s_has_last_point = false;
+    s_edge = 0;
+}
+
+static void draw_screen_on_show(void)
 {
-    if (s_draw_screen) {
-        return s_draw_screen;
+    s_hid_active = true;
+}
+
+static void draw_screen_on_hide(void)
+{
+    s_hid_active = false;
+    // Que el host no se quede con el botón pulsado
+    if (s_has_last_point && s_mode == DRAW_MODE_TABLET && !s_edge && s_draw_area) {
+        send_abs_point(&s_last_point, false);
     }
+    s_has_last_point = false;
+    s_edge = 0;
+    s_edge_scroll = false;
+}
 
+/* ============================================================
+ * CREAR LA PANTALLA DRAW MEJORADA
+ * ========================================================== */
+static lv_obj_t *draw_screen_create(void)
+{
     /* Pantalla vacía negra */
     s_draw_screen = lv_obj_create(NULL);
     lv_obj_remove_style_all(s_draw_screen);
@@ -225,6 +426,7 @@ lv_obj_t *draw_screen_get(void)
     lv_obj_set_style_bg_opa(btn_mode, LV_OPA_COVER, 0);
     lv_obj_set_style_radius(btn_mode, 8, 0);
     lv_obj_add_event_cb(btn_mode, btn_mode_event_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(btn_mode, btn_mode_long_press_cb, LV_EVENT_LONG_PRESSED, NULL);
 
     lv_obj_t *lbl_mode = lv_label_create(btn_mode);
     lv_label_set_text(lbl_mode, "Mode");
@@ -247,13 +449,36 @@ lv_obj_t *draw_screen_get(void)
     lv_obj_set_style_text_font(lbl_clear, &font_bold_26, 0);
     lv_obj_center(lbl_clear);
 
-    /* Crear timer para actualizar estado de conexión */
-    if (!s_status_timer) {
-        s_status_timer = lv_timer_create(status_timer_cb, 1000, NULL);
-        lv_timer_ready(s_status_timer);
-    }
+    /* Overlay de latencias (oculto hasta una pulsación larga en Mode) */
+    s_lbl_trace = lv_label_create(s_draw_screen);
+    lv_obj_set_style_text_color(s_lbl_trace, lv_color_hex(0xFFFF00), 0);
+    lv_obj_set_style_bg_color(s_lbl_trace, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(s_lbl_trace, LV_OPA_70, 0);
+    lv_obj_clear_flag(s_lbl_trace, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_align(s_lbl_trace, LV_ALIGN_TOP_MID, 0, draw_y);
+    lv_obj_add_flag(s_lbl_trace, LV_OBJ_FLAG_HIDDEN);
+
+    trace_install();
+    esp_event_handler_register(SENSORS_EVENT_BASE, SENSORS_EVT_WRIST_FLICK, wrist_flick_evt, NULL);
+
+    /* Estado de conexión: sólo se refresca mientras la pantalla está visible */
+    s_status_job = ui_sched_add("draw", 1000, s_draw_screen, status_job_cb, NULL);
+
+    lv_obj_add_event_cb(s_draw_screen, draw_screen_on_delete, LV_EVENT_DELETE, NULL);
 
     ESP_LOGI(TAG, "Pantalla DRAW/MOUSE creada - Resolución: %dx%d", scr_w, scr_h);
 
     return s_draw_screen;
+}
+
+const screen_desc_t draw_screen_desc = {
+    .name = "draw",
+    .create = draw_screen_create,
+    .on_show = draw_screen_on_show,
+    .on_hide = draw_screen_on_hide,
+};
+
+lv_obj_t *draw_screen_get(void)
+{
+    return screen_manager_get(SCREEN_ID_DRAW);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "magic_trick_screen.h"
+#include "ui_scheduler.h"
 #include "esp_log.h"
 #include "lvgl.h"
 #include "ui_fonts.h"
@@ -10,7 +11,6 @@ static const char *TAG = "MAGIC_TRICK";
 static lv_obj_t *s_screen = NULL;
 static lv_obj_t *s_lbl_status = NULL;   // Estado de conexión
 static lv_obj_t *s_lbl_time = NULL;     // Display central tipo reloj "HH:MM"
-static lv_timer_t *s_status_timer = NULL;
 
 static int s_suit = 1;   // 1=Corazones, 2=Picas, 3=Tréboles, 4=Diamantes (mostrado como 01-04)
 static int s_value = 1;  // 1=As, 2-10=números, 11=J, 12=Q, 13=K (mostrado como 01-13)
@@ -20,7 +20,7 @@ static const char *suit_names[] = {
     "",
     "CORAZONES",  // 1
     "PICAS",      // 2
-    "TREBOLES",   // 3
+    "TRÉBOLES",   // 3 (sin tilde si el layout del host no la tiene)
     "DIAMANTES"   // 4
 };
 
@@ -41,11 +41,11 @@ static const char *value_names[] = {
 };
 
 /* ============================================================
- * TIMER PARA ACTUALIZAR ESTADO
+ * JOB PARA ACTUALIZAR ESTADO (ui_scheduler)
  * ========================================================== */
-static void status_timer_cb(lv_timer_t *timer)
+static void status_job_cb(void *user)
 {
-    (void)timer;
+    (void)user;
     if (!s_lbl_status) return;
 
     bool connected = ble_hid_combined_is_connected();
@@ -142,14 +142,21 @@ static void btn_send_cb(lv_event_t *e)
 }
 
 /* ============================================================
- * CREAR PANTALLA
+ * CICLO DE VIDA (gestionado por screen_manager)
  * ========================================================== */
-lv_obj_t *magic_trick_screen_get(void)
+static void magic_trick_on_delete(lv_event_t *e)
 {
-    if (s_screen) {
-        return s_screen;
-    }
+    (void)e;
+    s_screen = NULL;
+    s_lbl_status = NULL;
+    s_lbl_time = NULL;
+}
 
+/* ============================================================
+ * CREAR PANTALLA
+ * ========================================================== */
+static lv_obj_t *magic_trick_screen_create(void)
+{
     /* Pantalla negra */
     s_screen = lv_obj_create(NULL);
     lv_obj_remove_style_all(s_screen);
@@ -259,14 +266,26 @@ lv_obj_t *magic_trick_screen_get(void)
     lv_obj_set_style_radius(btn_send, 40, 0);  // Circular
     lv_obj_add_event_cb(btn_send, btn_send_cb, LV_EVENT_CLICKED, NULL);
 
-    /* Crear timer para estado */
-    if (!s_status_timer) {
-        s_status_timer = lv_timer_create(status_timer_cb, 1000, NULL);
-        lv_timer_ready(s_status_timer);
-    }
+    /* Estado: el scheduler lo suspende mientras la pantalla no es visible
+     * y lo elimina junto con ella */
+    ui_sched_add("magic", 1000, s_screen, status_job_cb, NULL);
 
     update_display();
 
+    lv_obj_add_event_cb(s_screen, magic_trick_on_delete, LV_EVENT_DELETE, NULL);
+
     ESP_LOGI(TAG, "Pantalla Magic Trick creada (modo reloj)");
     return s_screen;
 }
+
+const screen_desc_t magic_trick_screen_desc = {
+    .name = "magic_trick",
+    .create = magic_trick_screen_create,
+    .on_show = NULL,
+    .on_hide = NULL,
+};
+
+lv_obj_t *magic_trick_screen_get(void)
+{
+    return screen_manager_get(SCREEN_ID_MAGIC_TRICK);
+}
@@ -1,17 +1,35 @@
 #include "notifications.h"
 #include "ui_fonts.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 
 #include "esp_check.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 
 #include "ui.h"
 #include "watchface.h"
-
-// Keep the last N notifications and allow swipe left/right
-#define MAX_NOTIFICATIONS 5
+#include "notif_store.h"
+#include "notif_store_file.h"
+#include "app_registry.h"
+#include "vlist.h"
+
+static const char* TAG = "notifications";
+
+// Notifications persist in notif_store (hundreds, on flash) and are shown
+// as a horizontal strip of cards, newest first. Only a few card widgets
+// exist: vlist maps the strip position onto them and recycles them as it
+// moves. Cards off center show a short preview of the message; the whole
+// body is read and laid out only for the card that settles in the middle.
+// The pager shows a window of dots.
+#define PAGER_DOTS      5
+#define NOTIF_CARDS     4       // VLIST_POOL_NEEDED for one card per screen
+#define NOTIF_CARD_GAP  16      // px between cards
+#define NOTIF_PREVIEW   160     // message bytes on a card off center
+#define NOTIF_SNAP_MS   160
 
 LV_IMAGE_DECLARE(image_notification_48);
 LV_IMAGE_DECLARE(image_sms_48);
@@ -27,29 +45,39 @@ LV_IMAGE_DECLARE(image_instagram_48);
 LV_IMAGE_DECLARE(image_tiktok_48);
 LV_IMAGE_DECLARE(image_x_48);
 
-typedef struct NotificationItem {
-    char app[32];
-    char title[64];
-    char message[256];
-    char ts_iso[40];
-} NotificationItem;
+// Store index (~12 KB) and the body of the centered card, both in PSRAM.
+// Only that card's whole message is read from flash.
+static notif_store_t* s_store;
+static char* s_body;
+static notif_store_io_t s_store_io;
+static uint8_t* s_store_ram;    // log in RAM when the SPIFFS file is unusable
+
+_Static_assert(NOTIF_MESSAGE_MAX <= NOTIF_STORE_BODY_MAX, "store clamps longer bodies");
 
-// Data buffer
-static NotificationItem notif_buf[MAX_NOTIFICATIONS];
-static int notif_count = 0; // valid items in buffer
+static inline int notif_total(void)
+{
+    return s_store ? (int)notif_store_count(s_store) : 0;
+}
 
-// Container and single reusable card (low memory)
+typedef struct {
+    lv_obj_t* root;
+    lv_obj_t* icon;
+    lv_obj_t* app;
+    lv_obj_t* title;
+    lv_obj_t* message;
+    lv_obj_t* time;
+    int32_t item;                 // bound index, VLIST_NONE when hidden
+    bool full;                    // message label holds the whole body
+} notif_card_t;
+
+// Container and the recycled cards
 static lv_obj_t *notification_screen;      // root container (fills panel)
-static lv_obj_t *card;            // single card reused for all items
-static lv_obj_t *avatar_img;      // optional image icon
-static lv_obj_t *lbl_app;
-static lv_obj_t *lbl_time;
-static lv_obj_t *lbl_title;
-static lv_obj_t *lbl_message;
-static lv_obj_t *hdr_separator;
+static notif_card_t s_cards[NOTIF_CARDS];
+static vlist_t s_list;
+static lv_timer_t* s_layout_timer;         // applies s_list once per refresh
 static lv_obj_t *pager_cont;      // bottom-center pager (dots)
-static lv_obj_t *pager_dots[MAX_NOTIFICATIONS];
-static int active_idx = 0;        // current shown index (0 = most recent)
+static lv_obj_t *pager_dots[PAGER_DOTS];
+static int active_idx = 0;        // centered index (0 = most recent)
 
 lv_obj_t* notifications_screen_get(void);
 
@@ -60,15 +88,18 @@ static void set_label_text(lv_obj_t* lbl, const char* txt)
     lv_label_set_text(lbl, txt);
 }
 
+// Shown on the first card while the store is empty
 static void show_empty_state(void)
 {
-    if (avatar_img) {
-        lv_image_set_src(avatar_img, &image_notification_48);
-    }
-    set_label_text(lbl_app, "Notifications");
-    set_label_text(lbl_title, "You don't have\nnew notifications...");
-    set_label_text(lbl_message, "");
-    set_label_text(lbl_time, "");
+    notif_card_t* c = &s_cards[0];
+    if (!c->root) return;
+    lv_image_set_src(c->icon, &image_notification_48);
+    set_label_text(c->app, "Notifications");
+    set_label_text(c->title, "You don't have\nnew notifications...");
+    set_label_text(c->message, "");
+    set_label_text(c->time, "");
+    lv_obj_set_x(c->root, 0);
+    lv_obj_clear_flag(c->root, LV_OBJ_FLAG_HIDDEN);
 }
 
 // Format "YYYY-MM-DD HH:MM" from ISO timestamp
@@ -87,103 +118,198 @@ static void format_datetime_ymd_hhmm(const char* iso_ts, char* out, size_t out_s
     out[11] = t[1]; out[12] = t[2]; out[13] = ':'; out[14] = t[4]; out[15] = t[5]; out[16] = '\0';
 }
 
-typedef struct AppMeta {
-    const char* id;
-    const char* friendly;    
-    const lv_image_dsc_t* icon;
-} AppMeta;
-
-static const AppMeta k_known_apps[] = {
-    { "sms",                                "SMS",          &image_sms_48 },
-    { "com.android.messaging",              "SMS",          &image_sms_48 },
-    { "com.google.android.apps.messaging",  "SMS",          &image_sms_48 },
-    { "com.google.android.apps.messagi",    "SMS",          &image_sms_48 },
-    { "call",                               "Call",         &image_call_48 },
-    { "com.google.android.dialer",          "Call",         &image_call_48 },
-    { "com.google.android.gm",              "Gmail",        &image_gmail_48 },
-    { "com.google.android.youtube",         "YouTube",      &image_youtube_48 },
-    { "com.whatsapp",                       "WhatsApp",     &image_whatsapp_48 },
-    { "com.facebook.katana",                "Facebook",     &image_messenger_48 },
-    { "org.telegram.messenger",             "Telegram",     &image_telegram_48 },
-    { "com.microsoft.office.outlook",       "Outlook",      &image_outlook_48 },
-    { "com.microsoft.teams",                "Teams",        &image_teams_48 },
-    { "com.instagram.android",              "Instagram",    &image_instagram_48 },
-    { "com.zhiliaoapp.musically",           "TikTok",       &image_tiktok_48 },
-    { "com.twitter.android",                "X (Twitter)",  &image_x_48 },
+// app_icon_t -> built-in image; custom icons come from app_registry
+static const lv_image_dsc_t* const k_app_icons[APP_ICON_BUILTIN_COUNT] = {
+    [APP_ICON_GENERIC]   = &image_notification_48,
+    [APP_ICON_SMS]       = &image_sms_48,
+    [APP_ICON_CALL]      = &image_call_48,
+    [APP_ICON_GMAIL]     = &image_gmail_48,
+    [APP_ICON_YOUTUBE]   = &image_youtube_48,
+    [APP_ICON_WHATSAPP]  = &image_whatsapp_48,
+    [APP_ICON_MESSENGER] = &image_messenger_48,
+    [APP_ICON_TELEGRAM]  = &image_telegram_48,
+    [APP_ICON_OUTLOOK]   = &image_outlook_48,
+    [APP_ICON_TEAMS]     = &image_teams_48,
+    [APP_ICON_INSTAGRAM] = &image_instagram_48,
+    [APP_ICON_TIKTOK]    = &image_tiktok_48,
+    [APP_ICON_X]         = &image_x_48,
 };
 
-static const AppMeta* get_app_meta(const char* app_id)
+// Decoded phone-pushed icons, least recently used slot is reused (never one
+// a card shows). Only the LVGL task touches them; a registry update drops
+// them all.
+#define ICON_CACHE_SLOTS 6
+_Static_assert(ICON_CACHE_SLOTS > NOTIF_CARDS, "a slot must be free of cards");
+
+typedef struct {
+    char id[APP_ID_MAX];
+    uint32_t used;
+    uint8_t* px;                  // RGB565A8, APP_ICON_MAX_DIM^2 * 3 in PSRAM
+    lv_image_dsc_t dsc;
+} icon_slot_t;
+
+static icon_slot_t s_icon_cache[ICON_CACHE_SLOTS];
+static uint32_t s_icon_gen;
+static uint32_t s_icon_tick;
+
+static bool icon_on_card(const lv_image_dsc_t* dsc)
+{
+    for (int i = 0; i < NOTIF_CARDS; ++i) {
+        if (s_cards[i].icon && lv_image_get_src(s_cards[i].icon) == dsc) return true;
+    }
+    return false;
+}
+
+static const lv_image_dsc_t* custom_icon(const char* app_id)
 {
-    static AppMeta dyn; // for unknown apps
-    if (app_id && *app_id) {
-        for (size_t i = 0; i < sizeof(k_known_apps)/sizeof(k_known_apps[0]); ++i) {
-            if (strcasecmp(app_id, k_known_apps[i].id) == 0) {
-                return &k_known_apps[i];
-            }
+    uint32_t gen = app_registry_generation();
+    if (gen != s_icon_gen) {
+        s_icon_gen = gen;
+        for (int i = 0; i < ICON_CACHE_SLOTS; ++i) s_icon_cache[i].id[0] = '\0';
+    }
+
+    icon_slot_t* slot = NULL;
+    for (int i = 0; i < ICON_CACHE_SLOTS; ++i) {
+        icon_slot_t* c = &s_icon_cache[i];
+        if (c->id[0] && strcasecmp(c->id, app_id) == 0) {
+            c->used = ++s_icon_tick;
+            return &c->dsc;
         }
-        dyn.id = app_id;
-        dyn.friendly = app_id;
-        dyn.icon = &image_notification_48;
-        return &dyn;
+        if (slot && !slot->id[0]) continue;    // keep the free slot found
+        if (c->px && icon_on_card(&c->dsc)) continue;
+        if (!slot || !c->id[0] || c->used < slot->used) slot = c;
+    }
+
+    if (!slot) return NULL;
+
+    const size_t cap = (size_t)APP_ICON_MAX_DIM * APP_ICON_MAX_DIM * 3;
+    if (!slot->px) slot->px = heap_caps_malloc(cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint16_t w, h;
+    if (!slot->px || app_registry_load_icon(app_id, slot->px, cap, &w, &h) != ESP_OK) {
+        slot->id[0] = '\0';
+        return NULL;
     }
-    static const AppMeta unknown = { "", "Notifications", &image_notification_48 };
-    return &unknown;
+    // Same pixels buffer as the previous owner: forget what LVGL cached
+    lv_image_cache_drop(&slot->dsc);
+    slot->dsc = (lv_image_dsc_t){
+        .header = {
+            .magic = LV_IMAGE_HEADER_MAGIC,
+            .cf = LV_COLOR_FORMAT_RGB565A8,
+            .w = w,
+            .h = h,
+            .stride = (uint32_t)w * 2,
+        },
+        .data_size = (uint32_t)w * h * 3,
+        .data = slot->px,
+    };
+    snprintf(slot->id, sizeof(slot->id), "%s", app_id);
+    slot->used = ++s_icon_tick;
+    return &slot->dsc;
+}
+
+static const lv_image_dsc_t* app_icon(const char* app_id, app_info_t* app)
+{
+    // Name and icon from the registry (built-in or pushed by the phone)
+    app_registry_lookup(app_id, app);
+    const lv_image_dsc_t* icon = app->icon == APP_ICON_CUSTOM ? custom_icon(app_id)
+                               : app->icon < APP_ICON_BUILTIN_COUNT ? k_app_icons[app->icon] : NULL;
+    return icon ? icon : &image_notification_48;
+}
+
+// Cut a preview at a UTF-8 boundary and mark it as shortened
+static void trim_preview(char* text, size_t body_len)
+{
+    size_t n = strlen(text);
+    if (n >= body_len) return;
+    if (n > NOTIF_PREVIEW - 4) n = NOTIF_PREVIEW - 4;
+    while (n > 0 && ((unsigned char)text[n] & 0xC0) == 0x80) n--;
+    memcpy(text + n, "...", 4);
 }
 
-static void update_card_content(int idx)
+// vlist bind: fill a card with item idx (preview only) or hide it
+static void bind_card(void* ctx, int slot, int32_t idx)
 {
-    if (idx < 0 || idx >= notif_count) {
-        show_empty_state();
+    (void)ctx;
+    notif_card_t* c = &s_cards[slot];
+    c->item = VLIST_NONE;
+    c->full = false;
+
+    notif_store_item_t item;
+    char preview[NOTIF_PREVIEW];
+    if (idx == VLIST_NONE ||
+        !notif_store_load(s_store, notif_store_nth(s_store, (unsigned)idx), &item, preview, sizeof(preview))) {
+        lv_obj_add_flag(c->root, LV_OBJ_FLAG_HIDDEN);
         return;
     }
+    trim_preview(preview, item.body_len);
+
     char dt[17];
-    format_datetime_ymd_hhmm(notif_buf[idx].ts_iso, dt, sizeof(dt));
-    /*if (lbl_num[idx]) {
-        char num[8];
-        lv_snprintf(num, sizeof(num), "# %d", idx + 1); // Latest is 1
-        lv_label_set_text(lbl_num[idx], num);
-    }*/
-    // Unified metadata for name, color, icon
-    const char* app_id = notif_buf[idx].app;
-    const AppMeta* meta = get_app_meta(app_id);
-    set_label_text(lbl_app, meta ? meta->friendly : app_id);
-    set_label_text(lbl_title, notif_buf[idx].title);
-    set_label_text(lbl_message, notif_buf[idx].message);
-    set_label_text(lbl_time, dt);
-
-    // Update avatar (image if available; otherwise colored monogram)
-    //if (avatar) {
-
-        // Always show an icon per metadata
-        const lv_image_dsc_t* icon = (meta && meta->icon) ? meta->icon : &image_notification_48;
-        if (icon && avatar_img) {
-            lv_image_set_src(avatar_img, icon);
-        }
-        // Use color from metadata on the label text (safer than bg on label)
-        //uint32_t color = meta ? meta->color : 0x3B82F6;
-        //lv_obj_set_style_text_color(lbl_app, lv_color_hex(color), 0);
+    format_datetime_ymd_hhmm(item.ts, dt, sizeof(dt));
+    app_info_t app;
+    lv_image_set_src(c->icon, app_icon(item.app, &app));
+    set_label_text(c->app, app.name);
+    set_label_text(c->title, item.title);
+    set_label_text(c->message, preview);
+    set_label_text(c->time, dt);
+    c->item = idx;
+    lv_obj_clear_flag(c->root, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void place_card(void* ctx, int slot, int32_t x)
+{
+    (void)ctx;
+    lv_obj_set_x(s_cards[slot].root, x);
+}
+
+static void layout_now(void)
+{
+    vlist_layout(&s_list, bind_card, place_card, NULL);
+    if (notif_total() == 0) show_empty_state();
+}
+
+// One vlist pass per refresh period however many drag events came in;
+// the timer pauses itself once the strip stops moving
+static void layout_timer_cb(lv_timer_t* t)
+{
+    if (!vlist_layout(&s_list, bind_card, place_card, NULL)) lv_timer_pause(t);
+}
 
-        // Letter avatar is no longer used (always show icon)
-    //}
+static void layout_kick(void)
+{
+    if (s_layout_timer) lv_timer_resume(s_layout_timer);
 }
 
-static void create_tile(int idx) { (void)idx; }
+// The centered card gets the whole message, read and measured only now
+static void expand_active(void)
+{
+    for (int i = 0; i < NOTIF_CARDS; ++i) {
+        notif_card_t* c = &s_cards[i];
+        if (c->item != active_idx || c->full) continue;
+        notif_store_item_t item;
+        if (notif_store_load(s_store, notif_store_nth(s_store, (unsigned)active_idx), &item,
+                             s_body, NOTIF_MESSAGE_MAX)) {
+            set_label_text(c->message, s_body);
+            c->full = true;
+        }
+    }
+}
 
-static void build_single_card(lv_obj_t* parent)
+static void build_card(lv_obj_t* parent, notif_card_t* c, int32_t width)
 {
-    card = lv_obj_create(parent);
+    c->item = VLIST_NONE;
+    c->root = lv_obj_create(parent);
+    lv_obj_t* card = c->root;
     lv_obj_remove_style_all(card);
-    lv_obj_set_size(card, lv_pct(100), lv_pct(100));
-    //lv_obj_set_style_pad_all(card, 10, 0);
-    //lv_obj_set_style_pad_row(card, 10, 0);
+    lv_obj_set_size(card, width, lv_pct(100));
     lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_flex_flow(card, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(card, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_SPACE_BETWEEN);
-    //lv_obj_add_flag(card, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
+    // Presses on the card bubble up to the container (where the handler is)
+    lv_obj_add_flag(card, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(card, LV_OBJ_FLAG_HIDDEN);
 
     lv_obj_t* hdr_card = lv_obj_create(card);
     lv_obj_remove_style_all(hdr_card);
-    //lv_obj_set_size(hdr_card, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_obj_set_flex_flow(hdr_card, LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(hdr_card, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_SPACE_EVENLY);
     lv_obj_set_size(hdr_card, lv_pct(100), LV_SIZE_CONTENT);
@@ -191,80 +317,64 @@ static void build_single_card(lv_obj_t* parent)
     lv_obj_set_style_bg_color(hdr_card, lv_color_hex(0xFFFFFF), 0);
     lv_obj_set_style_bg_opa(hdr_card, LV_OPA_20, 0);
 
-    /*avatar = lv_obj_create(hdr_card);
-    lv_obj_remove_style_all(avatar);
-    lv_obj_set_size(avatar, 62, 62);
-    lv_obj_set_style_radius(avatar, 18, 0);
-    lv_obj_set_style_bg_color(avatar, lv_color_hex(0x444444), 0);
-    lv_obj_set_style_bg_opa(avatar, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_width(avatar, 0, 0);
-    lv_obj_set_style_pad_all(avatar, 0, 0);*/
-
-    avatar_img = lv_image_create(hdr_card);
-    lv_image_set_src(avatar_img, &image_notification_48);
-    //lv_obj_set_size(avatar_img, 62, 62);    
-
-    lbl_app = lv_label_create(hdr_card);
-    lv_obj_set_style_text_color(lbl_app, lv_color_hex(0xF0F0F0), 0);
-    lv_obj_set_style_text_font(lbl_app, &font_normal_26, 0);
-    lv_obj_set_style_pad_left(lbl_app, 12, 0);
-    lv_label_set_text(lbl_app, "Notifications");
-    lv_label_set_long_mode(lbl_app, LV_LABEL_LONG_SCROLL_CIRCULAR);
-
-    /*hdr_separator = lv_obj_create(card);
-    lv_obj_remove_style_all(hdr_separator);
-    lv_obj_set_height(hdr_separator, 1);
-    lv_obj_set_width(hdr_separator, lv_pct(100));
-    lv_obj_set_style_bg_color(hdr_separator, lv_color_hex(0x4E4E4E), 0);
-    lv_obj_set_style_bg_opa(hdr_separator, LV_OPA_COVER, 0);
-    lv_obj_set_style_pad_top(hdr_separator, 0, 0);
-    lv_obj_set_style_pad_bottom(hdr_separator, 0, 0);
-    lv_obj_set_style_margin_top(hdr_separator, 0, 0);*/
-    //lv_obj_set_style_margin_bottom(hdr_separator, 8, 0);
-    //lv_obj_set_size(lbl_app, lv_pct(100), 52);
-
-    lbl_title = lv_label_create(card);
-    lv_label_set_text(lbl_title, "You don't have\nnew notifications...");
-    lv_obj_set_width(lbl_title, lv_pct(100));
-    lv_label_set_long_mode(lbl_title, LV_LABEL_LONG_WRAP);
-    lv_obj_set_style_text_align(lbl_title, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_set_style_text_color(lbl_title, lv_color_hex(0x90F090), 0);
-    lv_obj_set_style_text_font(lbl_title, &font_bold_26, 0);
-
-    lbl_message = lv_label_create(card);
-    lv_label_set_text(lbl_message, "");
-    lv_obj_set_width(lbl_message, lv_pct(100));
-    lv_label_set_long_mode(lbl_message, LV_LABEL_LONG_WRAP);
-    lv_obj_set_style_text_align(lbl_message, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_set_style_text_color(lbl_message, lv_color_hex(0xF0F0F0), 0);
-    lv_obj_set_style_text_font(lbl_message, &font_normal_26, 0);
-
-    lbl_time = lv_label_create(card);
-    lv_obj_set_style_pad_bottom(lbl_time, 25, 0);
-    lv_obj_set_style_text_color(lbl_time, lv_color_hex(0x909090), 0);
-    lv_obj_set_style_text_font(lbl_time, &font_normal_26, 0);
-    lv_label_set_text(lbl_time, "");
+    c->icon = lv_image_create(hdr_card);
+    lv_image_set_src(c->icon, &image_notification_48);
+
+    c->app = lv_label_create(hdr_card);
+    lv_obj_set_style_text_color(c->app, lv_color_hex(0xF0F0F0), 0);
+    lv_obj_set_style_text_font(c->app, &font_normal_26, 0);
+    lv_obj_set_style_pad_left(c->app, 12, 0);
+    lv_label_set_text(c->app, "Notifications");
+    lv_label_set_long_mode(c->app, LV_LABEL_LONG_SCROLL_CIRCULAR);
+
+    c->title = lv_label_create(card);
+    lv_label_set_text(c->title, "");
+    lv_obj_set_width(c->title, lv_pct(100));
+    lv_label_set_long_mode(c->title, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_align(c->title, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_color(c->title, lv_color_hex(0x90F090), 0);
+    lv_obj_set_style_text_font(c->title, &font_bold_26, 0);
+
+    c->message = lv_label_create(card);
+    lv_label_set_text(c->message, "");
+    lv_obj_set_width(c->message, lv_pct(100));
+    lv_label_set_long_mode(c->message, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_align(c->message, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_color(c->message, lv_color_hex(0xF0F0F0), 0);
+    lv_obj_set_style_text_font(c->message, &font_normal_26, 0);
+
+    c->time = lv_label_create(card);
+    lv_obj_set_style_pad_bottom(c->time, 25, 0);
+    lv_obj_set_style_text_color(c->time, lv_color_hex(0x909090), 0);
+    lv_obj_set_style_text_font(c->time, &font_normal_26, 0);
+    lv_label_set_text(c->time, "");
 }
 
 static void update_pager(int active_idx)
 {
     if (!pager_cont) return;
     // Hide when there are 0 or 1 notifications
-    if (notif_count <= 1) {
+    int count = notif_total();
+    if (count <= 1) {
         lv_obj_add_flag(pager_cont, LV_OBJ_FLAG_HIDDEN);
         return;
     }
 
     lv_obj_clear_flag(pager_cont, LV_OBJ_FLAG_HIDDEN);
 
-    // Ensure dots exist up to MAX_NOTIFICATIONS and reflect notif_count
+    // Up to PAGER_DOTS dots, a window that follows the active item
     const int inactive_sz = 6;     // px
     const int active_sz   = 10;    // px (bigger for current)
     const uint32_t col_inactive = 0x9CA3AF; // lighter gray for better visibility
     const uint32_t col_active   = 0xF6F6C2; // accent color matches title
 
-    for (int i = 0; i < MAX_NOTIFICATIONS; ++i) {
-        if (i >= notif_count) {
+    int dots = count < PAGER_DOTS ? count : PAGER_DOTS;
+    int first = active_idx - PAGER_DOTS / 2;
+    if (first > count - dots) first = count - dots;
+    if (first < 0) first = 0;
+
+    for (int i = 0; i < PAGER_DOTS; ++i) {
+        if (i >= dots) {
             if (pager_dots[i]) lv_obj_add_flag(pager_dots[i], LV_OBJ_FLAG_HIDDEN);
             continue;
         }
@@ -277,195 +387,178 @@ static void update_pager(int active_idx)
         }
         lv_obj_clear_flag(pager_dots[i], LV_OBJ_FLAG_HIDDEN);
 
-        bool is_active = (i == active_idx);
+        bool is_active = (first + i == active_idx);
         int sz = is_active ? active_sz : inactive_sz;
         lv_obj_set_size(pager_dots[i], sz, sz);
         lv_obj_set_style_bg_color(pager_dots[i], lv_color_hex(is_active ? col_active : col_inactive), 0);
     }
 }
 
-// Animation helpers (file scope)
-static void notif_anim_set_y(void *var, int32_t v)
-{
-    lv_obj_set_style_translate_y((lv_obj_t*)var, v, 0);
-}
-static void notif_anim_set_opa(void *var, int32_t v)
-{
-    lv_obj_set_style_opa((lv_obj_t*)var, (lv_opa_t)v, 0);
-}
-static void notif_anim_set_x(void *var, int32_t v)
-{
-    lv_obj_set_style_translate_x((lv_obj_t*)var, v, 0);
-}
 
-// Simple slide transition state
-static bool notif_is_animating = false;
-static int slide_target_idx = 0;
-static int slide_dir = 0; // +1 = to left (next), -1 = to right (prev)
+// Snap: a single animation of the strip position; the layout timer draws it
+static int snap_target_idx = 0;
 
-static void slide_phase2_ready_cb(lv_anim_t* a)
+static void snap_exec_cb(void* var, int32_t v)
 {
-    (void)a;
-    notif_is_animating = false;
+    vlist_scroll_to((vlist_t*)var, v);
+    layout_kick();
 }
 
-static void slide_phase1_ready_cb(lv_anim_t* a)
+static void snap_ready_cb(lv_anim_t* a)
 {
     (void)a;
-    // Swap content to target item
-    active_idx = slide_target_idx;
-    update_card_content(active_idx);
+    active_idx = snap_target_idx;
+    layout_now();
+    expand_active();
     update_pager(active_idx);
-
-    // Prepare for slide-in from opposite side
-    int32_t start_x = (slide_dir > 0) ? 30 : -30;
-    if (card) {
-        lv_obj_set_style_translate_x(card, start_x, 0);
-        lv_obj_set_style_opa(card, 0, 0);
-
-        // Slide-in
-        lv_anim_t a_in; lv_anim_init(&a_in);
-        lv_anim_set_var(&a_in, card);
-        lv_anim_set_values(&a_in, start_x, 0);
-        lv_anim_set_time(&a_in, 140);
-        lv_anim_set_exec_cb(&a_in, notif_anim_set_x);
-        lv_anim_set_ready_cb(&a_in, slide_phase2_ready_cb);
-        lv_anim_start(&a_in);
-
-        // Fade-in
-        lv_anim_t a_in_f; lv_anim_init(&a_in_f);
-        lv_anim_set_var(&a_in_f, card);
-        lv_anim_set_values(&a_in_f, 0, 255);
-        lv_anim_set_time(&a_in_f, 140);
-        lv_anim_set_exec_cb(&a_in_f, notif_anim_set_opa);
-        lv_anim_start(&a_in_f);
-    } else {
-        notif_is_animating = false;
-    }
 }
 
-static void start_slide_to(int new_idx, int dir)
+static void snap_to(int idx)
 {
-    if (!card || new_idx == active_idx) {
-        // Fallback: no animation
-        active_idx = new_idx;
-        update_card_content(active_idx);
-        update_pager(active_idx);
-        notif_is_animating = false;
+    snap_target_idx = idx;
+    int32_t to = idx * s_list.pitch;
+    lv_anim_delete(&s_list, snap_exec_cb);
+    if (s_list.scroll == to) {
+        snap_ready_cb(NULL);
         return;
     }
-    notif_is_animating = true;
-    slide_target_idx = new_idx;
-    slide_dir = dir;
-
-    // Ensure in known state
-    lv_obj_set_style_translate_x(card, 0, 0);
-    lv_obj_set_style_opa(card, 255, 0);
-
-    // Phase 1: slide-out slightly and fade-out
-    int32_t end_x = (dir > 0) ? -30 : 30;
-    lv_anim_t a_out; lv_anim_init(&a_out);
-    lv_anim_set_var(&a_out, card);
-    lv_anim_set_values(&a_out, 0, end_x);
-    lv_anim_set_time(&a_out, 120);
-    lv_anim_set_exec_cb(&a_out, notif_anim_set_x);
-    lv_anim_set_ready_cb(&a_out, slide_phase1_ready_cb);
-    lv_anim_start(&a_out);
-
-    lv_anim_t a_out_f; lv_anim_init(&a_out_f);
-    lv_anim_set_var(&a_out_f, card);
-    lv_anim_set_values(&a_out_f, 255, 0);
-    lv_anim_set_time(&a_out_f, 120);
-    lv_anim_set_exec_cb(&a_out_f, notif_anim_set_opa);
-    lv_anim_start(&a_out_f);
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, &s_list);
+    lv_anim_set_values(&a, s_list.scroll, to);
+    lv_anim_set_time(&a, NOTIF_SNAP_MS);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    lv_anim_set_exec_cb(&a, snap_exec_cb);
+    lv_anim_set_ready_cb(&a, snap_ready_cb);
+    lv_anim_start(&a);
+}
+
+// Strip back on the centered item after the list changed
+static void list_reset(void)
+{
+    int count = notif_total();
+    lv_anim_delete(&s_list, snap_exec_cb);
+    if (active_idx >= count) active_idx = count - 1;
+    if (active_idx < 0) active_idx = 0;
+    vlist_set_count(&s_list, count);
+    vlist_scroll_to(&s_list, active_idx * s_list.pitch);
+    layout_now();
+    expand_active();
+    update_pager(active_idx);
 }
 
 static void delete_notification_at(int idx)
 {
-    if (idx < 0 || idx >= notif_count) {
+    if (idx < 0 || idx >= notif_total()) {
         return;
     }
-    for (int i = idx; i < notif_count - 1; ++i) {
-        notif_buf[i] = notif_buf[i + 1];
-    }
-    notif_count--;
-    if (notif_count <= 0) {
-        notif_count = 0;
-        active_idx = 0;
-        notif_is_animating = false;
-        show_empty_state();
-        update_pager(active_idx);
+    if (!notif_store_delete(s_store, notif_store_nth(s_store, (unsigned)idx))) {
+        ESP_LOGW(TAG, "Delete failed");
         return;
     }
     if (active_idx > idx) {
         active_idx--;
     }
-    if (active_idx >= notif_count) {
-        active_idx = notif_count - 1;
-    }
-    notif_is_animating = false;
-    update_card_content(active_idx);
-    update_pager(active_idx);
+    list_reset();
 }
 
+// The strip follows the finger horizontally; vertical drags are left to the
+// tileview. On release it snaps to the neighbour past a 30 px swipe.
 static void gesture_event_cb(lv_event_t* e)
 {
     lv_event_code_t code = lv_event_get_code(e);
-    //ESP_LOGI("NOTIF", "Notif event: %d", code);
     static lv_point_t press_start = {0,0};
-    if (code == LV_EVENT_GESTURE) {
-        lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_active());
-        //ESP_LOGI("NOTIF", "Notif event dir : %d", dir);
-        if (!notif_is_animating) {
-            if (dir == LV_DIR_LEFT) {
-                if (active_idx + 1 < notif_count) {
-                    lv_indev_wait_release(lv_indev_active());
-                    start_slide_to(active_idx + 1, +1);
-                }
-            } else if (dir == LV_DIR_RIGHT) {
-                if (active_idx > 0) {
-                    lv_indev_wait_release(lv_indev_active());
-                    start_slide_to(active_idx - 1, -1);
-                }
-            }
-        }
-        /*if (dir == LV_DIR_TOP) {
-            lv_indev_wait_release(lv_indev_active());
-            load_screen(notification_screen, watchface_screen_get(), LV_SCR_LOAD_ANIM_MOVE_TOP);
+    static int32_t drag_start_scroll;
+    static bool dragging;
+
+    if (code == LV_EVENT_PRESSED) {
+        lv_indev_get_point(lv_indev_active(), &press_start);
+        lv_anim_delete(&s_list, snap_exec_cb);
+        drag_start_scroll = s_list.scroll;
+        dragging = false;
+        return;
+    }
+    if (code == LV_EVENT_PRESSING) {
+        lv_point_t now; lv_indev_get_point(lv_indev_active(), &now);
+        int dx = now.x - press_start.x;
+        int dy = now.y - press_start.y;
+        if (!dragging) {
+            if (abs(dx) < 10 || abs(dx) <= abs(dy)) return;
+            dragging = true;
         }
-        return;*/
+        vlist_scroll_to(&s_list, drag_start_scroll - dx);
+        layout_kick();
+        return;
+    }
+    if (code == LV_EVENT_RELEASED || code == LV_EVENT_PRESS_LOST) {
+        lv_point_t now; lv_indev_get_point(lv_indev_active(), &now);
+        int dx = now.x - press_start.x;
+        int target = active_idx;
+        if (dragging && dx <= -30 && active_idx + 1 < notif_total()) target = active_idx + 1;
+        if (dragging && dx >= 30 && active_idx > 0) target = active_idx - 1;
+        // Also lands an interrupted snap
+        if (dragging || s_list.scroll != active_idx * s_list.pitch) snap_to(target);
+        dragging = false;
+        return;
     }
     if (code == LV_EVENT_LONG_PRESSED) {
-        if (!notif_is_animating && notif_count > 0) {
+        if (!dragging && notif_total() > 0) {
             lv_indev_wait_release(lv_indev_active());
             delete_notification_at(active_idx);
         }
         return;
     }
-    if (code == LV_EVENT_PRESSED) {
-        lv_indev_get_point(lv_indev_active(), &press_start);
-        return;
+}
+
+static void* psram_calloc(size_t n, size_t size)
+{
+    void* p = heap_caps_calloc(n, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : calloc(n, size);
+}
+
+// Mount the persistent store; falls back to a RAM log (lost on reboot)
+// when the SPIFFS file can't be used
+static bool notif_store_open(void)
+{
+    s_store = psram_calloc(1, sizeof(notif_store_t));
+    s_body = psram_calloc(1, NOTIF_MESSAGE_MAX);
+    if (!s_store || !s_body) {
+        ESP_LOGE(TAG, "No memory for notification store");
+        free(s_store);
+        free(s_body);
+        s_store = NULL;
+        s_body = NULL;
+        return false;
     }
-    if (code == LV_EVENT_RELEASED) {
-        lv_point_t now; lv_indev_get_point(lv_indev_active(), &now);
-        int dx = now.x - press_start.x;
-        if (!notif_is_animating) {
-            if (dx <= -30) { // swipe left
-                if (active_idx + 1 < notif_count) {
-                    start_slide_to(active_idx + 1, +1);
-                }
-            } else if (dx >= 30) { // swipe right
-                if (active_idx > 0) {
-                    start_slide_to(active_idx - 1, -1);
-                }
-            }
-        }
-        return;
+
+    if (notif_store_file_io(&s_store_io, NOTIF_STORE_FILE_PATH, NOTIF_STORE_FILE_SIZE) &&
+        notif_store_mount(s_store, &s_store_io)) {
+        ESP_LOGI(TAG, "Notification store: %u items, %u records replayed",
+                 notif_store_count(s_store), (unsigned)s_store->stats.replayed);
+        return true;
+    }
+
+    ESP_LOGW(TAG, "Notification store not persistent, using RAM");
+    s_store_ram = psram_calloc(1, 2 * NOTIF_STORE_BLOCK);
+    if (s_store_ram) {
+        notif_store_mem_io(&s_store_io, s_store_ram, 2 * NOTIF_STORE_BLOCK);
+        if (notif_store_mount(s_store, &s_store_io)) return true;
     }
+    free(s_store_ram);
+    free(s_store);
+    free(s_body);
+    s_store_ram = NULL;
+    s_store = NULL;
+    s_body = NULL;
+    return false;
 }
 
 void notifications_screen_create(lv_obj_t* parent)
 {
+    if (!s_store && !notif_store_open()) {
+        return;
+    }
+    app_registry_init();
 
     static lv_style_t cmain_style;
 
@@ -474,22 +567,23 @@ void notifications_screen_create(lv_obj_t* parent)
     lv_style_set_bg_color(&cmain_style, lv_color_hex(0x000000));
     lv_style_set_bg_opa(&cmain_style, LV_OPA_100);
 
-    // Root container (no scroll)
+    // Root container (no scroll: vlist places the cards)
     notification_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(notification_screen);
     lv_obj_set_size(notification_screen, lv_pct(100), lv_pct(100));
     lv_obj_clear_flag(notification_screen, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_add_style(notification_screen, &cmain_style, 0);
 
-    // Build one reusable card and enable swipe/press events on container
-    // Listen to all events here; the handler filters by code.    
+    // Listen to all events here; the handler filters by code.
     lv_obj_add_flag(notification_screen, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
-    build_single_card(notification_screen);
 
-    // Ensure gestures on the card bubble up to the container (where handler is attached)
-    if (card) {
-        lv_obj_add_flag(card, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
+    // One card per screen width
+    int32_t width = lv_display_get_horizontal_resolution(lv_display_get_default());
+    if (!vlist_init(&s_list, NOTIF_CARDS, width, NOTIF_CARD_GAP, width)) {
+        ESP_LOGE(TAG, "Card pool too small for %d px", (int)width);
+        return;
     }
+    for (int i = 0; i < NOTIF_CARDS; ++i) build_card(notification_screen, &s_cards[i], width);
 
     // Pager indicator at bottom-center (dots with active highlight)
     pager_cont = lv_obj_create(notification_screen);
@@ -501,10 +595,17 @@ void notifications_screen_create(lv_obj_t* parent)
     lv_obj_set_style_pad_all(pager_cont, 0, 0);
     lv_obj_set_style_pad_row(pager_cont, 0, 0);
     lv_obj_set_style_pad_column(pager_cont, 8, 0); // gap between dots
-    for (int i = 0; i < MAX_NOTIFICATIONS; ++i) pager_dots[i] = NULL;
+    for (int i = 0; i < PAGER_DOTS; ++i) pager_dots[i] = NULL;
     lv_obj_add_flag(pager_cont, LV_OBJ_FLAG_HIDDEN);
 
     lv_obj_add_event_cb(notification_screen, gesture_event_cb, LV_EVENT_ALL, NULL);
+
+    s_layout_timer = lv_timer_create(layout_timer_cb, LV_DEF_REFR_PERIOD, NULL);
+    lv_timer_pause(s_layout_timer);
+
+    // Notifications kept from before the reboot
+    active_idx = 0;
+    list_reset();
 }
 
 lv_obj_t* notifications_screen_get(void)
@@ -522,50 +623,18 @@ void notifications_show(const char* app,
                         const char* message,
                         const char* timestamp_iso8601)
 {
-    if (!notification_screen) return;
+    if (!notification_screen || !s_store || !s_list.pool) return;
     if (!title && !message) return; // ignore empty
 
-    // Shift older items down
-    if (notif_count < MAX_NOTIFICATIONS) notif_count++;
-    for (int i = notif_count - 1; i > 0; --i) {
-        notif_buf[i] = notif_buf[i - 1];
+    // Repeated pushes of the same notification are ignored by the store
+    bool dup = false;
+    if (notif_store_add(s_store, app, title, message, timestamp_iso8601, &dup) == NOTIF_ID_NONE) {
+        ESP_LOGW(TAG, "Notification not stored");
+        return;
     }
-
-    // Copy new item into slot 0
-    #define CPY(dst, src) do { \
-        const char* s_ = (src) ? (src) : ""; \
-        strncpy((dst), s_, sizeof(dst) - 1); \
-        (dst)[sizeof(dst) - 1] = '\0'; \
-    } while (0)
-
-    CPY(notif_buf[0].app, app);
-    CPY(notif_buf[0].title, title);
-    CPY(notif_buf[0].message, message);
-    CPY(notif_buf[0].ts_iso, timestamp_iso8601);
+    if (dup) return;
 
     // Jump to latest
     active_idx = 0;
-    update_card_content(active_idx);
-    update_pager(active_idx);
-
-    // Subtle entrance animation for the newest card
-    /*if (card) {
-        // Start with slight offset + fade
-        lv_obj_set_style_translate_y(card, 16, 0);
-        lv_obj_set_style_opa(card, 0, 0);
-
-        lv_anim_t a1; lv_anim_init(&a1);
-        lv_anim_set_var(&a1, card);
-        lv_anim_set_values(&a1, 16, 0);
-        lv_anim_set_time(&a1, 180);
-        lv_anim_set_exec_cb(&a1, notif_anim_set_y);
-        lv_anim_start(&a1);
-
-        lv_anim_t a2; lv_anim_init(&a2);
-        lv_anim_set_var(&a2, card);
-        lv_anim_set_values(&a2, 0, 255);
-        lv_anim_set_time(&a2, 220);
-        lv_anim_set_exec_cb(&a2, notif_anim_set_opa);
-        lv_anim_start(&a2);
-    }*/
+    list_reset();
 }
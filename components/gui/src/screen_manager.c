@@ -0,0 +1,237 @@
+#include "screen_manager.h"
+#include "draw_screen.h"
+#include "magic_trick_screen.h"
+#include "steps_screen.h"
+#include "batt_screen.h"
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+static const char* TAG = "SCREEN_MGR";
+
+// Delay before trimming hidden screens, long enough for the 300 ms load
+// animation in load_screen() to finish with the outgoing screen.
+#define TRIM_DELAY_MS 500
+#define MAX_TILE_STATS 8
+
+static const screen_desc_t* const k_screens[SCREEN_ID_COUNT] = {
+    [SCREEN_ID_DRAW]        = &draw_screen_desc,
+    [SCREEN_ID_MAGIC_TRICK] = &magic_trick_screen_desc,
+    [SCREEN_ID_STEPS]       = &steps_screen_desc,
+    [SCREEN_ID_BATTERY]     = &batt_screen_desc,
+};
+
+typedef struct {
+    lv_obj_t* root;
+    bool visible;
+    uint32_t last_used;     // LRU stamp, higher = more recent
+    size_t bytes;           // heap cost measured when built
+    uint32_t opens;
+    uint32_t loads;         // opens that reached LV_EVENT_SCREEN_LOAD_START
+    uint32_t builds;
+    uint32_t evictions;
+    int64_t open_start_us;  // pending open, 0 when none
+    uint32_t last_open_us;
+    uint64_t total_open_us;
+} screen_slot_t;
+
+typedef struct {
+    const char* name;
+    uint32_t opens;
+    uint32_t last_open_us;
+    size_t bytes;
+} tile_stat_t;
+
+static screen_slot_t s_slots[SCREEN_ID_COUNT];
+static tile_stat_t s_tiles[MAX_TILE_STATS];
+static uint32_t s_lru_clock = 0;
+static lv_timer_t* s_trim_timer = NULL;
+
+static size_t heap_free_now(void)
+{
+    return heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
+static void screen_root_event_cb(lv_event_t* e)
+{
+    screen_id_t id = (screen_id_t)(uintptr_t)lv_event_get_user_data(e);
+    screen_slot_t* s = &s_slots[id];
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_SCREEN_LOAD_START) {
+        if (s->open_start_us) {
+            s->last_open_us = (uint32_t)(esp_timer_get_time() - s->open_start_us);
+            s->total_open_us += s->last_open_us;
+            s->loads++;
+            s->open_start_us = 0;
+        }
+    } else if (code == LV_EVENT_DELETE) {
+        // Deleted by the manager or by the module itself
+        s->root = NULL;
+        s->visible = false;
+        s->bytes = 0;
+    }
+}
+
+static void evict(screen_id_t id)
+{
+    screen_slot_t* s = &s_slots[id];
+    if (!s->root || s->visible || s->root == lv_screen_active()) return;
+
+    ESP_LOGI(TAG, "Evicting %s (%u bytes)", k_screens[id]->name, (unsigned)s->bytes);
+    s->evictions++;
+    lv_obj_delete(s->root);  // LV_EVENT_DELETE clears the slot
+}
+
+static void trim_hidden(void)
+{
+    for (;;) {
+        int warm = 0;
+        size_t bytes = 0;
+        int lru = -1;
+        for (int i = 0; i < SCREEN_ID_COUNT; ++i) {
+            screen_slot_t* s = &s_slots[i];
+            if (!s->root || s->visible || s->root == lv_screen_active()) continue;
+            warm++;
+            bytes += s->bytes;
+            if (lru < 0 || s->last_used < s_slots[lru].last_used) lru = i;
+        }
+        if (lru < 0) return;
+        if (warm <= SCREEN_MANAGER_MAX_WARM && bytes <= SCREEN_MANAGER_RAM_BUDGET) return;
+        evict((screen_id_t)lru);
+    }
+}
+
+static void trim_timer_cb(lv_timer_t* t)
+{
+    (void)t;
+    s_trim_timer = NULL;  // one-shot, LVGL deletes it after this callback
+    trim_hidden();
+}
+
+static void schedule_trim(void)
+{
+    if (s_trim_timer) {
+        lv_timer_reset(s_trim_timer);
+        return;
+    }
+    s_trim_timer = lv_timer_create(trim_timer_cb, TRIM_DELAY_MS, NULL);
+    if (s_trim_timer) lv_timer_set_repeat_count(s_trim_timer, 1);
+}
+
+lv_obj_t* screen_manager_get(screen_id_t id)
+{
+    if (id >= SCREEN_ID_COUNT) return NULL;
+    screen_slot_t* s = &s_slots[id];
+    const screen_desc_t* d = k_screens[id];
+
+    s->open_start_us = esp_timer_get_time();
+    s->opens++;
+    s->last_used = ++s_lru_clock;
+
+    if (s->root) return s->root;
+
+    // Make room before building, so the ceiling holds while both exist
+    trim_hidden();
+
+    size_t before = heap_free_now();
+    lv_obj_t* root = d->create ? d->create() : NULL;
+    size_t after = heap_free_now();
+    if (!root) {
+        ESP_LOGE(TAG, "Failed to build %s", d->name);
+        s->open_start_us = 0;
+        return NULL;
+    }
+
+    s->root = root;
+    s->bytes = (before > after) ? (before - after) : 0;
+    s->builds++;
+    lv_obj_add_event_cb(root, screen_root_event_cb, LV_EVENT_SCREEN_LOAD_START, (void*)(uintptr_t)id);
+    lv_obj_add_event_cb(root, screen_root_event_cb, LV_EVENT_DELETE, (void*)(uintptr_t)id);
+
+    ESP_LOGI(TAG, "Built %s in %u us, %u bytes", d->name,
+             (unsigned)(esp_timer_get_time() - s->open_start_us), (unsigned)s->bytes);
+    return root;
+}
+
+void screen_manager_notify_active(lv_obj_t* screen)
+{
+    bool hidden_any = false;
+    for (int i = 0; i < SCREEN_ID_COUNT; ++i) {
+        screen_slot_t* s = &s_slots[i];
+        const screen_desc_t* d = k_screens[i];
+        if (!s->root) continue;
+
+        if (s->root == screen) {
+            s->last_used = ++s_lru_clock;
+            if (!s->visible) {
+                s->visible = true;
+                if (d->on_show) d->on_show();
+            }
+        } else if (s->visible) {
+            s->visible = false;
+            if (d->on_hide) d->on_hide();
+            hidden_any = true;
+        }
+    }
+    if (hidden_any) schedule_trim();
+}
+
+void screen_manager_evict_hidden(void)
+{
+    for (int i = 0; i < SCREEN_ID_COUNT; ++i) {
+        evict((screen_id_t)i);
+    }
+}
+
+void screen_manager_tile_open(const char* name, void (*create)(lv_obj_t*), lv_obj_t* tile)
+{
+    if (!create || !tile) return;
+
+    int64_t t0 = esp_timer_get_time();
+    size_t before = heap_free_now();
+    create(tile);
+    size_t after = heap_free_now();
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+
+    tile_stat_t* st = NULL;
+    for (int i = 0; i < MAX_TILE_STATS; ++i) {
+        if (s_tiles[i].name == NULL || strcmp(s_tiles[i].name, name) == 0) {
+            st = &s_tiles[i];
+            break;
+        }
+    }
+    if (st) {
+        st->name = name;
+        st->opens++;
+        st->last_open_us = dt;
+        st->bytes = (before > after) ? (before - after) : 0;
+    }
+    ESP_LOGI(TAG, "Tile %s built in %u us, %u bytes", name, (unsigned)dt,
+             (unsigned)((before > after) ? (before - after) : 0));
+}
+
+void screen_manager_dump_stats(void)
+{
+    size_t warm_bytes = 0;
+    ESP_LOGI(TAG, "%-12s %-6s %5s %6s %5s %8s %8s %7s", "screen", "state", "opens",
+             "builds", "evict", "last_us", "avg_us", "bytes");
+    for (int i = 0; i < SCREEN_ID_COUNT; ++i) {
+        screen_slot_t* s = &s_slots[i];
+        const char* state = !s->root ? "cold" : (s->visible ? "active" : "warm");
+        uint32_t avg = s->loads ? (uint32_t)(s->total_open_us / s->loads) : 0;
+        if (s->root && !s->visible) warm_bytes += s->bytes;
+        ESP_LOGI(TAG, "%-12s %-6s %5u %6u %5u %8u %8u %7u", k_screens[i]->name, state,
+                 (unsigned)s->opens, (unsigned)s->builds, (unsigned)s->evictions,
+                 (unsigned)s->last_open_us, (unsigned)avg, (unsigned)s->bytes);
+    }
+    for (int i = 0; i < MAX_TILE_STATS && s_tiles[i].name; ++i) {
+        ESP_LOGI(TAG, "tile %-7s %5u opens, last %u us, %u bytes", s_tiles[i].name,
+                 (unsigned)s_tiles[i].opens, (unsigned)s_tiles[i].last_open_us,
+                 (unsigned)s_tiles[i].bytes);
+    }
+    ESP_LOGI(TAG, "Warm hidden: %u / %u bytes", (unsigned)warm_bytes,
+             (unsigned)SCREEN_MANAGER_RAM_BUDGET);
+}
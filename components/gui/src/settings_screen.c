@@ -6,6 +6,8 @@
 #include "setting_flashlight_screen.h"
 #include "esp_log.h"
 #include "settings_menu_screen.h"
+#include "screen_manager.h"
+#include "ui_scheduler.h"
 #include "rtc_lib.h"
 #include "ble_sync.h"
 #include "esp_err.h"
@@ -28,13 +30,14 @@ LV_IMAGE_DECLARE(image_settings_icon);
 
 static void click_event_cb(lv_event_t* e);
 static void toggle_event_cb(lv_event_t* e);
-static void time_timer_cb(lv_timer_t* timer);
+static void pair_now_event_cb(lv_event_t* e);
+static void time_job_cb(void* user);
 static void update_time_label(void);
 static void control_screen_on_delete(lv_event_t* e);
 
 static lv_obj_t* control_screen;
 static lv_obj_t* time_label;
-static lv_timer_t* time_timer;
+static ui_sched_job_t* time_job;
 
 static const lv_image_dsc_t* control_icons[] = {
     &image_brightness_icon,
@@ -71,23 +74,16 @@ static void update_time_label(void)
     lv_label_set_text_fmt(time_label, "%02d:%02d", rtc_get_hour(), rtc_get_minute());
 }
 
-static void time_timer_cb(lv_timer_t* timer)
+static void time_job_cb(void* user)
 {
-    (void)timer;
-    bool locked = bsp_display_lock(0);
+    (void)user;
     update_time_label();
-    if (locked) {
-        bsp_display_unlock();
-    }
 }
 
 static void control_screen_on_delete(lv_event_t* e)
 {
     (void)e;
-    if (time_timer) {
-        lv_timer_del(time_timer);
-        time_timer = NULL;
-    }
+    time_job = NULL;  // removed by the scheduler with its owner
     time_label = NULL;
     control_screen = NULL;
 }
@@ -105,9 +101,7 @@ static void screen_events(lv_event_t* e)
     }
     else if (lv_event_get_code(e) == LV_EVENT_SCREEN_LOADED) {
         update_time_label();
-        if (time_timer) {
-            lv_timer_ready(time_timer);
-        }
+        ui_sched_trigger(time_job);
     }
 }
 
@@ -198,6 +192,8 @@ void control_screen_create(lv_obj_t* parent)
                 }
             }
             if (i == CTRL_BLUETOOTH) {
+                /* Long press: advertise fast to pair a new host */
+                lv_obj_add_event_cb(item, pair_now_event_cb, LV_EVENT_LONG_PRESSED, NULL);
                 bool ble_on = ble_sync_is_enabled();
                 if (ble_on) {
                     lv_obj_add_state(item, LV_STATE_CHECKED);
@@ -224,10 +220,7 @@ void control_screen_create(lv_obj_t* parent)
     }
 
     update_time_label();
-    if (!time_timer) {
-        time_timer = lv_timer_create(time_timer_cb, 1000, NULL);
-        lv_timer_ready(time_timer);
-    }
+    time_job = ui_sched_add("controls", 1000, control_screen, time_job_cb, NULL);
 }
 
 lv_obj_t* control_screen_get(void)
@@ -251,7 +244,7 @@ static void click_event_cb(lv_event_t* e)
             lv_obj_t* t = ui_dynamic_tile_acquire();
             if (t) {
                 // Create the content into the dynamic tile and switch to it
-                lv_smartwatch_brightness_create(t);
+                screen_manager_tile_open("brightness", lv_smartwatch_brightness_create, t);
                 ui_dynamic_tile_show();
             }
         }
@@ -261,7 +254,7 @@ static void click_event_cb(lv_event_t* e)
         {
             lv_obj_t* t = ui_dynamic_tile_acquire();
             if (t) {
-                lv_smartwatch_batt_create(t);
+                screen_manager_tile_open("battery", lv_smartwatch_batt_create, t);
                 ui_dynamic_tile_show();
             }
         }
@@ -272,7 +265,7 @@ static void click_event_cb(lv_event_t* e)
         {
             lv_obj_t* t = ui_dynamic_tile_acquire();
             if (t) {
-                setting_flashlight_screen_create(t);
+                screen_manager_tile_open("flashlight", setting_flashlight_screen_create, t);
                 ui_dynamic_tile_show();
             }
         }
@@ -283,7 +276,7 @@ static void click_event_cb(lv_event_t* e)
         {
             lv_obj_t* t = ui_dynamic_tile_acquire();
             if (t) {
-                settings_menu_screen_create(t);
+                screen_manager_tile_open("settings", settings_menu_screen_create, t);
                 ui_dynamic_tile_show();
             }
         }
@@ -325,4 +318,15 @@ static void toggle_event_cb(lv_event_t* e)
     }
 }
 
+static void pair_now_event_cb(lv_event_t* e)
+{
+    (void)e;
+    /* Don't let the release toggle Bluetooth */
+    lv_indev_wait_release(lv_indev_active());
+    esp_err_t err = ble_sync_pair_now();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Pair now: %s", esp_err_to_name(err));
+    }
+}
+
 /* Scroll callback removed: screen is static and non-scrollable */
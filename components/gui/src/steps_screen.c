@@ -1,5 +1,6 @@
 #include "lvgl.h"
 #include "steps_screen.h"
+#include "ui_scheduler.h"
 #include "sensors.h"
 #include "ui_fonts.h"
 #include "settings.h"
@@ -17,17 +18,16 @@ static lv_obj_t* s_ticks[4] = { 0 };
 
 static lv_obj_t* s_icon_left = NULL;
 //static lv_obj_t* s_icon_right = NULL;
-static lv_timer_t* s_timer = NULL;
 static uint32_t s_goal_steps = 8000;
 
 LV_IMAGE_DECLARE(image_walk_48);
 
 static void screen_events(lv_event_t* e);
+static void on_delete(lv_event_t* e);
 
-static void steps_timer_cb(lv_timer_t* t)
+static void steps_job_cb(void* user)
 {
-    LV_UNUSED(t);
-    bsp_display_lock(0);
+    LV_UNUSED(user);
     //if (active_screen_get() == step_screen) {
         //if (!s_value_label) return;
         // Refresh goal from settings if changed
@@ -64,8 +64,6 @@ static void steps_timer_cb(lv_timer_t* t)
             lv_label_set_text(s_activity_label, text);
         }
     //}
-
-    bsp_display_unlock();
 }
 
 void steps_screen_create(lv_obj_t* parent)
@@ -166,12 +164,39 @@ void steps_screen_create(lv_obj_t* parent)
         lv_obj_align_to(s_ticks[i], s_bar, LV_ALIGN_LEFT_MID, x, 0);
     }
 
-    s_timer = lv_timer_create(steps_timer_cb, 5000, NULL);
-    lv_timer_ready(s_timer);
+    // Refreshed only while visible; removed with the screen
+    ui_sched_add("steps", 5000, step_screen, steps_job_cb, NULL);
 
+    lv_obj_add_event_cb(step_screen, on_delete, LV_EVENT_DELETE, NULL);
     //lv_obj_add_event_cb(step_screen, screen_events, LV_EVENT_GESTURE, NULL);
 }
 
+static void on_delete(lv_event_t* e)
+{
+    LV_UNUSED(e);
+    step_screen = NULL;
+    s_value_label = NULL;
+    s_goal_label = NULL;
+    s_activity_label = NULL;
+    s_bar = NULL;
+    s_icon_left = NULL;
+    for (int i = 0; i < 4; ++i) s_ticks[i] = NULL;
+}
+
+static lv_obj_t* steps_screen_build(void)
+{
+    // Standalone screen, owned by the screen manager
+    steps_screen_create(NULL);
+    return step_screen;
+}
+
+const screen_desc_t steps_screen_desc = {
+    .name = "steps",
+    .create = steps_screen_build,
+    .on_show = NULL,
+    .on_hide = NULL,
+};
+
 static void screen_events(lv_event_t* e)
 {
     if (lv_event_get_code(e) == LV_EVENT_GESTURE) {
@@ -188,11 +213,7 @@ static void screen_events(lv_event_t* e)
 
 lv_obj_t* steps_screen_get(void)
 {
-    if (step_screen == NULL) {
-        // Create as a standalone screen if not yet created
-        steps_screen_create(NULL);
-    }
-    return step_screen;
+    return screen_manager_get(SCREEN_ID_STEPS);
 }
 
 void steps_screen_set_goal(uint32_t goal_steps)
@@ -9,6 +9,8 @@
 #include "freertos/task.h"
 #include "lvgl.h"
 #include "notifications.h"
+#include "screen_manager.h"
+#include "ui_scheduler.h"
 #include "sensors.h"
 #include "settings_screen.h"
 #include "steps_screen.h"
@@ -19,7 +21,8 @@
 #include "bsp_power.h"
 
 #include "batt_screen.h"
-#include "driver/gpio.h"
+#include "input_service.h"
+#include "power_manager.h"
 #include "lvgl_spiffs_fs.h"
 
 static const char* TAG = "UI";
@@ -69,6 +72,8 @@ void load_screen(lv_obj_t* current_screen, lv_obj_t* next_screen,
     // bsp_display_lock(0);
     bsp_display_lock(300);
     lv_screen_load_anim(next_screen, anim, 300, 0, false);
+    screen_manager_notify_active(next_screen);
+    ui_sched_refresh();
     bsp_display_unlock();
     active_screen = next_screen;
     // bsp_display_unlock();
@@ -113,9 +118,23 @@ void swatch_tileview(void)
 
 static void tileview_change_cb(lv_event_t* e)
 {
+  static bool s_scroll_boost = false;
+  lv_event_code_t code = lv_event_get_code(e);
+
+  // Full clock for the drag + snap animation only
+  if (code == LV_EVENT_SCROLL_BEGIN && !s_scroll_boost) {
+    power_manager_boost_begin(PM_BOOST_UI_ANIM);
+    s_scroll_boost = true;
+  } else if (code == LV_EVENT_SCROLL_END && s_scroll_boost) {
+    power_manager_boost_end(PM_BOOST_UI_ANIM);
+    s_scroll_boost = false;
+  }
+
+  if (code != LV_EVENT_VALUE_CHANGED) return;
+
+  // Jobs of the tile that left / entered the screen
+  ui_sched_refresh();
 
-  if (lv_event_get_code(e) != LV_EVENT_VALUE_CHANGED) return;
-  
   lv_obj_t* act = lv_tileview_get_tile_active(main_screen);
   // Delete level-2 if not active
   if (dynamic_subtile && act != dynamic_subtile) {
@@ -261,6 +280,8 @@ void ui_show_messages_tile(void) {
 void ui_init(void) {
   bsp_display_lock(0);
 
+  ui_sched_init();
+
   init_theme();
 
   // Register LVGL FS driver for SPIFFS before any file-based widgets
@@ -280,11 +301,8 @@ void ui_init(void) {
   bsp_display_unlock();
 }
 
-// Hardware back button (GPIO0) handler
-#define UI_BACK_BTN GPIO_NUM_0
-
-static void ui_handle_back_async(void* user) {
-  (void)user;
+// Back action: BOOT key (GPIO0) press or PMIC power key short press
+static void ui_handle_back(void) {
 
   if (active_screen_get() != get_main_screen()) {
     load_screen(NULL, get_main_screen(), LV_SCR_LOAD_ANIM_OVER_TOP);
@@ -304,47 +322,23 @@ static void ui_handle_back_async(void* user) {
   }
 }
 
-static void ui_back_btn_task(void* arg) {
-  (void)arg;
-  // Configure GPIO0 as input with pull-up
-  gpio_config_t io = {
-      .pin_bit_mask = 1ULL << UI_BACK_BTN,
-      .mode = GPIO_MODE_INPUT,
-      .pull_up_en = GPIO_PULLUP_ENABLE,
-      .pull_down_en = GPIO_PULLDOWN_DISABLE,
-      .intr_type = GPIO_INTR_DISABLE,
-  };
-  (void)gpio_config(&io);
-  int idle =
-    gpio_get_level(UI_BACK_BTN); // consider this the idle (unpressed) level
-  int prev = idle;
-  TickType_t last_press = 0;
-  const TickType_t debounce = pdMS_TO_TICKS(120);
-  TickType_t last = xTaskGetTickCount();
-  for (;;) {
-    int lvl = gpio_get_level(UI_BACK_BTN);
-    if (prev != lvl) {
-      prev = lvl;
-      // Treat a press as a transition away from idle level (works for
-      // active-low or active-high)
-      if (lvl != idle) {
-        TickType_t now = xTaskGetTickCount();
-        if (now - last_press > debounce) {
-          last_press = now;
-          // Dispatch back action on LVGL thread
-          lv_async_call(ui_handle_back_async, NULL);
-        }
-      }
-    }
-    // When screen is ON, allow PMU power button short-press to act as Back.
-    // Do NOT consume it when screen is OFF to preserve wake behavior.
-    if (display_manager_is_on()) {
-      if (bsp_power_poll_pwr_button_short()) {
-        lv_async_call(ui_handle_back_async, NULL);
-      }
-    }
-    vTaskDelayUntil(&last, pdMS_TO_TICKS(20));
-  }
+// Input service events. Presses that wake the display arrive as
+// INPUT_EVT_WAKE and are handled by the display manager, not here.
+static void input_ui_evt(void* handler_arg, esp_event_base_t base, int32_t id,
+  void* event_data) {
+  (void)handler_arg;
+  (void)base;
+  const input_event_t* ev = (const input_event_t*)event_data;
+  if (!ev) return;
+
+  // BOOT acts on the press edge for the lowest latency, as before
+  bool back = (ev->button == INPUT_BTN_BOOT && id == INPUT_EVT_PRESS) ||
+              (ev->button == INPUT_BTN_PWR && id == INPUT_EVT_SHORT);
+  if (!back) return;
+
+  bsp_display_lock(0);
+  ui_handle_back();
+  bsp_display_unlock();
 }
 
 // Callback de eventos de energia (file-scope, não aninhada)
@@ -376,17 +370,20 @@ static void ble_ui_evt(void* handler_arg, esp_event_base_t base, int32_t id,
   //}
 }
 
-// Timer callback: periodic power refresh
-static void power_poll_cb(lv_timer_t* t) {
-  (void)t;
+// Scheduler job: periodic power refresh while the watchface is shown
+static void power_poll_cb(void* user) {
+  (void)user;
   bool vbus = bsp_power_is_vbus_in();
   bool chg = bsp_power_is_charging();
   int pct = bsp_power_get_battery_percent();
-  //if (bsp_display_lock(10)) {
-  bsp_display_lock(0);
   watchface_set_power_state(vbus, chg, pct);
+}
+
+// Display on/off: suspend all UI jobs while the panel is dark
+static void ui_display_state_cb(bool on) {
+  bsp_display_lock(0);
+  ui_sched_set_display_on(on);
   bsp_display_unlock();
-  //}
 }
 
 void ui_task(void* pvParameters) {
@@ -403,15 +400,17 @@ void ui_task(void* pvParameters) {
   esp_event_handler_register(BLE_SYNC_EVENT_BASE, ESP_EVENT_ANY_ID, ble_ui_evt,
     NULL);
 
-  // Start back button poller with a higher priority for snappier input
-  xTaskCreate(ui_back_btn_task, "ui_back_btn", 2048, NULL, 5, NULL);
+  // Back button, driven by GPIO / PMIC interrupts
+  esp_event_handler_register(INPUT_EVENT_BASE, ESP_EVENT_ANY_ID, input_ui_evt,
+    NULL);
 
-  // Periodic fallback: refresh power state every 5s in case no events fire
-  lv_timer_t* t = lv_timer_create(power_poll_cb, 5000, NULL);
-  // Trigger once immediately to avoid initial 0%
-  lv_timer_ready(t);
+  // Periodic fallback: refresh power state every 5s in case no events fire.
+  // Runs once right away to avoid the initial 0%.
+  bsp_display_lock(0);
+  ui_sched_add("power", 5000, tile2, power_poll_cb, NULL);
+  bsp_display_unlock();
+  display_manager_set_state_cb(ui_display_state_cb);
 
-  while (1) {
-    vTaskDelay(pdMS_TO_TICKS(500));
-  }
+  // Everything else runs from LVGL timers and events; nothing left to do here
+  vTaskDelete(NULL);
 }
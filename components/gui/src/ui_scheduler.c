@@ -0,0 +1,255 @@
+#include "ui_scheduler.h"
+
+#include "esp_log.h"
+#include <string.h>
+
+static const char* TAG = "UI_SCHED";
+
+// Delay before re-evaluating visibility, so a screen load animation has
+// already switched the active screen when the jobs are checked.
+#define REFRESH_DELAY_MS 20
+
+struct ui_sched_job {
+    const char* name;
+    uint32_t period_ms;
+    lv_obj_t* owner;
+    ui_sched_cb_t cb;
+    void* user;
+    uint32_t next_due;      // lv_tick deadline, aligned to period_ms
+    bool used;
+    bool visible;           // owner was on screen at the last evaluation
+    bool pending;           // run on next wakeup regardless of deadline
+    uint32_t runs;
+    uint32_t skipped;
+};
+
+static ui_sched_job_t s_jobs[UI_SCHED_MAX_JOBS];
+static lv_timer_t* s_timer = NULL;
+static bool s_paused = true;
+static uint32_t s_armed_at = 0;     // lv_tick when the timer was last armed
+static uint32_t s_armed_ms = 0;     // period it was armed with
+static bool s_display_on = true;
+static uint32_t s_wakeups = 0;
+static uint32_t s_start_tick = 0;
+
+static inline bool tick_reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+// First multiple of period strictly after t
+static inline uint32_t align_next(uint32_t t, uint32_t period)
+{
+    return (t / period + 1) * period;
+}
+
+static bool owner_visible(lv_obj_t* owner)
+{
+    if (!owner) return true;
+    if (lv_obj_get_screen(owner) != lv_screen_active()) return false;
+
+    for (lv_obj_t* o = owner; o; o = lv_obj_get_parent(o)) {
+        if (lv_obj_has_flag(o, LV_OBJ_FLAG_HIDDEN)) return false;
+        lv_obj_t* p = lv_obj_get_parent(o);
+        if (p && lv_obj_check_type(p, &lv_tileview_class) &&
+            lv_tileview_get_tile_active(p) != o) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Account the periods a hidden job did not run, as an independent timer
+// would have fired for each of them.
+static void account_hidden(ui_sched_job_t* j, uint32_t now)
+{
+    if (tick_reached(now, j->next_due)) {
+        j->skipped += (now - j->next_due) / j->period_ms + 1;
+        j->next_due = align_next(now, j->period_ms);
+    }
+}
+
+static void arm(uint32_t ms)
+{
+    s_armed_at = lv_tick_get();
+    s_armed_ms = ms;
+    s_paused = false;
+    lv_timer_set_period(s_timer, ms);
+    lv_timer_reset(s_timer);
+    lv_timer_resume(s_timer);
+}
+
+static void run_and_rearm(void)
+{
+    uint32_t now = lv_tick_get();
+
+    for (int i = 0; i < UI_SCHED_MAX_JOBS; ++i) {
+        ui_sched_job_t* j = &s_jobs[i];
+        if (!j->used) continue;
+
+        if (!s_display_on || !owner_visible(j->owner)) {
+            account_hidden(j, now);
+            j->visible = false;
+            continue;
+        }
+
+        bool shown = !j->visible;
+        j->visible = true;
+        if (shown || j->pending || tick_reached(now + UI_SCHED_SLACK_MS, j->next_due)) {
+            j->pending = false;
+            j->next_due = align_next(now + UI_SCHED_SLACK_MS, j->period_ms);
+            j->runs++;
+            j->cb(j->user);  // may add/remove jobs or delete the owner
+        }
+    }
+
+    // Sleep until the earliest deadline of a visible job
+    now = lv_tick_get();
+    int32_t wait = INT32_MAX;
+    for (int i = 0; i < UI_SCHED_MAX_JOBS; ++i) {
+        ui_sched_job_t* j = &s_jobs[i];
+        if (!j->used || !j->visible) continue;
+        int32_t d = j->pending ? 0 : (int32_t)(j->next_due - now);
+        if (d < wait) wait = d;
+    }
+
+    if (wait == INT32_MAX) {
+        lv_timer_pause(s_timer);
+        s_paused = true;
+        return;
+    }
+    arm(wait > 1 ? (uint32_t)wait : 1);
+}
+
+static void sched_timer_cb(lv_timer_t* t)
+{
+    (void)t;
+    s_wakeups++;
+    run_and_rearm();
+}
+
+static void schedule_refresh(uint32_t delay_ms)
+{
+    if (!s_timer) return;
+    if (!s_paused) {
+        uint32_t elapsed = lv_tick_elaps(s_armed_at);
+        if (elapsed < s_armed_ms && s_armed_ms - elapsed <= delay_ms) return;  // already sooner
+    }
+    arm(delay_ms ? delay_ms : 1);
+}
+
+static void owner_delete_cb(lv_event_t* e)
+{
+    ui_sched_job_t* j = (ui_sched_job_t*)lv_event_get_user_data(e);
+    if (j->used && j->owner == lv_event_get_current_target_obj(e)) {
+        ESP_LOGD(TAG, "Owner of %s deleted", j->name);
+        memset(j, 0, sizeof(*j));
+    }
+}
+
+void ui_sched_init(void)
+{
+    if (s_timer) return;
+    s_start_tick = lv_tick_get();
+    s_timer = lv_timer_create(sched_timer_cb, 1000, NULL);
+    lv_timer_pause(s_timer);
+}
+
+ui_sched_job_t* ui_sched_add(const char* name, uint32_t period_ms, lv_obj_t* owner,
+                             ui_sched_cb_t cb, void* user)
+{
+    if (!cb || period_ms == 0) return NULL;
+    if (!s_timer) ui_sched_init();
+
+    ui_sched_job_t* j = NULL;
+    for (int i = 0; i < UI_SCHED_MAX_JOBS; ++i) {
+        if (!s_jobs[i].used) {
+            j = &s_jobs[i];
+            break;
+        }
+    }
+    if (!j) {
+        ESP_LOGE(TAG, "No free slot for %s", name ? name : "?");
+        return NULL;
+    }
+
+    memset(j, 0, sizeof(*j));
+    j->name = name ? name : "?";
+    j->period_ms = period_ms;
+    j->owner = owner;
+    j->cb = cb;
+    j->user = user;
+    j->next_due = align_next(lv_tick_get(), period_ms);
+    j->pending = true;
+    j->used = true;
+    if (owner) {
+        lv_obj_add_event_cb(owner, owner_delete_cb, LV_EVENT_DELETE, j);
+    }
+
+    schedule_refresh(0);
+    return j;
+}
+
+void ui_sched_remove(ui_sched_job_t* job)
+{
+    if (!job || !job->used) return;
+    if (job->owner) {
+        lv_obj_remove_event_cb_with_user_data(job->owner, owner_delete_cb, job);
+    }
+    memset(job, 0, sizeof(*job));
+}
+
+void ui_sched_trigger(ui_sched_job_t* job)
+{
+    if (!job || !job->used) return;
+    job->pending = true;
+    schedule_refresh(0);
+}
+
+void ui_sched_refresh(void)
+{
+    schedule_refresh(REFRESH_DELAY_MS);
+}
+
+void ui_sched_set_display_on(bool on)
+{
+    if (s_display_on == on) return;
+    s_display_on = on;
+    ESP_LOGD(TAG, "Display %s", on ? "on" : "off");
+    // Off: the next evaluation finds nothing visible and pauses the timer
+    schedule_refresh(on ? 0 : REFRESH_DELAY_MS);
+}
+
+void ui_sched_get_stats(ui_sched_stats_t* out)
+{
+    if (!out) return;
+    uint32_t now = lv_tick_get();
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < UI_SCHED_MAX_JOBS; ++i) {
+        ui_sched_job_t* j = &s_jobs[i];
+        if (!j->used) continue;
+        if (!j->visible) account_hidden(j, now);
+        out->runs += j->runs;
+        out->skipped += j->skipped;
+    }
+    out->wakeups = s_wakeups;
+    out->legacy_wakeups = out->runs + out->skipped;
+    out->uptime_ms = now - s_start_tick;
+}
+
+void ui_sched_dump_stats(void)
+{
+    ui_sched_stats_t st;
+    ui_sched_get_stats(&st);
+
+    ESP_LOGI(TAG, "%-12s %6s %6s %6s %s", "job", "period", "runs", "skip", "state");
+    for (int i = 0; i < UI_SCHED_MAX_JOBS; ++i) {
+        ui_sched_job_t* j = &s_jobs[i];
+        if (!j->used) continue;
+        ESP_LOGI(TAG, "%-12s %6u %6u %6u %s", j->name, (unsigned)j->period_ms,
+                 (unsigned)j->runs, (unsigned)j->skipped, j->visible ? "visible" : "hidden");
+    }
+    ESP_LOGI(TAG, "Wakeups: %u scheduler vs %u with one timer per job (%u runs) in %u s",
+             (unsigned)st.wakeups, (unsigned)st.legacy_wakeups, (unsigned)st.runs,
+             (unsigned)(st.uptime_ms / 1000));
+}
@@ -8,6 +8,7 @@
 #include "ble_hid_combined.h"  // 🎯 Para verificar estado HID
 
 #include "ui.h"
+#include "ui_scheduler.h"
 #include "steps_screen.h"
 #include "settings_screen.h"
 #include "notifications.h"
@@ -27,17 +28,15 @@ static lv_obj_t* img_battery;
 static lv_obj_t* lbl_batt_pct;
 static lv_obj_t* lbl_charge_icon;
 static lv_obj_t* img_ble;
-static lv_timer_t* s_timer = NULL;
 
 static void screen_events(lv_event_t* e);
-static void update_time_task(lv_timer_t* timer);
+static void update_time_task(void* user);
 
 /* ==================== RELOJ ==================== */
 
-static void update_time_task(lv_timer_t* timer)
+static void update_time_task(void* user)
 {
-    (void)timer;
-    bsp_display_lock(0);
+    (void)user;
 
     if (label_hour) {
         lv_label_set_text_fmt(label_hour, "%02d", rtc_get_hour());
@@ -61,8 +60,6 @@ static void update_time_task(lv_timer_t* timer)
         lv_color_t col = hid_connected ? lv_color_hex(0x3B82F6) : lv_color_hex(0x606060);
         lv_obj_set_style_img_recolor(img_ble, col, 0);
     }
-
-    bsp_display_unlock();
 }
 
 void watchface_create(lv_obj_t* parent)
@@ -156,8 +153,8 @@ void watchface_create(lv_obj_t* parent)
     lv_obj_set_style_img_recolor_opa(img_ble, LV_OPA_COVER, 0);
     lv_obj_set_style_img_recolor(img_ble, lv_color_hex(0x606060), 0); // default grey
 
-    s_timer = lv_timer_create(update_time_task, 1000, NULL);
-    lv_timer_ready(s_timer);
+    // Reloj: sólo mientras el watchface está en pantalla
+    ui_sched_add("watchface", 1000, watchface_screen, update_time_task, NULL);
 
     // Eventos de gesto / toque
     lv_obj_add_event_cb(watchface_screen, screen_events, LV_EVENT_ALL, NULL);
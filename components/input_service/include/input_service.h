@@ -0,0 +1,69 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_event.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interrupt-driven buttons: the BOOT key (GPIO0) and the PMIC power key
+// (AXP2101 IRQ line). Changes are debounced in a one-shot esp_timer and the
+// classified presses are posted on the default event loop, so nothing polls
+// while the buttons are idle. Both pins are also light-sleep wake sources.
+// Where the PMIC IRQ line can't be used the power key is polled, and only
+// while the display is on; while the PMIC read is a stub
+// (BSP_POWER_HAS_PWR_BUTTON 0) the power key is not available at all.
+
+ESP_EVENT_DECLARE_BASE(INPUT_EVENT_BASE);
+
+typedef enum {
+    INPUT_BTN_BOOT = 0,  // GPIO0, used as Back
+    INPUT_BTN_PWR,       // PMIC power key
+    INPUT_BTN_COUNT
+} input_button_t;
+
+typedef enum {
+    INPUT_EVT_PRESS = 1,   // debounced press edge (lowest latency)
+    INPUT_EVT_SHORT,       // released before the long-press time
+    INPUT_EVT_LONG,        // held for INPUT_LONG_PRESS_MS
+    INPUT_EVT_DOUBLE,      // two short presses within INPUT_DOUBLE_CLICK_MS
+    INPUT_EVT_WAKE,        // any press while the wake filter reports "asleep"
+} input_event_id_t;
+
+// Payload of every INPUT_EVENT_BASE event
+typedef struct {
+    input_button_t button;
+    int64_t edge_us;       // esp_timer time of the first interrupt edge
+    int64_t post_us;       // esp_timer time the event was posted
+} input_event_t;
+
+#ifndef INPUT_DEBOUNCE_MS
+#define INPUT_DEBOUNCE_MS 15
+#endif
+#ifndef INPUT_LONG_PRESS_MS
+#define INPUT_LONG_PRESS_MS 800
+#endif
+#ifndef INPUT_DOUBLE_CLICK_MS
+#define INPUT_DOUBLE_CLICK_MS 250
+#endif
+
+// Configure the GPIO interrupts and timers. Safe to call once the default
+// event loop exists.
+esp_err_t input_service_init(void);
+
+// When set and returning false (e.g. display off), presses are reported as
+// a single INPUT_EVT_WAKE instead of PRESS/SHORT/LONG/DOUBLE, so the press
+// that wakes the watch doesn't also trigger an action.
+void input_service_set_wake_filter(bool (*is_awake)(void));
+
+// The display turned on or off: starts or stops the power key poll (no-op
+// when the key has an IRQ line or is unavailable).
+void input_service_set_awake(bool awake);
+
+// Log event counts and edge-to-post latency per button.
+void input_service_dump_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
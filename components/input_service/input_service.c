@@ -0,0 +1,346 @@
+// Interrupt-driven button input: level ISR -> one-shot debounce timer ->
+// press classification -> esp_event on INPUT_EVENT_BASE.
+//
+// Pins use level interrupts armed for the opposite of the current level
+// (an "edge" built from two levels), because only level triggers can also
+// wake the chip from automatic light sleep (gpio_wakeup_enable).
+
+#include "input_service.h"
+
+#include "bsp_power.h"
+#include "driver/gpio.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+ESP_EVENT_DEFINE_BASE(INPUT_EVENT_BASE);
+
+static const char* TAG = "INPUT";
+
+#define BOOT_BTN_GPIO GPIO_NUM_0
+
+// PMIC IRQ line (AXP2101, open drain, active low)
+#ifndef INPUT_PMIC_IRQ_GPIO
+#ifdef CONFIG_PMU_INTERRUPT_PIN
+#define INPUT_PMIC_IRQ_GPIO CONFIG_PMU_INTERRUPT_PIN
+#else
+#define INPUT_PMIC_IRQ_GPIO -1
+#endif
+#endif
+// Fallback poll period when the IRQ line cannot be used (display on only)
+#ifndef INPUT_PMIC_POLL_MS
+#define INPUT_PMIC_POLL_MS 200
+#endif
+
+#define EVT_SLOTS (INPUT_EVT_WAKE + 1)
+
+typedef struct {
+    const char* name;
+    gpio_num_t gpio;
+    int active_level;
+    esp_timer_handle_t debounce;
+    esp_timer_handle_t hold;
+    esp_timer_handle_t click;
+    volatile int64_t edge_us;   // first edge of the pending debounce window
+    int64_t press_edge_us;      // edge that started the current press
+    bool pressed;
+    bool long_fired;
+    bool swallow;               // press consumed as WAKE, ignore until release
+    uint8_t clicks;
+    // stats
+    uint32_t irqs;
+    uint32_t counts[EVT_SLOTS];
+    uint64_t lat_sum_us;
+    uint32_t lat_max_us;
+    uint32_t lat_n;
+} button_t;
+
+static button_t s_btn[INPUT_BTN_COUNT] = {
+    [INPUT_BTN_BOOT] = { .name = "boot", .gpio = BOOT_BTN_GPIO, .active_level = 0 },
+    [INPUT_BTN_PWR]  = { .name = "pwr",  .gpio = GPIO_NUM_NC,   .active_level = 0 },
+};
+
+static bool (*s_is_awake)(void) = NULL;
+static esp_timer_handle_t s_pmic_timer = NULL;
+static bool s_pmic_polling = false;     // no usable IRQ line: periodic reads
+static bool s_initialized = false;
+
+static void post(input_button_t id, input_event_id_t evt, int64_t edge_us)
+{
+    button_t* b = &s_btn[id];
+    input_event_t ev = {
+        .button = id,
+        .edge_us = edge_us,
+        .post_us = esp_timer_get_time(),
+    };
+    uint32_t lat = (uint32_t)(ev.post_us - edge_us);
+
+    b->counts[evt]++;
+    // Latency only makes sense for events that fire on an edge
+    if (evt == INPUT_EVT_PRESS || evt == INPUT_EVT_WAKE || id == INPUT_BTN_PWR) {
+        b->lat_sum_us += lat;
+        b->lat_n++;
+        if (lat > b->lat_max_us) b->lat_max_us = lat;
+    }
+    ESP_LOGD(TAG, "%s evt %d (%u us)", b->name, (int)evt, (unsigned)lat);
+    (void)esp_event_post(INPUT_EVENT_BASE, evt, &ev, sizeof(ev), 0);
+}
+
+static bool awake(void)
+{
+    return s_is_awake ? s_is_awake() : true;
+}
+
+// ----------------------------------------------------------------------------
+// GPIO button (BOOT)
+// ----------------------------------------------------------------------------
+
+// Arm the pin for the level opposite to its current state; also keeps it a
+// light-sleep wake source.
+static void arm_level(button_t* b, bool down)
+{
+    bool level_high = down ? (b->active_level == 0) : (b->active_level != 0);
+    gpio_wakeup_enable(b->gpio, level_high ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    gpio_intr_enable(b->gpio);
+}
+
+static void gpio_btn_isr(void* arg)
+{
+    button_t* b = (button_t*)arg;
+    // Level interrupt: mask until the debounce callback re-arms it
+    gpio_intr_disable(b->gpio);
+    b->irqs++;
+    b->edge_us = esp_timer_get_time();
+    (void)esp_timer_start_once(b->debounce, INPUT_DEBOUNCE_MS * 1000);
+}
+
+static void debounce_cb(void* arg)
+{
+    button_t* b = (button_t*)arg;
+    input_button_t id = (input_button_t)(b - s_btn);
+
+    // A level trigger armed for the opposite state cannot miss a change
+    // that happens right after sampling
+    bool down = gpio_get_level(b->gpio) == b->active_level;
+    arm_level(b, down);
+    if (down == b->pressed) return;  // bounce, state unchanged
+    b->pressed = down;
+
+    if (down) {
+        b->press_edge_us = b->edge_us;
+        b->long_fired = false;
+        if (!awake()) {
+            b->swallow = true;
+            b->clicks = 0;
+            esp_timer_stop(b->click);
+            post(id, INPUT_EVT_WAKE, b->press_edge_us);
+            return;
+        }
+        post(id, INPUT_EVT_PRESS, b->press_edge_us);
+        (void)esp_timer_start_once(b->hold, INPUT_LONG_PRESS_MS * 1000);
+        return;
+    }
+
+    // Released
+    esp_timer_stop(b->hold);
+    if (b->swallow || b->long_fired) {
+        b->swallow = false;
+        b->long_fired = false;
+        return;
+    }
+    if (++b->clicks >= 2) {
+        b->clicks = 0;
+        esp_timer_stop(b->click);
+        post(id, INPUT_EVT_DOUBLE, b->press_edge_us);
+    } else {
+        esp_timer_stop(b->click);
+        (void)esp_timer_start_once(b->click, INPUT_DOUBLE_CLICK_MS * 1000);
+    }
+}
+
+static void hold_cb(void* arg)
+{
+    button_t* b = (button_t*)arg;
+    if (!b->pressed || b->swallow) return;
+    b->long_fired = true;
+    b->clicks = 0;
+    esp_timer_stop(b->click);
+    post((input_button_t)(b - s_btn), INPUT_EVT_LONG, b->press_edge_us);
+}
+
+static void click_cb(void* arg)
+{
+    button_t* b = (button_t*)arg;
+    if (b->clicks == 1) {
+        post((input_button_t)(b - s_btn), INPUT_EVT_SHORT, b->press_edge_us);
+    }
+    b->clicks = 0;
+}
+
+static esp_err_t setup_gpio_button(input_button_t id)
+{
+    button_t* b = &s_btn[id];
+    const esp_timer_create_args_t deb = { .callback = debounce_cb, .arg = b, .name = "in_deb" };
+    const esp_timer_create_args_t hold = { .callback = hold_cb, .arg = b, .name = "in_hold" };
+    const esp_timer_create_args_t click = { .callback = click_cb, .arg = b, .name = "in_click" };
+    ESP_ERROR_CHECK(esp_timer_create(&deb, &b->debounce));
+    ESP_ERROR_CHECK(esp_timer_create(&hold, &b->hold));
+    ESP_ERROR_CHECK(esp_timer_create(&click, &b->click));
+
+    gpio_config_t io = {
+        .pin_bit_mask = 1ULL << b->gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t err = gpio_config(&io);
+    if (err != ESP_OK) return err;
+    err = gpio_isr_handler_add(b->gpio, gpio_btn_isr, b);
+    if (err != ESP_OK) return err;
+    b->pressed = gpio_get_level(b->gpio) == b->active_level;
+    arm_level(b, b->pressed);
+    return ESP_OK;
+}
+
+// ----------------------------------------------------------------------------
+// PMIC power key: the AXP2101 classifies the press itself and raises IRQ;
+// reading the status (I2C) happens in the esp_timer task, never in the ISR.
+// ----------------------------------------------------------------------------
+
+static void pmic_check_cb(void* arg)
+{
+    (void)arg;
+    button_t* b = &s_btn[INPUT_BTN_PWR];
+    if (bsp_power_poll_pwr_button_short()) {
+        post(INPUT_BTN_PWR, awake() ? INPUT_EVT_SHORT : INPUT_EVT_WAKE,
+             b->edge_us ? b->edge_us : esp_timer_get_time());
+    }
+    b->edge_us = 0;
+
+    if (b->gpio == GPIO_NUM_NC) return;  // polling mode
+    if (gpio_get_level(b->gpio) == 0) {
+        // IRQ still asserted by another PMIC source: keep it masked (and not
+        // a wake source) and look again later instead of storming
+        gpio_wakeup_disable(b->gpio);
+        (void)esp_timer_start_once(s_pmic_timer, INPUT_PMIC_POLL_MS * 1000);
+        return;
+    }
+    gpio_wakeup_enable(b->gpio, GPIO_INTR_LOW_LEVEL);
+    gpio_intr_enable(b->gpio);
+}
+
+static void pmic_irq_isr(void* arg)
+{
+    (void)arg;
+    button_t* b = &s_btn[INPUT_BTN_PWR];
+    gpio_intr_disable(b->gpio);
+    b->irqs++;
+    b->edge_us = esp_timer_get_time();
+    (void)esp_timer_start_once(s_pmic_timer, 1000);
+}
+
+static bool pmic_irq_usable(int gpio)
+{
+    if (gpio < 0 || !GPIO_IS_VALID_GPIO(gpio)) return false;
+#if CONFIG_SPIRAM_MODE_OCT
+    // GPIO33..37 carry the octal PSRAM bus on the ESP32-S3
+    if (gpio >= 33 && gpio <= 37) return false;
+#endif
+    return true;
+}
+
+// Each poll wakes the chip from light sleep, so it only runs while the
+// display is on; a press with the display off is not seen
+static void pmic_poll_run(bool on)
+{
+    if (!s_pmic_polling) return;
+    bool running = esp_timer_is_active(s_pmic_timer);
+    if (on && !running) {
+        (void)esp_timer_start_periodic(s_pmic_timer, INPUT_PMIC_POLL_MS * 1000);
+    } else if (!on && running) {
+        (void)esp_timer_stop(s_pmic_timer);
+    }
+}
+
+static esp_err_t setup_pmic_button(void)
+{
+    button_t* b = &s_btn[INPUT_BTN_PWR];
+
+    if (!BSP_POWER_HAS_PWR_BUTTON) {
+        // The status read is a stub that never reports a press: neither the
+        // IRQ (never acknowledged) nor a poll could see one
+        ESP_LOGW(TAG, "Power key unavailable: PMIC status read not implemented");
+        return ESP_OK;
+    }
+
+    const esp_timer_create_args_t args = { .callback = pmic_check_cb, .name = "in_pmic" };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &s_pmic_timer));
+
+    if (!pmic_irq_usable(INPUT_PMIC_IRQ_GPIO)) {
+        ESP_LOGW(TAG, "PMIC IRQ GPIO%d unusable, polling power key every %d ms while the display is on",
+                 (int)INPUT_PMIC_IRQ_GPIO, INPUT_PMIC_POLL_MS);
+        s_pmic_polling = true;
+        pmic_poll_run(awake());
+        return ESP_OK;
+    }
+
+    b->gpio = (gpio_num_t)INPUT_PMIC_IRQ_GPIO;
+    gpio_config_t io = {
+        .pin_bit_mask = 1ULL << b->gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t err = gpio_config(&io);
+    if (err != ESP_OK) return err;
+    err = gpio_isr_handler_add(b->gpio, pmic_irq_isr, NULL);
+    if (err != ESP_OK) return err;
+    // Active low, held until the status is read: level trigger + wake
+    gpio_wakeup_enable(b->gpio, GPIO_INTR_LOW_LEVEL);
+    gpio_intr_enable(b->gpio);
+    return ESP_OK;
+}
+
+esp_err_t input_service_init(void)
+{
+    if (s_initialized) return ESP_OK;
+
+    esp_err_t r = gpio_install_isr_service(0);
+    if (r != ESP_OK && r != ESP_ERR_INVALID_STATE) {
+        return r;
+    }
+    ESP_RETURN_ON_ERROR(setup_gpio_button(INPUT_BTN_BOOT), TAG, "boot button");
+    ESP_RETURN_ON_ERROR(setup_pmic_button(), TAG, "power key");
+
+    s_initialized = true;
+    ESP_LOGI(TAG, "Input service ready (debounce %d ms, long %d ms, double %d ms)",
+             INPUT_DEBOUNCE_MS, INPUT_LONG_PRESS_MS, INPUT_DOUBLE_CLICK_MS);
+    return ESP_OK;
+}
+
+void input_service_set_wake_filter(bool (*is_awake)(void))
+{
+    s_is_awake = is_awake;
+}
+
+void input_service_set_awake(bool awake)
+{
+    if (s_initialized) pmic_poll_run(awake);
+}
+
+void input_service_dump_stats(void)
+{
+    for (int i = 0; i < INPUT_BTN_COUNT; ++i) {
+        button_t* b = &s_btn[i];
+        uint32_t avg = b->lat_n ? (uint32_t)(b->lat_sum_us / b->lat_n) : 0;
+        ESP_LOGI(TAG, "%-4s irq=%u press=%u short=%u long=%u double=%u wake=%u lat avg=%u max=%u us",
+                 b->name, (unsigned)b->irqs, (unsigned)b->counts[INPUT_EVT_PRESS],
+                 (unsigned)b->counts[INPUT_EVT_SHORT], (unsigned)b->counts[INPUT_EVT_LONG],
+                 (unsigned)b->counts[INPUT_EVT_DOUBLE], (unsigned)b->counts[INPUT_EVT_WAKE],
+                 (unsigned)avg, (unsigned)b->lat_max_us);
+    }
+}
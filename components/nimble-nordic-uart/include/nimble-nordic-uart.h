@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <esp_err.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/ringbuf.h>
+#include <host/ble_hs.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Handle for the Nordic UART RX ring buffer
+extern RingbufHandle_t nordic_uart_rx_buf_handle;
+
+// A byte with this value at the start of a line begins a binary frame
+// instead: magic, type, u16 LE payload length, payload, u16 CRC. The whole
+// frame is queued as one ring-buffer item (no line splitting inside it).
+// Frames larger than CONFIG_NORDIC_UART_MAX_LINE_LENGTH are dropped whole.
+#define NORDIC_UART_FRAME_MAGIC   0xA5
+#define NORDIC_UART_FRAME_HDR_LEN 4
+#define NORDIC_UART_FRAME_CRC_LEN 2
+
+// Enum for Nordic UART callback types
+enum nordic_uart_callback_type {
+  NORDIC_UART_DISCONNECTED, // Callback type when disconnected
+  NORDIC_UART_CONNECTED,    // Callback type when connected
+};
+
+// Type definition for UART receive callback function
+typedef void (*uart_receive_callback_t)(struct ble_gatt_access_ctxt *ctxt);
+
+// Function to start the Nordic UART service
+// - device_name: Name of the BLE device (ignored if ble_host is already
+//   initialised by another role)
+// - callback: Function pointer to the callback function
+// The service joins the shared NimBLE host (ble_host.h) but doesn't start
+// it: call it before ble_host_start(), which the application calls once
+// every role has registered.
+esp_err_t nordic_uart_start(const char *device_name, void (*callback)(enum nordic_uart_callback_type callback_type));
+
+// Function to stop the Nordic UART service and free its buffers. The host,
+// advertising and the link stay up for the other roles.
+esp_err_t nordic_uart_stop(void);
+
+// Switch the service on or off without touching the host or the link (HID
+// keeps working). Off, writes are dropped, sends fail and the callback is
+// not called; switching off while connected reports DISCONNECTED, switching
+// on while connected reports CONNECTED. No-op before nordic_uart_start().
+void nordic_uart_set_enabled(bool enable);
+bool nordic_uart_is_enabled(void);
+
+// Whole-host controls, forwarded to ble_host (they affect HID as well)
+esp_err_t nordic_uart_disconnect(void);
+esp_err_t nordic_uart_set_advertising_enabled(bool enable);
+
+// Sends block until the whole message is queued (or fails) and never
+// interleave: each call below goes out as one unit.
+
+// Function to send a message over Nordic UART
+// - message: String message to be sent
+esp_err_t nordic_uart_send(const char *message);
+
+// Function to send a message with a newline over Nordic UART
+// - message: String message to be sent
+esp_err_t nordic_uart_sendln(const char *message);
+
+// Function to send raw bytes (binary frames) over Nordic UART
+esp_err_t nordic_uart_send_bytes(const uint8_t *data, size_t len);
+
+// Bulk transfer (e.g. history dump): announce roughly how many bytes will
+// follow so the link switches to short connection intervals up front, then
+// read back the achieved throughput. Sends in between are measured.
+typedef struct {
+  uint32_t bytes;
+  uint32_t notifications;
+  uint32_t backoffs;      // waits for free mbufs
+  uint32_t duration_ms;
+  uint32_t bytes_per_s;
+  uint16_t mtu;
+  uint16_t conn_itvl;     // 1.25 ms units
+} nordic_uart_tx_report_t;
+
+void nordic_uart_tx_bulk_begin(size_t expected_bytes);
+void nordic_uart_tx_bulk_end(nordic_uart_tx_report_t *out);
+
+// Negotiated ATT MTU (23 until the exchange completes)
+uint16_t nordic_uart_get_mtu(void);
+
+// Function to yield for UART receive callback
+// - uart_receive_callback: Callback function for UART receive
+esp_err_t nordic_uart_yield(uart_receive_callback_t uart_receive_callback);
+
+// private funcs for testing.
+esp_err_t _nordic_uart_buf_deinit();
+esp_err_t _nordic_uart_buf_init();
+esp_err_t _nordic_uart_send_line_buf_to_ring_buf();
+esp_err_t _nordic_uart_linebuf_append(char c);
+void _nordic_uart_linebuf_reset(void);
+bool _nordic_uart_linebuf_initialized();
+char* _nordic_uart_get_linebuf(void);
+
+esp_err_t _nordic_uart_start(const char *device_name, void (*callback)(enum nordic_uart_callback_type callback_type));
+esp_err_t _nordic_uart_stop(void);
+esp_err_t _nordic_uart_send(const char *message);
+esp_err_t _nordic_uart_send_bytes(const uint8_t *data, size_t len);
+esp_err_t _nordic_uart_sendln(const char *message);
+
+// Hint to adjust connection parameters for power saving while keeping link alive.
+// When enabled, asks ble_host for longer intervals and higher slave latency,
+// which it grants while no HID reports are flowing.
+// Safe to call anytime; takes effect on the next connection or immediately if connected.
+void nordic_uart_set_low_power_mode(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
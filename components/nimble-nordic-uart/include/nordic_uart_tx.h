@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TX scheduling policy for the Nordic UART notify path. Pure logic (no
+// NimBLE calls) so it can be tested on the host; nimble.c feeds it the
+// negotiated MTU, the free mbuf count and the bytes waiting to go out.
+//
+// - Payload per notification follows the ATT MTU (MTU - 3).
+// - Notifications are queued in bursts while the mbuf pool has headroom and
+//   the sender backs off for one connection interval when it runs low.
+// - The backlog decides what the UART asks ble_host for (ble_conn_arb.h):
+//   bulk while a transfer (history sync) is pending, nothing once it has
+//   drained, relaxed when low power is preferred. ble_host sets the
+//   connection parameters, weighing HID in too.
+
+#define NUS_TX_ATT_HDR        3
+#define NUS_TX_DEFAULT_MTU    23     // before the MTU exchange
+#define NUS_TX_PREFERRED_MTU  247    // 244 B payload, fits one 251 B DLE PDU
+#define NUS_TX_DLE_OCTETS     251
+#define NUS_TX_DLE_TIME_US    2120
+
+#define NUS_TX_BULK_BYTES     2048   // backlog that asks for the bulk profile
+#define NUS_TX_IDLE_MS        2000   // drained this long -> leave bulk
+#define NUS_TX_MBUF_RESERVE   4      // free mbufs left for the rest of the host
+#define NUS_TX_MAX_BURST      8      // notifications queued per connection event
+
+typedef enum {
+    NUS_CONN_IDLE = 0,      // no request: ble_host's choice
+    NUS_CONN_LOW_POWER,     // BLE_CONN_REQ_RELAXED: screen off, link kept
+    NUS_CONN_BULK,          // BLE_CONN_REQ_BULK: history dump / long transfers
+    NUS_CONN_COUNT,
+} nus_conn_profile_t;
+
+const char* nus_tx_profile_name(nus_conn_profile_t p);
+
+// Bytes carried by one notification for the given ATT MTU
+size_t nus_tx_payload_max(uint16_t mtu);
+
+// Notifications that may be queued now given the free mbufs and the
+// chunks still to send. 0 means wait for the controller to drain.
+unsigned nus_tx_burst(int free_mbufs, size_t chunks_left);
+
+typedef struct {
+    nus_conn_profile_t current;
+    bool low_power_pref;
+    uint32_t drained_since_ms;   // valid while backlog == 0
+    bool drained;
+} nus_tx_policy_t;
+
+void nus_tx_policy_init(nus_tx_policy_t* p);
+
+// Profile wanted for `backlog` pending bytes at time now_ms. Bulk is
+// entered at NUS_TX_BULK_BYTES and left NUS_TX_IDLE_MS after draining, so
+// a series of short sends doesn't flap the connection parameters.
+nus_conn_profile_t nus_tx_policy_update(nus_tx_policy_t* p, size_t backlog, uint32_t now_ms);
+
+// Throughput of one bulk session (e.g. a history dump)
+typedef struct {
+    bool active;
+    uint64_t start_us;
+    uint64_t last_us;
+    uint32_t bytes;
+    uint32_t notifications;
+    uint32_t backoffs;           // waits for mbufs
+} nus_tx_meter_t;
+
+void nus_tx_meter_begin(nus_tx_meter_t* m, uint64_t now_us);
+void nus_tx_meter_add(nus_tx_meter_t* m, size_t bytes, uint64_t now_us);
+// Bytes per second from the first to the last notification, 0 if unknown
+uint32_t nus_tx_meter_bps(const nus_tx_meter_t* m);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,6 +11,11 @@ RingbufHandle_t nordic_uart_rx_buf_handle;
 
 static char *_nordic_uart_rx_line_buf = NULL;
 static size_t _nordic_uart_rx_line_buf_pos = 0;
+// Binary frame in progress: total size once the header is in, else 0
+static bool _nordic_uart_rx_in_frame = false;
+static size_t _nordic_uart_rx_frame_len = 0;
+// Bytes left of a frame that was too large and is being dropped
+static size_t _nordic_uart_rx_skip = 0;
 
 esp_err_t _nordic_uart_send_line_buf_to_ring_buf() {
   _nordic_uart_rx_line_buf[_nordic_uart_rx_line_buf_pos] = '\0';
@@ -24,7 +29,50 @@ esp_err_t _nordic_uart_send_line_buf_to_ring_buf() {
   return res == pdTRUE ? ESP_OK : ESP_FAIL;
 }
 
+// Collect a binary frame byte for byte; queued whole once complete
+static esp_err_t _nordic_uart_frame_append(char c) {
+  _nordic_uart_rx_line_buf[_nordic_uart_rx_line_buf_pos++] = c;
+
+  if (_nordic_uart_rx_line_buf_pos == NORDIC_UART_FRAME_HDR_LEN) {
+    const uint8_t *h = (const uint8_t *)_nordic_uart_rx_line_buf;
+    _nordic_uart_rx_frame_len = NORDIC_UART_FRAME_HDR_LEN + (h[2] | (h[3] << 8)) +
+                                NORDIC_UART_FRAME_CRC_LEN;
+    if (_nordic_uart_rx_frame_len > CONFIG_NORDIC_UART_MAX_LINE_LENGTH) {
+      ESP_LOGW(_TAG, "Frame too large (%u), dropped", (unsigned)_nordic_uart_rx_frame_len);
+      // The rest of it must not come out as lines
+      _nordic_uart_rx_skip = _nordic_uart_rx_frame_len - NORDIC_UART_FRAME_HDR_LEN;
+      _nordic_uart_rx_line_buf_pos = 0;
+      _nordic_uart_rx_in_frame = false;
+      return ESP_FAIL;
+    }
+  }
+  if (_nordic_uart_rx_line_buf_pos < NORDIC_UART_FRAME_HDR_LEN ||
+      _nordic_uart_rx_line_buf_pos < _nordic_uart_rx_frame_len) {
+    return ESP_OK;
+  }
+
+  _nordic_uart_rx_in_frame = false;
+  if (_nordic_uart_send_line_buf_to_ring_buf() != ESP_OK) {
+    ESP_LOGE(_TAG, "Failed to send item");
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
 esp_err_t _nordic_uart_linebuf_append(char c) {
+  if (_nordic_uart_rx_skip > 0) {
+    _nordic_uart_rx_skip--;
+    return ESP_OK;
+  }
+  if (_nordic_uart_rx_in_frame) {
+    return _nordic_uart_frame_append(c);
+  }
+  if (_nordic_uart_rx_line_buf_pos == 0 && (uint8_t)c == NORDIC_UART_FRAME_MAGIC) {
+    _nordic_uart_rx_in_frame = true;
+    _nordic_uart_rx_frame_len = 0;
+    return _nordic_uart_frame_append(c);
+  }
+
   switch (c) {
   // break \003 == Ctrl-c
   case '\003':
@@ -66,6 +114,15 @@ esp_err_t _nordic_uart_linebuf_append(char c) {
   return ESP_OK;
 }
 
+// A frame or line cut off by a disconnect must not swallow what the next
+// connection sends
+void _nordic_uart_linebuf_reset(void) {
+  _nordic_uart_rx_line_buf_pos = 0;
+  _nordic_uart_rx_in_frame = false;
+  _nordic_uart_rx_frame_len = 0;
+  _nordic_uart_rx_skip = 0;
+}
+
 esp_err_t _nordic_uart_buf_deinit() {
   if (!_nordic_uart_linebuf_initialized())
     return ESP_FAIL;
@@ -85,7 +142,7 @@ esp_err_t _nordic_uart_buf_init() {
 
   // Buffer for receive BLE and split it with /\r*\n/
   _nordic_uart_rx_line_buf = malloc(CONFIG_NORDIC_UART_MAX_LINE_LENGTH + 1);
-  _nordic_uart_rx_line_buf_pos = 0;
+  _nordic_uart_linebuf_reset();
   nordic_uart_rx_buf_handle = xRingbufferCreate(CONFIG_NORDIC_UART_RX_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
   if (nordic_uart_rx_buf_handle == NULL) {
     ESP_LOGE(_TAG, "Failed to create ring buffer");
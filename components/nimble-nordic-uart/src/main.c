@@ -1,18 +1,14 @@
 #include "nimble-nordic-uart.h"
 
 #include <esp_log.h>
-#include <esp_nimble_hci.h>
-#include <nimble/nimble_port.h>
-#include <nimble/nimble_port_freertos.h>
-#include <nvs_flash.h>
-#include <services/gap/ble_svc_gap.h>
-#include <services/gatt/ble_svc_gatt.h>
 
 static const char *_TAG = "NORDIC UART";
 
 // Declaración de la función interna de bajo nivel
 // (implementada en nimble.c)
 esp_err_t _nordic_uart_send(const char *message);
+esp_err_t _nordic_uart_send_bytes(const uint8_t *data, size_t len);
+esp_err_t _nordic_uart_sendln(const char *message);
 
 // Enviar texto por el servicio Nordic UART
 esp_err_t nordic_uart_send(const char *message)
@@ -20,15 +16,15 @@ esp_err_t nordic_uart_send(const char *message)
     return _nordic_uart_send(message);
 }
 
+esp_err_t nordic_uart_send_bytes(const uint8_t *data, size_t len)
+{
+    return _nordic_uart_send_bytes(data, len);
+}
+
+// Mensaje y fin de línea bajo el mismo cerrojo: nada se cuela entre ellos
 esp_err_t nordic_uart_sendln(const char *message)
 {
-    if (nordic_uart_send(message) != ESP_OK) {
-        return ESP_FAIL;
-    }
-    if (nordic_uart_send("\r\n") != ESP_OK) {
-        return ESP_FAIL;
-    }
-    return ESP_OK;
+    return _nordic_uart_sendln(message);
 }
 
 /*
@@ -0,0 +1,521 @@
+#include "nimble-nordic-uart.h"
+#include "nordic_uart_tx.h"
+
+#include "ble_host.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host/ble_hs.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/timers.h>
+
+static const char* _TAG = "NORDIC UART";
+
+#define NUS_TX_BACKOFF_MAX_MS 1000   // give up a send after this long without mbufs
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define B0(x) ((x) & 0xFF)
+#define B1(x) (((x) >> 8) & 0xFF)
+#define B2(x) (((x) >> 16) & 0xFF)
+#define B3(x) (((x) >> 24) & 0xFF)
+#define B4(x) (((x) >> 32) & 0xFF)
+#define B5(x) (((x) >> 40) & 0xFF)
+
+// clang-format off
+#define UUID128_CONST(a32, b16, c16, d16, e48) \
+  BLE_UUID128_INIT( \
+    B0(e48), B1(e48), B2(e48), B3(e48), B4(e48), B5(e48), \
+    B0(d16), B1(d16), B0(c16), B1(c16), B0(b16), \
+    B1(b16), B0(a32), B1(a32), B2(a32), B3(a32), \
+  )
+// clang-format on
+
+static const ble_uuid128_t SERVICE_UUID = UUID128_CONST(0x6E400001, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
+static const ble_uuid128_t CHAR_UUID_RX = UUID128_CONST(0x6E400002, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
+static const ble_uuid128_t CHAR_UUID_TX = UUID128_CONST(0x6E400003, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
+
+// The NimBLE host (port, security, advertising) is ble_host's; this file
+// adds the UART service to it and follows the shared connection
+static bool s_svcs_added;
+// The service stays in the GATT table once the host runs; switched off it
+// ignores writes, sends nothing and doesn't report the link
+static volatile bool s_enabled;
+static uint16_t ble_conn_hdl;
+static uint16_t notify_char_attr_hdl;
+
+static void (*_nordic_uart_callback)(enum nordic_uart_callback_type callback_type) = NULL;
+static uart_receive_callback_t _uart_receive_callback = NULL;
+
+// TX scheduler state (policy in tx_sched.c)
+static portMUX_TYPE s_tx_mux = portMUX_INITIALIZER_UNLOCKED;
+static nus_tx_policy_t s_tx_policy = { .current = NUS_CONN_IDLE };
+static uint16_t s_mtu = NUS_TX_DEFAULT_MTU;
+static uint16_t s_conn_itvl = 40;                           // 1.25 ms units
+static size_t s_tx_backlog;          // bytes inside nordic_uart_send* calls
+static size_t s_bulk_expected;       // announced by nordic_uart_tx_bulk_begin
+static nus_tx_meter_t s_tx_meter;
+static TimerHandle_t s_tx_idle_timer;
+// One message at a time: a history batch goes out as several notifications
+// with mbuf waits in between, and nothing else may land inside it
+static SemaphoreHandle_t s_tx_lock;
+
+
+/* ================== CONN PARAMS ================== */
+
+// ble_host sets the parameters, HID included; the UART only says what it
+// needs (a retry after a refused update is ble_host's too)
+static void _request_conn_params(nus_conn_profile_t p)
+{
+    ble_conn_req_t req = BLE_CONN_REQ_NONE;
+    if (p == NUS_CONN_BULK) req = BLE_CONN_REQ_BULK;
+    if (p == NUS_CONN_LOW_POWER) req = BLE_CONN_REQ_RELAXED;
+    ESP_LOGD(_TAG, "Conn params wanted: %s", nus_tx_profile_name(p));
+    ble_host_conn_request(req);
+}
+
+// Re-evaluate the connection profile from the current backlog
+static void _tx_policy_step(void)
+{
+    taskENTER_CRITICAL(&s_tx_mux);
+    size_t backlog = s_tx_backlog + s_bulk_expected;
+    nus_conn_profile_t was = s_tx_policy.current;
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    nus_conn_profile_t now = nus_tx_policy_update(&s_tx_policy, backlog, now_ms);
+    bool waiting = s_tx_policy.drained;
+    taskEXIT_CRITICAL(&s_tx_mux);
+
+    if (now != was) _request_conn_params(now);
+    // Drained out of bulk: come back after the idle delay to relax the link
+    if (waiting && s_tx_idle_timer) xTimerReset(s_tx_idle_timer, 0);
+}
+
+static void _tx_idle_timer_cb(TimerHandle_t t)
+{
+    (void)t;
+    _tx_policy_step();
+}
+
+static void _tx_reset_link_state(void)
+{
+    taskENTER_CRITICAL(&s_tx_mux);
+    bool low_power = s_tx_policy.low_power_pref;
+    nus_tx_policy_init(&s_tx_policy);
+    s_tx_policy.low_power_pref = low_power;
+    s_tx_policy.current = low_power ? NUS_CONN_LOW_POWER : NUS_CONN_IDLE;
+    s_mtu = NUS_TX_DEFAULT_MTU;
+    s_conn_itvl = 40;
+    taskEXIT_CRITICAL(&s_tx_mux);
+}
+
+esp_err_t nordic_uart_yield(uart_receive_callback_t uart_receive_callback)
+{
+    _uart_receive_callback = uart_receive_callback;
+    return ESP_OK;
+}
+
+
+/* ================== GATT ================== */
+
+static int _uart_receive(uint16_t conn_handle, uint16_t attr_handle,
+                         struct ble_gatt_access_ctxt* ctxt, void* arg)
+{
+    (void)conn_handle;
+    (void)attr_handle;
+    (void)arg;
+
+    if (!s_enabled)
+        return 0;
+    if (_uart_receive_callback) {
+        _uart_receive_callback(ctxt);
+    } else {
+        for (int i = 0; i < ctxt->om->om_len; ++i) {
+            const char c = ctxt->om->om_data[i];
+            _nordic_uart_linebuf_append(c);
+        }
+    }
+    return 0;
+}
+
+// notify GATT callback no-op
+static int _uart_noop(uint16_t conn_handle, uint16_t attr_handle,
+                      struct ble_gatt_access_ctxt* ctxt, void* arg)
+{
+    (void)conn_handle;
+    (void)attr_handle;
+    (void)ctxt;
+    (void)arg;
+    return 0;
+}
+
+static const struct ble_gatt_svc_def gat_svcs[] = {
+    {
+        .type = BLE_GATT_SVC_TYPE_PRIMARY,
+        .uuid = &SERVICE_UUID.u,
+        .characteristics = (struct ble_gatt_chr_def[]){
+            {
+                .uuid = (ble_uuid_t*)&CHAR_UUID_RX,
+                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP,
+                .access_cb = _uart_receive,
+            },
+            {
+                .uuid = (ble_uuid_t*)&CHAR_UUID_TX,
+                .flags = BLE_GATT_CHR_F_NOTIFY,
+                .val_handle = &notify_char_attr_hdl,
+                .access_cb = _uart_noop,
+            },
+            { 0 },
+        },
+    },
+    { 0 }
+};
+
+/* ================== GAP EVENTS ================== */
+
+static int nus_gap_event(struct ble_gap_event* event, void* arg)
+{
+    (void)arg;
+
+    switch (event->type) {
+    case BLE_GAP_EVENT_CONNECT:
+        ESP_LOGI(_TAG, "BLE_GAP_EVENT_CONNECT %s",
+                 event->connect.status == 0 ? "OK" : "Failed");
+        if (event->connect.status == 0) {
+            ble_conn_hdl = event->connect.conn_handle;
+
+            struct ble_gap_conn_desc desc;
+            {
+                int rc = ble_gap_conn_find(event->connect.conn_handle, &desc);
+                if (rc != 0) {
+                    ESP_LOGE(_TAG,
+                        "failed to find connection by handle, error code: %d",
+                        rc);
+                    return rc;
+                }
+            }
+
+            // The link starts on the central's parameters; ask only for
+            // low power, which ble_host forgot with the last link
+            _tx_reset_link_state();
+            s_conn_itvl = desc.conn_itvl;
+            if (s_tx_policy.current != NUS_CONN_IDLE) _request_conn_params(s_tx_policy.current);
+
+            // Ask for a bigger ATT MTU and for Data Length Extension so a
+            // notification of MTU - 3 bytes travels in one link-layer PDU
+            int rc = ble_gattc_exchange_mtu(ble_conn_hdl, NULL, NULL);
+            if (rc != 0) ESP_LOGD(_TAG, "MTU exchange not started: %d", rc);
+            rc = ble_gap_set_data_len(ble_conn_hdl, NUS_TX_DLE_OCTETS, NUS_TX_DLE_TIME_US);
+            if (rc != 0) ESP_LOGD(_TAG, "Data length update refused: %d", rc);
+
+            if (s_enabled && _nordic_uart_callback)
+                _nordic_uart_callback(NORDIC_UART_CONNECTED);
+        }
+        break;
+
+    case BLE_GAP_EVENT_DISCONNECT:
+        // Drop a half-received frame or line first, or the Ctrl-C would be
+        // taken as one of its bytes
+        _nordic_uart_linebuf_reset();
+        if (s_enabled)
+            _nordic_uart_linebuf_append('\003'); // Ctrl-C
+        ESP_LOGI(_TAG, "BLE_GAP_EVENT_DISCONNECT");
+        ble_conn_hdl = 0;
+        _tx_reset_link_state();
+        if (s_enabled && _nordic_uart_callback)
+            _nordic_uart_callback(NORDIC_UART_DISCONNECTED);
+        break;
+
+    case BLE_GAP_EVENT_MTU:
+        s_mtu = event->mtu.value;
+        ESP_LOGI(_TAG, "MTU %u (%u B per notification)",
+                 s_mtu, (unsigned)nus_tx_payload_max(s_mtu));
+        break;
+
+    case BLE_GAP_EVENT_CONN_UPDATE: {
+        struct ble_gap_conn_desc desc;
+        if (event->conn_update.status == 0 &&
+            ble_gap_conn_find(event->conn_update.conn_handle, &desc) == 0) {
+            s_conn_itvl = desc.conn_itvl;
+            ESP_LOGI(_TAG, "Conn interval %u x1.25 ms, latency %u",
+                     desc.conn_itvl, desc.conn_latency);
+        }
+        break;
+    }
+
+    case BLE_GAP_EVENT_SUBSCRIBE:
+        if (event->subscribe.attr_handle == notify_char_attr_hdl) {
+            if (event->subscribe.cur_notify == 0) {
+                ESP_LOGI(_TAG, "Client unsubscribed from notifications");
+            } else {
+                ESP_LOGI(_TAG, "Client subscribed to notifications");
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+    return 0;
+}
+
+
+/* ================== SEND ================== */
+
+esp_err_t _nordic_uart_send(const char* message)
+{
+    return _nordic_uart_send_bytes((const uint8_t*)message, strlen(message));
+}
+
+static void _tx_account(size_t sent)
+{
+    taskENTER_CRITICAL(&s_tx_mux);
+    s_tx_backlog -= sent;
+    s_bulk_expected = s_bulk_expected > sent ? s_bulk_expected - sent : 0;
+    nus_tx_meter_add(&s_tx_meter, sent, (uint64_t)esp_timer_get_time());
+    taskEXIT_CRITICAL(&s_tx_mux);
+}
+
+// Slice by the negotiated MTU and queue bursts of notifications while the
+// mbuf pool has room; when it runs low wait one connection interval for
+// the controller to drain instead of hammering ENOMEM. s_tx_lock held.
+static esp_err_t _send_locked(const uint8_t* message, size_t size)
+{
+    if (size == 0)
+        return ESP_OK;
+    // A reconnect during a backoff must not get the rest of the message
+    const uint16_t conn = ble_conn_hdl;
+    if (conn == 0 || !s_enabled)
+        return ESP_FAIL;
+
+    const size_t chunk = nus_tx_payload_max(s_mtu);
+    const uint32_t wait_ms = MIN(100, MAX(10, s_conn_itvl * 5 / 4));
+    uint32_t waited_ms = 0;
+    size_t off = 0;
+    esp_err_t ret = ESP_OK;
+
+    taskENTER_CRITICAL(&s_tx_mux);
+    s_tx_backlog += size;
+    taskEXIT_CRITICAL(&s_tx_mux);
+    _tx_policy_step();
+
+    while (off < size) {
+        if (ble_conn_hdl != conn || !s_enabled) {
+            ret = ESP_FAIL;
+            break;
+        }
+        unsigned burst = nus_tx_burst(os_msys_num_free(), (size - off + chunk - 1) / chunk);
+        bool backoff = (burst == 0);
+
+        for (unsigned b = 0; b < burst && off < size; ++b) {
+            size_t n = MIN(chunk, size - off);
+            struct os_mbuf* om = ble_hs_mbuf_from_flat(&message[off], n);
+            if (!om) {
+                backoff = true;
+                break;
+            }
+            int err = ble_gatts_notify_custom(conn, notify_char_attr_hdl, om);
+            if (err == BLE_HS_ENOMEM) {
+                backoff = true;
+                break;
+            }
+            if (err) {
+                ret = ESP_FAIL;
+                break;
+            }
+            off += n;
+            _tx_account(n);
+            waited_ms = 0;
+        }
+        if (ret != ESP_OK) break;
+
+        if (backoff) {
+            if (waited_ms >= NUS_TX_BACKOFF_MAX_MS) {
+                ret = ESP_FAIL;
+                break;
+            }
+            s_tx_meter.backoffs++;
+            vTaskDelay(pdMS_TO_TICKS(wait_ms));
+            waited_ms += wait_ms;
+        }
+    }
+
+    if (off < size) {
+        taskENTER_CRITICAL(&s_tx_mux);
+        s_tx_backlog -= size - off;
+        taskEXIT_CRITICAL(&s_tx_mux);
+    }
+    _tx_policy_step();
+    return ret;
+}
+
+esp_err_t _nordic_uart_send_bytes(const uint8_t* message, size_t size)
+{
+    if (!s_tx_lock)
+        return ESP_FAIL;
+    xSemaphoreTake(s_tx_lock, portMAX_DELAY);
+    esp_err_t ret = _send_locked(message, size);
+    xSemaphoreGive(s_tx_lock);
+    return ret;
+}
+
+// The line and its end in one go
+esp_err_t _nordic_uart_sendln(const char* message)
+{
+    if (!s_tx_lock)
+        return ESP_FAIL;
+    xSemaphoreTake(s_tx_lock, portMAX_DELAY);
+    esp_err_t ret = _send_locked((const uint8_t*)message, strlen(message));
+    if (ret == ESP_OK)
+        ret = _send_locked((const uint8_t*)"\r\n", 2);
+    xSemaphoreGive(s_tx_lock);
+    return ret;
+}
+
+void nordic_uart_tx_bulk_begin(size_t expected_bytes)
+{
+    taskENTER_CRITICAL(&s_tx_mux);
+    s_bulk_expected = expected_bytes;
+    nus_tx_meter_begin(&s_tx_meter, (uint64_t)esp_timer_get_time());
+    taskEXIT_CRITICAL(&s_tx_mux);
+    _tx_policy_step();
+}
+
+void nordic_uart_tx_bulk_end(nordic_uart_tx_report_t* out)
+{
+    taskENTER_CRITICAL(&s_tx_mux);
+    nus_tx_meter_t m = s_tx_meter;
+    s_tx_meter.active = false;
+    s_bulk_expected = 0;
+    taskEXIT_CRITICAL(&s_tx_mux);
+    _tx_policy_step();
+
+    nordic_uart_tx_report_t r = {
+        .bytes = m.bytes,
+        .notifications = m.notifications,
+        .backoffs = m.backoffs,
+        .duration_ms = (uint32_t)((m.last_us - m.start_us) / 1000),
+        .bytes_per_s = nus_tx_meter_bps(&m),
+        .mtu = s_mtu,
+        .conn_itvl = s_conn_itvl,
+    };
+    ESP_LOGI(_TAG, "Bulk TX: %u B in %u notifications, %u ms, %u B/s (MTU %u, itvl %u x1.25 ms, %u backoffs)",
+             (unsigned)r.bytes, (unsigned)r.notifications, (unsigned)r.duration_ms,
+             (unsigned)r.bytes_per_s, r.mtu, r.conn_itvl, (unsigned)r.backoffs);
+    if (out) *out = r;
+}
+
+uint16_t nordic_uart_get_mtu(void)
+{
+    return s_mtu;
+}
+
+
+/* ================== API PÚBLICA ================== */
+
+void nordic_uart_set_low_power_mode(bool enable)
+{
+    taskENTER_CRITICAL(&s_tx_mux);
+    s_tx_policy.low_power_pref = enable;
+    taskEXIT_CRITICAL(&s_tx_mux);
+    _tx_policy_step();
+}
+
+/***
+ * arranque Nordic UART: añade el servicio al host compartido (ble_host).
+ * El host lo arranca main con ble_host_start() cuando todos los roles se
+ * han registrado; si ya corre sin el servicio UART no se puede añadir.
+ */
+esp_err_t nordic_uart_start(const char* device_name,
+                            void (*callback)(enum nordic_uart_callback_type callback_type))
+{
+    if (_nordic_uart_linebuf_initialized()) {
+        ESP_LOGE(_TAG, "Already initialized");
+        return ESP_FAIL;
+    }
+
+    esp_err_t err = ble_host_init(device_name);
+    if (err != ESP_OK) return ESP_FAIL;
+
+    if (!s_svcs_added) {
+        if (ble_host_add_services(gat_svcs) != ESP_OK ||
+            ble_host_add_listener(nus_gap_event, NULL) != ESP_OK) {
+            ESP_LOGE(_TAG, "BLE host already running without the UART service");
+            return ESP_FAIL;
+        }
+        ble_host_advertise_uuid(&SERVICE_UUID.u);
+        s_svcs_added = true;
+    }
+
+    _nordic_uart_callback = callback;
+    if (_nordic_uart_buf_init() != ESP_OK) {
+        ESP_LOGE(_TAG, "Failed to init Nordic UART buffers");
+        return ESP_FAIL;
+    }
+
+    ble_att_set_preferred_mtu(NUS_TX_PREFERRED_MTU);
+
+    if (!s_tx_lock) {
+        s_tx_lock = xSemaphoreCreateMutex();
+        if (!s_tx_lock) return ESP_ERR_NO_MEM;
+    }
+    if (!s_tx_idle_timer) {
+        s_tx_idle_timer = xTimerCreate("nus_tx_idle", pdMS_TO_TICKS(NUS_TX_IDLE_MS),
+                                       pdFALSE, NULL, _tx_idle_timer_cb);
+    }
+
+    s_enabled = true;
+    return ESP_OK;
+}
+
+// Solo el servicio UART: el host y el enlace (y con ellos el HID) siguen
+esp_err_t nordic_uart_stop(void)
+{
+    nordic_uart_set_enabled(false);
+    if (s_tx_lock) {
+        // Espera a que acabe un envío en curso antes de soltar los buffers
+        xSemaphoreTake(s_tx_lock, portMAX_DELAY);
+        xSemaphoreGive(s_tx_lock);
+    }
+    _nordic_uart_buf_deinit();
+    _nordic_uart_callback = NULL;
+    return ESP_OK;
+}
+
+void nordic_uart_set_enabled(bool enable)
+{
+    if (enable == s_enabled || !_nordic_uart_linebuf_initialized())
+        return;
+    // Apagado se despide del enlace como si se hubiera caído; encendido con
+    // un enlace abierto lo anuncia ya, sin esperar a la próxima conexión
+    if (!enable) {
+        s_enabled = false;
+        _nordic_uart_linebuf_reset();
+        if (ble_conn_hdl != 0 && _nordic_uart_callback)
+            _nordic_uart_callback(NORDIC_UART_DISCONNECTED);
+    } else {
+        _nordic_uart_linebuf_reset();
+        s_enabled = true;
+        if (ble_conn_hdl != 0 && _nordic_uart_callback)
+            _nordic_uart_callback(NORDIC_UART_CONNECTED);
+    }
+    // Un bulk anunciado ya no llegará: que el enlace no se quede rápido
+    taskENTER_CRITICAL(&s_tx_mux);
+    s_bulk_expected = 0;
+    taskEXIT_CRITICAL(&s_tx_mux);
+    _tx_policy_step();
+}
+
+bool nordic_uart_is_enabled(void)
+{
+    return s_enabled;
+}
+
+esp_err_t nordic_uart_disconnect(void)
+{
+    return ble_host_disconnect();
+}
+
+esp_err_t nordic_uart_set_advertising_enabled(bool enable)
+{
+    return ble_host_set_advertising_enabled(enable);
+}
@@ -0,0 +1,82 @@
+#include "nordic_uart_tx.h"
+
+#include <string.h>
+
+static const char* const s_profile_names[NUS_CONN_COUNT] = {
+    [NUS_CONN_IDLE] = "idle",
+    [NUS_CONN_LOW_POWER] = "low_power",
+    [NUS_CONN_BULK] = "bulk",
+};
+
+const char* nus_tx_profile_name(nus_conn_profile_t p)
+{
+    return (unsigned)p < NUS_CONN_COUNT ? s_profile_names[p] : "?";
+}
+
+size_t nus_tx_payload_max(uint16_t mtu)
+{
+    if (mtu < NUS_TX_DEFAULT_MTU) mtu = NUS_TX_DEFAULT_MTU;
+    return (size_t)mtu - NUS_TX_ATT_HDR;
+}
+
+unsigned nus_tx_burst(int free_mbufs, size_t chunks_left)
+{
+    int room = free_mbufs - NUS_TX_MBUF_RESERVE;
+    if (room <= 0 || chunks_left == 0) return 0;
+    unsigned n = (unsigned)room;
+    if (n > NUS_TX_MAX_BURST) n = NUS_TX_MAX_BURST;
+    if (n > chunks_left) n = (unsigned)chunks_left;
+    return n;
+}
+
+void nus_tx_policy_init(nus_tx_policy_t* p)
+{
+    memset(p, 0, sizeof(*p));
+    p->current = NUS_CONN_IDLE;
+}
+
+nus_conn_profile_t nus_tx_policy_update(nus_tx_policy_t* p, size_t backlog, uint32_t now_ms)
+{
+    nus_conn_profile_t rest = p->low_power_pref ? NUS_CONN_LOW_POWER : NUS_CONN_IDLE;
+
+    if (backlog >= NUS_TX_BULK_BYTES) {
+        p->drained = false;
+        p->current = NUS_CONN_BULK;
+    } else if (p->current == NUS_CONN_BULK) {
+        if (backlog > 0) {
+            p->drained = false;
+        } else if (!p->drained) {
+            p->drained = true;
+            p->drained_since_ms = now_ms;
+        } else if ((uint32_t)(now_ms - p->drained_since_ms) >= NUS_TX_IDLE_MS) {
+            p->drained = false;
+            p->current = rest;
+        }
+    } else {
+        p->current = rest;
+    }
+    return p->current;
+}
+
+void nus_tx_meter_begin(nus_tx_meter_t* m, uint64_t now_us)
+{
+    memset(m, 0, sizeof(*m));
+    m->active = true;
+    m->start_us = now_us;
+    m->last_us = now_us;
+}
+
+void nus_tx_meter_add(nus_tx_meter_t* m, size_t bytes, uint64_t now_us)
+{
+    if (!m->active) return;
+    m->bytes += (uint32_t)bytes;
+    m->notifications++;
+    m->last_us = now_us;
+}
+
+uint32_t nus_tx_meter_bps(const nus_tx_meter_t* m)
+{
+    uint64_t dt = m->last_us - m->start_us;
+    if (dt == 0) return 0;
+    return (uint32_t)((uint64_t)m->bytes * 1000000u / dt);
+}
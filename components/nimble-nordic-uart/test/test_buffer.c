@@ -0,0 +1,177 @@
+#include "unity.h"
+
+#include "nimble-nordic-uart.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include <string.h>
+
+TEST_CASE("buffer init / deinit", "[buffer]") {
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+  TEST_ESP_ERR(ESP_FAIL, _nordic_uart_buf_deinit());
+}
+
+TEST_CASE("buffer append", "[buffer]") {
+  size_t item_size;
+  char *str;
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  TEST_ESP_OK(_nordic_uart_linebuf_append('a'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('b'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('c'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT(str == NULL);
+
+  TEST_ESP_OK(_nordic_uart_linebuf_append('d'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\r'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("abcd", str);
+
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("", str);
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
+
+TEST_CASE("line buffer overflow", "[buffer]") {
+  size_t item_size;
+  char *str;
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  for (int i = 0; i < CONFIG_NORDIC_UART_MAX_LINE_LENGTH; ++i) {
+    TEST_ESP_OK(_nordic_uart_linebuf_append('0' + i % 10));
+  }
+  TEST_ESP_ERR(ESP_FAIL, _nordic_uart_linebuf_append('d'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\r'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_INT(CONFIG_NORDIC_UART_MAX_LINE_LENGTH, strlen(str));
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  TEST_ESP_OK(_nordic_uart_linebuf_append('a'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("a", str);
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
+
+TEST_CASE("ring buffer overflow", "[buffer]") {
+  size_t item_size;
+  char *str;
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+
+  for (int j = 0; j < CONFIG_NORDIC_UART_RX_BUFFER_SIZE / (CONFIG_NORDIC_UART_MAX_LINE_LENGTH + 1); ++j) {
+    for (int i = 0; i < CONFIG_NORDIC_UART_MAX_LINE_LENGTH; ++i) {
+      TEST_ESP_OK(_nordic_uart_linebuf_append('0' + i % 10));
+    }
+    TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  }
+
+  // ring buffer overflow
+  for (int i = 0; i < CONFIG_NORDIC_UART_MAX_LINE_LENGTH; ++i) {
+    TEST_ESP_OK(_nordic_uart_linebuf_append('0' + i % 10));
+  }
+  TEST_ESP_ERR(ESP_FAIL, _nordic_uart_linebuf_append('\n'));
+
+  for (int j = 0; j < CONFIG_NORDIC_UART_RX_BUFFER_SIZE / (CONFIG_NORDIC_UART_MAX_LINE_LENGTH + 1); ++j) {
+    str = xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+    TEST_ASSERT_NOT_NULL(str);
+    vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+  }
+  TEST_ASSERT_NULL(xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1));
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
+
+TEST_CASE("binary frame passthrough", "[buffer]") {
+  size_t item_size;
+  uint8_t *item;
+  // magic, type, len=3 ('\n' and '\0' inside must not split), payload, crc
+  const uint8_t frame[] = {NORDIC_UART_FRAME_MAGIC, 0x04, 0x03, 0x00, '\n', 0x00, 'x', 0x12, 0x34};
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  for (size_t i = 0; i < sizeof(frame); ++i) {
+    TEST_ESP_OK(_nordic_uart_linebuf_append((char)frame[i]));
+  }
+  item = (uint8_t *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_NOT_NULL(item);
+  TEST_ASSERT_EQUAL_INT(sizeof(frame) + 1, item_size);
+  TEST_ASSERT_EQUAL_MEMORY(frame, item, sizeof(frame));
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, item);
+
+  // back to line mode afterwards
+  TEST_ESP_OK(_nordic_uart_linebuf_append('o'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('k'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  item = (uint8_t *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("ok", (char *)item);
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, item);
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
+
+TEST_CASE("oversized frame is skipped whole", "[buffer]") {
+  size_t item_size;
+  char *str;
+  const uint16_t len = CONFIG_NORDIC_UART_MAX_LINE_LENGTH;
+  const uint8_t hdr[] = {NORDIC_UART_FRAME_MAGIC, 0x04, (uint8_t)len, (uint8_t)(len >> 8)};
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  for (size_t i = 0; i < sizeof(hdr) - 1; ++i) {
+    TEST_ESP_OK(_nordic_uart_linebuf_append((char)hdr[i]));
+  }
+  TEST_ESP_ERR(ESP_FAIL, _nordic_uart_linebuf_append((char)hdr[sizeof(hdr) - 1]));
+  // Payload with newlines and the CRC: none of it becomes a line
+  for (int i = 0; i < len + NORDIC_UART_FRAME_CRC_LEN; ++i) {
+    TEST_ESP_OK(_nordic_uart_linebuf_append(i % 16 ? 'x' : '\n'));
+  }
+  TEST_ASSERT_NULL(xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1));
+
+  TEST_ESP_OK(_nordic_uart_linebuf_append('o'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('k'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("ok", str);
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
+
+TEST_CASE("reset drops a frame cut off by a disconnect", "[buffer]") {
+  size_t item_size;
+  char *str;
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  // Header of a 100 byte frame, then the link goes down
+  TEST_ESP_OK(_nordic_uart_linebuf_append((char)NORDIC_UART_FRAME_MAGIC));
+  TEST_ESP_OK(_nordic_uart_linebuf_append(0x04));
+  TEST_ESP_OK(_nordic_uart_linebuf_append(100));
+  TEST_ESP_OK(_nordic_uart_linebuf_append(0));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('a'));
+
+  _nordic_uart_linebuf_reset();
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\003'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("\003", str);
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  // The next connection's first line arrives intact
+  TEST_ESP_OK(_nordic_uart_linebuf_append('h'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('i'));
+  TEST_ESP_OK(_nordic_uart_linebuf_append('\n'));
+  str = (char *)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, 1);
+  TEST_ASSERT_EQUAL_STRING("hi", str);
+  vRingbufferReturnItem(nordic_uart_rx_buf_handle, str);
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
@@ -25,3 +25,19 @@ TEST_CASE("twice nordic_uart_start and stop", "[nimble]") {
   vTaskDelay(500 / portTICK_PERIOD_MS);
   nordic_uart_stop();
 }
+
+TEST_CASE("nordic_uart_set_enabled gates the service only", "[nimble]") {
+  nordic_uart_set_enabled(true); // before start: no-op
+  TEST_ASSERT_FALSE(nordic_uart_is_enabled());
+
+  TEST_ESP_OK(nordic_uart_start("Nordic UART", NULL));
+  TEST_ASSERT_TRUE(nordic_uart_is_enabled());
+  nordic_uart_set_enabled(false);
+  TEST_ASSERT_FALSE(nordic_uart_is_enabled());
+  TEST_ESP_ERR(ESP_FAIL, nordic_uart_send("x"));
+  nordic_uart_set_enabled(true);
+  TEST_ASSERT_TRUE(nordic_uart_is_enabled());
+
+  nordic_uart_stop();
+  TEST_ASSERT_FALSE(nordic_uart_is_enabled());
+}
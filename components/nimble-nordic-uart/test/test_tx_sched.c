@@ -0,0 +1,86 @@
+#include "unity.h"
+
+#include "nordic_uart_tx.h"
+#include "ble_conn_arb.h"
+
+#include <stdio.h>
+
+TEST_CASE("payload follows the ATT MTU", "[tx_sched]") {
+  TEST_ASSERT_EQUAL(20, nus_tx_payload_max(23));
+  TEST_ASSERT_EQUAL(20, nus_tx_payload_max(0));
+  TEST_ASSERT_EQUAL(244, nus_tx_payload_max(NUS_TX_PREFERRED_MTU));
+  // One full notification plus L2CAP/ATT headers fits a DLE PDU
+  TEST_ASSERT_TRUE(nus_tx_payload_max(NUS_TX_PREFERRED_MTU) + NUS_TX_ATT_HDR + 4 <= NUS_TX_DLE_OCTETS);
+}
+
+TEST_CASE("burst respects the mbuf reserve", "[tx_sched]") {
+  TEST_ASSERT_EQUAL(0, nus_tx_burst(NUS_TX_MBUF_RESERVE, 10));
+  TEST_ASSERT_EQUAL(0, nus_tx_burst(0, 10));
+  TEST_ASSERT_EQUAL(2, nus_tx_burst(NUS_TX_MBUF_RESERVE + 2, 10));
+  TEST_ASSERT_EQUAL(NUS_TX_MAX_BURST, nus_tx_burst(100, 100));
+  TEST_ASSERT_EQUAL(3, nus_tx_burst(100, 3));
+  TEST_ASSERT_EQUAL(0, nus_tx_burst(100, 0));
+}
+
+TEST_CASE("bulk profile follows the backlog with hysteresis", "[tx_sched]") {
+  nus_tx_policy_t p;
+  nus_tx_policy_init(&p);
+  TEST_ASSERT_EQUAL(NUS_CONN_IDLE, nus_tx_policy_update(&p, 200, 0));
+  TEST_ASSERT_EQUAL(NUS_CONN_BULK, nus_tx_policy_update(&p, 20000, 10));
+  // Short gaps between history pages keep the bulk profile
+  TEST_ASSERT_EQUAL(NUS_CONN_BULK, nus_tx_policy_update(&p, 0, 100));
+  TEST_ASSERT_EQUAL(NUS_CONN_BULK, nus_tx_policy_update(&p, 500, 600));
+  TEST_ASSERT_EQUAL(NUS_CONN_BULK, nus_tx_policy_update(&p, 0, 700));
+  TEST_ASSERT_EQUAL(NUS_CONN_BULK, nus_tx_policy_update(&p, 0, 700 + NUS_TX_IDLE_MS - 1));
+  TEST_ASSERT_EQUAL(NUS_CONN_IDLE, nus_tx_policy_update(&p, 0, 700 + NUS_TX_IDLE_MS));
+
+  // With the screen off the link rests in low power
+  p.low_power_pref = true;
+  TEST_ASSERT_EQUAL(NUS_CONN_LOW_POWER, nus_tx_policy_update(&p, 100, 5000));
+  TEST_ASSERT_EQUAL(NUS_CONN_BULK, nus_tx_policy_update(&p, NUS_TX_BULK_BYTES, 5001));
+  nus_tx_policy_update(&p, 0, 5002);
+  TEST_ASSERT_EQUAL(NUS_CONN_LOW_POWER, nus_tx_policy_update(&p, 0, 5002 + NUS_TX_IDLE_MS));
+}
+
+// Simulated history dump: each connection event carries up to 4 PDUs and
+// the controller frees the mbufs of the packets it sent. Compares the old
+// fixed 203 B slicing at 30-50 ms with MTU slicing on the fast profile
+// ble_host picks for a bulk request.
+static uint32_t simulate_dump(size_t total, size_t chunk, uint16_t itvl, nus_tx_meter_t* m) {
+  const int pool = 12;
+  const int per_event = 4;
+  int free_mbufs = pool;
+  int in_flight = 0;
+  uint64_t now_us = 0;
+  size_t off = 0;
+  nus_tx_meter_begin(m, 0);
+  while (off < total) {
+    unsigned burst = nus_tx_burst(free_mbufs, (total - off + chunk - 1) / chunk);
+    if (burst == 0) m->backoffs++;
+    for (unsigned b = 0; b < burst && off < total; ++b) {
+      size_t n = total - off < chunk ? total - off : chunk;
+      off += n;
+      free_mbufs--;
+      in_flight++;
+      nus_tx_meter_add(m, n, now_us);
+    }
+    // Next connection event drains what the controller can carry
+    now_us += (uint64_t)itvl * 1250;
+    int sent = in_flight < per_event ? in_flight : per_event;
+    in_flight -= sent;
+    free_mbufs += sent;
+  }
+  return nus_tx_meter_bps(m);
+}
+
+TEST_CASE("history dump throughput", "[tx_sched][bench]") {
+  nus_tx_meter_t old_m, new_m;
+  uint32_t old_bps = simulate_dump(20000, 203, ble_conn_arb_params(BLE_CONN_IDLE)->itvl_max, &old_m);
+  uint32_t new_bps = simulate_dump(20000, nus_tx_payload_max(NUS_TX_PREFERRED_MTU),
+                                   ble_conn_arb_params(BLE_CONN_FAST)->itvl_max, &new_m);
+  TEST_ASSERT_EQUAL_UINT32(20000, new_m.bytes);
+  TEST_ASSERT_GREATER_THAN(old_bps, new_bps);
+  printf("history dump (simulated): fixed 203 B @50 ms %u B/s, MTU %u B @15 ms %u B/s, %u backoffs\n",
+         (unsigned)old_bps, (unsigned)nus_tx_payload_max(NUS_TX_PREFERRED_MTU), (unsigned)new_bps,
+         (unsigned)new_m.backoffs);
+}
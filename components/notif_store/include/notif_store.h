@@ -0,0 +1,130 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Persistent notification store. Records are appended to a log on flash
+// that wraps around block by block (the oldest block is erased when the
+// head reaches it). RAM only holds a fixed index of small entries: an age
+// list, a per-app group list and a dedup hash chain, all linked by entry
+// number, so insert and delete never move data. Bodies stay on flash and
+// are read with notif_store_load() when a card is shown. Deletes are
+// written as tombstones and the index is rebuilt by replaying the log on
+// mount. Plain C over a read / write / erase interface, tested on the host
+// with a RAM flash; notif_store_file.c backs it with a file on SPIFFS.
+
+#define NOTIF_STORE_CAP        256      // live notifications indexed
+#define NOTIF_STORE_BLOCK      16384    // erase unit of the log
+#define NOTIF_STORE_BUCKETS    128      // dedup hash buckets
+#define NOTIF_STORE_GROUPS     32       // distinct apps; extra apps share the last group
+
+#define NOTIF_STORE_APP_MAX    32
+#define NOTIF_STORE_TITLE_MAX  64
+#define NOTIF_STORE_TS_MAX     40
+#define NOTIF_STORE_BODY_MAX   4096
+
+#define NOTIF_ID_NONE          0xFFFF
+
+typedef uint16_t notif_id_t;
+
+typedef struct {
+    bool (*read)(void* ctx, uint32_t off, void* buf, size_t len);
+    bool (*write)(void* ctx, uint32_t off, const void* buf, size_t len);
+    bool (*erase)(void* ctx, uint32_t off, size_t len);   // fill with 0xFF
+    void* ctx;
+    uint32_t size;                      // multiple of NOTIF_STORE_BLOCK, >= 2 blocks
+} notif_store_io_t;
+
+typedef struct {
+    char app[NOTIF_STORE_APP_MAX];
+    char title[NOTIF_STORE_TITLE_MAX];
+    char ts[NOTIF_STORE_TS_MAX];
+    uint16_t body_len;
+    uint32_t seq;
+} notif_store_item_t;
+
+typedef struct {
+    uint32_t seq;
+    uint32_t off;                       // record offset in the log
+    uint32_t hash;                      // notif_store_hash(app, title, message)
+    notif_id_t older, newer;            // age list (free list uses older)
+    notif_id_t g_older, g_newer;        // group list
+    notif_id_t h_next;                  // dedup chain
+    uint8_t group;
+    bool used;
+} notif_store_entry_t;
+
+typedef struct {
+    uint32_t app_hash;
+    uint16_t count;                     // 0 = free
+    notif_id_t newest, oldest;
+} notif_store_group_t;
+
+typedef struct {
+    uint32_t inserts;
+    uint32_t duplicates;                // pushes ignored by dedup
+    uint32_t deletes;
+    uint32_t evicted;                   // dropped by block erase or a full index
+    uint32_t erases;
+    uint32_t bytes_written;
+    uint32_t replayed;                  // records read back by the last mount
+} notif_store_stats_t;
+
+typedef struct {
+    notif_store_io_t io;
+    uint32_t nblocks;
+    uint32_t cur_block;
+    uint32_t cur_off;                   // write offset inside cur_block
+    uint32_t block_seq;
+    uint32_t next_seq;
+    notif_id_t newest, oldest, free_head;
+    uint16_t count;
+    notif_id_t buckets[NOTIF_STORE_BUCKETS];
+    notif_store_entry_t e[NOTIF_STORE_CAP];
+    notif_store_group_t g[NOTIF_STORE_GROUPS];
+    notif_store_stats_t stats;
+} notif_store_t;
+
+// Rebuild the index from the log, formatting it if it holds no valid block.
+bool notif_store_mount(notif_store_t* s, const notif_store_io_t* io);
+
+// Append a notification. A notification with the same app, title and
+// message already in the store is not written again: its id is returned
+// with *dup set. NOTIF_ID_NONE on a flash error.
+notif_id_t notif_store_add(notif_store_t* s, const char* app, const char* title,
+                           const char* message, const char* ts, bool* dup);
+
+bool notif_store_delete(notif_store_t* s, notif_id_t id);
+bool notif_store_clear(notif_store_t* s);
+
+// Read back the header fields and, when body is not NULL, the message
+// (truncated to body_max - 1 and NUL terminated).
+bool notif_store_load(const notif_store_t* s, notif_id_t id, notif_store_item_t* item,
+                      char* body, size_t body_max);
+
+static inline unsigned notif_store_count(const notif_store_t* s) { return s->count; }
+static inline notif_id_t notif_store_newest(const notif_store_t* s) { return s->newest; }
+static inline notif_id_t notif_store_older(const notif_store_t* s, notif_id_t id) { return s->e[id].older; }
+static inline notif_id_t notif_store_newer(const notif_store_t* s, notif_id_t id) { return s->e[id].newer; }
+
+// n-th newest (0 = newest) and the reverse, walking the age list
+notif_id_t notif_store_nth(const notif_store_t* s, unsigned n);
+int notif_store_index_of(const notif_store_t* s, notif_id_t id);
+
+// Per-app grouping
+static inline unsigned notif_store_group_of(const notif_store_t* s, notif_id_t id) { return s->e[id].group; }
+static inline unsigned notif_store_group_count(const notif_store_t* s, unsigned g) { return s->g[g].count; }
+static inline notif_id_t notif_store_group_newest(const notif_store_t* s, unsigned g) { return s->g[g].newest; }
+static inline notif_id_t notif_store_group_older(const notif_store_t* s, notif_id_t id) { return s->e[id].g_older; }
+
+uint32_t notif_store_hash(const char* app, const char* title, const char* message);
+
+// Backend over a plain buffer (tests, or RAM fallback when flash is missing)
+void notif_store_mem_io(notif_store_io_t* io, uint8_t* buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+#include "notif_store.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default log: 16 blocks of 16 KB on the SPIFFS "storage" partition
+#define NOTIF_STORE_FILE_PATH  "/spiffs/notif.db"
+#define NOTIF_STORE_FILE_SIZE  (16 * NOTIF_STORE_BLOCK)
+
+// Open (or create, filled with 0xFF) the log file. SPIFFS must be mounted;
+// the file stays open for the lifetime of the store.
+bool notif_store_file_io(notif_store_io_t* io, const char* path, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
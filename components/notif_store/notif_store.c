@@ -0,0 +1,471 @@
+// Flash log + RAM index for notifications (see notif_store.h)
+
+#include "notif_store.h"
+
+#include <string.h>
+
+#define BLOCK_MAGIC     0x4E535442u     // "NSTB"
+#define REC_MAGIC       0x4E52u
+#define MAX_BLOCKS      64
+
+enum {
+    REC_ITEM = 1,
+    REC_DEL = 2,                        // arg = seq of the deleted item
+    REC_CLEAR = 3,                      // arg = every item below this seq
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+} block_hdr_t;
+
+typedef struct {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t app_len;
+    uint8_t title_len;
+    uint8_t ts_len;
+    uint16_t body_len;
+    uint32_t seq;
+    uint32_t arg;                       // item: dedup hash
+    uint32_t sum;                       // FNV-1a over header (sum = 0) and payload
+} rec_hdr_t;
+
+#define FNV_INIT 2166136261u
+
+static uint32_t fnv1a(uint32_t h, const void* data, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint32_t align4(uint32_t n)
+{
+    return (n + 3u) & ~3u;
+}
+
+static inline uint32_t rec_len(const rec_hdr_t* h)
+{
+    return align4(sizeof(rec_hdr_t) + h->app_len + h->title_len + h->ts_len + h->body_len);
+}
+
+uint32_t notif_store_hash(const char* app, const char* title, const char* message)
+{
+    const char sep = 0x1f;
+    uint32_t h = FNV_INIT;
+    h = fnv1a(h, app ? app : "", app ? strlen(app) : 0);
+    h = fnv1a(h, &sep, 1);
+    h = fnv1a(h, title ? title : "", title ? strlen(title) : 0);
+    h = fnv1a(h, &sep, 1);
+    return fnv1a(h, message ? message : "", message ? strlen(message) : 0);
+}
+
+/* ---------- RAM index ---------- */
+
+static unsigned group_find(notif_store_t* s, uint32_t app_hash)
+{
+    unsigned free_g = NOTIF_STORE_GROUPS;
+    for (unsigned g = 0; g < NOTIF_STORE_GROUPS; ++g) {
+        if (s->g[g].count && s->g[g].app_hash == app_hash) return g;
+        if (!s->g[g].count && free_g == NOTIF_STORE_GROUPS) free_g = g;
+    }
+    if (free_g == NOTIF_STORE_GROUPS) return NOTIF_STORE_GROUPS - 1;  // shared overflow group
+    s->g[free_g].app_hash = app_hash;
+    s->g[free_g].newest = s->g[free_g].oldest = NOTIF_ID_NONE;
+    return free_g;
+}
+
+static void entry_remove(notif_store_t* s, notif_id_t id)
+{
+    notif_store_entry_t* e = &s->e[id];
+
+    if (e->newer != NOTIF_ID_NONE) s->e[e->newer].older = e->older; else s->newest = e->older;
+    if (e->older != NOTIF_ID_NONE) s->e[e->older].newer = e->newer; else s->oldest = e->newer;
+
+    notif_store_group_t* g = &s->g[e->group];
+    if (e->g_newer != NOTIF_ID_NONE) s->e[e->g_newer].g_older = e->g_older; else g->newest = e->g_older;
+    if (e->g_older != NOTIF_ID_NONE) s->e[e->g_older].g_newer = e->g_newer; else g->oldest = e->g_newer;
+    g->count--;
+
+    notif_id_t* link = &s->buckets[e->hash % NOTIF_STORE_BUCKETS];
+    while (*link != id) link = &s->e[*link].h_next;
+    *link = e->h_next;
+
+    e->used = false;
+    e->older = s->free_head;
+    s->free_head = id;
+    s->count--;
+}
+
+static notif_id_t entry_alloc(notif_store_t* s)
+{
+    if (s->free_head == NOTIF_ID_NONE) {
+        // Index full: the oldest notification makes room
+        entry_remove(s, s->oldest);
+        s->stats.evicted++;
+    }
+    notif_id_t id = s->free_head;
+    s->free_head = s->e[id].older;
+    return id;
+}
+
+static notif_id_t entry_insert(notif_store_t* s, uint32_t seq, uint32_t off, uint32_t hash,
+                               uint32_t app_hash)
+{
+    notif_id_t id = entry_alloc(s);
+    notif_store_entry_t* e = &s->e[id];
+    memset(e, 0, sizeof(*e));
+    e->used = true;
+    e->seq = seq;
+    e->off = off;
+    e->hash = hash;
+
+    e->newer = NOTIF_ID_NONE;
+    e->older = s->newest;
+    if (s->newest != NOTIF_ID_NONE) s->e[s->newest].newer = id; else s->oldest = id;
+    s->newest = id;
+
+    unsigned gi = group_find(s, app_hash);
+    notif_store_group_t* g = &s->g[gi];
+    e->group = (uint8_t)gi;
+    e->g_newer = NOTIF_ID_NONE;
+    e->g_older = g->newest;
+    if (g->newest != NOTIF_ID_NONE) s->e[g->newest].g_newer = id; else g->oldest = id;
+    g->newest = id;
+    g->count++;
+
+    notif_id_t* bucket = &s->buckets[hash % NOTIF_STORE_BUCKETS];
+    e->h_next = *bucket;
+    *bucket = id;
+
+    s->count++;
+    return id;
+}
+
+static notif_id_t find_hash(const notif_store_t* s, uint32_t hash)
+{
+    for (notif_id_t id = s->buckets[hash % NOTIF_STORE_BUCKETS]; id != NOTIF_ID_NONE; id = s->e[id].h_next) {
+        if (s->e[id].hash == hash) return id;
+    }
+    return NOTIF_ID_NONE;
+}
+
+static void index_reset(notif_store_t* s)
+{
+    memset(s->e, 0, sizeof(s->e));
+    memset(s->g, 0, sizeof(s->g));
+    for (unsigned i = 0; i < NOTIF_STORE_BUCKETS; ++i) s->buckets[i] = NOTIF_ID_NONE;
+    for (unsigned i = 0; i < NOTIF_STORE_CAP; ++i) {
+        s->e[i].older = (i + 1 < NOTIF_STORE_CAP) ? (notif_id_t)(i + 1) : NOTIF_ID_NONE;
+    }
+    s->free_head = 0;
+    s->newest = s->oldest = NOTIF_ID_NONE;
+    s->count = 0;
+}
+
+/* ---------- Flash log ---------- */
+
+static inline uint32_t block_base(uint32_t b)
+{
+    return b * NOTIF_STORE_BLOCK;
+}
+
+// Move the head to the next block: everything still indexed there is the
+// oldest data in the store and goes first
+static bool advance_block(notif_store_t* s)
+{
+    uint32_t next = (s->cur_block + 1) % s->nblocks;
+    uint32_t lo = block_base(next), hi = lo + NOTIF_STORE_BLOCK;
+    for (notif_id_t id = 0; id < NOTIF_STORE_CAP; ++id) {
+        if (s->e[id].used && s->e[id].off >= lo && s->e[id].off < hi) {
+            entry_remove(s, id);
+            s->stats.evicted++;
+        }
+    }
+    if (!s->io.erase(s->io.ctx, lo, NOTIF_STORE_BLOCK)) return false;
+    s->stats.erases++;
+
+    block_hdr_t bh = { .magic = BLOCK_MAGIC, .seq = ++s->block_seq };
+    if (!s->io.write(s->io.ctx, lo, &bh, sizeof(bh))) return false;
+    s->cur_block = next;
+    s->cur_off = sizeof(bh);
+    return true;
+}
+
+// Append one record made of a header and up to four strings. Returns its
+// offset, or UINT32_MAX on a flash error.
+static uint32_t append(notif_store_t* s, rec_hdr_t* h, const char* const part[4])
+{
+    const size_t len[4] = { h->app_len, h->title_len, h->ts_len, h->body_len };
+    uint32_t total = rec_len(h);
+    if (s->cur_off + total > NOTIF_STORE_BLOCK && !advance_block(s)) return UINT32_MAX;
+
+    h->magic = REC_MAGIC;
+    h->seq = s->next_seq++;
+    h->sum = 0;
+    uint32_t sum = fnv1a(FNV_INIT, h, sizeof(*h));
+    for (int i = 0; i < 4; ++i) sum = fnv1a(sum, part[i], len[i]);
+    h->sum = sum;
+
+    uint32_t off = block_base(s->cur_block) + s->cur_off;
+    uint32_t pos = off;
+    if (!s->io.write(s->io.ctx, pos, h, sizeof(*h))) return UINT32_MAX;
+    pos += sizeof(*h);
+    for (int i = 0; i < 4; ++i) {
+        if (len[i] && !s->io.write(s->io.ctx, pos, part[i], len[i])) return UINT32_MAX;
+        pos += (uint32_t)len[i];
+    }
+    s->cur_off += total;
+    s->stats.bytes_written += total;
+    return off;
+}
+
+static size_t clamp_len(const char* str, size_t max)
+{
+    if (!str) return 0;
+    size_t n = strlen(str);
+    return n < max ? n : max - 1;
+}
+
+notif_id_t notif_store_add(notif_store_t* s, const char* app, const char* title,
+                           const char* message, const char* ts, bool* dup)
+{
+    uint32_t hash = notif_store_hash(app, title, message);
+    notif_id_t id = find_hash(s, hash);
+    if (dup) *dup = id != NOTIF_ID_NONE;
+    if (id != NOTIF_ID_NONE) {
+        s->stats.duplicates++;
+        return id;
+    }
+
+    rec_hdr_t h = {
+        .type = REC_ITEM,
+        .app_len = (uint8_t)clamp_len(app, NOTIF_STORE_APP_MAX),
+        .title_len = (uint8_t)clamp_len(title, NOTIF_STORE_TITLE_MAX),
+        .ts_len = (uint8_t)clamp_len(ts, NOTIF_STORE_TS_MAX),
+        .body_len = (uint16_t)clamp_len(message, NOTIF_STORE_BODY_MAX),
+        .arg = hash,
+    };
+    const char* const part[4] = { app, title, ts, message };
+    uint32_t off = append(s, &h, part);
+    if (off == UINT32_MAX) return NOTIF_ID_NONE;
+
+    s->stats.inserts++;
+    return entry_insert(s, h.seq, off, hash, fnv1a(FNV_INIT, app, h.app_len));
+}
+
+bool notif_store_delete(notif_store_t* s, notif_id_t id)
+{
+    if (id >= NOTIF_STORE_CAP || !s->e[id].used) return false;
+    rec_hdr_t h = { .type = REC_DEL, .arg = s->e[id].seq };
+    const char* const none[4] = { 0 };
+    if (append(s, &h, none) == UINT32_MAX) return false;
+    entry_remove(s, id);
+    s->stats.deletes++;
+    return true;
+}
+
+bool notif_store_clear(notif_store_t* s)
+{
+    rec_hdr_t h = { .type = REC_CLEAR, .arg = s->next_seq };
+    const char* const none[4] = { 0 };
+    if (append(s, &h, none) == UINT32_MAX) return false;
+    s->stats.deletes += s->count;
+    index_reset(s);
+    return true;
+}
+
+static bool read_str(const notif_store_t* s, uint32_t off, size_t len, char* out, size_t max)
+{
+    size_t n = len < max ? len : max - 1;
+    if (n && !s->io.read(s->io.ctx, off, out, n)) return false;
+    out[n] = '\0';
+    return true;
+}
+
+bool notif_store_load(const notif_store_t* s, notif_id_t id, notif_store_item_t* item,
+                      char* body, size_t body_max)
+{
+    if (id >= NOTIF_STORE_CAP || !s->e[id].used) return false;
+    rec_hdr_t h;
+    uint32_t off = s->e[id].off;
+    if (!s->io.read(s->io.ctx, off, &h, sizeof(h)) || h.magic != REC_MAGIC) return false;
+    off += sizeof(h);
+
+    if (item) {
+        if (!read_str(s, off, h.app_len, item->app, sizeof(item->app)) ||
+            !read_str(s, off + h.app_len, h.title_len, item->title, sizeof(item->title)) ||
+            !read_str(s, off + h.app_len + h.title_len, h.ts_len, item->ts, sizeof(item->ts))) {
+            return false;
+        }
+        item->body_len = h.body_len;
+        item->seq = h.seq;
+    }
+    if (body && body_max) {
+        return read_str(s, off + h.app_len + h.title_len + h.ts_len, h.body_len, body, body_max);
+    }
+    return true;
+}
+
+notif_id_t notif_store_nth(const notif_store_t* s, unsigned n)
+{
+    notif_id_t id = s->newest;
+    while (n-- && id != NOTIF_ID_NONE) id = s->e[id].older;
+    return id;
+}
+
+int notif_store_index_of(const notif_store_t* s, notif_id_t id)
+{
+    int n = 0;
+    for (notif_id_t it = s->newest; it != NOTIF_ID_NONE; it = s->e[it].older, ++n) {
+        if (it == id) return n;
+    }
+    return -1;
+}
+
+/* ---------- Mount ---------- */
+
+// Verify one record and feed it to the index. False on a torn or corrupt
+// record: the rest of the block is not trusted.
+static bool replay_record(notif_store_t* s, uint32_t off, const rec_hdr_t* hdr)
+{
+    rec_hdr_t h = *hdr;
+    uint32_t want = h.sum;
+    h.sum = 0;
+    uint32_t sum = fnv1a(FNV_INIT, &h, sizeof(h));
+
+    uint8_t buf[64];
+    uint32_t app_hash = FNV_INIT;
+    uint32_t pos = off + sizeof(h);
+    uint32_t left = h.app_len + h.title_len + h.ts_len + h.body_len;
+    uint32_t app_left = h.app_len;
+    while (left) {
+        uint32_t n = left < sizeof(buf) ? left : sizeof(buf);
+        if (!s->io.read(s->io.ctx, pos, buf, n)) return false;
+        sum = fnv1a(sum, buf, n);
+        if (app_left) {
+            uint32_t a = app_left < n ? app_left : n;
+            app_hash = fnv1a(app_hash, buf, a);
+            app_left -= a;
+        }
+        pos += n;
+        left -= n;
+    }
+    if (sum != want) return false;
+
+    switch (h.type) {
+    case REC_ITEM:
+        entry_insert(s, h.seq, off, h.arg, app_hash);
+        break;
+    case REC_DEL:
+        for (notif_id_t id = 0; id < NOTIF_STORE_CAP; ++id) {
+            if (s->e[id].used && s->e[id].seq == h.arg) {
+                entry_remove(s, id);
+                break;
+            }
+        }
+        break;
+    case REC_CLEAR:
+        for (notif_id_t id = 0; id < NOTIF_STORE_CAP; ++id) {
+            if (s->e[id].used && s->e[id].seq < h.arg) entry_remove(s, id);
+        }
+        break;
+    default:
+        break;
+    }
+    if (h.seq >= s->next_seq) s->next_seq = h.seq + 1;
+    s->stats.replayed++;
+    return true;
+}
+
+bool notif_store_mount(notif_store_t* s, const notif_store_io_t* io)
+{
+    memset(s, 0, sizeof(*s));
+    s->io = *io;
+    s->nblocks = io->size / NOTIF_STORE_BLOCK;
+    if (s->nblocks < 2 || s->nblocks > MAX_BLOCKS) return false;
+    index_reset(s);
+
+    // Valid blocks in write order
+    uint8_t order[MAX_BLOCKS];
+    uint32_t seqs[MAX_BLOCKS];
+    unsigned n = 0;
+    for (uint32_t b = 0; b < s->nblocks; ++b) {
+        block_hdr_t bh;
+        if (!io->read(io->ctx, block_base(b), &bh, sizeof(bh))) return false;
+        if (bh.magic != BLOCK_MAGIC) continue;
+        unsigned i = n++;
+        while (i > 0 && seqs[i - 1] > bh.seq) {
+            seqs[i] = seqs[i - 1];
+            order[i] = order[i - 1];
+            --i;
+        }
+        seqs[i] = bh.seq;
+        order[i] = (uint8_t)b;
+    }
+
+    s->next_seq = 1;
+    if (n == 0) {
+        s->cur_block = s->nblocks - 1;
+        return advance_block(s);
+    }
+
+    for (unsigned i = 0; i < n; ++i) {
+        uint32_t base = block_base(order[i]);
+        uint32_t off = sizeof(block_hdr_t);
+        bool clean = true;
+        while (off + sizeof(rec_hdr_t) <= NOTIF_STORE_BLOCK) {
+            rec_hdr_t h;
+            if (!io->read(io->ctx, base + off, &h, sizeof(h))) return false;
+            if (h.magic == 0xFFFF) break;               // erased: end of block
+            if (h.magic != REC_MAGIC || off + rec_len(&h) > NOTIF_STORE_BLOCK ||
+                !replay_record(s, base + off, &h)) {
+                clean = false;
+                break;
+            }
+            off += rec_len(&h);
+        }
+        s->cur_block = order[i];
+        // After a torn write, continue in a fresh block
+        s->cur_off = clean ? off : NOTIF_STORE_BLOCK;
+        s->block_seq = seqs[i];
+    }
+    return true;
+}
+
+/* ---------- RAM backend ---------- */
+
+static bool mem_read(void* ctx, uint32_t off, void* buf, size_t len)
+{
+    uint8_t* mem = (uint8_t*)ctx;
+    memcpy(buf, mem + off, len);
+    return true;
+}
+
+static bool mem_write(void* ctx, uint32_t off, const void* buf, size_t len)
+{
+    // NOR semantics: programming only clears bits
+    uint8_t* mem = (uint8_t*)ctx;
+    const uint8_t* src = (const uint8_t*)buf;
+    for (size_t i = 0; i < len; ++i) mem[off + i] &= src[i];
+    return true;
+}
+
+static bool mem_erase(void* ctx, uint32_t off, size_t len)
+{
+    memset((uint8_t*)ctx + off, 0xFF, len);
+    return true;
+}
+
+void notif_store_mem_io(notif_store_io_t* io, uint8_t* buf, uint32_t size)
+{
+    io->read = mem_read;
+    io->write = mem_write;
+    io->erase = mem_erase;
+    io->ctx = buf;
+    io->size = size;
+}
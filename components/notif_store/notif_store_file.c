@@ -0,0 +1,66 @@
+// notif_store backend over one preallocated file on SPIFFS
+
+#include "notif_store_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+static const char* TAG = "NOTIF_STORE";
+
+static bool file_read(void* ctx, uint32_t off, void* buf, size_t len)
+{
+    FILE* f = (FILE*)ctx;
+    return fseek(f, (long)off, SEEK_SET) == 0 && fread(buf, 1, len, f) == len;
+}
+
+static bool file_write(void* ctx, uint32_t off, const void* buf, size_t len)
+{
+    FILE* f = (FILE*)ctx;
+    if (fseek(f, (long)off, SEEK_SET) != 0 || fwrite(buf, 1, len, f) != len) return false;
+    return fflush(f) == 0;
+}
+
+static bool file_erase(void* ctx, uint32_t off, size_t len)
+{
+    static const uint8_t ff[256] = {
+        [0 ... 255] = 0xFF,
+    };
+    FILE* f = (FILE*)ctx;
+    if (fseek(f, (long)off, SEEK_SET) != 0) return false;
+    while (len) {
+        size_t n = len < sizeof(ff) ? len : sizeof(ff);
+        if (fwrite(ff, 1, n, f) != n) return false;
+        len -= n;
+    }
+    return fflush(f) == 0;
+}
+
+bool notif_store_file_io(notif_store_io_t* io, const char* path, uint32_t size)
+{
+    FILE* f = fopen(path, "r+b");
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        if ((uint32_t)ftell(f) != size) {
+            ESP_LOGW(TAG, "%s has the wrong size, recreating", path);
+            fclose(f);
+            f = NULL;
+        }
+    }
+    if (!f) {
+        // The store formats itself on mount; the file only has to exist
+        f = fopen(path, "w+b");
+        if (!f || !file_erase(f, 0, size)) {
+            ESP_LOGE(TAG, "Can't create %s", path);
+            if (f) fclose(f);
+            return false;
+        }
+    }
+    io->read = file_read;
+    io->write = file_write;
+    io->erase = file_erase;
+    io->ctx = f;
+    io->size = size;
+    return true;
+}
@@ -0,0 +1,229 @@
+#include "unity.h"
+
+#include "notif_store.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FLASH_SIZE (8 * NOTIF_STORE_BLOCK)
+
+static uint8_t s_flash[FLASH_SIZE];
+static notif_store_t s_store;
+static notif_store_t s_again;
+static char s_body[NOTIF_STORE_BODY_MAX];
+
+static void fresh(notif_store_t* s, notif_store_io_t* io) {
+  memset(s_flash, 0x5A, sizeof(s_flash));  // not erased: mount must format
+  notif_store_mem_io(io, s_flash, sizeof(s_flash));
+  TEST_ASSERT_TRUE(notif_store_mount(s, io));
+}
+
+static notif_id_t add(notif_store_t* s, const char* app, int n, size_t body_len) {
+  char title[32];
+  static char body[NOTIF_STORE_BODY_MAX];
+  snprintf(title, sizeof(title), "title %d", n);
+  size_t k = (size_t)snprintf(body, sizeof(body), "#%d#", n);
+  if (body_len < k) body_len = k;
+  memset(body + k, 'a' + n % 26, body_len - k);
+  body[body_len] = '\0';
+  bool dup;
+  notif_id_t id = notif_store_add(s, app, title, body, "2025-01-01T10:00:00", &dup);
+  TEST_ASSERT_NOT_EQUAL(NOTIF_ID_NONE, id);
+  TEST_ASSERT_FALSE(dup);
+  return id;
+}
+
+// Same sequence of items, newest first, in both stores
+static void assert_same(const notif_store_t* a, const notif_store_t* b) {
+  TEST_ASSERT_EQUAL(notif_store_count(a), notif_store_count(b));
+  notif_id_t x = notif_store_newest(a), y = notif_store_newest(b);
+  while (x != NOTIF_ID_NONE) {
+    notif_store_item_t ia, ib;
+    TEST_ASSERT_TRUE(notif_store_load(a, x, &ia, NULL, 0));
+    TEST_ASSERT_TRUE(notif_store_load(b, y, &ib, NULL, 0));
+    TEST_ASSERT_EQUAL_UINT32(ia.seq, ib.seq);
+    TEST_ASSERT_EQUAL_STRING(ia.title, ib.title);
+    x = notif_store_older(a, x);
+    y = notif_store_older(b, y);
+  }
+  TEST_ASSERT_EQUAL(NOTIF_ID_NONE, y);
+}
+
+TEST_CASE("insert, dedup, lazy body load", "[notif_store]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  TEST_ASSERT_EQUAL(0, notif_store_count(&s_store));
+
+  bool dup;
+  notif_id_t a = notif_store_add(&s_store, "com.whatsapp", "Ana", "hola", "2025-01-01T10:00:00", &dup);
+  TEST_ASSERT_FALSE(dup);
+  notif_id_t b = notif_store_add(&s_store, "sms", "Luis", "ok", "2025-01-01T10:01:00", &dup);
+  TEST_ASSERT_FALSE(dup);
+  // Same app, title and message (different timestamp): ignored
+  TEST_ASSERT_EQUAL(a, notif_store_add(&s_store, "com.whatsapp", "Ana", "hola", "2025-01-01T10:05:00", &dup));
+  TEST_ASSERT_TRUE(dup);
+  TEST_ASSERT_EQUAL_UINT32(1, s_store.stats.duplicates);
+  TEST_ASSERT_EQUAL(2, notif_store_count(&s_store));
+
+  TEST_ASSERT_EQUAL(b, notif_store_newest(&s_store));
+  TEST_ASSERT_EQUAL(a, notif_store_nth(&s_store, 1));
+  TEST_ASSERT_EQUAL(1, notif_store_index_of(&s_store, a));
+
+  notif_store_item_t it;
+  TEST_ASSERT_TRUE(notif_store_load(&s_store, a, &it, NULL, 0));
+  TEST_ASSERT_EQUAL_STRING("com.whatsapp", it.app);
+  TEST_ASSERT_EQUAL_STRING("Ana", it.title);
+  TEST_ASSERT_EQUAL_STRING("2025-01-01T10:00:00", it.ts);
+  TEST_ASSERT_EQUAL(4, it.body_len);
+  TEST_ASSERT_TRUE(notif_store_load(&s_store, a, NULL, s_body, sizeof(s_body)));
+  TEST_ASSERT_EQUAL_STRING("hola", s_body);
+  // Truncated into a small buffer
+  char small[3];
+  TEST_ASSERT_TRUE(notif_store_load(&s_store, a, NULL, small, sizeof(small)));
+  TEST_ASSERT_EQUAL_STRING("ho", small);
+
+  // Oversized fields are clamped, not rejected
+  static char big[NOTIF_STORE_BODY_MAX + 100];
+  memset(big, 'x', sizeof(big) - 1);
+  notif_id_t c = notif_store_add(&s_store, "app", "t", big, "", NULL);
+  TEST_ASSERT_TRUE(notif_store_load(&s_store, c, &it, s_body, sizeof(s_body)));
+  TEST_ASSERT_EQUAL(NOTIF_STORE_BODY_MAX - 1, it.body_len);
+  TEST_ASSERT_EQUAL(NOTIF_STORE_BODY_MAX - 1, strlen(s_body));
+}
+
+TEST_CASE("per-app groups", "[notif_store]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  notif_id_t w1 = add(&s_store, "com.whatsapp", 1, 10);
+  notif_id_t s1 = add(&s_store, "sms", 2, 10);
+  notif_id_t w2 = add(&s_store, "com.whatsapp", 3, 10);
+
+  unsigned gw = notif_store_group_of(&s_store, w1);
+  TEST_ASSERT_EQUAL(gw, notif_store_group_of(&s_store, w2));
+  TEST_ASSERT_NOT_EQUAL(gw, notif_store_group_of(&s_store, s1));
+  TEST_ASSERT_EQUAL(2, notif_store_group_count(&s_store, gw));
+  TEST_ASSERT_EQUAL(w2, notif_store_group_newest(&s_store, gw));
+  TEST_ASSERT_EQUAL(w1, notif_store_group_older(&s_store, w2));
+
+  TEST_ASSERT_TRUE(notif_store_delete(&s_store, w2));
+  TEST_ASSERT_EQUAL(1, notif_store_group_count(&s_store, gw));
+  TEST_ASSERT_EQUAL(w1, notif_store_group_newest(&s_store, gw));
+  TEST_ASSERT_FALSE(notif_store_delete(&s_store, w2));
+}
+
+TEST_CASE("deletes and clear survive a remount", "[notif_store]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  notif_id_t ids[10];
+  for (int i = 0; i < 10; ++i) ids[i] = add(&s_store, i & 1 ? "sms" : "mail", i, 100);
+  TEST_ASSERT_TRUE(notif_store_delete(&s_store, ids[3]));
+  TEST_ASSERT_TRUE(notif_store_delete(&s_store, ids[9]));
+  TEST_ASSERT_EQUAL(8, notif_store_count(&s_store));
+
+  TEST_ASSERT_TRUE(notif_store_mount(&s_again, &io));
+  assert_same(&s_store, &s_again);
+  // A re-added deleted notification is new again, not a duplicate
+  add(&s_again, "mail", 9, 100);
+
+  TEST_ASSERT_TRUE(notif_store_clear(&s_again));
+  TEST_ASSERT_EQUAL(0, notif_store_count(&s_again));
+  add(&s_again, "sms", 42, 100);
+  TEST_ASSERT_TRUE(notif_store_mount(&s_store, &io));
+  TEST_ASSERT_EQUAL(1, notif_store_count(&s_store));
+  assert_same(&s_store, &s_again);
+}
+
+TEST_CASE("log wraps by erasing the oldest block", "[notif_store]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  // ~1 KB records: 15 per block, the 8-block log wraps several times
+  for (int i = 0; i < 400; ++i) {
+    add(&s_store, "com.whatsapp", i, 1000);
+    if (i % 37 == 0 && notif_store_count(&s_store) > 2) {
+      TEST_ASSERT_TRUE(notif_store_delete(&s_store, notif_store_nth(&s_store, 1)));
+    }
+  }
+  TEST_ASSERT_TRUE(s_store.stats.erases > 8);
+  TEST_ASSERT_TRUE(s_store.stats.evicted > 0);
+  // At most one block's worth is lost to the erase in progress
+  TEST_ASSERT_TRUE(notif_store_count(&s_store) >= 6 * 15);
+
+  notif_store_item_t it;
+  TEST_ASSERT_TRUE(notif_store_load(&s_store, notif_store_newest(&s_store), &it, s_body, sizeof(s_body)));
+  TEST_ASSERT_EQUAL_STRING("title 399", it.title);
+  TEST_ASSERT_EQUAL(1000, strlen(s_body));
+
+  TEST_ASSERT_TRUE(notif_store_mount(&s_again, &io));
+  assert_same(&s_store, &s_again);
+  add(&s_again, "sms", 1000, 10);
+}
+
+TEST_CASE("full index drops the oldest", "[notif_store]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  for (int i = 0; i < NOTIF_STORE_CAP + 20; ++i) add(&s_store, "x", i, 8);
+  TEST_ASSERT_EQUAL(NOTIF_STORE_CAP, notif_store_count(&s_store));
+  notif_store_item_t it;
+  TEST_ASSERT_TRUE(notif_store_load(&s_store, notif_store_nth(&s_store, NOTIF_STORE_CAP - 1), &it, NULL, 0));
+  TEST_ASSERT_EQUAL_STRING("title 20", it.title);
+
+  TEST_ASSERT_TRUE(notif_store_mount(&s_again, &io));
+  assert_same(&s_store, &s_again);
+}
+
+TEST_CASE("torn write is dropped on mount", "[notif_store]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  for (int i = 0; i < 5; ++i) add(&s_store, "sms", i, 50);
+  notif_id_t last = notif_store_newest(&s_store);
+  // Power lost half way through the newest record's body
+  uint32_t off = s_store.e[last].off;
+  s_flash[off + 60] ^= 0xFF;
+
+  TEST_ASSERT_TRUE(notif_store_mount(&s_again, &io));
+  TEST_ASSERT_EQUAL(4, notif_store_count(&s_again));
+  // Writing resumes in a fresh block, the damaged one is left alone
+  uint32_t block = off / NOTIF_STORE_BLOCK;
+  notif_id_t id = add(&s_again, "sms", 99, 50);
+  TEST_ASSERT_NOT_EQUAL(block, s_again.e[id].off / NOTIF_STORE_BLOCK);
+  TEST_ASSERT_TRUE(notif_store_mount(&s_store, &io));
+  TEST_ASSERT_EQUAL(5, notif_store_count(&s_store));
+}
+
+// The old UI buffer shifted all its ~4.2 KB items on every insert
+typedef struct {
+  char app[32];
+  char title[64];
+  char message[NOTIF_STORE_BODY_MAX];
+  char ts[40];
+} legacy_item_t;
+
+static legacy_item_t s_legacy[5];
+
+TEST_CASE("insert throughput", "[notif_store][bench]") {
+  notif_store_io_t io;
+  fresh(&s_store, &io);
+  const int n = 2000;
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < n; ++i) add(&s_store, i % 3 ? "com.whatsapp" : "sms", i, 200);
+  int64_t dt = esp_timer_get_time() - t0;
+
+  t0 = esp_timer_get_time();
+  for (int i = 0; i < n; ++i) {
+    for (int k = 4; k > 0; --k) s_legacy[k] = s_legacy[k - 1];
+    snprintf(s_legacy[0].title, sizeof(s_legacy[0].title), "title %d", i);
+  }
+  int64_t dt_legacy = esp_timer_get_time() - t0;
+
+  t0 = esp_timer_get_time();
+  TEST_ASSERT_TRUE(notif_store_mount(&s_again, &io));
+  int64_t dt_mount = esp_timer_get_time() - t0;
+
+  printf("notif_store: %d inserts in %u us (%u/s), %u B/insert on flash, %u erases, %u indexed "
+         "(legacy 5-item shift: %u us); mount replayed %u records in %u us\n",
+         n, (unsigned)dt, dt > 0 ? (unsigned)((int64_t)n * 1000000 / dt) : 0,
+         (unsigned)(s_store.stats.bytes_written / s_store.stats.inserts), (unsigned)s_store.stats.erases,
+         notif_store_count(&s_store), (unsigned)dt_legacy, (unsigned)s_again.stats.replayed,
+         (unsigned)dt_mount);
+}
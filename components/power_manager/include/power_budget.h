@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Current / energy budget per power state. Plain C with no ESP-IDF
+// dependency, so the same model runs on target (fed with measured state
+// residency) and on the host (fed with a usage profile). Only the
+// residency is measured: the per-state currents below are estimates until
+// POWER_BUDGET_MEASURED is set, and every figure derived from them (charge,
+// energy, runtime) is an estimate too.
+
+typedef enum {
+    PM_STATE_ACTIVE = 0,   // display on, user interacting, light sleep blocked
+    PM_STATE_DIMMED,       // display on at low brightness, light sleep blocked
+    PM_STATE_SCREEN_OFF,   // panel asleep, automatic light sleep, BLE connected
+    PM_STATE_DEEP_IDLE,    // long screen-off, only wake sources and BLE keepalive
+    PM_STATE_COUNT
+} power_state_t;
+
+// Average supply current per state, in microamps.
+// Estimates for this board (ESP32-S3 + 2.06" AMOLED + AXP2101) at 3.9 V from
+// datasheet figures, not measured; replace them with bench measurements
+// (power_manager prints the measured residency to combine with them) and
+// set POWER_BUDGET_MEASURED.
+#ifndef POWER_BUDGET_MEASURED
+#define POWER_BUDGET_MEASURED       0
+#endif
+#define POWER_BUDGET_ACTIVE_UA      62000u  // 80-240 MHz DFS, panel at 60 %
+#define POWER_BUDGET_DIMMED_UA      31000u  // panel at ~15 %
+#define POWER_BUDGET_SCREEN_OFF_UA   2600u  // light sleep, BLE 30-50 ms conn interval
+#define POWER_BUDGET_DEEP_IDLE_UA    1100u  // light sleep, relaxed BLE, IMU wake-on-motion
+
+#define POWER_BUDGET_BATTERY_MAH     300u
+#define POWER_BUDGET_VBAT_MV         3900u
+
+typedef struct {
+    uint32_t current_ua[PM_STATE_COUNT];
+} power_budget_t;
+
+// Budget filled with the POWER_BUDGET_*_UA figures (estimates unless
+// POWER_BUDGET_MEASURED).
+void power_budget_default(power_budget_t* b);
+
+// Time-weighted average current for the given residency (any time unit).
+uint32_t power_budget_avg_ua(const power_budget_t* b, const uint64_t residency[PM_STATE_COUNT]);
+
+// Charge drawn in microamp-hours for residency given in microseconds.
+uint64_t power_budget_charge_uah(const power_budget_t* b, const uint64_t residency_us[PM_STATE_COUNT]);
+
+// Energy in microwatt-hours at the given battery voltage.
+uint64_t power_budget_energy_uwh(uint64_t charge_uah, uint32_t vbat_mv);
+
+// Hours a battery of capacity_mah lasts at avg_ua (0 current -> UINT32_MAX).
+uint32_t power_budget_runtime_h(uint32_t capacity_mah, uint32_t avg_ua);
+
+const char* power_state_name(power_state_t s);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_event.h"
+#include "power_budget.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// System power policy: DFS between POWER_MANAGER_MIN_MHZ and
+// POWER_MANAGER_MAX_MHZ with automatic light sleep and GPIO wake enabled
+// (IMU, touch, PMIC and BOOT pins are armed by their drivers; BLE wakes
+// through controller modem sleep), plus residency accounting per
+// power_state_t. The display manager decides the state; this component
+// records it and notifies POWER_MANAGER_EVENT_BASE listeners.
+
+#ifndef POWER_MANAGER_MAX_MHZ
+#define POWER_MANAGER_MAX_MHZ 240
+#endif
+#ifndef POWER_MANAGER_MIN_MHZ
+#define POWER_MANAGER_MIN_MHZ 80
+#endif
+
+ESP_EVENT_DECLARE_BASE(POWER_MANAGER_EVENT_BASE);
+
+typedef enum {
+    POWER_MANAGER_EVT_STATE = 1,   // payload: power_state_t (new state)
+} power_manager_event_id_t;
+
+// Configure DFS + light sleep and the wake sources. Call once, early.
+esp_err_t power_manager_init(void);
+
+void power_manager_set_state(power_state_t state);
+power_state_t power_manager_get_state(void);
+
+// Time spent in each state since boot, in microseconds (includes the
+// current state up to now).
+void power_manager_get_residency(uint64_t out_us[PM_STATE_COUNT]);
+
+// Log residency (measured), transitions and the charge/energy power_budget
+// derives from it (estimated while POWER_BUDGET_MEASURED is 0).
+void power_manager_dump_stats(void);
+
+// ---------------------------------------------------------------------------
+// CPU boost: bursty workloads hold an ESP_PM_CPU_FREQ_MAX lock only while
+// they run, so the clock sits at POWER_MANAGER_MIN_MHZ the rest of the time.
+// Sections nest (per workload and across workloads) and may be entered from
+// any task, never from an ISR.
+// ---------------------------------------------------------------------------
+typedef enum {
+    PM_BOOST_UI_ANIM = 0,  // tileview scroll / snap animation
+    PM_BOOST_AUDIO,        // WAV read + decode
+    PM_BOOST_BLE_RX,       // JSON parsing of received BLE messages
+    PM_BOOST_STORAGE,      // settings save, SPIFFS format
+    PM_BOOST_COUNT
+} pm_boost_t;
+
+void power_manager_boost_begin(pm_boost_t w);
+void power_manager_boost_end(pm_boost_t w);
+
+// With boosting disabled the sections are still timed but no lock is taken,
+// so the per-workload durations of both runs give the latency impact of the
+// boost. Toggling clears the boost statistics.
+void power_manager_set_boost_enabled(bool enabled);
+
+typedef struct {
+    uint32_t count;        // completed outermost sections
+    uint64_t total_us;     // summed section duration
+    uint32_t max_us;       // longest section
+} pm_boost_stats_t;
+
+void power_manager_get_boost_stats(pm_boost_t w, pm_boost_stats_t* out);
+
+// Time with at least one boost held (CPU at POWER_MANAGER_MAX_MHZ because of
+// a boost) and the remaining time, since boot or the last toggle.
+void power_manager_get_freq_residency(uint64_t* boosted_us, uint64_t* base_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,52 @@
+#include "power_budget.h"
+#include <stddef.h>
+
+void power_budget_default(power_budget_t* b)
+{
+    if (!b) return;
+    b->current_ua[PM_STATE_ACTIVE] = POWER_BUDGET_ACTIVE_UA;
+    b->current_ua[PM_STATE_DIMMED] = POWER_BUDGET_DIMMED_UA;
+    b->current_ua[PM_STATE_SCREEN_OFF] = POWER_BUDGET_SCREEN_OFF_UA;
+    b->current_ua[PM_STATE_DEEP_IDLE] = POWER_BUDGET_DEEP_IDLE_UA;
+}
+
+uint32_t power_budget_avg_ua(const power_budget_t* b, const uint64_t residency[PM_STATE_COUNT])
+{
+    // ua * us stays below 2^64 for ~9 years of residency at 62 mA
+    uint64_t total = 0;
+    uint64_t acc = 0;
+    for (int i = 0; i < PM_STATE_COUNT; ++i) {
+        total += residency[i];
+        acc += (uint64_t)b->current_ua[i] * residency[i];
+    }
+    if (total == 0) return 0;
+    return (uint32_t)((acc + total / 2) / total);
+}
+
+uint64_t power_budget_charge_uah(const power_budget_t* b, const uint64_t residency_us[PM_STATE_COUNT])
+{
+    uint64_t acc = 0;
+    for (int i = 0; i < PM_STATE_COUNT; ++i) {
+        acc += (uint64_t)b->current_ua[i] * residency_us[i];
+    }
+    return (acc + 1800000000ull) / 3600000000ull;
+}
+
+uint64_t power_budget_energy_uwh(uint64_t charge_uah, uint32_t vbat_mv)
+{
+    return (charge_uah * vbat_mv + 500) / 1000;
+}
+
+uint32_t power_budget_runtime_h(uint32_t capacity_mah, uint32_t avg_ua)
+{
+    if (avg_ua == 0) return UINT32_MAX;
+    return (uint32_t)(((uint64_t)capacity_mah * 1000u) / avg_ua);
+}
+
+const char* power_state_name(power_state_t s)
+{
+    static const char* const names[PM_STATE_COUNT] = {
+        "active", "dimmed", "screen_off", "deep_idle",
+    };
+    return (s >= 0 && s < PM_STATE_COUNT) ? names[s] : "?";
+}
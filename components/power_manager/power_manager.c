@@ -0,0 +1,255 @@
+// DFS + automatic light sleep policy and per-state power accounting
+
+#include "power_manager.h"
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+ESP_EVENT_DEFINE_BASE(POWER_MANAGER_EVENT_BASE);
+
+static const char* TAG = "POWER_MGR";
+
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#define LIGHT_SLEEP_ENABLED true
+#else
+#define LIGHT_SLEEP_ENABLED false
+#endif
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static power_state_t s_state = PM_STATE_ACTIVE;
+static int64_t s_state_since_us = 0;
+static uint64_t s_residency_us[PM_STATE_COUNT];
+static uint32_t s_transitions[PM_STATE_COUNT];  // entries into each state
+static bool s_initialized = false;
+
+// CPU boost bookkeeping (guarded by s_lock)
+static const char* const s_boost_names[PM_BOOST_COUNT] = {
+    "boost_ui", "boost_audio", "boost_ble_rx", "boost_storage",
+};
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t s_boost_lock[PM_BOOST_COUNT];
+#endif
+static bool s_boost_enabled = true;
+static uint16_t s_boost_depth[PM_BOOST_COUNT];
+static int64_t s_boost_start_us[PM_BOOST_COUNT];
+static pm_boost_stats_t s_boost_stats[PM_BOOST_COUNT];
+static uint32_t s_boost_active;        // workloads with depth > 0
+static int64_t s_boost_since_us;       // start of the current boosted span
+static uint64_t s_boosted_us;          // closed boosted spans
+static int64_t s_freq_epoch_us;        // start of frequency accounting
+
+esp_err_t power_manager_init(void)
+{
+    if (s_initialized) return ESP_OK;
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_cfg = {
+        .max_freq_mhz = POWER_MANAGER_MAX_MHZ,
+        .min_freq_mhz = POWER_MANAGER_MIN_MHZ,
+        .light_sleep_enable = LIGHT_SLEEP_ENABLED,
+    };
+    esp_err_t err = esp_pm_configure(&pm_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_pm_configure failed: %s", esp_err_to_name(err));
+        return err;
+    }
+#else
+    ESP_LOGW(TAG, "CONFIG_PM_ENABLE is off: fixed CPU clock, no light sleep");
+#endif
+
+    // Light-sleep wake sources. Each pin is armed by the driver that owns
+    // its interrupt with gpio_wakeup_enable(): IMU (sensors), touch
+    // (display_manager), PMIC and BOOT (input_service). BLE needs none: with
+    // controller modem sleep the radio wakes the chip for connection events.
+    ESP_RETURN_ON_ERROR(esp_sleep_enable_gpio_wakeup(), TAG, "gpio wakeup");
+
+#if CONFIG_PM_ENABLE
+    // One lock per workload so esp_pm_dump_locks() names the holder
+    for (int i = 0; i < PM_BOOST_COUNT; ++i) {
+        ESP_RETURN_ON_ERROR(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, s_boost_names[i],
+                                               &s_boost_lock[i]),
+                            TAG, "boost lock");
+    }
+#endif
+
+    s_freq_epoch_us = esp_timer_get_time();
+    s_state_since_us = esp_timer_get_time();
+    s_state = PM_STATE_ACTIVE;
+    s_transitions[PM_STATE_ACTIVE] = 1;
+    s_initialized = true;
+
+    ESP_LOGI(TAG, "DFS %d-%d MHz, light sleep %s", POWER_MANAGER_MIN_MHZ, POWER_MANAGER_MAX_MHZ,
+             LIGHT_SLEEP_ENABLED ? "auto" : "off");
+    return ESP_OK;
+}
+
+void power_manager_set_state(power_state_t state)
+{
+    if (state >= PM_STATE_COUNT) return;
+
+    int64_t now = esp_timer_get_time();
+    power_state_t prev;
+    portENTER_CRITICAL(&s_lock);
+    prev = s_state;
+    if (prev != state) {
+        s_residency_us[prev] += (uint64_t)(now - s_state_since_us);
+        s_state_since_us = now;
+        s_state = state;
+        s_transitions[state]++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (prev == state) return;
+
+    ESP_LOGI(TAG, "%s -> %s", power_state_name(prev), power_state_name(state));
+    (void)esp_event_post(POWER_MANAGER_EVENT_BASE, POWER_MANAGER_EVT_STATE, &state,
+                         sizeof(state), 0);
+}
+
+power_state_t power_manager_get_state(void)
+{
+    return s_state;
+}
+
+void power_manager_get_residency(uint64_t out_us[PM_STATE_COUNT])
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    memcpy(out_us, s_residency_us, sizeof(s_residency_us));
+    out_us[s_state] += (uint64_t)(now - s_state_since_us);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void power_manager_dump_stats(void)
+{
+    uint64_t res[PM_STATE_COUNT];
+    uint64_t total = 0;
+    power_manager_get_residency(res);
+    for (int i = 0; i < PM_STATE_COUNT; ++i) total += res[i];
+
+    power_budget_t budget;
+    power_budget_default(&budget);
+
+    const char* kind = POWER_BUDGET_MEASURED ? "measured" : "estimated";
+    ESP_LOGI(TAG, "%-10s %10s %6s %7s %8s  (uAh from %s currents)", "state", "time_s", "share",
+             "entries", "uAh", kind);
+    for (int i = 0; i < PM_STATE_COUNT; ++i) {
+        uint64_t one[PM_STATE_COUNT] = { 0 };
+        one[i] = res[i];
+        ESP_LOGI(TAG, "%-10s %10u %5u%% %7u %8u", power_state_name((power_state_t)i),
+                 (unsigned)(res[i] / 1000000), total ? (unsigned)(res[i] * 100 / total) : 0,
+                 (unsigned)s_transitions[i], (unsigned)power_budget_charge_uah(&budget, one));
+    }
+
+    uint32_t avg = power_budget_avg_ua(&budget, res);
+    uint64_t uah = power_budget_charge_uah(&budget, res);
+    ESP_LOGI(TAG, "Average %u uA, %u uAh / %u uWh so far, ~%u h on %u mAh (%s)", (unsigned)avg,
+             (unsigned)uah, (unsigned)power_budget_energy_uwh(uah, POWER_BUDGET_VBAT_MV),
+             (unsigned)power_budget_runtime_h(POWER_BUDGET_BATTERY_MAH, avg),
+             (unsigned)POWER_BUDGET_BATTERY_MAH, kind);
+
+    uint64_t boosted, base;
+    power_manager_get_freq_residency(&boosted, &base);
+    uint64_t span = boosted + base;
+    ESP_LOGI(TAG, "CPU boost %s: %u ms at %d MHz (%u.%u%%), %u ms at base",
+             s_boost_enabled ? "on" : "off", (unsigned)(boosted / 1000), POWER_MANAGER_MAX_MHZ,
+             span ? (unsigned)(boosted * 100 / span) : 0,
+             span ? (unsigned)(boosted * 1000 / span % 10) : 0, (unsigned)(base / 1000));
+    for (int i = 0; i < PM_BOOST_COUNT; ++i) {
+        pm_boost_stats_t st;
+        power_manager_get_boost_stats((pm_boost_t)i, &st);
+        if (st.count == 0) continue;
+        ESP_LOGI(TAG, "  %-13s n=%u avg=%u us max=%u us", s_boost_names[i], (unsigned)st.count,
+                 (unsigned)(st.total_us / st.count), (unsigned)st.max_us);
+    }
+#if CONFIG_PM_PROFILING
+    esp_pm_dump_locks(stdout);
+#endif
+}
+
+void power_manager_boost_begin(pm_boost_t w)
+{
+    if (w >= PM_BOOST_COUNT) return;
+
+    int64_t now = esp_timer_get_time();
+    bool take = false;
+    portENTER_CRITICAL(&s_lock);
+    if (s_boost_depth[w]++ == 0) {
+        s_boost_start_us[w] = now;
+        if (s_boost_active++ == 0) s_boost_since_us = now;
+        take = s_boost_enabled;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+#if CONFIG_PM_ENABLE
+    if (take && s_boost_lock[w]) (void)esp_pm_lock_acquire(s_boost_lock[w]);
+#else
+    (void)take;
+#endif
+}
+
+void power_manager_boost_end(pm_boost_t w)
+{
+    if (w >= PM_BOOST_COUNT) return;
+
+    int64_t now = esp_timer_get_time();
+    bool give = false;
+    portENTER_CRITICAL(&s_lock);
+    if (s_boost_depth[w] > 0 && --s_boost_depth[w] == 0) {
+        uint64_t dt = (uint64_t)(now - s_boost_start_us[w]);
+        pm_boost_stats_t* st = &s_boost_stats[w];
+        st->count++;
+        st->total_us += dt;
+        if (dt > st->max_us) st->max_us = (uint32_t)dt;
+        if (--s_boost_active == 0) s_boosted_us += (uint64_t)(now - s_boost_since_us);
+        give = s_boost_enabled;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+#if CONFIG_PM_ENABLE
+    if (give && s_boost_lock[w]) (void)esp_pm_lock_release(s_boost_lock[w]);
+#else
+    (void)give;
+#endif
+}
+
+void power_manager_set_boost_enabled(bool enabled)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    // Only toggle with no section open, so acquire/release stay paired
+    bool idle = s_boost_active == 0;
+    if (idle && s_boost_enabled != enabled) {
+        s_boost_enabled = enabled;
+        memset(s_boost_stats, 0, sizeof(s_boost_stats));
+        s_boosted_us = 0;
+        s_freq_epoch_us = now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (!idle) ESP_LOGW(TAG, "Boost toggle ignored: a boost section is open");
+}
+
+void power_manager_get_boost_stats(pm_boost_t w, pm_boost_stats_t* out)
+{
+    if (w >= PM_BOOST_COUNT || !out) return;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_boost_stats[w];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void power_manager_get_freq_residency(uint64_t* boosted_us, uint64_t* base_us)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    uint64_t boosted = s_boosted_us;
+    if (s_boost_active) boosted += (uint64_t)(now - s_boost_since_us);
+    uint64_t span = (uint64_t)(now - s_freq_epoch_us);
+    portEXIT_CRITICAL(&s_lock);
+    if (boosted_us) *boosted_us = boosted;
+    if (base_us) *base_us = span > boosted ? span - boosted : 0;
+}
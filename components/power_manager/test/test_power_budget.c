@@ -0,0 +1,50 @@
+#include "unity.h"
+
+#include "power_budget.h"
+
+#define HOUR_US (3600ull * 1000000ull)
+
+TEST_CASE("budget average is time weighted", "[power_budget]") {
+  power_budget_t b;
+  power_budget_default(&b);
+
+  uint64_t only_active[PM_STATE_COUNT] = {HOUR_US, 0, 0, 0};
+  TEST_ASSERT_EQUAL_UINT32(POWER_BUDGET_ACTIVE_UA, power_budget_avg_ua(&b, only_active));
+
+  uint64_t half[PM_STATE_COUNT] = {HOUR_US, 0, HOUR_US, 0};
+  TEST_ASSERT_EQUAL_UINT32((POWER_BUDGET_ACTIVE_UA + POWER_BUDGET_SCREEN_OFF_UA) / 2,
+                           power_budget_avg_ua(&b, half));
+
+  uint64_t none[PM_STATE_COUNT] = {0};
+  TEST_ASSERT_EQUAL_UINT32(0, power_budget_avg_ua(&b, none));
+}
+
+TEST_CASE("budget charge and energy", "[power_budget]") {
+  power_budget_t b;
+  power_budget_default(&b);
+
+  uint64_t one_hour_off[PM_STATE_COUNT] = {0, 0, HOUR_US, 0};
+  uint64_t uah = power_budget_charge_uah(&b, one_hour_off);
+  TEST_ASSERT_EQUAL_UINT64(POWER_BUDGET_SCREEN_OFF_UA, uah);
+  TEST_ASSERT_EQUAL_UINT64((uint64_t)POWER_BUDGET_SCREEN_OFF_UA * 3900 / 1000,
+                           power_budget_energy_uwh(uah, 3900));
+
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, power_budget_runtime_h(300, 0));
+  TEST_ASSERT_EQUAL_UINT32(100, power_budget_runtime_h(300, 3000));
+}
+
+TEST_CASE("typical day fits the battery", "[power_budget]") {
+  // 1 h interacting, 1 h dimmed, 6 h screen off, 16 h deep idle
+  power_budget_t b;
+  power_budget_default(&b);
+  uint64_t day[PM_STATE_COUNT] = {1 * HOUR_US, 1 * HOUR_US, 6 * HOUR_US, 16 * HOUR_US};
+
+  uint64_t uah = power_budget_charge_uah(&b, day);
+  TEST_ASSERT_LESS_THAN_UINT64((uint64_t)POWER_BUDGET_BATTERY_MAH * 1000, uah);
+
+  uint32_t avg = power_budget_avg_ua(&b, day);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(24, power_budget_runtime_h(POWER_BUDGET_BATTERY_MAH, avg));
+
+  // Screen-off states must dominate the day for the budget to hold
+  TEST_ASSERT_LESS_THAN_UINT32(POWER_BUDGET_DIMMED_UA, avg);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include "esp_event.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +18,18 @@ uint32_t sensors_get_step_count(void);
 // Returns current activity classification
 sensors_activity_t sensors_get_activity(void);
 
+// Wrist gestures, posted on the default event loop while the screen is on
+ESP_EVENT_DECLARE_BASE(SENSORS_EVENT_BASE);
+
+typedef enum {
+    SENSORS_EVT_WRIST_FLICK = 1,   // payload: sensors_flick_t
+} sensors_event_id_t;
+
+typedef struct {
+    int8_t dir;                    // +1 flick to the right, -1 to the left
+    int64_t us;                    // esp_timer time of the peak
+} sensors_flick_t;
+
 #ifdef __cplusplus
 }
 #endif
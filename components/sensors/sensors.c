@@ -23,8 +23,15 @@
 #define RAISE_ACCEL_MAX_MG 1150.0f // acceptable accel magnitude upper bound
 #define RAISE_COOLDOWN_MS 3500     // min ms between wakeups
 
+// Wrist flick: a sharp jolt along Y (the watch's left/right axis) with the
+// slow part (gravity, arm tilt) filtered out. Not tuned on many wrists yet.
+#define FLICK_THRESH_MG 900.0f     // high-passed |ay| to count as a flick
+#define FLICK_COOLDOWN_MS 700      // ignores the rebound of the same flick
+
 static const char *TAG = "SENSORS";
 
+ESP_EVENT_DEFINE_BASE(SENSORS_EVENT_BASE);
+
 static qmi8658_dev_t s_imu;
 static bool s_imu_ready = false;
 static volatile uint32_t s_step_count = 0; // daily steps
@@ -56,6 +63,8 @@ static void maybe_reset_daily_counter(void) {
 
 static void IRAM_ATTR imu_irq_isr(void *arg) {
   BaseType_t hp = pdFALSE;
+  // Level interrupt: stay masked until the task has serviced the IMU
+  gpio_intr_disable(IMU_IRQ_GPIO);
   if (s_wom_sem) {
     xSemaphoreGiveFromISR(s_wom_sem, &hp);
   }
@@ -70,8 +79,9 @@ static esp_err_t imu_setup_irq(void) {
       // QMI8658 INT is typically active-low; use pull-up only
       .pull_up_en = GPIO_PULLUP_ENABLE,
       .pull_down_en = GPIO_PULLDOWN_DISABLE,
-      // Use falling edge to avoid interrupt storms on level changes/noise
-      .intr_type = GPIO_INTR_NEGEDGE,
+      // Level-low: the only trigger that wakes the chip from light sleep.
+      // The ISR masks it, so a held line doesn't storm.
+      .intr_type = GPIO_INTR_DISABLE,
   };
   ESP_ERROR_CHECK(gpio_config(&io));
   esp_err_t r = gpio_install_isr_service(0);
@@ -80,7 +90,7 @@ static esp_err_t imu_setup_irq(void) {
   }
   // Clear any pending status before enabling
   gpio_intr_disable(IMU_IRQ_GPIO);
-  (void)gpio_set_intr_type(IMU_IRQ_GPIO, GPIO_INTR_NEGEDGE);
+  ESP_ERROR_CHECK(gpio_wakeup_enable(IMU_IRQ_GPIO, GPIO_INTR_LOW_LEVEL));
   ESP_ERROR_CHECK(gpio_isr_handler_add(IMU_IRQ_GPIO, imu_irq_isr, NULL));
   gpio_intr_enable(IMU_IRQ_GPIO);
   return ESP_OK;
@@ -144,6 +154,9 @@ void sensors_task(void *pvParameters) {
   uint32_t ts_hist[16] = {0};
   int hist_idx = 0, hist_num = 0;
   uint32_t last_raise_ms = 0;
+  // Wrist flick state
+  float ay_lp = 0.0f;
+  uint32_t last_flick_ms = 0;
 
   bool wom_enabled = true; // enabled in init
   bool ready_for_next_peak = true;
@@ -159,6 +172,12 @@ void sensors_task(void *pvParameters) {
         (void)qmi8658_enable_wake_on_motion(&s_imu, 12);
         wom_enabled = true;
       }
+      // Motion woke us from light sleep: the sampling below reads the IMU
+      // (clearing its latch), then the line is armed again. Turning the
+      // screen on is left to raise-to-wake.
+      if (s_wom_sem && xSemaphoreTake(s_wom_sem, 0) == pdTRUE) {
+        gpio_intr_enable(IMU_IRQ_GPIO);
+      }
       /*if (s_wom_sem && xSemaphoreTake(s_wom_sem, 0) == pdTRUE) {
           ESP_LOGI(TAG, "Wake-on-motion IRQ");
           display_manager_turn_on();
@@ -226,6 +245,21 @@ void sensors_task(void *pvParameters) {
         s_activity = SENSORS_ACTIVITY_IDLE;
       }
 
+      // Wrist flick: only while the screen is on (someone is using it)
+      float ay_hp = ay - ay_lp;
+      ay_lp = alpha * ay_lp + (1.0f - alpha) * ay;
+      if (screen_on && fabsf(ay_hp) > FLICK_THRESH_MG &&
+          (now_ms - last_flick_ms) > FLICK_COOLDOWN_MS) {
+        sensors_flick_t ev = {
+            .dir = ay_hp > 0 ? 1 : -1,
+            .us = esp_timer_get_time(),
+        };
+        last_flick_ms = now_ms;
+        ESP_LOGD(TAG, "Wrist flick %+d (%.0f mg)", ev.dir, ay_hp);
+        (void)esp_event_post(SENSORS_EVENT_BASE, SENSORS_EVT_WRIST_FLICK, &ev,
+                             sizeof(ev), 0);
+      }
+
       // Raise-to-wake: compute pitch angle from accel (degrees)
       // pitch ~ rotation around Y: -ax against gravity
       float ax_g = ax / 1000.0f, ay_g = ay / 1000.0f, az_g = az / 1000.0f;
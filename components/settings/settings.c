@@ -13,6 +13,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/timers.h"
 #include "cJSON.h"
+#include "power_manager.h"
 
 static const char *TAG = "SETTINGS";
 
@@ -112,7 +113,7 @@ static bool settings_mount_spiffs(void)
     return false;
 }
 
-static bool settings_write_json(void)
+static bool settings_write_json_file(void)
 {
     if (!settings_mount_spiffs()) return false;
     cJSON *root = cJSON_CreateObject();
@@ -145,6 +146,14 @@ static bool settings_write_json(void)
     return true;
 }
 
+static bool settings_write_json(void)
+{
+    power_manager_boost_begin(PM_BOOST_STORAGE);
+    bool ok = settings_write_json_file();
+    power_manager_boost_end(PM_BOOST_STORAGE);
+    return ok;
+}
+
 static bool settings_read_json(void)
 {
     if (!settings_mount_spiffs()) return false;
@@ -345,14 +354,17 @@ bool settings_format_spiffs(void)
         lv_refr_now(NULL);
         bsp_display_unlock();
     }
+    power_manager_boost_begin(PM_BOOST_STORAGE);
     esp_err_t r = esp_spiffs_format(SETTINGS_PARTITION);
     if (r != ESP_OK) {
+        power_manager_boost_end(PM_BOOST_STORAGE);
         ESP_LOGE(TAG, "SPIFFS format failed: %s", esp_err_to_name(r));
         if (overlay && bsp_display_lock(100)) { lv_obj_del(overlay); lv_refr_now(NULL); bsp_display_unlock(); }
         return false;
     }
     // Remount and write defaults
     bool ok = settings_mount_spiffs() && settings_write_json();
+    power_manager_boost_end(PM_BOOST_STORAGE);
     if (overlay && bsp_display_lock(100)) { lv_obj_del(overlay); lv_refr_now(NULL); bsp_display_unlock(); }
     return ok;
 }
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Virtual list: maps a scroll position over `count` equally spaced items
+// onto a small pool of widgets. Only items overlapping the viewport (plus
+// one on each side, so a drag never binds mid-gesture) hold a slot; an item
+// keeps its slot while it stays in range, so scrolling rebinds at most one
+// widget per item crossed. Memory and work per frame don't depend on count.
+//
+// Scrolling only records the position; vlist_layout() applies it, so the
+// GUI calls it once per refresh however many touch events came in.
+// Plain C, tested on the host.
+
+#define VLIST_POOL_MAX 6
+#define VLIST_NONE     (-1)
+
+typedef struct {
+    uint32_t layouts;    // vlist_layout passes that did work
+    uint32_t binds;      // bind callbacks with an item
+    uint32_t hides;      // bind callbacks with VLIST_NONE
+    uint32_t scrolls;    // scroll requests folded into those passes
+} vlist_stats_t;
+
+// Load item into the widget of slot, or hide it (item == VLIST_NONE)
+typedef void (*vlist_bind_cb_t)(void* ctx, int slot, int32_t item);
+// Move the widget of slot to pos (px from the viewport start)
+typedef void (*vlist_place_cb_t)(void* ctx, int slot, int32_t pos);
+
+typedef struct {
+    int32_t count;
+    int32_t gap;         // between items
+    int32_t pitch;       // item size + gap
+    int32_t view;        // viewport size
+    int32_t scroll;      // 0 .. vlist_max_scroll()
+    int pool;
+    int32_t item[VLIST_POOL_MAX];    // bound item per slot, VLIST_NONE if free
+    bool shown[VLIST_POOL_MAX];      // slot widget visible
+    bool dirty;
+    vlist_stats_t stats;
+} vlist_t;
+
+// Slots needed so that every item in range has a widget
+#define VLIST_POOL_NEEDED(size, gap, view) (((view) + (size) + (gap) - 1) / ((size) + (gap)) + 3)
+
+// pool: widgets available, at least VLIST_POOL_NEEDED(size, gap, view).
+// False when the pool is too small or larger than VLIST_POOL_MAX.
+bool vlist_init(vlist_t* v, int pool, int32_t size, int32_t gap, int32_t view);
+
+// Last item flush with the end of the viewport
+static inline int32_t vlist_max_scroll(const vlist_t* v)
+{
+    int32_t m = v->count * v->pitch - v->gap - v->view;
+    return m > 0 ? m : 0;
+}
+
+// Item count changed; items are rebound (indices may have shifted)
+void vlist_set_count(vlist_t* v, int32_t count);
+// Contents changed without a count change (e.g. insert + trim at the end)
+void vlist_invalidate(vlist_t* v);
+
+void vlist_scroll_to(vlist_t* v, int32_t pos);
+// Item whose start is closest to the scroll position (snap target)
+int32_t vlist_nearest(const vlist_t* v);
+
+// Apply the pending scroll: rebind slots that left the range, then place
+// every visible widget. Returns false when nothing changed since last pass.
+bool vlist_layout(vlist_t* v, vlist_bind_cb_t bind, vlist_place_cb_t place, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
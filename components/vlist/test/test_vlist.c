@@ -0,0 +1,164 @@
+#include "unity.h"
+
+#include "vlist.h"
+
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+// Round watch face: one card per screen, 16 px apart
+#define SIZE 410
+#define GAP  16
+#define POOL VLIST_POOL_NEEDED(SIZE, GAP, SIZE)
+
+typedef struct {
+  int32_t item[VLIST_POOL_MAX];
+  int32_t pos[VLIST_POOL_MAX];
+} widgets_t;
+
+static void widgets_init(widgets_t* w) {
+  memset(w, 0, sizeof(*w));
+  for (int s = 0; s < VLIST_POOL_MAX; ++s) w->item[s] = VLIST_NONE;
+}
+
+static void bind(void* ctx, int slot, int32_t item) {
+  widgets_t* w = ctx;
+  w->item[slot] = item;
+}
+
+static void place(void* ctx, int slot, int32_t pos) {
+  widgets_t* w = ctx;
+  w->pos[slot] = pos;
+}
+
+// Every item overlapping the viewport has exactly one widget, at its place
+static void assert_consistent(const vlist_t* v, const widgets_t* w) {
+  int32_t first = v->scroll / v->pitch;
+  int32_t last = (v->scroll + v->view - 1) / v->pitch;
+  if (last > v->count - 1) last = v->count - 1;
+  for (int32_t i = first; i <= last; ++i) {
+    int n = 0;
+    for (int s = 0; s < v->pool; ++s) {
+      if (w->item[s] == i) {
+        n++;
+        TEST_ASSERT_EQUAL(i * v->pitch - v->scroll, w->pos[s]);
+      }
+    }
+    TEST_ASSERT_EQUAL(1, n);
+  }
+}
+
+TEST_CASE("visible items get one widget each", "[vlist]") {
+  vlist_t v;
+  widgets_t w;
+  widgets_init(&w);
+  TEST_ASSERT_FALSE(vlist_init(&v, POOL - 1, SIZE, GAP, SIZE));
+  TEST_ASSERT_TRUE(vlist_init(&v, POOL, SIZE, GAP, SIZE));
+  vlist_set_count(&v, 10);
+  TEST_ASSERT_EQUAL(9 * (SIZE + GAP), vlist_max_scroll(&v));
+
+  TEST_ASSERT_TRUE(vlist_layout(&v, bind, place, &w));
+  assert_consistent(&v, &w);
+  TEST_ASSERT_EQUAL(2, v.stats.binds);   // item 0 and the next one
+
+  for (int32_t pos = 0; pos <= vlist_max_scroll(&v) + 100; pos += 37) {
+    vlist_scroll_to(&v, pos);
+    vlist_layout(&v, bind, place, &w);
+    assert_consistent(&v, &w);
+  }
+  TEST_ASSERT_EQUAL(vlist_max_scroll(&v), v.scroll);
+  TEST_ASSERT_EQUAL(9, vlist_nearest(&v));
+  // A forward sweep binds each item once
+  TEST_ASSERT_EQUAL(10, v.stats.binds);
+
+  vlist_scroll_to(&v, (SIZE + GAP) * 4 + (SIZE + GAP) / 2 + 1);
+  TEST_ASSERT_EQUAL(5, vlist_nearest(&v));
+  vlist_scroll_to(&v, -50);
+  TEST_ASSERT_EQUAL(0, v.scroll);
+}
+
+TEST_CASE("scrolls fold into one layout pass", "[vlist]") {
+  vlist_t v;
+  widgets_t w;
+  widgets_init(&w);
+  TEST_ASSERT_TRUE(vlist_init(&v, POOL, SIZE, GAP, SIZE));
+  vlist_set_count(&v, 50);
+  vlist_layout(&v, bind, place, &w);
+  TEST_ASSERT_FALSE(vlist_layout(&v, bind, place, &w));
+
+  for (int i = 1; i <= 20; ++i) vlist_scroll_to(&v, i * 9);
+  TEST_ASSERT_TRUE(vlist_layout(&v, bind, place, &w));
+  TEST_ASSERT_FALSE(vlist_layout(&v, bind, place, &w));
+  TEST_ASSERT_EQUAL(2, v.stats.layouts);
+  assert_consistent(&v, &w);
+}
+
+TEST_CASE("count changes rebind and hide", "[vlist]") {
+  vlist_t v;
+  widgets_t w;
+  widgets_init(&w);
+  TEST_ASSERT_TRUE(vlist_init(&v, POOL, SIZE, GAP, SIZE));
+  vlist_set_count(&v, 5);
+  vlist_scroll_to(&v, vlist_max_scroll(&v));
+  vlist_layout(&v, bind, place, &w);
+
+  vlist_set_count(&v, 2);          // deleted from the end: scroll clamps
+  TEST_ASSERT_EQUAL(SIZE + GAP, v.scroll);
+  vlist_layout(&v, bind, place, &w);
+  assert_consistent(&v, &w);
+  for (int s = 0; s < v.pool; ++s) TEST_ASSERT_TRUE(w.item[s] < 2);
+
+  uint32_t before = v.stats.binds;
+  vlist_invalidate(&v);            // new item on top: same slots, new contents
+  vlist_layout(&v, bind, place, &w);
+  TEST_ASSERT_EQUAL(2, v.stats.binds - before);
+
+  vlist_set_count(&v, 0);
+  vlist_layout(&v, bind, place, &w);
+  for (int s = 0; s < v.pool; ++s) TEST_ASSERT_EQUAL(VLIST_NONE, w.item[s]);
+  TEST_ASSERT_EQUAL(VLIST_NONE, vlist_nearest(&v));
+}
+
+// Scripted swipe through the whole list, 24 px per frame like a fast drag.
+// The bind callback does the work of a card update (copy a title + preview).
+static char s_card[VLIST_POOL_MAX][160];
+static char s_text[1000][160];
+
+static void bind_text(void* ctx, int slot, int32_t item) {
+  (void)ctx;
+  if (item != VLIST_NONE) memcpy(s_card[slot], s_text[item], sizeof(s_card[slot]));
+}
+
+TEST_CASE("frame cost does not grow with the list", "[vlist][bench]") {
+  static const int32_t sizes[] = {10, 100, 1000};
+  for (int i = 0; i < 1000; ++i) snprintf(s_text[i], sizeof(s_text[i]), "notification %d", i);
+
+  for (unsigned k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+    vlist_t v;
+    widgets_t w;
+    widgets_init(&w);
+    TEST_ASSERT_TRUE(vlist_init(&v, POOL, SIZE, GAP, SIZE));
+    vlist_set_count(&v, sizes[k]);
+    vlist_layout(&v, bind_text, place, &w);   // screen opened
+
+    int frames = 0;
+    uint32_t max_binds = 0;
+    int64_t total = 0, worst = 0;
+    for (int32_t pos = 24; pos <= vlist_max_scroll(&v); pos += 24, ++frames) {
+      uint32_t b0 = v.stats.binds;
+      int64_t t0 = esp_timer_get_time();
+      vlist_scroll_to(&v, pos);
+      vlist_layout(&v, bind_text, place, &w);
+      int64_t dt = esp_timer_get_time() - t0;
+      total += dt;
+      if (dt > worst) worst = dt;
+      if (v.stats.binds - b0 > max_binds) max_binds = v.stats.binds - b0;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(1, max_binds);
+    TEST_ASSERT_EQUAL((uint32_t)sizes[k], v.stats.binds);
+    printf("vlist: %4d items, %5d frames, %u B state, %d widgets, avg %u ns/frame, worst %u us, "
+           "max %u bind/frame\n",
+           (int)sizes[k], frames, (unsigned)sizeof(v), v.pool,
+           frames ? (unsigned)(total * 1000 / frames) : 0, (unsigned)worst, (unsigned)max_binds);
+  }
+}
@@ -0,0 +1,100 @@
+// Virtual list windowing (see vlist.h)
+
+#include "vlist.h"
+
+#include <string.h>
+
+bool vlist_init(vlist_t* v, int pool, int32_t size, int32_t gap, int32_t view)
+{
+    memset(v, 0, sizeof(*v));
+    if (size <= 0 || gap < 0 || view <= 0) return false;
+    if (pool > VLIST_POOL_MAX || pool < VLIST_POOL_NEEDED(size, gap, view)) return false;
+    v->gap = gap;
+    v->pitch = size + gap;
+    v->view = view;
+    v->pool = pool;
+    for (int i = 0; i < VLIST_POOL_MAX; ++i) v->item[i] = VLIST_NONE;
+    v->dirty = true;
+    return true;
+}
+
+void vlist_invalidate(vlist_t* v)
+{
+    for (int i = 0; i < v->pool; ++i) v->item[i] = VLIST_NONE;
+    v->dirty = true;
+}
+
+void vlist_set_count(vlist_t* v, int32_t count)
+{
+    v->count = count > 0 ? count : 0;
+    vlist_invalidate(v);
+    vlist_scroll_to(v, v->scroll);
+}
+
+void vlist_scroll_to(vlist_t* v, int32_t pos)
+{
+    int32_t max = vlist_max_scroll(v);
+    if (pos > max) pos = max;
+    if (pos < 0) pos = 0;
+    v->stats.scrolls++;
+    if (pos != v->scroll) {
+        v->scroll = pos;
+        v->dirty = true;
+    }
+}
+
+int32_t vlist_nearest(const vlist_t* v)
+{
+    if (v->count == 0) return VLIST_NONE;
+    int32_t i = (v->scroll + v->pitch / 2) / v->pitch;
+    return i < v->count ? i : v->count - 1;
+}
+
+bool vlist_layout(vlist_t* v, vlist_bind_cb_t bind, vlist_place_cb_t place, void* ctx)
+{
+    if (!v->dirty) return false;
+    v->dirty = false;
+    v->stats.layouts++;
+
+    // Items in range: the ones overlapping the viewport and one either side
+    int32_t first = 0, last = -1;
+    if (v->count > 0) {
+        first = v->scroll / v->pitch - 1;
+        last = (v->scroll + v->view - 1) / v->pitch + 1;
+        if (first < 0) first = 0;
+        if (last > v->count - 1) last = v->count - 1;
+    }
+
+    // Release slots whose item left the range
+    for (int s = 0; s < v->pool; ++s) {
+        if (v->item[s] != VLIST_NONE && (v->item[s] < first || v->item[s] > last)) {
+            v->item[s] = VLIST_NONE;
+        }
+    }
+
+    // Bind items without a slot; the range never exceeds the pool
+    for (int32_t i = first; i <= last; ++i) {
+        int free_slot = -1;
+        bool bound = false;
+        for (int s = 0; s < v->pool; ++s) {
+            if (v->item[s] == i) { bound = true; break; }
+            if (free_slot < 0 && v->item[s] == VLIST_NONE) free_slot = s;
+        }
+        if (bound || free_slot < 0) continue;
+        v->item[free_slot] = i;
+        v->shown[free_slot] = true;
+        v->stats.binds++;
+        bind(ctx, free_slot, i);
+    }
+
+    for (int s = 0; s < v->pool; ++s) {
+        if (v->item[s] != VLIST_NONE) {
+            place(ctx, s, v->item[s] * v->pitch - v->scroll);
+        } else if (v->shown[s]) {
+            v->shown[s] = false;
+            v->stats.hides++;
+            bind(ctx, s, VLIST_NONE);
+        }
+    }
+    return true;
+}
@@ -5,6 +5,7 @@
 #include "bsp/esp-bsp.h"
 #include "bsp_board_extra.h"
 #include "display_manager.h"
+#include "power_manager.h"
 
 #include "esp_check.h"
 #include "esp_err.h"
@@ -16,14 +17,15 @@
 #include "settings.h"
 #include "ui.h"
 
-// HID Combinado (Mouse + Keyboard en un solo dispositivo)
+// HID Combinado (Mouse + Keyboard en un solo dispositivo) y UART de
+// sincronización, los dos sobre el mismo host NimBLE
 #include "ble_hid_combined.h"
+#include "ble_host.h"
+#include "ble_sync.h"
 
 // Power management
 #include "esp_wifi.h"
 #include "esp_bt.h"
-#include "esp_sleep.h"
-#include "esp_pm.h"
 
 #include "audio_alert.h"
 
@@ -72,7 +74,9 @@ extern "C" void app_main(void) {
     // 3) Event loop
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
-    // 4) Activar pantalla pronto
+    // 4) DFS + light sleep automático; la pantalla lo bloquea mientras está
+    //    encendida (display_manager_pm_early_init)
+    ESP_ERROR_CHECK(power_manager_init());
     display_manager_pm_early_init();
 
     // 5) Iniciar pantalla / BSP
@@ -82,6 +86,11 @@ extern "C" void app_main(void) {
     // 6) Cargar ajustes del usuario
     settings_init();
 
+    // 7) Tarea de audio: las alertas solo se encolan
+    if (audio_alert_init() != ESP_OK) {
+        ESP_LOGE(TAG, "✗ Audio task not started");
+    }
+
     /* --------------------------------------------------------
        HID COMBINADO BLE (Mouse + Keyboard)
        Emparejamiento con PIN: 1234
@@ -108,6 +117,17 @@ extern "C" void app_main(void) {
         ESP_LOGI(TAG, "");
     }
 
+    // Servicio UART de sincronización en el mismo servidor GATT. Los
+    // servicios se añaden antes de arrancar el host, que solo se arranca
+    // aquí: si el sync falla el HID funciona igual.
+    esp_err_t sync_err = ble_sync_init();
+    if (sync_err != ESP_OK) {
+        ESP_LOGE(TAG, "✗ BLE sync init FAILED: %s", esp_err_to_name(sync_err));
+    }
+    if (ble_host_start() != ESP_OK) {
+        ESP_LOGE(TAG, "✗ BLE host not started");
+    }
+
     /* --------------------------------------------------------
        UI
        -------------------------------------------------------- */
@@ -117,20 +137,4 @@ extern "C" void app_main(void) {
 
     // Sonido de inicio
     audio_alert_play_startup();
-
-    /* --------------------------------------------------------
-       POWER MANAGEMENT — NO APAGAR NUNCA
-       -------------------------------------------------------- */
-
-    esp_pm_config_t pm_cfg = {
-        .max_freq_mhz = 240,
-        .min_freq_mhz = 240,
-        .light_sleep_enable = false
-    };
-    ESP_ERROR_CHECK(esp_pm_configure(&pm_cfg));
-
-    // Sin fuentes de wakeup (por seguridad)
-    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
-
-    ESP_LOGI(TAG, "Screen will NEVER turn off. PM disabled.");
 }